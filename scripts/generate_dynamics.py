@@ -0,0 +1,964 @@
+#!/usr/bin/env python3
+"""
+Generates a fixed size dynamics kernel for a robot from its URDF definition.
+
+The kinematic tree is flattened the same way pinocchio builds its model. Links
+attached by fixed joints are merged into the body of their moving parent joint,
+and every joint and link becomes a frame on a body. The forward kinematics,
+non-linear effects, articulated body algorithm and frame jacobians are then
+emitted as straight line code for each body, with the joint placements and
+inertias as constants.
+
+Only revolute and prismatic joints are supported. Joint damping, friction and
+limits are ignored, as they are by pinocchio.
+
+Usage:
+    generate_dynamics.py --urdf robot.urdf --output directory [--name robot_kernel]
+"""
+
+import argparse
+import math
+import os
+import sys
+import xml.etree.ElementTree as ET
+
+GRAVITY = 9.81
+
+
+def identity():
+    return [[1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [0.0, 0.0, 1.0]]
+
+
+def multiply(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(3)) for j in range(3)] for i in range(3)]
+
+
+def transpose(a):
+    return [[a[j][i] for j in range(3)] for i in range(3)]
+
+
+def apply(a, v):
+    return [sum(a[i][k] * v[k] for k in range(3)) for i in range(3)]
+
+
+def add(a, b):
+    return [a[i] + b[i] for i in range(3)]
+
+
+def rpy_to_rotation(roll, pitch, yaw):
+    """URDF fixed axis roll, pitch, yaw as Rz(yaw) Ry(pitch) Rx(roll)."""
+    cr, sr = math.cos(roll), math.sin(roll)
+    cp, sp = math.cos(pitch), math.sin(pitch)
+    cy, sy = math.cos(yaw), math.sin(yaw)
+    return [
+        [cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr],
+        [sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr],
+        [-sp, cp * sr, cp * cr],
+    ]
+
+
+class Transform:
+    """A rigid transform, mapping child coordinates to the parent."""
+
+    def __init__(self, rotation=None, translation=None):
+        self.rotation = rotation if rotation is not None else identity()
+        self.translation = translation if translation is not None else [0.0, 0.0, 0.0]
+
+    def __mul__(self, other):
+        return Transform(
+            multiply(self.rotation, other.rotation),
+            add(apply(self.rotation, other.translation), self.translation),
+        )
+
+    def is_identity(self):
+        return (
+            all(abs(self.rotation[i][j] - (i == j)) < 1e-15 for i in range(3) for j in range(3))
+            and all(abs(x) < 1e-15 for x in self.translation)
+        )
+
+
+def parse_vector(text, default):
+    if text is None:
+        return list(default)
+    return [float(x) for x in text.split()]
+
+
+def parse_origin(element):
+    origin = element.find("origin") if element is not None else None
+    if origin is None:
+        return Transform()
+    xyz = parse_vector(origin.get("xyz"), [0.0, 0.0, 0.0])
+    rpy = parse_vector(origin.get("rpy"), [0.0, 0.0, 0.0])
+    return Transform(rpy_to_rotation(*rpy), xyz)
+
+
+class Inertia:
+    """Mass, centre of mass and rotational inertia about the centre of mass."""
+
+    def __init__(self, mass=0.0, com=None, rotational=None):
+        self.mass = mass
+        self.com = com if com is not None else [0.0, 0.0, 0.0]
+        self.rotational = rotational if rotational is not None else [[0.0] * 3 for _ in range(3)]
+
+    def transformed(self, transform):
+        rotation = transform.rotation
+        return Inertia(
+            self.mass,
+            add(apply(rotation, self.com), transform.translation),
+            multiply(multiply(rotation, self.rotational), transpose(rotation)),
+        )
+
+    def __add__(self, other):
+        mass = self.mass + other.mass
+        if mass == 0.0:
+            return Inertia()
+
+        com = [(self.mass * self.com[i] + other.mass * other.com[i]) / mass for i in range(3)]
+
+        # Parallel axis theorem to the combined centre of mass.
+        rotational = [[0.0] * 3 for _ in range(3)]
+        for part in (self, other):
+            d = [part.com[i] - com[i] for i in range(3)]
+            dd = sum(x * x for x in d)
+            for i in range(3):
+                for j in range(3):
+                    rotational[i][j] += part.rotational[i][j] + part.mass * ((i == j) * dd - d[i] * d[j])
+
+        return Inertia(mass, com, rotational)
+
+    def spatial(self):
+        """The 6x6 spatial inertia in (linear, angular) order."""
+        m, c = self.mass, self.com
+        cross = [[0.0, -c[2], c[1]], [c[2], 0.0, -c[0]], [-c[1], c[0], 0.0]]
+        cc = multiply(cross, cross)
+        matrix = [[0.0] * 6 for _ in range(6)]
+        for i in range(3):
+            for j in range(3):
+                matrix[i][j] = m * (i == j)
+                matrix[i][3 + j] = -m * cross[i][j]
+                matrix[3 + i][j] = m * cross[i][j]
+                matrix[3 + i][3 + j] = self.rotational[i][j] - m * cc[i][j]
+        return matrix
+
+
+def parse_inertial(link):
+    inertial = link.find("inertial")
+    if inertial is None:
+        return Inertia()
+
+    mass = float(inertial.find("mass").get("value"))
+    element = inertial.find("inertia")
+    get = lambda name: float(element.get(name, "0"))
+    rotational = [
+        [get("ixx"), get("ixy"), get("ixz")],
+        [get("ixy"), get("iyy"), get("iyz")],
+        [get("ixz"), get("iyz"), get("izz")],
+    ]
+    return Inertia(mass, [0.0, 0.0, 0.0], rotational).transformed(parse_origin(inertial))
+
+
+class Body:
+    """A body of the flattened tree, moved by a single joint."""
+
+    def __init__(self, index, name, parent, placement, kind, axis):
+        self.index = index
+        self.name = name
+        self.parent = parent
+        self.placement = placement
+        self.kind = kind
+        self.axis = axis
+        self.inertia = Inertia()
+
+
+class Frame:
+    """A named frame fixed to a body, or to the world if the body is -1."""
+
+    def __init__(self, name, body, placement):
+        self.name = name
+        self.body = body
+        self.placement = placement
+
+
+class Tree:
+
+    def __init__(self, path):
+        root = ET.parse(path).getroot()
+
+        self.links = {link.get("name"): link for link in root.findall("link")}
+        self.children = {name: [] for name in self.links}
+        children = set()
+
+        for joint in root.findall("joint"):
+            parent = joint.find("parent").get("link")
+            child = joint.find("child").get("link")
+            self.children[parent].append(joint)
+            children.add(child)
+
+        roots = [name for name in self.links if name not in children]
+        if len(roots) != 1:
+            sys.exit(f"expected a single root link, found {roots}")
+
+        self.bodies = []
+        self.frames = []
+
+        self.frames.append(Frame(roots[0], -1, Transform()))
+        self.visit(roots[0], -1, Transform())
+
+    def visit(self, link, body, transform):
+        for joint in self.children[link]:
+            name = joint.get("name")
+            kind = joint.get("type")
+            child = joint.find("child").get("link")
+            placement = transform * parse_origin(joint)
+
+            if kind == "fixed":
+                self.add_inertia(body, child, placement)
+                self.frames.append(Frame(name, body, placement))
+                self.frames.append(Frame(child, body, placement))
+                self.visit(child, body, placement)
+                continue
+
+            if kind not in ("revolute", "prismatic"):
+                sys.exit(f"joint {name} has unsupported type {kind}")
+
+            axis = parse_vector(joint.find("axis").get("xyz") if joint.find("axis") is not None else None, [1.0, 0.0, 0.0])
+            norm = math.sqrt(sum(x * x for x in axis))
+            axis = [x / norm for x in axis]
+
+            moved = Body(len(self.bodies), name, body, placement, kind, axis)
+            self.bodies.append(moved)
+            self.add_inertia(moved.index, child, Transform())
+            self.frames.append(Frame(name, moved.index, Transform()))
+            self.frames.append(Frame(child, moved.index, Transform()))
+            self.visit(child, moved.index, Transform())
+
+    def add_inertia(self, body, link, transform):
+        # Inertia fixed to the world does not affect the dynamics.
+        if body < 0:
+            return
+        inertia = parse_inertial(self.links[link]).transformed(transform)
+        self.bodies[body].inertia = self.bodies[body].inertia + inertia
+
+    def support(self, body):
+        """The bodies from the root to a body."""
+        chain = []
+        while body >= 0:
+            chain.append(body)
+            body = self.bodies[body].parent
+        return list(reversed(chain))
+
+
+def number(x):
+    if x == 0.0:
+        return "0.0"
+    return repr(float(x))
+
+
+def matrix3(m):
+    values = ", ".join(number(m[i][j]) for i in range(3) for j in range(3))
+    return f"(Matrix3d() << {values}).finished()"
+
+
+def vector3(v):
+    return f"Vector3d({', '.join(number(x) for x in v)})"
+
+
+def subspace(body):
+    """
+    The index and sign of the motion subspace if the axis is aligned, or None.
+    The subspace is in (linear, angular) order.
+    """
+    offset = 0 if body.kind == "prismatic" else 3
+    for i in range(3):
+        if abs(abs(body.axis[i]) - 1.0) < 1e-12:
+            return offset + i, (1.0 if body.axis[i] > 0 else -1.0)
+    return None
+
+
+class Emitter:
+
+    def __init__(self, tree, name, source):
+        self.tree = tree
+        self.name = name
+        self.source = source
+        self.dof = len(tree.bodies)
+
+    def header(self):
+        tree = self.tree
+        names = ",\n".join(f'    "{frame.name}"' for frame in tree.frames)
+        return f"""// Generated by scripts/generate_dynamics.py from {self.source}. Do not edit,
+// regenerate with the generate_dynamics target when the model changes.
+
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include "controller/eigen.hpp"
+
+/**
+ * @brief A fixed size dynamics kernel for the kinematic tree of
+ * {self.source}.
+ *
+ * Spatial quantities are in (linear, angular) order. Body quantities are
+ * expressed in the body frame, and world quantities at the world origin, as in
+ * pinocchio.
+ */
+namespace FrankaRidgeback::Kernel {{
+
+using Matrix3d = Eigen::Matrix3d;
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+/// The degrees of freedom of the tree, one per body.
+inline constexpr int DOF = {self.dof};
+
+/// The number of frames, one for each joint and link.
+inline constexpr int FRAMES = {len(tree.frames)};
+
+/// The name of each frame.
+inline constexpr std::array<std::string_view, FRAMES> FRAME_NAMES {{{{
+{names}
+}}}};
+
+/// The jacobian of a frame in the world.
+using Jacobian = Eigen::Matrix<double, 6, DOF>;
+
+/**
+ * @brief The quantities of each body computed by the kernel functions.
+ */
+struct Data {{
+
+    /// The rotation of each body relative to its parent.
+    std::array<Matrix3d, DOF> parent_rotation;
+
+    /// The translation of each body relative to its parent.
+    std::array<Vector3d, DOF> parent_translation;
+
+    /// The rotation of each body in the world.
+    std::array<Matrix3d, DOF> rotation;
+
+    /// The translation of each body in the world.
+    std::array<Vector3d, DOF> translation;
+
+    /// The spatial velocity of each body.
+    std::array<Vector6d, DOF> velocity;
+
+    /// The spatial acceleration of each body.
+    std::array<Vector6d, DOF> acceleration;
+
+    /// The velocity product acceleration of each body.
+    std::array<Vector6d, DOF> bias;
+
+    /// The articulated inertia of each body.
+    std::array<Matrix6d, DOF> inertia;
+
+    /// The articulated bias force, or the force transmitted by each joint.
+    std::array<Vector6d, DOF> force;
+
+    /// The articulated inertia along each joint subspace.
+    std::array<Vector6d, DOF> u_inertia;
+
+    /// The joint space articulated inertia of each joint.
+    std::array<double, DOF> d_inertia;
+
+    /// The joint force not yet balanced by each body.
+    std::array<double, DOF> u_force;
+}};
+
+/**
+ * @brief Find a frame by name.
+ * @param name The name of the frame.
+ * @returns The index of the frame, or -1 if there is no such frame.
+ */
+inline int find_frame(std::string_view name)
+{{
+    for (int frame = 0; frame < FRAMES; ++frame) {{
+        if (FRAME_NAMES[frame] == name)
+            return frame;
+    }}
+    return -1;
+}}
+
+/**
+ * @brief Compute the placement of each body.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ */
+void placements(Data &data, const Eigen::Ref<const VectorXd> &position);
+
+/**
+ * @brief Compute the placement, velocity and acceleration of each body,
+ * without gravity.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param acceleration The joint accelerations.
+ */
+void forward_kinematics(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &acceleration
+);
+
+/**
+ * @brief Compute the joint forces for the joint accelerations with the
+ * recursive newton euler algorithm.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param acceleration The joint accelerations.
+ * @param force The joint forces to set.
+ */
+void rnea(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &acceleration,
+    Eigen::Ref<VectorXd> force
+);
+
+/**
+ * @brief Compute the joint forces of gravity and the velocity product terms
+ * with the recursive newton euler algorithm.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param force The joint forces to set.
+ */
+void non_linear_effects(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    Eigen::Ref<VectorXd> force
+);
+
+/**
+ * @brief Compute the joint accelerations from the joint forces with the
+ * articulated body algorithm.
+ *
+ * @param data The data to update. The body accelerations include gravity.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param force The joint forces.
+ * @param acceleration The joint accelerations to set.
+ */
+void aba(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &force,
+    Eigen::Ref<VectorXd> acceleration
+);
+
+/**
+ * @brief Get the placement of a frame in the world, after the body
+ * placements are computed.
+ *
+ * @param data The kernel data.
+ * @param frame The index of the frame.
+ * @param rotation The rotation of the frame to set.
+ * @param translation The translation of the frame to set.
+ */
+void frame_placement(const Data &data, int frame, Matrix3d &rotation, Vector3d &translation);
+
+/**
+ * @brief Get the spatial velocity of a frame in the world, after the forward
+ * kinematics are computed.
+ */
+Vector6d frame_velocity(const Data &data, int frame);
+
+/**
+ * @brief Get the spatial acceleration of a frame in the world, after the
+ * forward kinematics are computed.
+ */
+Vector6d frame_acceleration(const Data &data, int frame);
+
+/**
+ * @brief Get the jacobian of a frame in the world, after the body placements
+ * are computed.
+ *
+ * @param data The kernel data.
+ * @param frame The index of the frame.
+ * @param jacobian The jacobian to set.
+ */
+void frame_jacobian(const Data &data, int frame, Jacobian &jacobian);
+
+}} // namespace FrankaRidgeback::Kernel
+"""
+
+    def constants(self):
+        lines = []
+        for body in self.tree.bodies:
+            lines.append(f"// {body.name}, {body.kind} about ({', '.join(number(x) for x in body.axis)}).")
+            if not Transform(body.placement.rotation).is_identity():
+                lines.append(f"static const Matrix3d PLACEMENT_ROTATION_{body.index} = {matrix3(body.placement.rotation)};")
+            lines.append(f"static const Vector3d PLACEMENT_TRANSLATION_{body.index} = {vector3(body.placement.translation)};")
+            inertia = body.inertia.spatial()
+            values = ",\n    ".join(", ".join(number(inertia[i][j]) for j in range(6)) for i in range(6))
+            lines.append(f"static const Matrix6d INERTIA_{body.index} = (Matrix6d() <<\n    {values}\n).finished();")
+            if subspace(body) is None:
+                s = [0.0] * 6
+                offset = 0 if body.kind == "prismatic" else 3
+                for i in range(3):
+                    s[offset + i] = body.axis[i]
+                lines.append(f"static const Vector6d SUBSPACE_{body.index} = (Vector6d() << {', '.join(number(x) for x in s)}).finished();")
+            lines.append("")
+        return "\n".join(lines)
+
+    def joint_rotation(self, body, q):
+        """Code for the rotation of a revolute joint."""
+        aligned = subspace(body)
+        if aligned is None:
+            axis = vector3(body.axis)
+            return f"AngleAxisd({q}, {axis}).toRotationMatrix()"
+
+        index, sign = aligned
+        angle = q if sign > 0 else f"-{q}"
+        return f"rotation_{'xyz'[index - 3]}({angle})"
+
+    def placement(self, body):
+        b = body.index
+        q = f"position[{b}]"
+        rotated = not Transform(body.placement.rotation).is_identity()
+        lines = []
+
+        if body.kind == "revolute":
+            joint = self.joint_rotation(body, q)
+            rotation = f"PLACEMENT_ROTATION_{b} * {joint}" if rotated else joint
+            lines.append(f"data.parent_rotation[{b}] = {rotation};")
+            lines.append(f"data.parent_translation[{b}] = PLACEMENT_TRANSLATION_{b};")
+        else:
+            axis = vector3(body.axis)
+            if rotated:
+                lines.append(f"data.parent_rotation[{b}] = PLACEMENT_ROTATION_{b};")
+                lines.append(
+                    f"data.parent_translation[{b}] = PLACEMENT_TRANSLATION_{b} + PLACEMENT_ROTATION_{b} * ({axis} * {q});"
+                )
+            else:
+                lines.append(f"data.parent_rotation[{b}].setIdentity();")
+                lines.append(f"data.parent_translation[{b}] = PLACEMENT_TRANSLATION_{b} + {axis} * {q};")
+
+        if body.parent < 0:
+            lines.append(f"data.rotation[{b}] = data.parent_rotation[{b}];")
+            lines.append(f"data.translation[{b}] = data.parent_translation[{b}];")
+        else:
+            p = body.parent
+            lines.append(f"data.rotation[{b}] = data.rotation[{p}] * data.parent_rotation[{b}];")
+            lines.append(
+                f"data.translation[{b}] = data.translation[{p}] + data.rotation[{p}] * data.parent_translation[{b}];"
+            )
+        return lines
+
+    def add_subspace(self, body, target, value):
+        """Code adding the joint subspace times a value to a spatial vector."""
+        aligned = subspace(body)
+        if aligned is None:
+            return f"{target} += SUBSPACE_{body.index} * {value};"
+        index, sign = aligned
+        return f"{target}[{index}] {'+' if sign > 0 else '-'}= {value};"
+
+    def project_subspace(self, body, vector):
+        """Code for the transpose of the joint subspace times a spatial vector."""
+        aligned = subspace(body)
+        if aligned is None:
+            return f"SUBSPACE_{body.index}.dot({vector})"
+        index, sign = aligned
+        return f"{vector}[{index}]" if sign > 0 else f"-{vector}[{index}]"
+
+    def parent_motion(self, body, motion, root):
+        """Code for the motion of the parent in the body frame."""
+        b = body.index
+        if body.parent < 0:
+            return f"act_inverse(data.parent_rotation[{b}], data.parent_translation[{b}], {root})"
+        return f"act_inverse(data.parent_rotation[{b}], data.parent_translation[{b}], data.{motion}[{body.parent}])"
+
+    def placements_function(self):
+        lines = ["void placements(Data &data, const Eigen::Ref<const VectorXd> &position)", "{"]
+        for body in self.tree.bodies:
+            lines.append(f"    // {body.name}")
+            lines += ["    " + line for line in self.placement(body)]
+            lines.append("")
+        lines[-1] = "}"
+        return "\n".join(lines)
+
+    def velocity(self, body):
+        b = body.index
+        lines = []
+        if body.parent < 0:
+            lines.append(f"data.velocity[{b}].setZero();")
+        else:
+            lines.append(f"data.velocity[{b}] = {self.parent_motion(body, 'velocity', '')};")
+        lines.append(self.add_subspace(body, f"data.velocity[{b}]", f"velocity[{b}]"))
+        return lines
+
+    def joint_motion(self, body, value):
+        """Code for the joint subspace times a value as a spatial vector."""
+        aligned = subspace(body)
+        if aligned is None:
+            return f"(SUBSPACE_{body.index} * {value}).eval()"
+        index, sign = aligned
+        return f"unit_motion<{index}>({'' if sign > 0 else '-'}{value})"
+
+    def forward_kinematics_function(self):
+        lines = [
+            "void forward_kinematics(",
+            "    Data &data,",
+            "    const Eigen::Ref<const VectorXd> &position,",
+            "    const Eigen::Ref<const VectorXd> &velocity,",
+            "    const Eigen::Ref<const VectorXd> &acceleration",
+            ") {",
+            "    placements(data, position);",
+            "",
+        ]
+        for body in self.tree.bodies:
+            b = body.index
+            lines.append(f"    // {body.name}")
+            lines += ["    " + line for line in self.velocity(body)]
+            if body.parent < 0:
+                lines.append(f"    data.acceleration[{b}].setZero();")
+            else:
+                lines.append(f"    data.acceleration[{b}] = {self.parent_motion(body, 'acceleration', '')};")
+            lines.append(self.add_subspace(body, f"    data.acceleration[{b}]", f"acceleration[{b}]"))
+            lines.append(
+                f"    data.acceleration[{b}] += cross_motion(data.velocity[{b}], {self.joint_motion(body, f'velocity[{b}]')});"
+            )
+            lines.append("")
+        lines[-1] = "}"
+        return "\n".join(lines)
+
+    def rnea_function(self, name, with_acceleration):
+        """
+        The recursive newton euler algorithm, or only the non-linear effects
+        without the joint accelerations.
+        """
+        lines = [
+            f"void {name}(",
+            "    Data &data,",
+            "    const Eigen::Ref<const VectorXd> &position,",
+            "    const Eigen::Ref<const VectorXd> &velocity,",
+        ]
+        if with_acceleration:
+            lines.append("    const Eigen::Ref<const VectorXd> &acceleration,")
+        lines += [
+            "    Eigen::Ref<VectorXd> force",
+            ") {",
+            "    placements(data, position);",
+            "",
+        ]
+        for body in self.tree.bodies:
+            b = body.index
+            lines.append(f"    // {body.name}")
+            lines += ["    " + line for line in self.velocity(body)]
+            lines.append(f"    data.acceleration[{b}] = {self.parent_motion(body, 'acceleration', 'GRAVITY_ACCELERATION')};")
+            if with_acceleration:
+                lines.append(self.add_subspace(body, f"    data.acceleration[{b}]", f"acceleration[{b}]"))
+            lines.append(
+                f"    data.acceleration[{b}] += cross_motion(data.velocity[{b}], {self.joint_motion(body, f'velocity[{b}]')});"
+            )
+            lines.append(
+                f"    data.force[{b}] = INERTIA_{b} * data.acceleration[{b}] + "
+                f"cross_force(data.velocity[{b}], INERTIA_{b} * data.velocity[{b}]);"
+            )
+            lines.append("")
+
+        lines.append("    // Transmit the forces from the leaves to the root.")
+        for body in reversed(self.tree.bodies):
+            b = body.index
+            lines.append(f"    force[{b}] = {self.project_subspace(body, f'data.force[{b}]')};")
+            if body.parent >= 0:
+                lines.append(
+                    f"    data.force[{body.parent}] += "
+                    f"act_force(data.parent_rotation[{b}], data.parent_translation[{b}], data.force[{b}]);"
+                )
+        lines.append("}")
+        return "\n".join(lines)
+
+    def aba_function(self):
+        lines = [
+            "void aba(",
+            "    Data &data,",
+            "    const Eigen::Ref<const VectorXd> &position,",
+            "    const Eigen::Ref<const VectorXd> &velocity,",
+            "    const Eigen::Ref<const VectorXd> &force,",
+            "    Eigen::Ref<VectorXd> acceleration",
+            ") {",
+            "    placements(data, position);",
+            "",
+            "    // Velocities, velocity product accelerations and bias forces from the",
+            "    // root to the leaves.",
+        ]
+        for body in self.tree.bodies:
+            b = body.index
+            lines.append(f"    // {body.name}")
+            lines += ["    " + line for line in self.velocity(body)]
+            lines.append(
+                f"    data.bias[{b}] = cross_motion(data.velocity[{b}], {self.joint_motion(body, f'velocity[{b}]')});"
+            )
+            lines.append(f"    data.inertia[{b}] = INERTIA_{b};")
+            lines.append(f"    data.force[{b}] = cross_force(data.velocity[{b}], INERTIA_{b} * data.velocity[{b}]);")
+            lines.append("")
+
+        lines.append("    // Articulated inertias and bias forces from the leaves to the root.")
+        for body in reversed(self.tree.bodies):
+            b = body.index
+            aligned = subspace(body)
+            lines.append(f"    // {body.name}")
+            if aligned is None:
+                lines.append(f"    data.u_inertia[{b}] = data.inertia[{b}] * SUBSPACE_{b};")
+            else:
+                index, sign = aligned
+                lines.append(f"    data.u_inertia[{b}] = {'' if sign > 0 else '-'}data.inertia[{b}].col({index});")
+            lines.append(f"    data.d_inertia[{b}] = {self.project_subspace(body, f'data.u_inertia[{b}]')};")
+            lines.append(f"    data.u_force[{b}] = force[{b}] - {self.project_subspace(body, f'data.force[{b}]')};")
+            if body.parent >= 0:
+                p = body.parent
+                lines += [
+                    "    {",
+                    f"        Matrix6d inertia = data.inertia[{b}] - "
+                    f"data.u_inertia[{b}] * data.u_inertia[{b}].transpose() / data.d_inertia[{b}];",
+                    f"        Vector6d bias = data.force[{b}] + inertia * data.bias[{b}] + "
+                    f"data.u_inertia[{b}] * (data.u_force[{b}] / data.d_inertia[{b}]);",
+                    f"        data.inertia[{p}] += inertia_to_parent(data.parent_rotation[{b}], data.parent_translation[{b}], inertia);",
+                    f"        data.force[{p}] += act_force(data.parent_rotation[{b}], data.parent_translation[{b}], bias);",
+                    "    }",
+                ]
+            lines.append("")
+
+        lines.append("    // Accelerations from the root to the leaves.")
+        for body in self.tree.bodies:
+            b = body.index
+            lines.append(f"    // {body.name}")
+            lines.append(
+                f"    data.acceleration[{b}] = {self.parent_motion(body, 'acceleration', 'GRAVITY_ACCELERATION')} + data.bias[{b}];"
+            )
+            lines.append(
+                f"    acceleration[{b}] = (data.u_force[{b}] - "
+                f"data.u_inertia[{b}].dot(data.acceleration[{b}])) / data.d_inertia[{b}];"
+            )
+            lines.append(self.add_subspace(body, f"    data.acceleration[{b}]", f"acceleration[{b}]"))
+            lines.append("")
+        lines[-1] = "}"
+        return "\n".join(lines)
+
+    def frame_functions(self):
+        tree = self.tree
+        placement = [
+            "void frame_placement(const Data &data, int frame, Matrix3d &rotation, Vector3d &translation)",
+            "{",
+            "    switch (frame) {",
+        ]
+        velocity = ["Vector6d frame_velocity(const Data &data, int frame)", "{", "    switch (frame) {"]
+        acceleration = ["Vector6d frame_acceleration(const Data &data, int frame)", "{", "    switch (frame) {"]
+        jacobian = [
+            "void frame_jacobian(const Data &data, int frame, Jacobian &jacobian)",
+            "{",
+            "    jacobian.setZero();",
+            "",
+            "    switch (frame) {",
+        ]
+
+        # Group the frames of each body into a single case.
+        groups = {}
+        for index, frame in enumerate(tree.frames):
+            groups.setdefault(frame.body, []).append(index)
+
+        for index, frame in enumerate(tree.frames):
+            b = frame.body
+            case = f"    case {index}: // {frame.name}"
+            placement.append(case)
+            if b < 0:
+                placement.append(f"        rotation = {matrix3(frame.placement.rotation)};")
+                placement.append(f"        translation = {vector3(frame.placement.translation)};")
+            elif frame.placement.is_identity():
+                placement.append(f"        rotation = data.rotation[{b}];")
+                placement.append(f"        translation = data.translation[{b}];")
+            else:
+                placement.append(f"        rotation = data.rotation[{b}] * {matrix3(frame.placement.rotation)};")
+                placement.append(
+                    f"        translation = data.translation[{b}] + data.rotation[{b}] * {vector3(frame.placement.translation)};"
+                )
+            placement.append("        return;")
+
+        for b, frames in sorted(groups.items()):
+            for index in frames:
+                case = f"    case {index}: // {tree.frames[index].name}"
+                velocity.append(case)
+                acceleration.append(case)
+                jacobian.append(case)
+
+            if b < 0:
+                velocity.append("        return Vector6d::Zero();")
+                acceleration.append("        return Vector6d::Zero();")
+                jacobian.append("        return;")
+                continue
+
+            velocity.append(f"        return act(data.rotation[{b}], data.translation[{b}], data.velocity[{b}]);")
+            acceleration.append(
+                f"        return act(data.rotation[{b}], data.translation[{b}], data.acceleration[{b}]);"
+            )
+            for support in tree.support(b):
+                jacobian.append(
+                    f"        jacobian.col({support}) = act(data.rotation[{support}], data.translation[{support}], "
+                    f"{self.joint_motion(tree.bodies[support], '1.0')});"
+                )
+            jacobian.append("        return;")
+
+        for function in (placement, velocity, acceleration, jacobian):
+            function.append("    }")
+            if function is velocity or function is acceleration:
+                function.append("")
+                function.append("    return Vector6d::Zero();")
+            function.append("}")
+
+        return "\n\n".join("\n".join(f) for f in (placement, velocity, acceleration, jacobian))
+
+    def source_file(self):
+        return f"""// Generated by scripts/generate_dynamics.py from {self.source}. Do not edit,
+// regenerate with the generate_dynamics target when the model changes.
+
+#include "frankaridgeback/generated/{self.name}.hpp"
+
+#include <cmath>
+
+namespace FrankaRidgeback::Kernel {{
+
+namespace {{
+
+/// The acceleration of the root that is equivalent to gravity.
+const Vector6d GRAVITY_ACCELERATION = (Vector6d() << 0.0, 0.0, {number(GRAVITY)}, 0.0, 0.0, 0.0).finished();
+
+inline Matrix3d rotation_x(double angle)
+{{
+    double c = std::cos(angle), s = std::sin(angle);
+    return (Matrix3d() << 1.0, 0.0, 0.0, 0.0, c, -s, 0.0, s, c).finished();
+}}
+
+inline Matrix3d rotation_y(double angle)
+{{
+    double c = std::cos(angle), s = std::sin(angle);
+    return (Matrix3d() << c, 0.0, s, 0.0, 1.0, 0.0, -s, 0.0, c).finished();
+}}
+
+inline Matrix3d rotation_z(double angle)
+{{
+    double c = std::cos(angle), s = std::sin(angle);
+    return (Matrix3d() << c, -s, 0.0, s, c, 0.0, 0.0, 0.0, 1.0).finished();
+}}
+
+template<int Index>
+inline Vector6d unit_motion(double value)
+{{
+    Vector6d motion = Vector6d::Zero();
+    motion[Index] = value;
+    return motion;
+}}
+
+/// Transform a motion from a child frame to its parent.
+inline Vector6d act(const Matrix3d &rotation, const Vector3d &translation, const Vector6d &motion)
+{{
+    Vector6d result;
+    result.tail<3>() = rotation * motion.tail<3>();
+    result.head<3>() = rotation * motion.head<3>() + translation.cross(result.tail<3>());
+    return result;
+}}
+
+/// Transform a motion from a parent frame to its child.
+inline Vector6d act_inverse(const Matrix3d &rotation, const Vector3d &translation, const Vector6d &motion)
+{{
+    Vector6d result;
+    result.tail<3>() = rotation.transpose() * motion.tail<3>();
+    result.head<3>() = rotation.transpose() * (motion.head<3>() - translation.cross(motion.tail<3>()));
+    return result;
+}}
+
+/// Transform a force from a child frame to its parent.
+inline Vector6d act_force(const Matrix3d &rotation, const Vector3d &translation, const Vector6d &force)
+{{
+    Vector6d result;
+    result.head<3>() = rotation * force.head<3>();
+    result.tail<3>() = rotation * force.tail<3>() + translation.cross(result.head<3>());
+    return result;
+}}
+
+/// The spatial cross product of a velocity and a motion.
+inline Vector6d cross_motion(const Vector6d &velocity, const Vector6d &motion)
+{{
+    Vector6d result;
+    result.head<3>() = velocity.tail<3>().cross(motion.head<3>()) + velocity.head<3>().cross(motion.tail<3>());
+    result.tail<3>() = velocity.tail<3>().cross(motion.tail<3>());
+    return result;
+}}
+
+/// The spatial cross product of a velocity and a force.
+inline Vector6d cross_force(const Vector6d &velocity, const Vector6d &force)
+{{
+    Vector6d result;
+    result.head<3>() = velocity.tail<3>().cross(force.head<3>());
+    result.tail<3>() = velocity.tail<3>().cross(force.tail<3>()) + velocity.head<3>().cross(force.head<3>());
+    return result;
+}}
+
+/// Transform a spatial inertia from a child frame to its parent.
+inline Matrix6d inertia_to_parent(const Matrix3d &rotation, const Vector3d &translation, const Matrix6d &inertia)
+{{
+    Matrix3d skew;
+    skew << 0.0, -translation.z(), translation.y(),
+            translation.z(), 0.0, -translation.x(),
+            -translation.y(), translation.x(), 0.0;
+
+    // The motion transform from the parent to the child.
+    Matrix6d inverse = Matrix6d::Zero();
+    inverse.topLeftCorner<3, 3>() = rotation.transpose();
+    inverse.topRightCorner<3, 3>() = -rotation.transpose() * skew;
+    inverse.bottomRightCorner<3, 3>() = rotation.transpose();
+
+    return inverse.transpose() * inertia * inverse;
+}}
+
+{self.constants()}
+}} // namespace
+
+{self.placements_function()}
+
+{self.forward_kinematics_function()}
+
+{self.rnea_function("rnea", True)}
+
+{self.rnea_function("non_linear_effects", False)}
+
+{self.aba_function()}
+
+{self.frame_functions()}
+
+}} // namespace FrankaRidgeback::Kernel
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip())
+    parser.add_argument("--urdf", required=True, help="The URDF robot definition.")
+    parser.add_argument("--output", required=True, help="The directory to write the kernel to.")
+    parser.add_argument("--name", default="robot_kernel", help="The file name of the kernel.")
+    arguments = parser.parse_args()
+
+    tree = Tree(arguments.urdf)
+    emitter = Emitter(tree, arguments.name, os.path.basename(arguments.urdf))
+
+    os.makedirs(arguments.output, exist_ok=True)
+
+    with open(os.path.join(arguments.output, arguments.name + ".hpp"), "w", newline="\n") as file:
+        file.write(emitter.header())
+
+    with open(os.path.join(arguments.output, arguments.name + ".cpp"), "w", newline="\n") as file:
+        file.write(emitter.source_file())
+
+    print(f"generated {len(tree.bodies)} bodies and {len(tree.frames)} frames")
+
+
+if __name__ == "__main__":
+    main()
@@ -15,5 +15,6 @@ mkdir -p build
 cmake \
     -DCMAKE_PREFIX_PATH=$CMAKE_PREFIX_PATH \
     -DCMAKE_FIND_USE_CMAKE_ENVIRONMENT_PATH=y \
+    -DCMAKE_BUILD_TYPE=Debug \
     -B build \
     -S src
@@ -0,0 +1,36 @@
+#!/bin/bash
+# Profile guided optimisation build.
+#
+# Builds an instrumented binary, runs a representative test to collect
+# profiles, then rebuilds using the profiles.
+#
+# usage: ./scripts/linux/pgo.bash [test name]
+
+set -e
+
+WORKSPACE=$(pwd)
+TEST=${1:-reach}
+
+# Add library directories to cmake path.
+CMAKE_PREFIX_PATH+=";$WORKSPACE/lib/raisimlib/raisim/linux"
+export CMAKE_PREFIX_PATH
+
+# Add raisim linker directories to path.
+export LD_LIBRARY_PATH=$LD_LIBRARY_PATH:$WORKSPACE/raisim/linux/lib
+
+# Discard stale profiles from a previous build.
+rm -rf build/pgo-data build/pgo-output
+
+# Presets are read from the current directory.
+cd src
+
+cmake --preset pgo-generate
+cmake --build --preset pgo-generate
+
+# Run from the folder containing the robot model.
+(cd frankaridgeback && $WORKSPACE/build/pgo/bin/test --test $TEST --out $WORKSPACE/build/pgo-output)
+
+cmake --preset pgo-use
+cmake --build --preset pgo-use
+
+echo "optimised binary at build/pgo/bin/test"
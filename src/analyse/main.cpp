@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "analyse/summary.hpp"
+#include "logging/file.hpp"
+
+/**
+ * @brief Summarise the logs of a test run, or of each run in a folder.
+ *
+ * A single run is summarised into summary.json, trend.csv and summary.csv in
+ * its folder. Each run of multiple runs is summarised into its own folder,
+ * and the folder of the runs gets a summary.json of every run and a
+ * summary.csv with a row per run.
+ */
+int main(int argc, char **argv)
+{
+    bool valid = (
+        (argc == 3 || (argc == 5 && std::string(argv[3]) == "--threads")) &&
+        (std::string(argv[1]) == "single" || std::string(argv[1]) == "multi")
+    );
+
+    if (!valid) {
+        std::cerr << "usage: " << argv[0] << " <single | multi> <path> [--threads <count>]" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path path = argv[2];
+    bool multiple = std::string(argv[1]) == "multi";
+
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc == 5) {
+        try {
+            threads = (unsigned int)std::stoul(argv[4]);
+        }
+        catch (const std::exception &) {
+            std::cerr << "invalid thread count " << argv[4] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!std::filesystem::is_directory(path)) {
+        std::cerr << "results folder " << path << " does not exist" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> runs;
+    if (multiple) {
+        for (const auto &entry : std::filesystem::directory_iterator(path)) {
+            if (entry.is_directory())
+                runs.push_back(entry.path());
+        }
+        std::sort(runs.begin(), runs.end());
+    }
+    else {
+        runs.push_back(path);
+    }
+
+    std::cout << "analysing " << runs.size() << " runs of " << path << std::endl;
+
+    auto summaries = analyse::summarise(runs, threads);
+
+    bool written = true;
+    for (std::size_t i = 0; i < runs.size(); ++i)
+        written &= analyse::write_run(summaries[i], runs[i]);
+
+    if (multiple) {
+        json statistics = json::object();
+        for (const auto &summary : summaries)
+            statistics[summary.name] = summary.statistics;
+
+        auto file = logger::File::create(path / "summary.json");
+        if (file)
+            file->get_stream() << statistics.dump(4);
+        written &= (bool)file;
+    }
+
+    written &= analyse::write_table(summaries, path);
+    return written ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include "analyse/reader.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace analyse {
+
+namespace {
+
+/**
+ * @brief Remove the surrounding whitespace of a field.
+ */
+std::string_view trim(std::string_view field)
+{
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+        field.remove_prefix(1);
+
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t' || field.back() == '\r'))
+        field.remove_suffix(1);
+
+    return field;
+}
+
+/**
+ * @brief Call a function with each comma separated field of a line.
+ */
+template<typename Function>
+void split(std::string_view line, Function &&function)
+{
+    while (true) {
+        std::size_t comma = line.find(',');
+        function(trim(line.substr(0, comma)));
+
+        if (comma == std::string_view::npos)
+            return;
+
+        line.remove_prefix(comma + 1);
+    }
+}
+
+} // namespace
+
+std::unique_ptr<Reader> Reader::create(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "failed to open log " << path << std::endl;
+        return nullptr;
+    }
+
+    auto reader = std::unique_ptr<Reader>(new Reader(std::move(file)));
+
+    std::string_view line;
+    if (!reader->read_line(line)) {
+        std::cerr << "log " << path << " has no header" << std::endl;
+        return nullptr;
+    }
+
+    split(line, [&](std::string_view field) {
+        reader->m_header.emplace_back(field);
+    });
+
+    reader->m_row.reserve(reader->m_header.size());
+    return reader;
+}
+
+Reader::Reader(std::ifstream &&file)
+    : m_file(std::move(file))
+    , m_buffer(CHUNK_SIZE)
+    , m_begin(0)
+    , m_end(0)
+{}
+
+int Reader::find(std::string_view name) const
+{
+    auto it = std::find(m_header.begin(), m_header.end(), name);
+    return it == m_header.end() ? -1 : (int)(it - m_header.begin());
+}
+
+std::span<const double> Reader::next()
+{
+    std::string_view line;
+
+    // Skip blank lines.
+    do {
+        if (!read_line(line))
+            return {};
+    } while (trim(line).empty());
+
+    m_row.clear();
+    split(line, [&](std::string_view field) {
+        double value = NAN;
+
+        // std::from_chars does not accept a leading plus.
+        if (!field.empty() && field.front() == '+')
+            field.remove_prefix(1);
+
+        auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+        if (result.ec != std::errc() || result.ptr != field.data() + field.size())
+            value = NAN;
+
+        m_row.push_back(value);
+    });
+
+    return m_row;
+}
+
+bool Reader::read_line(std::string_view &line)
+{
+    std::size_t searched = m_begin;
+
+    while (true) {
+        char *begin = m_buffer.data() + m_begin;
+        char *newline = (char *)std::memchr(
+            m_buffer.data() + searched, '\n', m_end - searched
+        );
+
+        if (newline) {
+            line = std::string_view(begin, newline - begin);
+            m_begin = newline - m_buffer.data() + 1;
+            return true;
+        }
+
+        // The last line may not end with a newline.
+        if (!m_file) {
+            if (m_begin == m_end)
+                return false;
+
+            line = std::string_view(begin, m_end - m_begin);
+            m_begin = m_end;
+            return true;
+        }
+
+        // Move the partial line to the front, growing the buffer for lines
+        // longer than a chunk.
+        std::size_t partial = m_end - m_begin;
+        std::memmove(m_buffer.data(), begin, partial);
+        m_begin = 0;
+        m_end = partial;
+        searched = partial;
+
+        if (m_buffer.size() - m_end < CHUNK_SIZE / 2)
+            m_buffer.resize(m_buffer.size() * 2);
+
+        m_file.read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+        m_end += m_file.gcount();
+    }
+}
+
+} // namespace analyse
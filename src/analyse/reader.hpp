@@ -0,0 +1,85 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace analyse {
+
+/**
+ * @brief Reads the rows of a CSV log one at a time.
+ *
+ * The file is read in chunks, so memory is bounded by the chunk and the
+ * longest row regardless of the file size. Values are parsed with
+ * std::from_chars. Fields that are not numbers are read as NaN.
+ */
+class Reader
+{
+public:
+
+    /// The number of bytes read from the file at once.
+    static constexpr std::size_t CHUNK_SIZE = 1 << 20;
+
+    /**
+     * @brief Open a CSV log and read its header.
+     *
+     * @param path The path of the log.
+     * @returns A pointer to the reader on success or nullptr on failure.
+     */
+    static std::unique_ptr<Reader> create(const std::filesystem::path &path);
+
+    /**
+     * @brief Get the column names of the header.
+     */
+    inline const std::vector<std::string> &get_header() const {
+        return m_header;
+    }
+
+    /**
+     * @brief Get the index of a column.
+     *
+     * @param name The name of the column.
+     * @returns The index of the column, or -1 if there is no such column.
+     */
+    int find(std::string_view name) const;
+
+    /**
+     * @brief Read the next row.
+     * @returns The values of the row, or an empty span at the end of the file.
+     */
+    std::span<const double> next();
+
+private:
+
+    Reader(std::ifstream &&file);
+
+    /**
+     * @brief Get the next line of the file.
+     * @returns If there was another line.
+     */
+    bool read_line(std::string_view &line);
+
+    /// The file being read.
+    std::ifstream m_file;
+
+    /// The chunk of the file being read.
+    std::vector<char> m_buffer;
+
+    /// The start of the unread part of the chunk.
+    std::size_t m_begin;
+
+    /// The end of the chunk.
+    std::size_t m_end;
+
+    /// The column names of the header.
+    std::vector<std::string> m_header;
+
+    /// The values of the last row.
+    std::vector<double> m_row;
+};
+
+} // namespace analyse
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace analyse {
+
+/**
+ * @brief The running count, mean, variance and range of a sequence, using
+ * Welford's algorithm.
+ */
+class Moments
+{
+public:
+
+    inline void add(double value)
+    {
+        ++m_count;
+        double delta = value - m_mean;
+        m_mean += delta / (double)m_count;
+        m_m2 += delta * (value - m_mean);
+        m_minimum = std::min(m_minimum, value);
+        m_maximum = std::max(m_maximum, value);
+    }
+
+    inline std::int64_t get_count() const {
+        return m_count;
+    }
+
+    inline double get_mean() const {
+        return m_count > 0 ? m_mean : NAN;
+    }
+
+    /**
+     * @brief Get the sample standard deviation.
+     */
+    inline double get_deviation() const {
+        return m_count > 1 ? std::sqrt(m_m2 / (double)(m_count - 1)) : NAN;
+    }
+
+    inline double get_minimum() const {
+        return m_count > 0 ? m_minimum : NAN;
+    }
+
+    inline double get_maximum() const {
+        return m_count > 0 ? m_maximum : NAN;
+    }
+
+private:
+
+    std::int64_t m_count = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+    double m_minimum = std::numeric_limits<double>::infinity();
+    double m_maximum = -std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Estimates a quantile of a sequence in constant memory with the P²
+ * algorithm of Jain and Chlamtac.
+ *
+ * Five markers track the minimum, the maximum, the quantile and the
+ * quantiles half way to either side. The markers are adjusted towards their
+ * desired positions with a piecewise parabolic prediction as values arrive.
+ */
+class Quantile
+{
+public:
+
+    /**
+     * @brief Create a quantile estimator.
+     * @param quantile The quantile to estimate, between 0 and 1.
+     */
+    inline Quantile(double quantile)
+        : m_quantile(quantile)
+        , m_increments {0.0, quantile / 2.0, quantile, (1.0 + quantile) / 2.0, 1.0}
+    {}
+
+    inline void add(double value)
+    {
+        // Collect the first values exactly.
+        if (m_count < 5) {
+            m_heights[m_count++] = value;
+
+            if (m_count == 5) {
+                std::sort(m_heights.begin(), m_heights.end());
+                for (int i = 0; i < 5; ++i) {
+                    m_positions[i] = i + 1;
+                    m_desired[i] = 1.0 + 4.0 * m_increments[i];
+                }
+            }
+            return;
+        }
+
+        ++m_count;
+
+        // Find the cell of the value, extending the extremes.
+        int cell;
+        if (value < m_heights[0]) {
+            m_heights[0] = value;
+            cell = 0;
+        }
+        else if (value >= m_heights[4]) {
+            m_heights[4] = value;
+            cell = 3;
+        }
+        else {
+            cell = 0;
+            while (value >= m_heights[cell + 1])
+                ++cell;
+        }
+
+        for (int i = cell + 1; i < 5; ++i)
+            ++m_positions[i];
+
+        for (int i = 0; i < 5; ++i)
+            m_desired[i] += m_increments[i];
+
+        // Adjust the heights of the middle markers.
+        for (int i = 1; i < 4; ++i) {
+            double offset = m_desired[i] - m_positions[i];
+
+            bool right = offset >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0;
+            bool left = offset <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0;
+            if (!right && !left)
+                continue;
+
+            double direction = right ? 1.0 : -1.0;
+            double height = parabolic(i, direction);
+
+            if (!(m_heights[i - 1] < height && height < m_heights[i + 1]))
+                height = linear(i, direction);
+
+            m_heights[i] = height;
+            m_positions[i] += direction;
+        }
+    }
+
+    /**
+     * @brief Get the estimated quantile, or NaN if no values were added.
+     */
+    inline double get() const
+    {
+        if (m_count == 0)
+            return NAN;
+
+        if (m_count >= 5)
+            return m_heights[2];
+
+        // Interpolate the exact quantile of the first values.
+        std::array<double, 5> sorted = m_heights;
+        for (std::int64_t i = 1; i < m_count; ++i) {
+            for (std::int64_t j = i; j > 0 && sorted[j] < sorted[j - 1]; --j)
+                std::swap(sorted[j], sorted[j - 1]);
+        }
+
+        double position = m_quantile * (double)(m_count - 1);
+        std::int64_t index = (std::int64_t)position;
+        if (index + 1 >= m_count)
+            return sorted[m_count - 1];
+
+        double fraction = position - (double)index;
+        return sorted[index] + fraction * (sorted[index + 1] - sorted[index]);
+    }
+
+private:
+
+    inline double parabolic(int i, double direction) const
+    {
+        const auto &n = m_positions;
+        const auto &q = m_heights;
+
+        return q[i] + direction / (n[i + 1] - n[i - 1]) * (
+            (n[i] - n[i - 1] + direction) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+            (n[i + 1] - n[i] - direction) * (q[i] - q[i - 1]) / (n[i] - n[i - 1])
+        );
+    }
+
+    inline double linear(int i, double direction) const
+    {
+        int j = i + (int)direction;
+        return m_heights[i] + direction * (m_heights[j] - m_heights[i]) / (m_positions[j] - m_positions[i]);
+    }
+
+    /// The estimated quantile.
+    double m_quantile;
+
+    /// The increment of the desired position of each marker per value.
+    std::array<double, 5> m_increments;
+
+    /// The height of each marker.
+    std::array<double, 5> m_heights {};
+
+    /// The position of each marker.
+    std::array<double, 5> m_positions {};
+
+    /// The desired position of each marker.
+    std::array<double, 5> m_desired {};
+
+    /// The number of values added.
+    std::int64_t m_count = 0;
+};
+
+/**
+ * @brief The least squares slope of a sequence over time.
+ */
+class Trend
+{
+public:
+
+    inline void add(double time, double value)
+    {
+        ++m_count;
+        double delta = time - m_time;
+        m_time += delta / (double)m_count;
+        m_value += (value - m_value) / (double)m_count;
+        m_time_variance += delta * (time - m_time);
+        m_covariance += delta * (value - m_value);
+
+        if (m_count == 1)
+            m_first = value;
+        m_last = value;
+    }
+
+    /**
+     * @brief Get the change in value per unit time.
+     */
+    inline double get_slope() const {
+        return m_time_variance > 0.0 ? m_covariance / m_time_variance : NAN;
+    }
+
+    inline double get_first() const {
+        return m_count > 0 ? m_first : NAN;
+    }
+
+    inline double get_last() const {
+        return m_count > 0 ? m_last : NAN;
+    }
+
+private:
+
+    std::int64_t m_count = 0;
+    double m_time = 0.0;
+    double m_value = 0.0;
+    double m_time_variance = 0.0;
+    double m_covariance = 0.0;
+    double m_first = NAN;
+    double m_last = NAN;
+};
+
+/**
+ * @brief Downsamples a time series into a bounded number of bins.
+ *
+ * Each bin aggregates the same number of consecutive values. Once every bin
+ * is used, adjacent bins are merged and the values per bin doubles, so the
+ * series spans between half and all of the bins however long it is.
+ */
+class Series
+{
+public:
+
+    /**
+     * @brief A bin of consecutive values.
+     */
+    struct Bin {
+
+        /// The mean time of the values.
+        double time = 0.0;
+
+        /// The mean of the values.
+        double mean = 0.0;
+
+        double minimum = std::numeric_limits<double>::infinity();
+
+        double maximum = -std::numeric_limits<double>::infinity();
+
+        /// The number of values.
+        std::int64_t count = 0;
+    };
+
+    /**
+     * @brief Create a series.
+     * @param bins The maximum number of bins.
+     */
+    inline Series(std::size_t bins = 200)
+        : m_capacity(std::max<std::size_t>(bins, 2) & ~(std::size_t)1)
+        , m_values_per_bin(1)
+    {
+        m_bins.reserve(m_capacity);
+    }
+
+    inline void add(double time, double value)
+    {
+        if (m_bins.empty() || m_bins.back().count == m_values_per_bin) {
+            if (m_bins.size() == m_capacity)
+                merge();
+            m_bins.emplace_back();
+        }
+
+        Bin &bin = m_bins.back();
+        ++bin.count;
+        bin.time += (time - bin.time) / (double)bin.count;
+        bin.mean += (value - bin.mean) / (double)bin.count;
+        bin.minimum = std::min(bin.minimum, value);
+        bin.maximum = std::max(bin.maximum, value);
+    }
+
+    inline const std::vector<Bin> &get_bins() const {
+        return m_bins;
+    }
+
+private:
+
+    /**
+     * @brief Merge adjacent bins, halving the number of bins.
+     */
+    inline void merge()
+    {
+        for (std::size_t i = 0; i < m_bins.size() / 2; ++i) {
+            const Bin &first = m_bins[2 * i];
+            const Bin &second = m_bins[2 * i + 1];
+
+            std::int64_t count = first.count + second.count;
+            double weight = (double)second.count / (double)count;
+
+            m_bins[i] = Bin {
+                .time = first.time + weight * (second.time - first.time),
+                .mean = first.mean + weight * (second.mean - first.mean),
+                .minimum = std::min(first.minimum, second.minimum),
+                .maximum = std::max(first.maximum, second.maximum),
+                .count = count
+            };
+        }
+
+        m_bins.resize(m_bins.size() / 2);
+        m_values_per_bin *= 2;
+    }
+
+    /// The maximum number of bins. Even, so bins merge in pairs.
+    std::size_t m_capacity;
+
+    /// The number of values aggregated by each bin.
+    std::int64_t m_values_per_bin;
+
+    /// The bins.
+    std::vector<Bin> m_bins;
+};
+
+} // namespace analyse
@@ -0,0 +1,549 @@
+#include "analyse/summary.hpp"
+
+#include <cmath>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <optional>
+
+#include "analyse/reader.hpp"
+#include "controller/concurrency.hpp"
+#include "logging/csv.hpp"
+#include "logging/file.hpp"
+
+namespace analyse {
+
+namespace {
+
+/**
+ * @brief The summary of a single log.
+ */
+struct Section {
+
+    /// The summary statistics of the log.
+    json statistics = json::object();
+
+    /// The downsampled series of the statistics over time, by name.
+    std::vector<std::pair<std::string, Series>> series;
+};
+
+/**
+ * @brief A log summarised from each run.
+ */
+struct Log {
+
+    /// The name of the section of the summary.
+    const char *section;
+
+    /// The path of the log relative to the run folder.
+    const char *path;
+
+    /// Summarises the rows of the log.
+    std::function<bool(Reader &reader, Section &section)> analyse;
+};
+
+/**
+ * @brief Get a value of a row, or NaN if the row has no such column.
+ */
+inline double at(std::span<const double> row, int column)
+{
+    return column >= 0 && column < (int)row.size() ? row[column] : NAN;
+}
+
+/**
+ * @brief Describe the moments of a sequence.
+ */
+json describe(const Moments &moments)
+{
+    return {
+        {"count", moments.get_count()},
+        {"mean", moments.get_mean()},
+        {"deviation", moments.get_deviation()},
+        {"minimum", moments.get_minimum()},
+        {"maximum", moments.get_maximum()}
+    };
+}
+
+/**
+ * @brief Describe the moments and quantiles of a sequence.
+ */
+json describe(const Moments &moments, const std::vector<std::pair<const char *, Quantile>> &quantiles)
+{
+    json description = describe(moments);
+    for (const auto &[name, quantile] : quantiles)
+        description[name] = quantile.get();
+    return description;
+}
+
+/**
+ * @brief Summarise the duration of each update and its phases, and the
+ * effective sample size and cost scale if logged.
+ */
+bool analyse_update(Reader &reader, Section &section)
+{
+    static constexpr const char *PHASES[] = {
+        "sample_duration", "rollout_duration", "optimise_duration", "filter_duration"
+    };
+
+    int time = reader.find("time");
+    int duration = reader.find("update_duration");
+
+    if (time < 0 || duration < 0) {
+        std::cerr << "update log has no time or update_duration column" << std::endl;
+        return false;
+    }
+
+    int ess = reader.find("effective_sample_size");
+    int cost_scale = reader.find("cost_scale");
+
+    std::array<int, std::size(PHASES)> phase_columns;
+    for (std::size_t i = 0; i < std::size(PHASES); ++i)
+        phase_columns[i] = reader.find(PHASES[i]);
+
+    Moments moments, ess_moments, cost_scale_moments;
+    std::array<Moments, std::size(PHASES)> phases;
+    std::vector<std::pair<const char *, Quantile>> quantiles {
+        {"p50", Quantile(0.5)}, {"p90", Quantile(0.9)}, {"p99", Quantile(0.99)}
+    };
+    Series series, ess_series, cost_scale_series;
+
+    for (auto row = reader.next(); !row.empty(); row = reader.next()) {
+        double t = at(row, time);
+
+        // Logged by the update logger since the cost scale is adapted.
+        if (std::isfinite(at(row, ess))) {
+            ess_moments.add(at(row, ess));
+            ess_series.add(t, at(row, ess));
+        }
+
+        if (std::isfinite(at(row, cost_scale))) {
+            cost_scale_moments.add(at(row, cost_scale));
+            cost_scale_series.add(t, at(row, cost_scale));
+        }
+
+        double value = at(row, duration);
+        if (!std::isfinite(value))
+            continue;
+
+        moments.add(value);
+        for (auto &[name, quantile] : quantiles)
+            quantile.add(value);
+        series.add(t, value);
+
+        for (std::size_t i = 0; i < phases.size(); ++i) {
+            double phase = at(row, phase_columns[i]);
+            if (std::isfinite(phase))
+                phases[i].add(phase);
+        }
+    }
+
+    section.statistics["updates"] = moments.get_count();
+    section.statistics["update_duration"] = describe(moments, quantiles);
+    for (std::size_t i = 0; i < phases.size(); ++i)
+        section.statistics["phases"][PHASES[i]] = phases[i].get_mean();
+
+    section.series.emplace_back("update_duration", std::move(series));
+
+    if (ess >= 0) {
+        section.statistics["effective_sample_size"] = describe(ess_moments);
+        section.series.emplace_back("update_effective_sample_size", std::move(ess_series));
+    }
+
+    if (cost_scale >= 0) {
+        section.statistics["cost_scale"] = describe(cost_scale_moments);
+        section.series.emplace_back("cost_scale", std::move(cost_scale_series));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Summarise the cost of the optimal rollout over time.
+ */
+bool analyse_optimal_cost(Reader &reader, Section &section)
+{
+    int time = reader.find("time");
+    int cost = reader.find("cost");
+
+    if (time < 0 || cost < 0) {
+        std::cerr << "optimal cost log has no time or cost column" << std::endl;
+        return false;
+    }
+
+    Moments moments;
+    Trend trend;
+    Series series;
+
+    for (auto row = reader.next(); !row.empty(); row = reader.next()) {
+        double value = at(row, cost);
+        if (!std::isfinite(value))
+            continue;
+
+        moments.add(value);
+        trend.add(at(row, time), value);
+        series.add(at(row, time), value);
+    }
+
+    section.statistics = describe(moments);
+    section.statistics["first"] = trend.get_first();
+    section.statistics["last"] = trend.get_last();
+    section.statistics["slope"] = trend.get_slope();
+
+    section.series.emplace_back("optimal_cost", std::move(series));
+    return true;
+}
+
+/**
+ * @brief Summarise the lowest and mean rollout cost of each update, and the
+ * fraction of failed rollouts.
+ */
+bool analyse_costs(Reader &reader, Section &section)
+{
+    int time = reader.find("time");
+    if (time < 0) {
+        std::cerr << "costs log has no time column" << std::endl;
+        return false;
+    }
+
+    Moments minimum_moments, mean_moments;
+    Trend trend;
+    Series minimum_series, mean_series;
+    std::int64_t rollouts = 0, failed = 0;
+
+    for (auto row = reader.next(); !row.empty(); row = reader.next()) {
+        double minimum = INFINITY, sum = 0.0;
+        std::int64_t count = 0;
+
+        for (std::size_t i = time + 1; i < row.size(); ++i) {
+            if (!std::isfinite(row[i])) {
+                ++failed;
+                continue;
+            }
+
+            minimum = std::min(minimum, row[i]);
+            sum += row[i];
+            ++count;
+        }
+
+        rollouts += row.size() - (time + 1);
+        if (count == 0)
+            continue;
+
+        double t = at(row, time);
+        double mean = sum / (double)count;
+
+        minimum_moments.add(minimum);
+        mean_moments.add(mean);
+        trend.add(t, minimum);
+        minimum_series.add(t, minimum);
+        mean_series.add(t, mean);
+    }
+
+    section.statistics["minimum"] = describe(minimum_moments);
+    section.statistics["minimum"]["slope"] = trend.get_slope();
+    section.statistics["mean"] = describe(mean_moments);
+    section.statistics["failed_fraction"] = rollouts > 0 ? (double)failed / (double)rollouts : NAN;
+
+    section.series.emplace_back("minimum_cost", std::move(minimum_series));
+    section.series.emplace_back("mean_cost", std::move(mean_series));
+    return true;
+}
+
+/**
+ * @brief Summarise the effective sample size and normalised entropy of the
+ * rollout weights of each update.
+ */
+bool analyse_weights(Reader &reader, Section &section)
+{
+    int time = reader.find("time");
+    if (time < 0) {
+        std::cerr << "weights log has no time column" << std::endl;
+        return false;
+    }
+
+    Moments ess_moments, entropy_moments;
+    std::vector<std::pair<const char *, Quantile>> quantiles {
+        {"p10", Quantile(0.1)}, {"p50", Quantile(0.5)}
+    };
+    Series ess_series, entropy_series;
+    std::size_t rollouts = 0;
+
+    for (auto row = reader.next(); !row.empty(); row = reader.next()) {
+        auto weights = row.subspan(std::min<std::size_t>(time + 1, row.size()));
+        rollouts = std::max(rollouts, weights.size());
+
+        double sum = 0.0, squares = 0.0;
+        for (double weight : weights) {
+            if (std::isfinite(weight) && weight > 0.0) {
+                sum += weight;
+                squares += weight * weight;
+            }
+        }
+
+        if (sum <= 0.0)
+            continue;
+
+        double entropy = 0.0;
+        for (double weight : weights) {
+            if (std::isfinite(weight) && weight > 0.0) {
+                double probability = weight / sum;
+                entropy -= probability * std::log(probability);
+            }
+        }
+
+        double ess = sum * sum / squares;
+        double normalised = weights.size() > 1 ? entropy / std::log((double)weights.size()) : 0.0;
+        double t = at(row, time);
+
+        ess_moments.add(ess);
+        entropy_moments.add(normalised);
+        for (auto &[name, quantile] : quantiles)
+            quantile.add(ess);
+        ess_series.add(t, ess);
+        entropy_series.add(t, normalised);
+    }
+
+    section.statistics["rollouts"] = rollouts;
+    section.statistics["effective_sample_size"] = describe(ess_moments, quantiles);
+    section.statistics["entropy"] = describe(entropy_moments);
+
+    section.series.emplace_back("effective_sample_size", std::move(ess_series));
+    section.series.emplace_back("weight_entropy", std::move(entropy_series));
+    return true;
+}
+
+/**
+ * @brief Summarise the norm of the columns other than time of each row,
+ * after the first 10ms.
+ *
+ * @param name The name of the series of the norm.
+ */
+bool analyse_norm(Reader &reader, Section &section, const char *name)
+{
+    int time = reader.find("time");
+    if (time < 0) {
+        std::cerr << name << " log has no time column" << std::endl;
+        return false;
+    }
+
+    Moments moments;
+    std::vector<std::pair<const char *, Quantile>> quantiles {
+        {"p50", Quantile(0.5)}, {"p90", Quantile(0.9)}
+    };
+    Series series;
+    double squares = 0.0;
+
+    for (auto row = reader.next(); !row.empty(); row = reader.next()) {
+        double t = at(row, time);
+        if (!(t > 0.01))
+            continue;
+
+        double norm = 0.0;
+        for (std::size_t i = 0; i < row.size(); ++i) {
+            if ((int)i != time)
+                norm += row[i] * row[i];
+        }
+        norm = std::sqrt(norm);
+
+        if (!std::isfinite(norm))
+            continue;
+
+        moments.add(norm);
+        for (auto &[name, quantile] : quantiles)
+            quantile.add(norm);
+        series.add(t, norm);
+        squares += norm * norm;
+    }
+
+    section.statistics = describe(moments, quantiles);
+    section.statistics["rmse"] = moments.get_count() > 0
+        ? std::sqrt(squares / (double)moments.get_count())
+        : NAN;
+
+    section.series.emplace_back(name, std::move(series));
+    return true;
+}
+
+/// The logs summarised from each run.
+const std::vector<Log> LOGS {
+    {"update", "mppi/update.csv", analyse_update},
+    {"optimal_cost", "mppi/optimal_cost.csv", analyse_optimal_cost},
+    {"costs", "mppi/costs.csv", analyse_costs},
+    {"weights", "mppi/weights.csv", analyse_weights},
+    {"tracking", "pid/force/error.csv", [](Reader &reader, Section &section) {
+        return analyse_norm(reader, section, "tracking_error");
+    }},
+    {"force", "pid/force/control.csv", [](Reader &reader, Section &section) {
+        return analyse_norm(reader, section, "force");
+    }}
+};
+
+/**
+ * @brief Get a number of the statistics of a run, or NaN if absent.
+ *
+ * @param statistics The statistics of the run.
+ * @param pointer The json pointer to the number.
+ */
+double lookup(const json &statistics, const char *pointer)
+{
+    json::json_pointer path(pointer);
+    if (!statistics.contains(path) || !statistics[path].is_number())
+        return NAN;
+
+    return statistics[path].get<double>();
+}
+
+} // namespace
+
+std::vector<Summary> summarise(
+    const std::vector<std::filesystem::path> &runs,
+    unsigned int threads
+) {
+    struct Task {
+        std::size_t run;
+        const Log *log;
+        std::uintmax_t size;
+        std::future<std::optional<Section>> result;
+    };
+
+    std::vector<Task> tasks;
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        for (const Log &log : LOGS) {
+            std::error_code code;
+            auto size = std::filesystem::file_size(runs[i] / log.path, code);
+            if (!code)
+                tasks.push_back(Task {.run = i, .log = &log, .size = size});
+        }
+    }
+
+    // Analyse the largest logs first, so the longest task does not start
+    // last.
+    std::vector<Task *> order(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+        order[i] = &tasks[i];
+
+    std::sort(order.begin(), order.end(), [](const Task *left, const Task *right) {
+        return left->size > right->size;
+    });
+
+    {
+        ThreadPool pool(std::max(1u, threads));
+
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            Task &task = *order[i];
+            task.result = pool.enqueue(
+                (unsigned int)(order.size() - i),
+                [path = runs[task.run] / task.log->path, log = task.log]() {
+                    std::optional<Section> section;
+
+                    auto reader = Reader::create(path);
+                    if (!reader)
+                        return section;
+
+                    section.emplace();
+                    if (!log->analyse(*reader, *section)) {
+                        std::cerr << "failed to summarise " << path << std::endl;
+                        section.reset();
+                    }
+
+                    return section;
+                }
+            );
+        }
+
+        for (Task &task : tasks)
+            task.result.wait();
+    }
+
+    std::vector<Summary> summaries(runs.size());
+    for (std::size_t i = 0; i < runs.size(); ++i)
+        summaries[i].name = runs[i].filename().string();
+
+    for (Task &task : tasks) {
+        std::optional<Section> section = task.result.get();
+        if (!section)
+            continue;
+
+        Summary &summary = summaries[task.run];
+        summary.statistics[task.log->section] = std::move(section->statistics);
+        for (auto &series : section->series)
+            summary.series.push_back(std::move(series));
+    }
+
+    return summaries;
+}
+
+bool write_run(const Summary &summary, const std::filesystem::path &folder)
+{
+    auto file = logger::File::create(folder / "summary.json");
+    if (!file) {
+        std::cerr << "failed to write summary of " << summary.name << std::endl;
+        return false;
+    }
+
+    file->get_stream() << summary.statistics.dump(4);
+
+    auto trend = logger::CSV::create(logger::CSV::Configuration{
+        .path = folder / "trend.csv",
+        .header = logger::CSV::make_header(
+            "series", "time", "mean", "minimum", "maximum", "count"
+        )
+    });
+
+    if (!trend) {
+        std::cerr << "failed to write trend of " << summary.name << std::endl;
+        return false;
+    }
+
+    for (const auto &[name, series] : summary.series) {
+        for (const Series::Bin &bin : series.get_bins())
+            trend->write(name, bin.time, bin.mean, bin.minimum, bin.maximum, bin.count);
+    }
+
+    return true;
+}
+
+bool write_table(const std::vector<Summary> &summaries, const std::filesystem::path &folder)
+{
+    static constexpr std::pair<const char *, const char *> COLUMNS[] = {
+        {"updates", "/update/updates"},
+        {"update_duration_p50", "/update/update_duration/p50"},
+        {"update_duration_p99", "/update/update_duration/p99"},
+        {"update_duration_maximum", "/update/update_duration/maximum"},
+        {"optimal_cost_mean", "/optimal_cost/mean"},
+        {"optimal_cost_slope", "/optimal_cost/slope"},
+        {"minimum_cost_mean", "/costs/minimum/mean"},
+        {"failed_fraction", "/costs/failed_fraction"},
+        {"effective_sample_size_mean", "/update/effective_sample_size/mean"},
+        {"cost_scale_mean", "/update/cost_scale/mean"},
+        {"entropy_mean", "/weights/entropy/mean"},
+        {"tracking_rmse", "/tracking/rmse"},
+        {"force_mean", "/force/mean"}
+    };
+
+    logger::CSV::Header header {"name"};
+    for (const auto &[column, pointer] : COLUMNS)
+        header.push_back(column);
+
+    auto table = logger::CSV::create(logger::CSV::Configuration{
+        .path = folder / "summary.csv",
+        .header = header
+    });
+
+    if (!table) {
+        std::cerr << "failed to write summary table" << std::endl;
+        return false;
+    }
+
+    std::vector<double> values(std::size(COLUMNS));
+    for (const Summary &summary : summaries) {
+        for (std::size_t i = 0; i < std::size(COLUMNS); ++i)
+            values[i] = lookup(summary.statistics, COLUMNS[i].second);
+
+        table->write(summary.name, values);
+    }
+
+    return true;
+}
+
+} // namespace analyse
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "analyse/statistics.hpp"
+#include "controller/json.hpp"
+
+namespace analyse {
+
+/**
+ * @brief The summary of the logs of a run.
+ */
+struct Summary {
+
+    /// The name of the run, the name of its folder.
+    std::string name;
+
+    /// The summary statistics of each log, by section.
+    json statistics = json::object();
+
+    /// The downsampled series of the statistics over time, by name.
+    std::vector<std::pair<std::string, Series>> series;
+};
+
+/**
+ * @brief Summarise the logs of runs in a single pass over each log.
+ *
+ * The update durations, cost trends, weight effective sample size and
+ * entropy, tracking error and user force are summarised from the mppi and
+ * pid logs of each run, where present. Logs are analysed concurrently,
+ * largest first.
+ *
+ * @param runs The folders of the runs.
+ * @param threads The number of threads analysing logs.
+ *
+ * @returns The summary of each run.
+ */
+std::vector<Summary> summarise(
+    const std::vector<std::filesystem::path> &runs,
+    unsigned int threads
+);
+
+/**
+ * @brief Write the summary of a run to summary.json, and the series to
+ * trend.csv with a row per bin of each series.
+ *
+ * @param summary The summary of the run.
+ * @param folder The folder to write to.
+ *
+ * @returns If the summary was written.
+ */
+bool write_run(const Summary &summary, const std::filesystem::path &folder);
+
+/**
+ * @brief Write the headline statistics of runs to summary.csv, with a row per
+ * run.
+ *
+ * @param summaries The summary of each run.
+ * @param folder The folder to write to.
+ *
+ * @returns If the summary was written.
+ */
+bool write_table(const std::vector<Summary> &summaries, const std::filesystem::path &folder);
+
+} // namespace analyse
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -9,6 +11,9 @@
 #include <exception>
 #include <type_traits>
 #include <memory>
+#include <latch>
+
+#include "controller/realtime.hpp"
 
 /**
  * @brief Convenience type for retrieving type of std::invoke_result.
@@ -80,6 +85,20 @@ public:
         return enqueue(0, std::forward<Callable>(callable), std::forward<Args>(args)...);
     }
 
+    /**
+     * @brief Set every worker thread to a real time priority.
+     *
+     * @param priority The SCHED_FIFO priority between 1 and 99.
+     * @returns If all the worker priorities were set.
+     */
+    inline bool set_priority(int priority);
+
+    /**
+     * @brief Touch the stack of every worker thread so that tasks do not page
+     * fault. Blocks until every worker has done so.
+     */
+    inline void prefault();
+
 private:
 
     /**
@@ -147,6 +166,34 @@ inline ThreadPool::~ThreadPool()
     m_condition.notify_all();
 }
 
+inline bool ThreadPool::set_priority(int priority)
+{
+    for (auto &thread : m_threads) {
+        if (!realtime::set_priority(thread.native_handle(), priority))
+            return false;
+    }
+
+    return true;
+}
+
+inline void ThreadPool::prefault()
+{
+    // Each task blocks until all tasks have started, so every worker must pick
+    // up exactly one.
+    std::latch started(m_threads.size());
+    std::vector<std::future<void>> futures;
+
+    for (std::size_t i = 0; i < m_threads.size(); i++) {
+        futures.push_back(enqueue([&started]{
+            realtime::prefault_stack();
+            started.arrive_and_wait();
+        }));
+    }
+
+    for (auto &future : futures)
+        future.get();
+}
+
 void ThreadPool::worker(std::stop_token stop)
 {
     // The task to perform. Required since popping and running occur in
@@ -1,9 +1,53 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cmath>
+#include <cstdint>
+
+#include <Eigen/Dense>
 
 #include "controller/json.hpp"
 
+/**
+ * @brief The largest absolute error of fast_log10() for positive normal
+ * values.
+ */
+inline constexpr double FAST_LOG10_ERROR = 1e-9;
+
+/**
+ * @brief Approximate the base 10 logarithm of a positive normal value.
+ *
+ * The value is split into its exponent and a mantissa in [sqrt(1/2), sqrt(2)),
+ * whose natural logarithm is the series 2 * atanh((m - 1) / (m + 1)) to the
+ * ninth power. The error is below FAST_LOG10_ERROR. Branch free, so loops
+ * over arrays of values vectorise. Zero, negative and non-finite values
+ * return an unspecified value.
+ *
+ * @param value The positive normal value.
+ * @returns The approximate base 10 logarithm of the value.
+ */
+inline double fast_log10(double value)
+{
+    constexpr std::uint64_t MANTISSA = 0x000FFFFFFFFFFFFFull;
+    constexpr std::uint64_t ONE = 0x3FF0000000000000ull;
+
+    std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+    double exponent = (double)((std::int64_t)(bits >> 52) & 0x7FF) - 1023.0;
+    double mantissa = std::bit_cast<double>((bits & MANTISSA) | ONE);
+
+    // Centre the mantissa on one to halve the range of the series.
+    bool high = mantissa > M_SQRT2;
+    mantissa = high ? 0.5 * mantissa : mantissa;
+    exponent = high ? exponent + 1.0 : exponent;
+
+    double t = (mantissa - 1.0) / (mantissa + 1.0);
+    double t2 = t * t;
+    double series = t * (2.0 + t2 * (2.0 / 3.0 + t2 * (2.0 / 5.0 + t2 * (2.0 / 7.0 + t2 * (2.0 / 9.0)))));
+
+    return (series + exponent * M_LN2) * (1.0 / M_LN10);
+}
+
 /**
  * @brief A generic objective function for evaluating a single variable.
  */
@@ -57,7 +101,7 @@ struct RightInverseBarrierFunction {
     inline double operator()(double value) const
     {
         if (value >= upper_bound)
-            return maximum_cost + scale * std::pow(value - upper_bound, 2);
+            return maximum_cost + scale * (value - upper_bound) * (value - upper_bound);
         return std::min(scale / (upper_bound - value), maximum_cost);
     }
 
@@ -88,7 +132,7 @@ struct LeftInverseBarrierFunction {
     inline double operator()(double value) const
     {
         if (value <= lower_bound)
-            return maximum_cost + scale * std::pow(lower_bound - value, 2);
+            return maximum_cost + scale * (lower_bound - value) * (lower_bound - value);
         return std::min(scale / (value - lower_bound), maximum_cost);
     }
 
@@ -116,6 +160,9 @@ struct UpperLogarithmicBarrierFunction {
     /// The maximum value to clamp the barrier function to.
     double maximum_cost = 1e10;
 
+    /// If the logarithm is approximated with fast_log10().
+    bool approximate = false;
+
     /**
      * @brief Calculate the cost of the barrier function.
      */
@@ -123,12 +170,15 @@ struct UpperLogarithmicBarrierFunction {
     {
         if (value >= upper_bound)
             return maximum_cost;
-        return std::min(scale * (-std::log10(-value + upper_bound) + offset), 0.0);
+
+        double distance = -value + upper_bound;
+        double log = approximate ? fast_log10(distance) : std::log10(distance);
+        return std::min(scale * (-log + offset), 0.0);
     }
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(
         UpperLogarithmicBarrierFunction,
-        upper_bound, scale, offset, maximum_cost
+        upper_bound, scale, offset, maximum_cost, approximate
     )
 };
 
@@ -150,6 +200,9 @@ struct LowerLogarithmicBarrierFunction {
     /// The maximum value to clamp the barrier function to.
     double maximum_cost = 1e10;
 
+    /// If the logarithm is approximated with fast_log10().
+    bool approximate = false;
+
     /**
      * @brief Calculate the cost of the barrier function.
      */
@@ -157,11 +210,205 @@ struct LowerLogarithmicBarrierFunction {
     {
         if (value <= lower_bound)
             return maximum_cost;
-        return std::min(scale * (-std::log10(value - lower_bound) + offset), 0.0);
+
+        double distance = value - lower_bound;
+        double log = approximate ? fast_log10(distance) : std::log10(distance);
+        return std::min(scale * (-log + offset), 0.0);
     }
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(
         LowerLogarithmicBarrierFunction,
-        lower_bound, scale, offset, maximum_cost
+        lower_bound, scale, offset, maximum_cost, approximate
     )
 };
+
+/**
+ * @brief A fixed size array of barrier functions of the same family,
+ * evaluated together over an array of values.
+ *
+ * The parameters are stored as arrays so the barriers evaluate without
+ * branching, and vectorise. Specialised for each barrier family.
+ *
+ * @tparam Barrier The barrier function family.
+ * @tparam Size The number of barriers.
+ */
+template<typename Barrier, int Size>
+struct BarrierArray;
+
+template<int Size>
+struct BarrierArray<RightInverseBarrierFunction, Size> {
+
+    using Values = Eigen::Array<double, Size, 1>;
+
+    Values upper_bound;
+
+    Values scale;
+
+    Values maximum_cost;
+
+    BarrierArray(const std::array<RightInverseBarrierFunction, Size> &barriers)
+    {
+        for (int i = 0; i < Size; ++i) {
+            upper_bound[i] = barriers[i].upper_bound;
+            scale[i] = barriers[i].scale;
+            maximum_cost[i] = barriers[i].maximum_cost;
+        }
+    }
+
+    /**
+     * @brief Calculate the total cost of the barriers.
+     * @param value The value of each barrier.
+     */
+    inline double operator()(const Values &value) const
+    {
+        Values distance = upper_bound - value;
+        return (distance <= 0.0).select(
+            maximum_cost + scale * distance.square(),
+            (scale / distance).min(maximum_cost)
+        ).sum();
+    }
+};
+
+template<int Size>
+struct BarrierArray<LeftInverseBarrierFunction, Size> {
+
+    using Values = Eigen::Array<double, Size, 1>;
+
+    Values lower_bound;
+
+    Values scale;
+
+    Values maximum_cost;
+
+    BarrierArray(const std::array<LeftInverseBarrierFunction, Size> &barriers)
+    {
+        for (int i = 0; i < Size; ++i) {
+            lower_bound[i] = barriers[i].lower_bound;
+            scale[i] = barriers[i].scale;
+            maximum_cost[i] = barriers[i].maximum_cost;
+        }
+    }
+
+    /**
+     * @brief Calculate the total cost of the barriers.
+     * @param value The value of each barrier.
+     */
+    inline double operator()(const Values &value) const
+    {
+        Values distance = value - lower_bound;
+        return (distance <= 0.0).select(
+            maximum_cost + scale * distance.square(),
+            (scale / distance).min(maximum_cost)
+        ).sum();
+    }
+};
+
+/**
+ * @brief Take the base 10 logarithm of an array, approximated with
+ * fast_log10() if required.
+ */
+template<int Size>
+inline Eigen::Array<double, Size, 1> barrier_log10(
+    const Eigen::Array<double, Size, 1> &value,
+    bool approximate
+) {
+    if (!approximate)
+        return value.log10();
+
+    Eigen::Array<double, Size, 1> log;
+    for (int i = 0; i < Size; ++i)
+        log[i] = fast_log10(value[i]);
+    return log;
+}
+
+template<int Size>
+struct BarrierArray<UpperLogarithmicBarrierFunction, Size> {
+
+    using Values = Eigen::Array<double, Size, 1>;
+
+    Values upper_bound;
+
+    Values scale;
+
+    Values offset;
+
+    Values maximum_cost;
+
+    /// If the logarithms are approximated, only if every barrier is.
+    bool approximate;
+
+    BarrierArray(const std::array<UpperLogarithmicBarrierFunction, Size> &barriers)
+        : approximate(true)
+    {
+        for (int i = 0; i < Size; ++i) {
+            upper_bound[i] = barriers[i].upper_bound;
+            scale[i] = barriers[i].scale;
+            offset[i] = barriers[i].offset;
+            maximum_cost[i] = barriers[i].maximum_cost;
+            approximate = approximate && barriers[i].approximate;
+        }
+    }
+
+    /**
+     * @brief Calculate the total cost of the barriers.
+     * @param value The value of each barrier.
+     */
+    inline double operator()(const Values &value) const
+    {
+        Values distance = upper_bound - value;
+
+        // Breached barriers take the logarithm of one, and are then replaced.
+        Values log = barrier_log10<Size>((distance > 0.0).select(distance, 1.0), approximate);
+
+        return (distance <= 0.0).select(
+            maximum_cost,
+            (scale * (offset - log)).min(0.0)
+        ).sum();
+    }
+};
+
+template<int Size>
+struct BarrierArray<LowerLogarithmicBarrierFunction, Size> {
+
+    using Values = Eigen::Array<double, Size, 1>;
+
+    Values lower_bound;
+
+    Values scale;
+
+    Values offset;
+
+    Values maximum_cost;
+
+    /// If the logarithms are approximated, only if every barrier is.
+    bool approximate;
+
+    BarrierArray(const std::array<LowerLogarithmicBarrierFunction, Size> &barriers)
+        : approximate(true)
+    {
+        for (int i = 0; i < Size; ++i) {
+            lower_bound[i] = barriers[i].lower_bound;
+            scale[i] = barriers[i].scale;
+            offset[i] = barriers[i].offset;
+            maximum_cost[i] = barriers[i].maximum_cost;
+            approximate = approximate && barriers[i].approximate;
+        }
+    }
+
+    /**
+     * @brief Calculate the total cost of the barriers.
+     * @param value The value of each barrier.
+     */
+    inline double operator()(const Values &value) const
+    {
+        Values distance = value - lower_bound;
+
+        // Breached barriers take the logarithm of one, and are then replaced.
+        Values log = barrier_log10<Size>((distance > 0.0).select(distance, 1.0), approximate);
+
+        return (distance <= 0.0).select(
+            maximum_cost,
+            (scale * (offset - log)).min(0.0)
+        ).sum();
+    }
+};
@@ -0,0 +1,127 @@
+#include "controller/deadline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace mppi {
+
+std::unique_ptr<DeadlineMonitor> DeadlineMonitor::create(
+    const Configuration &configuration,
+    double period,
+    std::int64_t rollouts
+) {
+    if (!(configuration.budget > 0.0) || !(period > 0.0)) {
+        std::cerr << "deadline monitor budget and period must be positive" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.miss_limit == 0 || configuration.recover_limit == 0 ||
+        configuration.probe_interval == 0) {
+        std::cerr << "deadline monitor miss and recover limits and probe interval must be nonzero" << std::endl;
+        return nullptr;
+    }
+
+    if (!(configuration.rollout_factor > 0.0 && configuration.rollout_factor < 1.0)) {
+        std::cerr << "deadline monitor rollout factor must be in (0, 1)" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.minimum_rollouts < 1 || configuration.minimum_rollouts > rollouts) {
+        std::cerr << "deadline monitor minimum rollouts must be between 1 and "
+                  << rollouts << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<DeadlineMonitor>(
+        new DeadlineMonitor(configuration, configuration.budget * period, rollouts)
+    );
+}
+
+DeadlineMonitor::DeadlineMonitor(
+    const Configuration &configuration,
+    double deadline,
+    std::int64_t rollouts
+) : m_configuration(configuration)
+  , m_deadline(deadline)
+  , m_rollouts(rollouts)
+  , m_fallback(false)
+  , m_probe_periods(0)
+  , m_statistics()
+{}
+
+bool DeadlineMonitor::should_update()
+{
+    if (!m_fallback)
+        return true;
+
+    if (++m_probe_periods < m_configuration.probe_interval) {
+        ++m_statistics.skipped;
+        return false;
+    }
+
+    m_probe_periods = 0;
+    return true;
+}
+
+void DeadlineMonitor::observe(
+    Trajectory &trajectory,
+    double duration,
+    const Trajectory::Phases &phases
+) {
+    ++m_statistics.updates;
+    m_statistics.duration = duration;
+    m_statistics.worst_duration = std::max(m_statistics.worst_duration, duration);
+
+    std::int64_t limit = trajectory.get_rollout_limit();
+
+    if (duration > m_deadline) {
+        ++m_statistics.overruns;
+        ++m_statistics.consecutive_overruns;
+        m_statistics.consecutive_on_time = 0;
+        m_statistics.overrun_phases += phases;
+
+        if (m_statistics.consecutive_overruns < m_configuration.miss_limit)
+            return;
+
+        m_statistics.consecutive_overruns = 0;
+
+        // Shed rollouts until the minimum, then fall back.
+        if (limit > m_configuration.minimum_rollouts) {
+            trajectory.set_rollout_limit(std::max(
+                m_configuration.minimum_rollouts,
+                (std::int64_t)(limit * m_configuration.rollout_factor)
+            ));
+            ++m_statistics.degradations;
+        }
+        else if (!m_fallback) {
+            m_fallback = true;
+            m_probe_periods = 0;
+            ++m_statistics.fallbacks;
+        }
+
+        return;
+    }
+
+    ++m_statistics.consecutive_on_time;
+    m_statistics.consecutive_overruns = 0;
+
+    if (m_statistics.consecutive_on_time < m_configuration.recover_limit)
+        return;
+
+    m_statistics.consecutive_on_time = 0;
+
+    // Leave fallback before restoring rollouts, in the reverse order of
+    // degradation.
+    if (m_fallback) {
+        m_fallback = false;
+    }
+    else if (limit < m_rollouts) {
+        trajectory.set_rollout_limit(std::min(
+            m_rollouts,
+            (std::int64_t)std::ceil(limit / m_configuration.rollout_factor)
+        ));
+    }
+}
+
+} // namespace mppi
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <memory>
+
+#include "controller/json.hpp"
+#include "controller/mppi.hpp"
+
+namespace mppi {
+
+/**
+ * @brief Monitors trajectory updates against the period they must complete
+ * within, and degrades the trajectory generator when they repeatedly overrun.
+ *
+ * After a number of consecutive overruns, the sampled rollouts are reduced by
+ * a factor down to a minimum. If updates still overrun at the minimum, the
+ * monitor enters fallback, where the caller should stop applying the stale
+ * trajectory and use a cheaper controller. In fallback, the trajectory is only
+ * updated every few periods to probe whether updates are on time again, so the
+ * load is shed rather than spent on a trajectory that is not applied. After a
+ * number of consecutive on time updates, the monitor leaves fallback and then
+ * restores rollouts one step at a time.
+ */
+class DeadlineMonitor
+{
+public:
+
+    struct Configuration {
+
+        /// The fraction of the update period the update may take.
+        double budget;
+
+        /// The number of consecutive overruns before degrading a step.
+        unsigned int miss_limit;
+
+        /// The number of consecutive on time updates before recovering a step.
+        unsigned int recover_limit;
+
+        /// The factor in (0, 1) the sampled rollouts are multiplied by on each
+        /// degradation step.
+        double rollout_factor;
+
+        /// The smallest number of sampled rollouts to degrade to, before
+        /// falling back.
+        std::int64_t minimum_rollouts;
+
+        /// The number of update periods between the updates probing the
+        /// deadline in fallback. The trajectory is not updated in the other
+        /// periods.
+        unsigned int probe_interval;
+
+        // JSON conversion for deadline monitor configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            budget, miss_limit, recover_limit, rollout_factor, minimum_rollouts,
+            probe_interval
+        )
+    };
+
+    /**
+     * @brief Cumulative statistics of the monitored updates.
+     */
+    struct Statistics {
+
+        /// The number of monitored updates.
+        std::size_t updates = 0;
+
+        /// The number of updates that overran the deadline.
+        std::size_t overruns = 0;
+
+        /// The number of consecutive overrunning updates.
+        unsigned int consecutive_overruns = 0;
+
+        /// The number of consecutive on time updates.
+        unsigned int consecutive_on_time = 0;
+
+        /// The duration of the last update in seconds.
+        double duration = 0.0;
+
+        /// The longest update duration in seconds.
+        double worst_duration = 0.0;
+
+        /// The cumulative phase durations of the overrunning updates.
+        Trajectory::Phases overrun_phases;
+
+        /// The number of degradation steps taken.
+        std::size_t degradations = 0;
+
+        /// The number of times fallback was entered.
+        std::size_t fallbacks = 0;
+
+        /// The number of update periods skipped in fallback.
+        std::size_t skipped = 0;
+    };
+
+    /**
+     * @brief Create a deadline monitor.
+     *
+     * @param configuration The configuration of the monitor.
+     * @param period The period of time between updates in seconds.
+     * @param rollouts The configured number of sampled rollouts.
+     *
+     * @returns A pointer to the monitor on success or nullptr on failure.
+     */
+    static std::unique_ptr<DeadlineMonitor> create(
+        const Configuration &configuration,
+        double period,
+        std::int64_t rollouts
+    );
+
+    /**
+     * @brief Observe the duration of an update, and degrade or recover the
+     * trajectory generator.
+     *
+     * @param trajectory The trajectory generator that was updated.
+     * @param duration The wall time of the update in seconds. May span
+     * several trajectory updates.
+     * @param phases The phase durations of the update.
+     */
+    void observe(
+        Trajectory &trajectory,
+        double duration,
+        const Trajectory::Phases &phases
+    );
+
+    /**
+     * @brief If the trajectory should be updated this update period.
+     *
+     * Always true outside of fallback. In fallback, true once every probe
+     * interval, and otherwise counts the period as skipped. The updates that
+     * are made should be observed as usual.
+     */
+    bool should_update();
+
+    /**
+     * @brief If the trajectory should not be applied, and a fallback
+     * controller should be used instead.
+     */
+    inline bool in_fallback() const {
+        return m_fallback;
+    }
+
+    /**
+     * @brief Get the deadline of each update in seconds.
+     */
+    inline double get_deadline() const {
+        return m_deadline;
+    }
+
+    /**
+     * @brief Get the update statistics.
+     */
+    inline const Statistics &get_statistics() const {
+        return m_statistics;
+    }
+
+private:
+
+    DeadlineMonitor(
+        const Configuration &configuration,
+        double deadline,
+        std::int64_t rollouts
+    );
+
+    /// The configuration of the monitor.
+    const Configuration m_configuration;
+
+    /// The deadline of each update in seconds.
+    const double m_deadline;
+
+    /// The configured number of sampled rollouts.
+    const std::int64_t m_rollouts;
+
+    /// If the monitor is in fallback.
+    bool m_fallback;
+
+    /// The number of update periods since the last update in fallback.
+    unsigned int m_probe_periods;
+
+    /// The update statistics.
+    Statistics m_statistics;
+};
+
+} // namespace mppi
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <variant>
+#include <mutex>
 #include <shared_mutex>
 #include <deque>
 
@@ -63,6 +63,20 @@ public:
         m_mean = mean;
     }
 
+    /**
+     * @brief Restart the pseudo-random sequence from a seed.
+     *
+     * The sequence from a seed is only reproducible by the same build, since
+     * the normal distribution is implementation defined.
+     *
+     * @param seed The seed of the sequence.
+     */
+    inline void seed(std::uint64_t seed)
+    {
+        m_generator.seed((std::mt19937::result_type)(seed ^ (seed >> 32)));
+        m_distribution.reset();
+    }
+
     /**
      * @brief Sample the distribution.
      * @returns A vector of values sampled from each gaussian.
@@ -50,16 +50,20 @@ namespace Eigen {
 template <typename _Scalar, int _Rows, int _Cols, int _Options, int _MaxRows, int _MaxCols>
 void to_json(json &destination, const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols> &matrix)
 {
-    destination = json::array();
+    json::array_t rows;
+    rows.reserve(matrix.rows());
 
     for (int i = 0; i < matrix.rows(); i++) {
-        auto row = json::array();
+        json::array_t row;
+        row.reserve(matrix.cols());
 
         for (int j = 0; j < matrix.cols(); j++)
-            row.push_back(matrix(i, j));
+            row.emplace_back(matrix(i, j));
 
-        destination.push_back(row);
+        rows.emplace_back(std::move(row));
     }
+
+    destination = std::move(rows);
 }
 
 template <typename _Scalar, int _Rows, int _Cols, int _Options, int _MaxRows, int _MaxCols>
@@ -67,17 +71,43 @@ void from_json(const json &source, Eigen::Matrix<_Scalar, _Rows, _Cols, _Options
 {
     using T = typename Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>::Scalar;
 
-    if (source.empty())
-        matrix.resize(0, 0);
+    // Empty in each dynamic dimension. Vectors keep their single column.
+    auto clear = [&]() {
+        matrix.resize(
+            _Rows == Eigen::Dynamic ? 0 : _Rows,
+            _Cols == Eigen::Dynamic ? 0 : _Cols
+        );
+    };
+
+    // A null matrix is empty, as for an empty array.
+    if (source.is_null()) {
+        clear();
+        return;
+    }
+
+    // Read the underlying arrays directly rather than through nested lookups.
+    const auto &rows = source.get_ref<const json::array_t&>();
 
-    std::size_t n = source.size();
-    std::size_t m = source[0].size();
+    if (rows.empty()) {
+        clear();
+        return;
+    }
+
+    std::size_t n = rows.size();
+    std::size_t m = rows[0].get_ref<const json::array_t&>().size();
     matrix.resize(n, m);
 
     for (std::size_t i = 0; i < n; i++) {
-        for (std::size_t j = 0; j < m; j++) {
-            matrix(i, j) = source[i][j].get<T>();
+        const auto &row = rows[i].get_ref<const json::array_t&>();
+
+        if (row.size() != m) {
+            throw json::type_error::create(
+                302, "matrix rows must have equal length", &source
+            );
         }
+
+        for (std::size_t j = 0; j < m; j++)
+            matrix(i, j) = row[j].get<T>();
     }
 }
 
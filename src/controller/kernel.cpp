@@ -0,0 +1,16 @@
+#include "controller/kernel.hpp"
+
+namespace mppi::kernel {
+
+MPPI_DISPATCH
+void accumulate(
+    double *__restrict destination,
+    const double *__restrict source,
+    double weight,
+    std::size_t size
+) {
+    for (std::size_t i = 0; i < size; ++i)
+        destination[i] += weight * source[i];
+}
+
+} // namespace mppi::kernel
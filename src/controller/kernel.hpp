@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Compiles the following function for several instruction set levels,
+ * selected at load time for the running processor.
+ *
+ * Enabled with the MPPI_RUNTIME_DISPATCH build option. Binaries are deployed
+ * to processors with different vector extensions, so the hot kernels are
+ * cloned rather than compiled for a single -march.
+ */
+#if defined(MPPI_RUNTIME_DISPATCH) && defined(__x86_64__) && defined(__GNUC__)
+    #define MPPI_DISPATCH \
+        __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+    #define MPPI_DISPATCH
+#endif
+
+namespace mppi::kernel {
+
+/**
+ * @brief Add a weighted array to a destination array.
+ *
+ * Written as a plain loop so that each dispatched clone is auto-vectorised
+ * for its instruction set.
+ *
+ * @param destination The array to accumulate into.
+ * @param source The array to weight and add.
+ * @param weight The scalar weight of the source.
+ * @param size The number of elements in each array.
+ */
+void accumulate(
+    double *__restrict destination,
+    const double *__restrict source,
+    double weight,
+    std::size_t size
+);
+
+} // namespace mppi::kernel
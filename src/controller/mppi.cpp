@@ -1,5 +1,7 @@
 #include "mppi.hpp"
+#include "controller/kernel.hpp"
 
+#include <algorithm>
 #include <ranges>
 #include <cmath>
 #include <numeric>
@@ -68,59 +70,268 @@ std::unique_ptr<Trajectory> Trajectory::create(
         return nullptr;
     }
 
-    return std::unique_ptr<Trajectory>(new Trajectory(
+    if (configuration.cost_scale_adaptation) {
+        const auto &adaptation = *configuration.cost_scale_adaptation;
+
+        if (!(adaptation.target > 0.0 && adaptation.target <= 1.0)) {
+            std::cerr << "trajectory target effective sample size must be in (0, 1]" << std::endl;
+            return nullptr;
+        }
+
+        if (!(adaptation.rate > 0.0 && adaptation.rate <= 1.0)) {
+            std::cerr << "trajectory cost scale adaptation rate must be in (0, 1]" << std::endl;
+            return nullptr;
+        }
+
+        if (!(adaptation.minimum > 0.0 && adaptation.minimum <= configuration.cost_scale &&
+              configuration.cost_scale <= adaptation.maximum)) {
+            std::cerr << "trajectory cost scale must be within the positive adaptation bounds"
+                      << std::endl;
+            return nullptr;
+        }
+    }
+
+    auto plan = make_plan(
         configuration,
+        dynamics->get_state_dof(),
+        dynamics->get_control_dof()
+    );
+
+    if (!plan) {
+        std::cerr << "invalid trajectory configuration" << std::endl;
+        return nullptr;
+    }
+
+    // Lock memory before allocating so all buffers stay resident.
+    if (configuration.realtime && configuration.realtime->lock_memory) {
+        if (!realtime::lock_memory()) {
+            std::cerr << "failed to lock trajectory memory" << std::endl;
+            return nullptr;
+        }
+    }
+
+    auto trajectory = std::unique_ptr<Trajectory>(new Trajectory(
+        configuration,
+        std::move(*plan),
         std::move(dynamics),
         std::move(cost),
         std::move(filter)
     ));
+
+    // Created before preparing for real time, so its buffers are faulted in
+    // by the warm up rollout.
+    if (configuration.recording) {
+        trajectory->m_recorder = Recorder::create(
+            *configuration.recording,
+            trajectory->m_state_dof,
+            trajectory->m_step_count,
+            trajectory->m_rollout_count,
+            configuration.threads
+        );
+
+        if (!trajectory->m_recorder) {
+            std::cerr << "failed to create trajectory rollout recorder" << std::endl;
+            return nullptr;
+        }
+    }
+
+    if (configuration.realtime) {
+        if (!trajectory->prepare_realtime(*configuration.realtime, configuration.initial_state)) {
+            std::cerr << "failed to prepare trajectory for real time" << std::endl;
+            return nullptr;
+        }
+    }
+
+    // Without workers, the seeded samples are only rolled out locally.
+    if (configuration.distributed && !configuration.distributed->workers.empty()) {
+        trajectory->m_coordinator = distributed::Coordinator::create(
+            *configuration.distributed,
+            trajectory->m_rollout_count - s_static_rollouts,
+            trajectory->m_state_dof,
+            trajectory->m_control_dof,
+            trajectory->m_step_count,
+            trajectory->m_time_step
+        );
+
+        if (!trajectory->m_coordinator) {
+            std::cerr << "failed to connect to trajectory workers" << std::endl;
+            return nullptr;
+        }
+    }
+
+    return trajectory;
+}
+
+std::optional<Trajectory::Plan> Trajectory::make_plan(
+    const Configuration &configuration,
+    int state_dof,
+    int control_dof
+) {
+    if (configuration.initial_state.size() != state_dof) {
+        std::cerr << "trajectory initial state must have length "
+                  << state_dof << std::endl;
+        return std::nullopt;
+    }
+
+    if (configuration.keep_best_rollouts > configuration.rollouts) {
+        std::cerr << "trajectory cached rollouts " << configuration.keep_best_rollouts
+                  << " > rollouts " << configuration.rollouts << std::endl;
+        return std::nullopt;
+    }
+
+    if (!(configuration.time_step > 0.0)) {
+        std::cerr << "trajectory time step must be positive" << std::endl;
+        return std::nullopt;
+    }
+
+    if (configuration.horison < configuration.time_step) {
+        std::cerr << "trajectory horison must be at least one time step" << std::endl;
+        return std::nullopt;
+    }
+
+    // The horison must be a whole number of time steps, within rounding error.
+    double steps = configuration.horison / configuration.time_step;
+    if (std::abs(steps - std::round(steps)) > 1e-6) {
+        std::cerr << "trajectory horison " << configuration.horison
+                  << " is not a multiple of the time step "
+                  << configuration.time_step << std::endl;
+        return std::nullopt;
+    }
+
+    if (!(configuration.cost_discount_factor > 0.0 &&
+          configuration.cost_discount_factor <= 1.0)) {
+        std::cerr << "trajectory cost discount factor must be in (0, 1]" << std::endl;
+        return std::nullopt;
+    }
+
+    if (configuration.control_bound &&
+        (configuration.control_min.array() > configuration.control_max.array()).any()) {
+        std::cerr << "trajectory control minimum exceeds control maximum" << std::endl;
+        return std::nullopt;
+    }
+
+    if (configuration.control_default &&
+        configuration.control_default->size() != control_dof) {
+        std::cerr << "trajectory default control must have length "
+                  << control_dof << std::endl;
+        return std::nullopt;
+    }
+
+    Plan plan;
+    plan.step_count = (int)std::round(steps);
+
+    // The filter fits a polynomial over 2 * window + 1 samples, which must fit
+    // within the horison and have more samples than the polynomial order.
+    if (configuration.smoothing) {
+        unsigned int samples = 2 * configuration.smoothing->window + 1;
+
+        if (configuration.smoothing->window == 0 || samples > (unsigned int)plan.step_count) {
+            std::cerr << "trajectory smoothing window of " << samples
+                      << " samples does not fit " << plan.step_count
+                      << " time steps" << std::endl;
+            return std::nullopt;
+        }
+
+        if (configuration.smoothing->order >= samples) {
+            std::cerr << "trajectory smoothing order " << configuration.smoothing->order
+                      << " must be less than the " << samples << " window samples"
+                      << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    plan.discount.resize(plan.step_count);
+    plan.step_time.resize(plan.step_count);
+
+    for (int step = 0; step < plan.step_count; ++step) {
+        plan.discount[step] = std::pow(configuration.cost_discount_factor, step);
+        plan.step_time[step] = step * configuration.time_step;
+    }
+
+    plan.control_min = configuration.control_min.replicate(1, plan.step_count);
+    plan.control_max = configuration.control_max.replicate(1, plan.step_count);
+
+    auto parameterisation = Parameterisation::create(
+        configuration.sample_mask,
+        configuration.knots,
+        control_dof,
+        plan.step_count
+    );
+
+    if (!parameterisation)
+        return std::nullopt;
+
+    plan.parameterisation = std::move(*parameterisation);
+
+    return plan;
 }
 
 Trajectory::Trajectory(
     const Configuration &configuration,
+    Plan &&plan,
     std::unique_ptr<Dynamics> &&dynamics,
     std::unique_ptr<Cost> &&cost,
     std::unique_ptr<Filter> &&filter
 ) noexcept
-  : m_step_count(std::ceil(configuration.horison / configuration.time_step))
+  : m_plan(std::move(plan))
+  , m_step_count(m_plan.step_count)
   , m_time_step(configuration.time_step)
   , m_rollout_count(configuration.rollouts + s_static_rollouts)
+  , m_active_rollout_count(m_rollout_count)
   , m_thread_count(configuration.threads)
   , m_state_dof(dynamics->get_state_dof())
   , m_control_dof(dynamics->get_control_dof())
   , m_update_last(0)
   , m_update_duration(0)
+  , m_update_phases()
   , m_update_count(0)
   , m_thread_pool(configuration.threads)
   , m_dynamics(configuration.threads)
   , m_cost(configuration.threads)
+  , m_optimal_cost()
   , m_futures(configuration.threads)
-  , m_gaussian(configuration.covariance)
+  , m_gaussian(m_plan.parameterisation.reduce(configuration.covariance))
   , m_rollout_state(configuration.initial_state)
   , m_rollout_time(0.0)
+  , m_rollout_step_time(m_plan.step_time.size())
   , m_last_shift_time(0.0)
-  , m_cost_discount_factor(configuration.cost_discount_factor)
-  , m_cost_scale(configuration.cost_scale)
   , m_shift_by(0)
   , m_shifted(0)
-  , m_rollouts(m_rollout_count, Rollout(dynamics->get_control_dof(), m_step_count))
+  , m_cost_scale(configuration.cost_scale)
+  , m_cost_scale_adaptation(configuration.cost_scale_adaptation)
+  , m_effective_sample_size(0.0)
+  , m_weighted_rollout_count(0)
+  , m_rollouts(
+        m_rollout_count,
+        Rollout(
+            m_plan.parameterisation.get_parameter_dof(),
+            m_plan.parameterisation.get_knot_count()
+        )
+    )
   , m_weights(m_rollout_count, 1) // (rows, cols) ...
   , m_gradient(dynamics->get_control_dof(), m_step_count)
+  , m_gradient_parameters(
+        m_plan.parameterisation.get_parameter_dof(),
+        m_plan.parameterisation.get_knot_count()
+    )
   , m_gradient_step(configuration.gradient_step)
   , m_filter(std::move(filter))
   , m_optimal_control_shifted(dynamics->get_control_dof(), m_step_count)
   , m_optimal_rollout(dynamics->get_control_dof(), m_step_count)
   , m_optimal_control(dynamics->get_control_dof(), m_step_count)
+  , m_seed()
+  , m_coordinator(nullptr)
+  , m_remote_rollout_count(0)
+  , m_recorder(nullptr)
   , m_keep_best_rollouts(configuration.keep_best_rollouts)
   , m_ordered_rollouts(configuration.rollouts)
   , m_bound_control(configuration.control_bound)
-  , m_control_min(configuration.control_min)
-  , m_control_max(configuration.control_max)
   , m_control_default(configuration.control_default)
 {
     m_rollout_state.setZero();
     m_weights.setZero();
     m_gradient.setZero();
+    m_gradient_parameters.setZero();
     m_optimal_control.setZero();
     m_optimal_control_shifted.setZero();
 
@@ -129,6 +340,11 @@ Trajectory::Trajectory(
         rollout.noise.setZero();
     }
 
+    // Seed the local samples too, so that distributed updates are
+    // reproducible from the configuration.
+    if (configuration.distributed)
+        m_seed = configuration.distributed->seed;
+
     // Ensure the passed dynamics and cost are not destroyed.
     m_dynamics[0] = std::move(dynamics);
     m_cost[0] = std::move(cost);
@@ -139,6 +355,8 @@ Trajectory::Trajectory(
         m_cost[i] = m_cost[0]->copy();
     }
 
+    m_optimal_cost = m_cost[0]->copy_optimal();
+
     if (configuration.smoothing) {
         m_smoothing_filter = SavitzkyGolayFilter(
             m_step_count,
@@ -151,6 +369,45 @@ Trajectory::Trajectory(
     }
 }
 
+bool Trajectory::prepare_realtime(
+    const Configuration::Realtime &realtime,
+    const VectorXd &initial_state
+) {
+    if (realtime.worker_priority != 0) {
+        if (realtime.worker_priority < 1 || realtime.worker_priority > 99) {
+            std::cerr << "trajectory worker priority must be between 1 and 99" << std::endl;
+            return false;
+        }
+
+        if (!m_thread_pool.set_priority(realtime.worker_priority))
+            return false;
+    }
+
+    if (realtime.control_priority != 0) {
+        if (realtime.control_priority < 1 || realtime.control_priority > 99) {
+            std::cerr << "trajectory control priority must be between 1 and 99" << std::endl;
+            return false;
+        }
+
+        if (!realtime::set_priority(realtime.control_priority))
+            return false;
+    }
+
+    m_thread_pool.prefault();
+    realtime::prefault_stack();
+
+    // Roll out every sample once from the initial state, then discard the
+    // results. The optimal control and timing are untouched.
+    m_rollout_state = initial_state;
+    rollout();
+
+    for (auto &rollout : m_rollouts)
+        rollout.cost = 0.0;
+
+    m_rollout_state.setZero();
+    return true;
+}
+
 void Trajectory::update(const Eigen::Ref<Eigen::VectorXd> state, double time)
 {
     using namespace std::chrono;
@@ -160,19 +417,41 @@ void Trajectory::update(const Eigen::Ref<Eigen::VectorXd> state, double time)
 
     auto start = steady_clock::now();
 
+    // Prepare the time dependent parts of the cost once for every rollout.
+    m_rollout_step_time = m_rollout_time + m_plan.step_time.array();
+    m_cost[0]->prepare(m_rollout_step_time, m_dynamics[0].get());
+
     // Sample all the control trajectories for each rollout.
     sample(time);
 
+    // Workers roll out their samples concurrently with the local rollouts.
+    if (m_coordinator)
+        m_coordinator->dispatch(m_rollout_state, time, m_optimal_control_shifted, m_update_count);
+
+    auto sampled = steady_clock::now();
+
     // Calculate the cost of each sampled rollout.
     rollout();
 
+    if (m_coordinator)
+        m_remote_rollout_count = m_coordinator->collect_costs();
+
+    auto rolled_out = steady_clock::now();
+
     // Take a fancy linear combination of the rollouts to generate a gradient
     // to step the final control trajectory towards.
     optimise();
+    auto optimised = steady_clock::now();
 
     // Rollout the updated optimal trajectory, and apply the optional filter at
     // each time step. The rollout also computes optimal trajectory cost.
     filter();
+    auto filtered = steady_clock::now();
+
+    m_update_phases.sample = duration<double>(sampled - start).count();
+    m_update_phases.rollout = duration<double>(rolled_out - sampled).count();
+    m_update_phases.optimise = duration<double>(optimised - rolled_out).count();
+    m_update_phases.filter = duration<double>(filtered - optimised).count();
 
     // Update the optimal control trajectory under lock.
     {
@@ -186,6 +465,20 @@ void Trajectory::update(const Eigen::Ref<Eigen::VectorXd> state, double time)
     ++m_update_count;
 }
 
+void Trajectory::set_rollout_limit(std::int64_t rollouts)
+{
+    rollouts = std::clamp<std::int64_t>(
+        rollouts, 1, m_rollout_count - s_static_rollouts
+    );
+
+    m_active_rollout_count = (int)(rollouts + s_static_rollouts);
+
+    // Inactive rollouts are ignored by optimisation and sorted last when
+    // selecting rollouts to keep.
+    for (std::int64_t index = m_active_rollout_count; index < m_rollout_count; ++index)
+        m_rollouts[index].cost = NAN;
+}
+
 void Trajectory::sample(double time)
 {
     // The number of time steps to shift the optimal control and best sampled
@@ -206,11 +499,8 @@ void Trajectory::sample(double time)
 
         // Reset to random noise if all trajectories are out of date.
         if (m_shift_by >= m_step_count) {
-            for (std::int64_t index = s_static_rollouts; index < m_rollout_count; ++index) {
-                Rollout &rollout = m_rollouts[index];
-                for (int i = 0; i < m_step_count; i++)
-                    rollout.noise.col(i) = m_gaussian();
-            }
+            for (std::int64_t index = s_static_rollouts; index < m_active_rollout_count; ++index)
+                sample(index, 0);
             return;
         }
     }
@@ -220,12 +510,17 @@ void Trajectory::sample(double time)
     // that are always kept.
     std::iota(m_ordered_rollouts.begin(), m_ordered_rollouts.end(), s_static_rollouts);
 
-    // Sort indexes by rollout cost.
+    // Sort indexes by rollout cost. Failed and inactive rollouts have NaN
+    // costs that are ordered last.
     std::stable_sort(
         m_ordered_rollouts.begin(),
         m_ordered_rollouts.end(),
         [this](std::int64_t left, std::int64_t right) {
-            return m_rollouts[left].cost < m_rollouts[right].cost;
+            double left_cost = m_rollouts[left].cost;
+            double right_cost = m_rollouts[right].cost;
+            if (std::isnan(right_cost))
+                return !std::isnan(left_cost);
+            return left_cost < right_cost;
         }
     );
 
@@ -240,31 +535,49 @@ void Trajectory::sample(double time)
     // Shift kept rollouts to align with the current time.
     if (m_shift_by > 0) {
         for (std::int64_t index : keep) {
+            if (index >= m_active_rollout_count)
+                continue;
+
             Rollout &rollout = m_rollouts[index];
 
             // Shift the rollout noise to align with current time.
-            rollout.noise.leftCols(m_shifted) = rollout.noise.rightCols(m_shifted).eval();
+            int sampled = m_plan.parameterisation.shift(rollout.noise, m_shift_by);
 
             // Add noise to the rest of the rollout.
-            for (int i = m_shifted; i < m_step_count; i++)
-                rollout.noise.col(i) = m_gaussian();
+            sample(index, sampled);
         }
     }
 
     for (std::int64_t index : resample) {
-        Rollout &rollout = m_rollouts[index];
+        if (index >= m_active_rollout_count)
+            continue;
 
         // Add noise to the last control for the rest of the rollout.
-        for (int i = 0; i < m_step_count; i++) {
-            rollout.noise.col(i) = m_gaussian();
-        }
+        sample(index, 0);
     }
 
     // The zero noise sample is always the first element, that is untouched.
     // get_rollout(0).setZero();
 
-    // Sample negative the previous optimal noise.
-    m_rollouts[1].noise = -m_optimal_control;
+    // Sample negative the previous optimal noise, at the knots.
+    m_plan.parameterisation.project(m_rollouts[1].noise, -m_optimal_control);
+}
+
+void Trajectory::sample(std::int64_t index, std::int64_t first)
+{
+    const int knots = m_plan.parameterisation.get_knot_count();
+    Rollout &rollout = m_rollouts[index];
+
+    // Sampled rollouts are numbered from zero before the remote rollouts, and
+    // seeded as workers seed theirs.
+    if (m_seed) {
+        m_gaussian.seed(distributed::rollout_seed(
+            *m_seed, m_update_count, (std::uint64_t)(index - s_static_rollouts)
+        ));
+    }
+
+    for (std::int64_t i = first; i < knots; i++)
+        rollout.noise.col(i) = m_gaussian();
 }
 
 void Trajectory::rollout()
@@ -272,7 +585,10 @@ void Trajectory::rollout()
     // Get the rounded down number rollouts per thread, and the remaining
     // rollouts to distribute between the threads. The rollouts to distribute
     // will always be less than the number of threads.
-    auto [each_thread, distribute] = std::div(m_rollout_count, m_thread_count);
+    auto [each_thread, distribute] = std::div(m_active_rollout_count, m_thread_count);
+
+    if (m_recorder)
+        m_recorder->reset(m_active_rollout_count);
 
     int start = 0;
     for (unsigned int thread = 0; thread < m_thread_count; thread++) {
@@ -291,7 +607,14 @@ void Trajectory::rollout()
         // Rollout trajectories from [start, stop)
         auto lambda = [this, thread, start, stop]() {
             for (int i = start; i < stop; i++) {
-                rollout(&m_rollouts[i], m_dynamics[thread].get(), m_cost[thread].get());
+                if (!m_recorder) {
+                    rollout(&m_rollouts[i], m_dynamics[thread].get(), m_cost[thread].get(), nullptr);
+                    continue;
+                }
+
+                double *states = m_recorder->begin(thread, i);
+                rollout(&m_rollouts[i], m_dynamics[thread].get(), m_cost[thread].get(), states);
+                m_recorder->end(thread, i, m_rollouts[i].cost);
             }
         };
 
@@ -299,29 +622,40 @@ void Trajectory::rollout()
         start = stop;
     }
 
-    // Barrier waiting for all threads to complete.
-    for (auto &future : m_futures)
-        future.get();
+    // Barrier waiting for all threads to complete. Threads without rollouts
+    // were not given a task.
+    for (auto &future : m_futures) {
+        if (future.valid())
+            future.get();
+    }
+
+    if (m_recorder)
+        m_recorder->collect();
 }
 
-void Trajectory::rollout(Rollout *rollout, Dynamics *dynamics, Cost *cost)
+void Trajectory::rollout(Rollout *rollout, Dynamics *dynamics, Cost *cost, double *states)
 {
     Eigen::VectorXd state = m_rollout_state;
+    Eigen::VectorXd control(m_control_dof);
+
     dynamics->set_state(state, m_rollout_time);
     cost->reset(m_rollout_time);
     rollout->cost = 0.0;
 
     for (int step = 0; step < m_step_count; ++step) {
 
-        // Add the rollout noise to the optimal control.
-        Eigen::VectorXd control = (
-            m_optimal_control_shifted.col(step) +
-            rollout->noise.col(step)
-        );
+        // Add the rollout noise to the optimal control. Reuses the control
+        // buffer to avoid allocating each step.
+        control = m_optimal_control_shifted.col(step);
+
+        m_plan.parameterisation.add(control, rollout->noise, step);
+
+        if (states)
+            m_recorder->record(states, step, state);
 
         double step_cost = (
-            std::pow(m_cost_discount_factor, step) *
-            cost->get_cost(state, control, dynamics, m_rollout_time + step * m_time_step)
+            m_plan.discount[step] *
+            cost->get_cost(state, control, dynamics, m_rollout_time + m_plan.step_time[step])
         );
 
         // Rollout weight is interpreted as zero during optimisation.
@@ -356,21 +690,52 @@ void Trajectory::optimise()
         }
     );
 
+    // No non-nan rollouts, this is an error.
+    if (it1 == it2) {
+        // Workers wait for the weight of every update, so skip it before
+        // failing to keep them in step with the next update.
+        if (m_coordinator) {
+            double total = 0.0;
+            m_coordinator->accumulate(0.0, 0.0, m_cost_scale, m_gradient, total);
+        }
+        throw std::runtime_error("all nan rollouts");
+    }
+
     minimum = it1->cost;
     maximum = it2->cost;
 
-    // No non-nan rollouts, this is an error.
-    if (it1 == it2)
-        throw std::runtime_error("all nan rollouts");
+    // Include the cost range of the remote rollouts.
+    if (m_coordinator && m_remote_rollout_count > 0) {
+        minimum = std::min(minimum, m_coordinator->get_minimum());
+        maximum = std::max(maximum, m_coordinator->get_maximum());
+    }
 
     // For parameterisation of each cost.
     double difference = maximum - minimum;
-    if (difference < 1e-6)
+    if (difference < 1e-6) {
+        // Every rollout would be weighted equally.
+        m_effective_sample_size = (double)std::ranges::distance(rollouts);
+        m_weighted_rollout_count = 0;
+
+        // Workers wait for the weight of every update, even if skipped.
+        if (m_coordinator) {
+            double total = 0.0;
+            m_coordinator->accumulate(minimum, 0.0, m_cost_scale, m_gradient, total);
+        }
         return;
+    }
+
+    if (m_cost_scale_adaptation)
+        adapt_cost_scale();
 
     // Running sum of total likelihood for normalisation between zero and one.
     double total = 0.0;
 
+    // Running sum of the squared likelihoods and count of the valid rollouts,
+    // for the effective sample size.
+    double squares = 0.0;
+    std::int64_t valid = 0;
+
     // Transform the weights to likelihoods.
     for (std::int64_t i = 0; i < m_rollout_count; ++i) {
         double cost = m_rollouts[i].cost;
@@ -386,9 +751,25 @@ void Trajectory::optimise()
         );
 
         total += likelihood;
+        squares += likelihood * likelihood;
+        ++valid;
         m_weights[i] = likelihood;
     }
 
+    // The effective sample size of the local rollouts, invariant to the
+    // normalisation of the weights.
+    m_effective_sample_size = total * total / squares;
+    m_weighted_rollout_count = valid;
+
+    m_gradient.setZero();
+
+    // Add the unnormalised likelihoods and weighted noise of the remote
+    // rollouts, then normalise both by the total of all rollouts.
+    if (m_coordinator) {
+        m_coordinator->accumulate(minimum, difference, m_cost_scale, m_gradient, total);
+        m_gradient /= total;
+    }
+
     // Normalise the likelihoods.
     std::transform(
         m_weights.begin(),
@@ -398,11 +779,23 @@ void Trajectory::optimise()
     );
 
     // The optimal trajectory is a linear combination of the noise samples.
-    m_gradient = m_rollouts[0].noise * m_weights[0];
-    for (std::int64_t i = 1; i < m_rollout_count; ++i) {
-        m_gradient += m_rollouts[i].noise * m_weights[i];
+    // Since the noise is linear in its parameters, the parameters are
+    // combined and expanded to each time step once.
+    m_gradient_parameters.setZero();
+    for (std::int64_t i = 0; i < m_rollout_count; ++i) {
+        if (m_weights[i] == 0.0)
+            continue;
+
+        kernel::accumulate(
+            m_gradient_parameters.data(),
+            m_rollouts[i].noise.data(),
+            m_weights[i],
+            m_gradient_parameters.size()
+        );
     }
 
+    m_plan.parameterisation.expand(m_gradient, m_gradient_parameters);
+
     // Step in the direction of the gradient.
     m_optimal_control_shifted += m_gradient * m_gradient_step;
 
@@ -413,14 +806,14 @@ void Trajectory::optimise()
         for (int i = 0; i < m_step_count; i++) {
             m_smoothing_filter->add_measurement(
                 m_optimal_control_shifted.col(i),
-                m_rollout_time + i * m_time_step
+                m_rollout_time + m_plan.step_time[i]
             );
         }
 
         for (int i = 0; i < m_step_count; i++) {
             m_smoothing_filter->apply(
                 m_optimal_control_shifted.col(i),
-                m_rollout_time + i * m_time_step
+                m_rollout_time + m_plan.step_time[i]
             );
         }
     }
@@ -428,16 +821,36 @@ void Trajectory::optimise()
     // Clip the optimal control.
     if (m_bound_control) {
         m_optimal_control_shifted = m_optimal_control_shifted
-            .cwiseMin(m_control_max.replicate(1, m_step_count))
-            .cwiseMax(m_control_min.replicate(1, m_step_count));
+            .cwiseMin(m_plan.control_max)
+            .cwiseMax(m_plan.control_min);
     }
 }
 
+void Trajectory::adapt_cost_scale()
+{
+    if (m_weighted_rollout_count == 0)
+        return;
+
+    const auto &adaptation = *m_cost_scale_adaptation;
+
+    double target = adaptation.target * (double)m_weighted_rollout_count;
+    double ratio = m_effective_sample_size / target;
+
+    // The effective sample size falls roughly in proportion to the cost
+    // scale once the weights concentrate, so a step in log space converges
+    // for rates up to one.
+    m_cost_scale = std::clamp(
+        m_cost_scale * std::pow(ratio, adaptation.rate),
+        adaptation.minimum,
+        adaptation.maximum
+    );
+}
+
 void Trajectory::filter()
 {
     Eigen::VectorXd state = m_rollout_state;
     Dynamics *dynamics = m_dynamics[0].get();
-    Cost *cost = m_cost[0].get();
+    Cost *cost = m_optimal_cost.get();
 
     dynamics->set_state(state, m_rollout_time);
     cost->reset(m_rollout_time);
@@ -449,11 +862,11 @@ void Trajectory::filter()
 
         // Apply the filter to the optimal control.
         if (m_filter)
-            m_filter->filter(state, control, m_rollout_time + step * m_time_step);
+            m_filter->filter(state, control, m_rollout_time + m_plan.step_time[step]);
 
         double step_cost = (
-            std::pow(m_cost_discount_factor, step) *
-            cost->get_cost(state, control, dynamics, m_rollout_time + step * m_time_step)
+            m_plan.discount[step] *
+            cost->get_cost(state, control, dynamics, m_rollout_time + m_plan.step_time[step])
         );
 
         // Cumulative running cost.
@@ -13,6 +13,9 @@
 #include "controller/gaussian.hpp"
 #include "controller/concurrency.hpp"
 #include "controller/filter.hpp"
+#include "controller/parameterisation.hpp"
+#include "controller/recorder.hpp"
+#include "distributed/coordinator.hpp"
 
 namespace mppi {
 
@@ -109,6 +112,33 @@ public:
      */
     virtual std::unique_ptr<Cost> copy() = 0;
 
+    /**
+     * @brief Make a copy of this objective function to evaluate the optimal
+     * rollout.
+     * 
+     * Costs that keep a breakdown of their terms for logging need only do so
+     * in this copy, rather than in every rollout.
+     * 
+     * @returns A std::unique_ptr to the objective function copy.
+     */
+    virtual std::unique_ptr<Cost> copy_optimal()
+    {
+        return copy();
+    }
+
+    /**
+     * @brief Prepare the parts of the cost that depend only on time.
+     * 
+     * Called once per update, before the rollouts, with the time of each step
+     * of the horison. Results are shared read only with every copy of the
+     * cost, so each rollout only evaluates the parts depending on the state.
+     * Copies should still evaluate the cost if a time was not prepared.
+     * 
+     * @param times The time of each step of the horison.
+     * @param dynamics Pointer to the dynamics at the initial time.
+     */
+    virtual void prepare(const VectorXd & /* times */, Dynamics * /* dynamics */) {}
+
     /**
      * @brief Reset the cost.
      */
@@ -207,6 +237,16 @@ struct Configuration
     /// The covariance matrix to generate rollout noise from.
     MatrixXd covariance;
 
+    /// If each control degree of freedom is sampled. Unsampled degrees of
+    /// freedom follow the optimal control without noise. All are sampled if
+    /// not provided.
+    std::optional<std::vector<bool>> sample_mask;
+
+    /// The number of noise samples per rollout, spread evenly over the
+    /// horison and linearly interpolated between time steps. At least two.
+    /// Each time step is sampled if not provided.
+    std::optional<unsigned int> knots;
+
     /// If the control output is bounded between control_min and control_max.
     bool control_bound;
 
@@ -239,12 +279,78 @@ struct Configuration
     /// rollouts.
     unsigned int threads;
 
+    /// Real time configuration.
+    struct Realtime {
+
+        /// If all process memory is locked into RAM on creation.
+        bool lock_memory;
+
+        /// The SCHED_FIFO priority of the rollout worker threads, or zero to
+        /// leave the default scheduling policy.
+        int worker_priority;
+
+        /// The SCHED_FIFO priority of the control thread, or zero to leave the
+        /// default scheduling policy. The control thread is the thread that
+        /// creates the trajectory, and must be the thread that updates it.
+        int control_priority;
+
+        // JSON conversion for Realtime.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Realtime, lock_memory, worker_priority, control_priority
+        )
+    };
+
+    /// If enabled, locks memory, sets worker and control thread priorities and
+    /// prefaults all buffers on creation so that updates do not page fault.
+    std::optional<Realtime> realtime;
+
+    /// If enabled, each update additionally rolls out seeded samples in
+    /// worker processes. Workers must share the dynamics, objective,
+    /// covariance, sample mask, knots, time step, horison and discount of the
+    /// trajectory. The local samples are seeded by rollout index like the
+    /// worker samples, so without workers the trajectory rolls out the same
+    /// samples locally.
+    std::optional<distributed::Coordinator::Configuration> distributed;
+
+    /// If enabled, records the states of the best and a sample of the
+    /// rollouts of each update.
+    std::optional<Recorder::Configuration> recording;
+
+    /**
+     * @brief Adaptation of the cost scale toward a target effective sample
+     * size of the rollout weights.
+     */
+    struct CostScaleAdaptation {
+
+        /// The target effective sample size, as a fraction of the rollouts
+        /// with a valid cost.
+        double target;
+
+        /// The fraction of the log ratio of the effective and target sample
+        /// sizes corrected each update, between zero and one.
+        double rate;
+
+        /// The smallest cost scale.
+        double minimum;
+
+        /// The largest cost scale.
+        double maximum;
+
+        // JSON conversion for CostScaleAdaptation.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(CostScaleAdaptation, target, rate, minimum, maximum)
+    };
+
+    /// If enabled, the cost scale starts at cost_scale and is adapted after
+    /// each update toward a target effective sample size.
+    std::optional<CostScaleAdaptation> cost_scale_adaptation;
+
     // JSON conversion for mppi configuration.
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(
         Configuration,
         initial_state, rollouts, keep_best_rollouts, time_step, horison,
         gradient_step, cost_scale, cost_discount_factor, covariance,
-        control_bound, control_min, control_max, control_default, smoothing, threads
+        sample_mask, knots, control_bound, control_min, control_max, control_default, smoothing, threads,
+        realtime, distributed, recording, cost_scale_adaptation
     )
 };
 
@@ -276,8 +382,9 @@ public:
     {
     public:
 
-        /// The noise applied to the previous optimal rollout. Has `control_dof`
-        /// number of rows and `steps` number of columns.
+        /// The parameters of the noise applied to the previous optimal
+        /// rollout. Has a row per sampled control degree of freedom and a
+        /// column per knot, which is each time step by default.
         MatrixXd noise;
 
         /// The cost of the rollout.
@@ -290,17 +397,43 @@ public:
         /**
          * @brief Create a new rollout.
          * 
-         * @param control_dof The number of rows of noise.
-         * @param steps The number of columns of noise.
+         * @param rows The number of rows of noise.
+         * @param columns The number of columns of noise.
          */
-        Rollout(std::size_t control_dof, std::size_t steps)
-            : noise(control_dof, steps)
+        Rollout(std::size_t rows, std::size_t columns)
+            : noise(rows, columns)
             , cost(0.0)
         {
             noise.setZero();
         }
     };
 
+    /**
+     * @brief The computation duration of each phase of an update, in seconds.
+     */
+    struct Phases {
+
+        /// Duration of sampling the rollout noise.
+        double sample = 0.0;
+
+        /// Duration of rolling out and costing the samples.
+        double rollout = 0.0;
+
+        /// Duration of weighting the rollouts and stepping the optimal control.
+        double optimise = 0.0;
+
+        /// Duration of rolling out and filtering the optimal control.
+        double filter = 0.0;
+
+        inline Phases &operator+=(const Phases &other) {
+            sample += other.sample;
+            rollout += other.rollout;
+            optimise += other.optimise;
+            filter += other.filter;
+            return *this;
+        }
+    };
+
     /// The number of rollouts added to the configured rollouts. These are the
     /// zero control sample and negative of the previous optimal trajectory.
     static const constexpr std::int64_t s_static_rollouts = 2;
@@ -373,6 +506,13 @@ public:
         return m_update_duration;
     }
 
+    /**
+     * @brief Get the computation duration of each phase of the last update.
+     */
+    inline const Phases &get_update_phases() const {
+        return m_update_phases;
+    }
+
     /**
      * @brief Get the time of the last update.
      */
@@ -394,6 +534,44 @@ public:
         return m_rollout_count;
     }
 
+    /**
+     * @brief Get the number of sampled rollouts performed each update,
+     * excluding the static rollouts.
+     */
+    inline std::int64_t get_rollout_limit() const {
+        return m_active_rollout_count - s_static_rollouts;
+    }
+
+    /**
+     * @brief Limit the number of sampled rollouts performed each update.
+     *
+     * Used to shed computation when updates overrun. Rollouts beyond the limit
+     * are not sampled or rolled out and have a NaN cost, so do not contribute
+     * to the optimal control. The static rollouts are always performed.
+     *
+     * @param rollouts The number of sampled rollouts, clamped between one and
+     * the configured number of rollouts.
+     */
+    void set_rollout_limit(std::int64_t rollouts);
+
+    /**
+     * @brief Restart the sequence of rollout noise from a seed, so that
+     * updates from the same states are reproducible.
+     *
+     * @param seed The seed of the rollout noise.
+     */
+    inline void seed(std::uint64_t seed) {
+        m_gaussian.seed(seed);
+    }
+
+    /**
+     * @brief Get the number of rollouts performed by worker processes in the
+     * last update that had a valid cost.
+     */
+    inline std::int64_t get_remote_rollout_count() const {
+        return m_remote_rollout_count;
+    }
+
     /**
      * @brief Get the initial state of all the rollouts of the previous update
      * (or the initial state if update has not been called yet).
@@ -409,6 +587,22 @@ public:
         return m_weights;
     }
 
+    /**
+     * @brief Get the effective sample size of the last update rollout
+     * weights, the number of equally weighted rollouts with the same
+     * variance. Only the local rollouts are included when distributed.
+     */
+    inline double get_effective_sample_size() const {
+        return m_effective_sample_size;
+    }
+
+    /**
+     * @brief Get the cost to likelihood scale of the last update.
+     */
+    inline double get_cost_scale() const {
+        return m_cost_scale;
+    }
+
     /**
      * @brief Get the last update gradient.
      */
@@ -416,6 +610,14 @@ public:
         return m_gradient;
     }
 
+    /**
+     * @brief Get the recorder of the rollout states, or nullptr if the
+     * rollouts are not recorded.
+     */
+    inline const Recorder *get_recorder() const {
+        return m_recorder.get();
+    }
+
     /**
      * @brief Get the rollouts.
      */
@@ -446,7 +648,7 @@ public:
     }
 
     inline const Cost &get_optimal_cost() const {
-        return *m_cost[0];
+        return *m_optimal_cost;
     }
 
     inline const Dynamics &get_optimal_dynamics() const {
@@ -475,17 +677,78 @@ public:
 
 private:
 
+    /**
+     * @brief Constants derived from the configuration once on creation, so
+     * that updates only perform arithmetic.
+     */
+    struct Plan {
+
+        /// The number of time steps per rollout.
+        int step_count;
+
+        /// The cost discount factor raised to the power of each time step.
+        VectorXd discount;
+
+        /// The time of each step relative to the start of a rollout.
+        VectorXd step_time;
+
+        /// The minimum control replicated for each time step.
+        MatrixXd control_min;
+
+        /// The maximum control replicated for each time step.
+        MatrixXd control_max;
+
+        /// Maps the sampled noise parameters to control noise.
+        Parameterisation parameterisation;
+    };
+
+    /**
+     * @brief Validate a configuration and precompute its plan.
+     *
+     * @param configuration The configuration of the trajectory generator.
+     * @param state_dof The degrees of freedom of the dynamics state.
+     * @param control_dof The degrees of freedom of the dynamics control.
+     *
+     * @returns The plan on success, or std::nullopt if the configuration is
+     * invalid.
+     */
+    static std::optional<Plan> make_plan(
+        const Configuration &configuration,
+        int state_dof,
+        int control_dof
+    );
+
     /**
      * @brief Initialise the trajectory generator.
      * @param configuration The configuration of the trajectory generator.
+     * @param plan The precomputed plan of the configuration.
      */
     Trajectory(
         const Configuration &configuration,
+        Plan &&plan,
         std::unique_ptr<Dynamics> &&dynamics,
         std::unique_ptr<Cost> &&cost,
         std::unique_ptr<Filter> &&filter
     ) noexcept;
 
+    /**
+     * @brief Prepare the trajectory generator for real time updates.
+     *
+     * Sets the worker priorities and the priority of the calling control
+     * thread, touches the worker and control stacks and performs a warm up
+     * rollout from the initial state so that every rollout buffer and the
+     * dynamics and cost data of each thread are faulted in.
+     *
+     * @param realtime The real time configuration.
+     * @param initial_state The state to warm up from.
+     *
+     * @returns If preparation succeeded.
+     */
+    bool prepare_realtime(
+        const Configuration::Realtime &realtime,
+        const VectorXd &initial_state
+    );
+
     /**
      * @brief Sample the rollouts to simulate.
      * 
@@ -504,6 +767,15 @@ private:
      */
     void sample(double time);
 
+    /**
+     * @brief Sample new noise parameters for a rollout from a knot to the
+     * horison.
+     *
+     * @param index The index of the rollout to sample.
+     * @param first The first knot to sample.
+     */
+    void sample(std::int64_t index, std::int64_t first);
+
     /**
      * @brief Distributes rollout calculations amongst worker threads, and waits
      * for them to complete.
@@ -516,8 +788,10 @@ private:
      * @param rollout The rollout to store data in.
      * @param dynamics The dynamics object to use for rolling out.
      * @param cost The objective function to use to calculate rollout cost.
+     * @param states The recorder buffer to record the rollout states into,
+     * or nullptr if the rollout is not recorded.
      */
-    void rollout(Rollout *rollout, Dynamics *dynamics, Cost *cost);
+    void rollout(Rollout *rollout, Dynamics *dynamics, Cost *cost, double *states);
 
     /**
      * @brief Updates the optimal control trajectory.
@@ -535,6 +809,15 @@ private:
      */
     void optimise();
 
+    /**
+     * @brief Scale the cost scale by the ratio of the effective and target
+     * sample sizes of the last update, raised to the adaptation rate.
+     *
+     * Larger cost scales concentrate the weights on fewer rollouts, reducing
+     * the effective sample size.
+     */
+    void adapt_cost_scale();
+
     /**
      * @brief Rolls out and filters the optimal trajectory.
      * 
@@ -542,6 +825,9 @@ private:
      */
     void filter();
 
+    /// Constants precomputed from the configuration.
+    const Plan m_plan;
+
     /// The number of time steps per rollout.
     const int m_step_count;
 
@@ -551,6 +837,10 @@ private:
     /// The number of rollouts.
     const int m_rollout_count;
 
+    /// The number of rollouts performed each update, including the static
+    /// rollouts. At most the number of rollouts.
+    int m_active_rollout_count;
+
     /// The number of threads.
     const int m_thread_count;
 
@@ -566,6 +856,9 @@ private:
     /// The duration of the last update, in seconds.
     double m_update_duration;
 
+    /// The duration of each phase of the last update, in seconds.
+    Phases m_update_phases;
+
     /// The number of trajectory updates.
     std::size_t m_update_count;
 
@@ -578,6 +871,9 @@ private:
     /// Keeps track of individual cumulative cost of dynamics simulation rollouts.
     std::vector<std::unique_ptr<Cost>> m_cost;
 
+    /// The cost of the filtered optimal rollout.
+    std::unique_ptr<Cost> m_optimal_cost;
+
     /// Barrier to wait for thread concurrent rollout calculation to complete.
     std::vector<std::future<void>> m_futures;
 
@@ -590,6 +886,9 @@ private:
     /// The current time of trajectory generation.
     double m_rollout_time;
 
+    /// The time of each step of the current trajectory generation.
+    VectorXd m_rollout_step_time;
+
     /// The time of the last trajectory generation.
     double m_last_rollout_time;
 
@@ -602,11 +901,18 @@ private:
     /// The number of columns that was shifted to align with current time.
     std::int64_t m_shifted;
 
-    /// The discount factor of near future control actions.
-    const double m_cost_discount_factor;
-
     /// Scaling applied to the cost to likelyhood mapping.
-    const double m_cost_scale;
+    double m_cost_scale;
+
+    /// The adaptation of the cost scale, if enabled.
+    const std::optional<Configuration::CostScaleAdaptation> m_cost_scale_adaptation;
+
+    /// The effective sample size of the last update rollout weights.
+    double m_effective_sample_size;
+
+    /// The number of rollouts weighted with the cost scale in the last
+    /// update, or zero if the weights did not depend on the cost scale.
+    std::int64_t m_weighted_rollout_count;
 
     /// The control parameters applied at each step in the rollouts.
     std::vector<Rollout> m_rollouts;
@@ -617,6 +923,9 @@ private:
     /// The gradient applied to the optimal control trajectory.
     MatrixXd m_gradient;
 
+    /// The weighted sum of the local rollout noise parameters.
+    MatrixXd m_gradient_parameters;
+
     /// The scalar amount by which to add the gradient to the optimal control.
     const double m_gradient_step;
 
@@ -635,6 +944,19 @@ private:
     /// Mutex protecting concurrent access to the optimal control.
     std::mutex m_optimal_control_mutex;
 
+    /// The base seed of the rollout noise if distributed, that each sampled
+    /// rollout is seeded from by its index and the update.
+    std::optional<std::uint64_t> m_seed;
+
+    /// Distributes additional rollouts to worker processes. May be nullptr.
+    std::unique_ptr<distributed::Coordinator> m_coordinator;
+
+    /// The number of remote rollouts of the current update with a valid cost.
+    std::int64_t m_remote_rollout_count;
+
+    /// Records the states of a subset of the rollouts. May be nullptr.
+    std::unique_ptr<Recorder> m_recorder;
+
     /// The number of best rollouts to keep for warm starting the next update.
     const std::int64_t m_keep_best_rollouts;
 
@@ -647,12 +969,6 @@ private:
     /// If the trajectory should be bounded each time step.
     const bool m_bound_control;
 
-    /// The minimum control if bounded.
-    VectorXd m_control_min;
-
-    /// The maximum control if bounded.
-    VectorXd m_control_max;
-
     /// If the end of the trajectory is reached, the control to return.
     std::optional<VectorXd> m_control_default;
 };
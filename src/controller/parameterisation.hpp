@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include "controller/eigen.hpp"
+
+namespace mppi {
+
+/**
+ * @brief Maps the sampled noise parameters of a rollout to the control noise
+ * at each time step.
+ *
+ * Noise is only sampled for the active control degrees of freedom, at knots
+ * spread evenly over the horison and linearly interpolated in between. The
+ * parameters have a row per active degree of freedom and a column per knot.
+ * With every degree of freedom active and a knot per time step, the
+ * parameters are the control noise.
+ */
+class Parameterisation
+{
+public:
+
+    /**
+     * @brief Create a noise parameterisation.
+     *
+     * @param mask If each control degree of freedom is sampled, or all if not
+     * provided.
+     * @param knots The number of knots, or a knot per time step if not
+     * provided.
+     * @param control_dof The degrees of freedom of the control.
+     * @param step_count The number of time steps of a rollout.
+     *
+     * @returns The parameterisation on success or std::nullopt on failure.
+     */
+    static std::optional<Parameterisation> create(
+        const std::optional<std::vector<bool>> &mask,
+        const std::optional<unsigned int> &knots,
+        int control_dof,
+        int step_count
+    ) {
+        std::vector<bool> active = mask.value_or(std::vector<bool>(control_dof, true));
+
+        if ((int)active.size() != control_dof) {
+            std::cerr << "trajectory sample mask must have length " << control_dof << std::endl;
+            return std::nullopt;
+        }
+
+        if (std::find(active.begin(), active.end(), true) == active.end()) {
+            std::cerr << "trajectory sample mask must sample a degree of freedom" << std::endl;
+            return std::nullopt;
+        }
+
+        int knot_count = (int)knots.value_or(step_count);
+
+        // Interpolation needs a knot at each end, unless there is one step.
+        if (knot_count < std::min(2, step_count) || knot_count > step_count) {
+            std::cerr << "trajectory knots must be between 2 and the " << step_count
+                      << " time steps" << std::endl;
+            return std::nullopt;
+        }
+
+        return Parameterisation(active, knot_count, step_count);
+    }
+
+    /**
+     * @brief An empty parameterisation, for default construction.
+     */
+    Parameterisation() = default;
+
+    /**
+     * @brief Get the degrees of freedom of the control.
+     */
+    inline int get_control_dof() const {
+        return m_control_dof;
+    }
+
+    /**
+     * @brief Get the number of sampled degrees of freedom, the rows of the
+     * parameters.
+     */
+    inline int get_parameter_dof() const {
+        return (int)m_active.size();
+    }
+
+    /**
+     * @brief Get the number of time steps of a rollout.
+     */
+    inline int get_step_count() const {
+        return m_step_count;
+    }
+
+    /**
+     * @brief Get the number of knots, the columns of the parameters.
+     */
+    inline int get_knot_count() const {
+        return m_knot_count;
+    }
+
+    /**
+     * @brief Get the covariance of the sampled degrees of freedom.
+     * @param covariance The covariance of all control degrees of freedom.
+     * @returns The covariance of the parameters at a knot.
+     */
+    inline MatrixXd reduce(const MatrixXd &covariance) const {
+        return covariance(m_active, m_active);
+    }
+
+    /**
+     * @brief Add the noise at a time step to a control.
+     *
+     * @param control The control to add to.
+     * @param parameters The noise parameters.
+     * @param step The time step.
+     */
+    template<typename Parameters>
+    inline void add(
+        Eigen::Ref<VectorXd> control,
+        const Eigen::MatrixBase<Parameters> &parameters,
+        int step
+    ) const {
+        int lower = m_lower[step];
+        double fraction = m_fraction[step];
+
+        auto lower_noise = parameters.col(lower).template cast<double>();
+
+        if (fraction == 0.0) {
+            add(control, lower_noise);
+            return;
+        }
+
+        auto upper_noise = parameters.col(lower + 1).template cast<double>();
+        add(control, (1.0 - fraction) * lower_noise + fraction * upper_noise);
+    }
+
+    /**
+     * @brief Add the noise at every time step to a control trajectory.
+     *
+     * @param control The control trajectory to add to, with a column per time
+     * step.
+     * @param parameters The noise parameters.
+     */
+    template<typename Parameters>
+    inline void expand(MatrixXd &control, const Eigen::MatrixBase<Parameters> &parameters) const
+    {
+        for (int step = 0; step < m_step_count; ++step)
+            add(control.col(step), parameters, step);
+    }
+
+    /**
+     * @brief Set the parameters to a control trajectory sampled at the knots.
+     *
+     * @param parameters The noise parameters to set.
+     * @param control The control trajectory, with a column per time step.
+     */
+    template<typename Parameters>
+    inline void project(Eigen::MatrixBase<Parameters> &parameters, const MatrixXd &control) const
+    {
+        using Scalar = typename Parameters::Scalar;
+
+        for (int knot = 0; knot < m_knot_count; ++knot) {
+            auto [lower, fraction] = locate(control.cols(), knot_position(knot));
+
+            if (fraction == 0.0) {
+                parameters.col(knot) = control(m_active, lower).template cast<Scalar>();
+                continue;
+            }
+
+            parameters.col(knot) = (
+                (1.0 - fraction) * control(m_active, lower) +
+                fraction * control(m_active, lower + 1)
+            ).template cast<Scalar>();
+        }
+    }
+
+    /**
+     * @brief Shift the parameters forward in time in place, discarding the
+     * start of the horison.
+     *
+     * @param parameters The noise parameters to shift.
+     * @param steps The number of time steps to shift by.
+     *
+     * @returns The first knot past the end of the previous horison, from which
+     * the parameters must be resampled.
+     */
+    template<typename Parameters>
+    inline int shift(Eigen::MatrixBase<Parameters> &parameters, std::int64_t steps) const
+    {
+        using Scalar = typename Parameters::Scalar;
+
+        // Knots only read from knots at or after themselves, so can be
+        // updated in order.
+        for (int knot = 0; knot < m_knot_count; ++knot) {
+            double position = knot_position(knot) + (double)steps;
+            if (position > m_step_count - 1 + 1e-9)
+                return knot;
+
+            auto [lower, fraction] = locate(m_knot_count, position * m_knots_per_step);
+
+            if (fraction == 0.0) {
+                parameters.col(knot) = parameters.col(lower);
+                continue;
+            }
+
+            parameters.col(knot) = (
+                Scalar(1.0 - fraction) * parameters.col(lower) +
+                Scalar(fraction) * parameters.col(lower + 1)
+            ).eval();
+        }
+
+        return m_knot_count;
+    }
+
+private:
+
+    /**
+     * @brief Initialise the parameterisation.
+     *
+     * @param mask If each control degree of freedom is sampled.
+     * @param knot_count The number of knots.
+     * @param step_count The number of time steps of a rollout.
+     */
+    Parameterisation(const std::vector<bool> &mask, int knot_count, int step_count)
+        : m_control_dof((int)mask.size())
+        , m_knot_count(knot_count)
+        , m_step_count(step_count)
+        , m_knots_per_step(
+            step_count > 1 ? (double)(knot_count - 1) / (double)(step_count - 1) : 1.0
+          )
+        , m_all_active(std::find(mask.begin(), mask.end(), false) == mask.end())
+    {
+        for (int dof = 0; dof < (int)mask.size(); ++dof) {
+            if (mask[dof])
+                m_active.push_back(dof);
+        }
+
+        m_lower.resize(step_count);
+        m_fraction.resize(step_count);
+
+        for (int step = 0; step < step_count; ++step) {
+            auto [lower, fraction] = locate(knot_count, step * m_knots_per_step);
+            m_lower[step] = lower;
+            m_fraction[step] = fraction;
+        }
+    }
+
+    /**
+     * @brief Get the time step of a knot.
+     */
+    inline double knot_position(int knot) const {
+        return knot / m_knots_per_step;
+    }
+
+    /**
+     * @brief Split a position between columns into the lower column and the
+     * fraction towards the next.
+     *
+     * @param columns The number of columns.
+     * @param position The position in columns.
+     *
+     * @returns The lower column and the fraction, which is zero at the last
+     * column.
+     */
+    static inline std::pair<int, double> locate(Eigen::Index columns, double position)
+    {
+        int lower = (int)std::floor(position + 1e-9);
+        if (lower >= columns - 1)
+            return {(int)columns - 1, 0.0};
+
+        double fraction = position - lower;
+        if (std::abs(fraction) < 1e-9)
+            fraction = 0.0;
+
+        return {lower, fraction};
+    }
+
+    /**
+     * @brief Add noise of the active degrees of freedom to a control.
+     */
+    template<typename Noise>
+    inline void add(Eigen::Ref<VectorXd> control, const Noise &noise) const
+    {
+        if (m_all_active) {
+            control += noise;
+            return;
+        }
+
+        for (std::size_t i = 0; i < m_active.size(); ++i)
+            control[m_active[i]] += noise.coeff(i);
+    }
+
+    /// The degrees of freedom of the control.
+    int m_control_dof = 0;
+
+    /// The number of knots.
+    int m_knot_count = 0;
+
+    /// The number of time steps of a rollout.
+    int m_step_count = 0;
+
+    /// The number of knots per time step, at most one.
+    double m_knots_per_step = 1.0;
+
+    /// If every control degree of freedom is sampled.
+    bool m_all_active = true;
+
+    /// The indexes of the sampled control degrees of freedom.
+    std::vector<int> m_active;
+
+    /// The knot before each time step.
+    std::vector<int> m_lower;
+
+    /// The fraction of each time step between its lower and upper knot.
+    std::vector<double> m_fraction;
+};
+
+} // namespace mppi
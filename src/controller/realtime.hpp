@@ -0,0 +1,109 @@
+#pragma once
+
+// Real time process utilities. Only supported on linux, elsewhere each
+// function reports failure.
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef __linux__
+    #include <malloc.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/mman.h>
+#endif
+
+namespace realtime {
+
+/// The number of bytes of stack touched by prefault_stack().
+static constexpr const std::size_t s_stack_prefault = 256 * 1024;
+
+/**
+ * @brief Lock all current and future process memory into RAM.
+ *
+ * Also stops the allocator returning freed memory to the operating system or
+ * serving allocations with new mappings, so that memory reused by the hot path
+ * is never faulted in again.
+ *
+ * @returns If the memory was locked. Requires CAP_IPC_LOCK or a sufficient
+ * memlock limit.
+ */
+inline bool lock_memory()
+{
+#ifdef __linux__
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "failed to lock process memory: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    return true;
+#else
+    std::cerr << "locking process memory is unsupported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+/**
+ * @brief Set a thread to the first in first out real time scheduling policy.
+ *
+ * @param thread The native handle of the thread.
+ * @param priority The priority between 1 and 99. Higher preempts lower.
+ *
+ * @returns If the priority was set. Requires CAP_SYS_NICE or a sufficient
+ * rtprio limit.
+ */
+inline bool set_priority(std::thread::native_handle_type thread, int priority)
+{
+#ifdef __linux__
+    sched_param parameters {};
+    parameters.sched_priority = priority;
+
+    int error = pthread_setschedparam(thread, SCHED_FIFO, &parameters);
+    if (error != 0) {
+        std::cerr << "failed to set thread priority " << priority << ": "
+                  << std::strerror(error) << std::endl;
+        return false;
+    }
+
+    return true;
+#else
+    std::cerr << "real time thread priorities are unsupported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+/**
+ * @brief Set the calling thread to the first in first out real time scheduling
+ * policy.
+ *
+ * @param priority The priority between 1 and 99. Higher preempts lower.
+ * @returns If the priority was set.
+ */
+inline bool set_priority(int priority)
+{
+#ifdef __linux__
+    return set_priority(pthread_self(), priority);
+#else
+    std::cerr << "real time thread priorities are unsupported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+/**
+ * @brief Touch the calling thread's stack so that later calls do not page
+ * fault. Call after lock_memory() so the pages stay resident.
+ */
+[[gnu::noinline]] inline void prefault_stack()
+{
+    [[maybe_unused]] volatile unsigned char stack[s_stack_prefault];
+
+    // One write per page.
+    for (std::size_t i = 0; i < s_stack_prefault; i += 4096)
+        stack[i] = 0;
+}
+
+} // namespace realtime
@@ -0,0 +1,189 @@
+#include "controller/recorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+namespace mppi {
+
+std::unique_ptr<Recorder> Recorder::create(
+    const Configuration &configuration,
+    int state_dof,
+    int steps,
+    std::int64_t rollouts,
+    unsigned int threads
+) {
+    if (configuration.best < 0 || configuration.sampled < 0) {
+        std::cerr << "recorder best and sampled rollouts cannot be negative" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.best > rollouts || configuration.sampled > rollouts) {
+        std::cerr << "recorder cannot record more than the " << rollouts
+                  << " rollouts" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<unsigned int> indexes(state_dof);
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    if (configuration.states) {
+        indexes = *configuration.states;
+
+        if (indexes.empty()) {
+            std::cerr << "recorder must record at least one state" << std::endl;
+            return nullptr;
+        }
+
+        for (unsigned int index : indexes) {
+            if (index >= (unsigned int)state_dof) {
+                std::cerr << "recorder state index " << index
+                          << " exceeds the state dof " << state_dof << std::endl;
+                return nullptr;
+            }
+        }
+    }
+
+    return std::unique_ptr<Recorder>(
+        new Recorder(configuration, std::move(indexes), steps, threads)
+    );
+}
+
+Recorder::Recorder(
+    const Configuration &configuration,
+    std::vector<unsigned int> &&indexes,
+    int steps,
+    unsigned int threads
+) : m_state_dof((int)indexes.size())
+  , m_steps(steps)
+  , m_block_size((std::size_t)indexes.size() * steps)
+  , m_states(configuration.states.value_or(std::vector<unsigned int>()))
+  , m_indexes(std::move(indexes))
+  , m_threads(threads)
+  , m_sampled_states(m_state_dof, steps * configuration.sampled)
+  , m_sampled(configuration.sampled)
+  , m_stride(1)
+  , m_best(configuration.best)
+{
+    m_sampled_states.setZero();
+    for (std::size_t i = 0; i < m_sampled.size(); ++i)
+        m_sampled[i].block = i;
+
+    // Only the best rollouts need a spare block, since sampled rollouts are
+    // recorded directly into their slot.
+    for (Thread &thread : m_threads) {
+        std::size_t blocks = m_best > 0 ? m_best + 1 : 0;
+
+        thread.states.setZero(m_state_dof, steps * blocks);
+        thread.best.resize(m_best);
+        for (std::size_t i = 0; i < m_best; ++i)
+            thread.best[i].block = i;
+        thread.spare = m_best;
+    }
+
+    m_candidates.reserve(m_best * threads);
+    m_records.reserve(m_best + m_sampled.size());
+}
+
+void Recorder::reset(std::int64_t rollouts)
+{
+    for (Thread &thread : m_threads) {
+        for (Slot &slot : thread.best) {
+            slot.rollout = -1;
+            slot.cost = std::numeric_limits<double>::infinity();
+        }
+    }
+
+    for (Slot &slot : m_sampled)
+        slot.rollout = -1;
+
+    if (!m_sampled.empty())
+        m_stride = std::max<std::int64_t>(1, rollouts / (std::int64_t)m_sampled.size());
+
+    m_records.clear();
+}
+
+double *Recorder::begin(unsigned int thread, std::int64_t rollout)
+{
+    std::int64_t sample = get_sample(rollout);
+    if (sample >= 0)
+        return m_sampled_states.data() + m_sampled[sample].block * m_block_size;
+
+    if (m_best == 0)
+        return nullptr;
+
+    return get_block(m_threads[thread], m_threads[thread].spare);
+}
+
+void Recorder::end(unsigned int thread, std::int64_t rollout, double cost)
+{
+    Thread &buffer = m_threads[thread];
+    std::int64_t sample = get_sample(rollout);
+
+    if (sample >= 0) {
+        m_sampled[sample].rollout = rollout;
+        m_sampled[sample].cost = cost;
+    }
+
+    if (m_best == 0 || std::isnan(cost))
+        return;
+
+    // Replace the highest cost best rollout of the thread, if any.
+    auto worst = std::max_element(
+        buffer.best.begin(),
+        buffer.best.end(),
+        [](const Slot &left, const Slot &right) { return left.cost < right.cost; }
+    );
+
+    if (!(cost < worst->cost))
+        return;
+
+    // Sampled rollouts were not recorded into the spare block.
+    if (sample >= 0) {
+        std::copy_n(
+            m_sampled_states.data() + m_sampled[sample].block * m_block_size,
+            m_block_size,
+            get_block(buffer, buffer.spare)
+        );
+    }
+
+    std::swap(worst->block, buffer.spare);
+    worst->rollout = rollout;
+    worst->cost = cost;
+}
+
+void Recorder::collect()
+{
+    m_candidates.clear();
+    m_records.clear();
+
+    for (Thread &thread : m_threads) {
+        for (const Slot &slot : thread.best) {
+            if (slot.rollout >= 0)
+                m_candidates.push_back({slot.rollout, slot.cost, get_block(thread, slot.block)});
+        }
+    }
+
+    std::size_t best = std::min(m_best, m_candidates.size());
+    std::partial_sort(
+        m_candidates.begin(),
+        m_candidates.begin() + best,
+        m_candidates.end(),
+        [](const Record &left, const Record &right) { return left.cost < right.cost; }
+    );
+
+    m_records.insert(m_records.end(), m_candidates.begin(), m_candidates.begin() + best);
+
+    for (const Slot &slot : m_sampled) {
+        if (slot.rollout >= 0) {
+            m_records.push_back({
+                slot.rollout,
+                slot.cost,
+                m_sampled_states.data() + slot.block * m_block_size
+            });
+        }
+    }
+}
+
+} // namespace mppi
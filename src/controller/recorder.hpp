@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "controller/eigen.hpp"
+#include "controller/json.hpp"
+
+namespace mppi {
+
+/**
+ * @brief Records the states of a subset of the rollouts of each update.
+ *
+ * The lowest cost rollouts and a subset sampled evenly over the rollouts are
+ * recorded. Since the cost of a rollout is only known once it completes, each
+ * thread records its rollout into a spare buffer, and swaps it with its
+ * highest cost best rollout if it is lower cost. The best rollouts of each
+ * thread are merged once all the rollouts are complete. All buffers are
+ * allocated on creation.
+ *
+ * Recording is thread safe when each thread only records the rollouts it
+ * performs, into its own buffer.
+ */
+class Recorder
+{
+public:
+
+    struct Configuration {
+
+        /// The number of lowest cost rollouts to record each update.
+        std::int64_t best;
+
+        /// The number of rollouts to record each update, sampled evenly over
+        /// the rollouts.
+        std::int64_t sampled;
+
+        /// The indexes of the state degrees of freedom to record. The whole
+        /// state is recorded if not provided.
+        std::optional<std::vector<unsigned int>> states;
+
+        // JSON conversion for recorder configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(Configuration, best, sampled, states)
+    };
+
+    /**
+     * @brief A recorded rollout.
+     */
+    struct Record {
+
+        /// The index of the rollout.
+        std::int64_t rollout;
+
+        /// The cost of the rollout. The states after the step the rollout
+        /// failed at are not recorded if NaN.
+        double cost;
+
+        /// The recorded state at each step, stored column major with a column
+        /// per step.
+        const double *states;
+    };
+
+    /**
+     * @brief Create a rollout recorder.
+     *
+     * @param configuration The configuration of the recorder.
+     * @param state_dof The degrees of freedom of the dynamics state.
+     * @param steps The number of time steps of each rollout.
+     * @param rollouts The number of rollouts of each update.
+     * @param threads The number of threads performing rollouts.
+     *
+     * @returns A pointer to the recorder on success or nullptr on failure.
+     */
+    static std::unique_ptr<Recorder> create(
+        const Configuration &configuration,
+        int state_dof,
+        int steps,
+        std::int64_t rollouts,
+        unsigned int threads
+    );
+
+    /**
+     * @brief Begin recording an update.
+     * @param rollouts The number of rollouts performed in the update.
+     */
+    void reset(std::int64_t rollouts);
+
+    /**
+     * @brief Begin recording a rollout.
+     *
+     * @param thread The thread performing the rollout.
+     * @param rollout The index of the rollout.
+     *
+     * @returns The buffer to record the rollout states into, or nullptr if
+     * the rollout is not recorded.
+     */
+    double *begin(unsigned int thread, std::int64_t rollout);
+
+    /**
+     * @brief Record the state of a rollout at a step.
+     *
+     * @param states The buffer of the rollout returned by begin().
+     * @param step The step of the rollout.
+     * @param state The state at the step.
+     */
+    inline void record(double *states, int step, const VectorXd &state) const
+    {
+        double *column = states + (std::size_t)step * m_state_dof;
+
+        if (m_states.empty()) {
+            Eigen::Map<VectorXd>(column, m_state_dof) = state;
+            return;
+        }
+
+        for (int i = 0; i < m_state_dof; ++i)
+            column[i] = state[m_states[i]];
+    }
+
+    /**
+     * @brief Finish recording a rollout.
+     *
+     * @param thread The thread performing the rollout.
+     * @param rollout The index of the rollout.
+     * @param cost The cost of the rollout.
+     */
+    void end(unsigned int thread, std::int64_t rollout, double cost);
+
+    /**
+     * @brief Merge the records of each thread once all rollouts of the
+     * update are complete.
+     */
+    void collect();
+
+    /**
+     * @brief Get the records of the last update.
+     *
+     * The best rollouts in order of increasing cost, followed by the sampled
+     * rollouts in order of rollout index. Valid until the next reset.
+     */
+    inline const std::vector<Record> &get_records() const {
+        return m_records;
+    }
+
+    /**
+     * @brief Get the number of recorded state degrees of freedom.
+     */
+    inline int get_state_dof() const {
+        return m_state_dof;
+    }
+
+    /**
+     * @brief Get the number of recorded time steps of each rollout.
+     */
+    inline int get_step_count() const {
+        return m_steps;
+    }
+
+    /**
+     * @brief Get the indexes of the recorded state degrees of freedom.
+     */
+    inline const std::vector<unsigned int> &get_state_indexes() const {
+        return m_indexes;
+    }
+
+private:
+
+    /**
+     * @brief A slot for a recorded rollout.
+     */
+    struct Slot {
+
+        /// The index of the rollout, or -1 if empty.
+        std::int64_t rollout = -1;
+
+        /// The cost of the rollout.
+        double cost = std::numeric_limits<double>::infinity();
+
+        /// The index of the block of the buffer storing the rollout.
+        std::size_t block = 0;
+    };
+
+    /**
+     * @brief The best rollouts of a thread.
+     */
+    struct Thread {
+
+        /// The recorded states, with a block of columns per slot and a spare
+        /// block for the current rollout.
+        MatrixXd states;
+
+        /// The slot of each best rollout.
+        std::vector<Slot> best;
+
+        /// The block recording the current rollout.
+        std::size_t spare;
+    };
+
+    Recorder(
+        const Configuration &configuration,
+        std::vector<unsigned int> &&indexes,
+        int steps,
+        unsigned int threads
+    );
+
+    /**
+     * @brief Get the buffer of a block of a thread.
+     */
+    inline double *get_block(Thread &thread, std::size_t block)
+    {
+        return thread.states.data() + block * m_block_size;
+    }
+
+    /**
+     * @brief Get the sampled slot of a rollout.
+     * @returns The index of the sampled slot, or -1 if the rollout is not
+     * sampled.
+     */
+    inline std::int64_t get_sample(std::int64_t rollout) const
+    {
+        if (m_sampled.empty() || rollout % m_stride != 0)
+            return -1;
+
+        std::int64_t sample = rollout / m_stride;
+        return sample < (std::int64_t)m_sampled.size() ? sample : -1;
+    }
+
+    /// The number of recorded state degrees of freedom.
+    const int m_state_dof;
+
+    /// The number of time steps of each rollout.
+    const int m_steps;
+
+    /// The number of values of each recorded rollout.
+    const std::size_t m_block_size;
+
+    /// The indexes of the recorded state degrees of freedom, or empty if the
+    /// whole state is recorded.
+    const std::vector<unsigned int> m_states;
+
+    /// The indexes of the recorded state degrees of freedom.
+    const std::vector<unsigned int> m_indexes;
+
+    /// The best rollouts of each thread.
+    std::vector<Thread> m_threads;
+
+    /// The states of the sampled rollouts, with a block of columns per slot.
+    MatrixXd m_sampled_states;
+
+    /// The slot of each sampled rollout.
+    std::vector<Slot> m_sampled;
+
+    /// The number of rollouts between each sampled rollout.
+    std::int64_t m_stride;
+
+    /// The number of best rollouts to record.
+    std::size_t m_best;
+
+    /// Buffer of the best rollouts of every thread to merge.
+    std::vector<Record> m_candidates;
+
+    /// The records of the last update.
+    std::vector<Record> m_records;
+};
+
+} // namespace mppi
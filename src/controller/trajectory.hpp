@@ -380,7 +380,7 @@ public:
      */
     inline Vector3d get_position(double time) override;
 
-private:
+protected:
 
     /**
      * @brief Initialise a new lissajous trajectory.
@@ -388,6 +388,8 @@ private:
      */
     inline LissajousTrajectory(const Configuration &configuration);
 
+private:
+
     /// The configuration of the lissajous trajectory.
     Configuration m_configuration;
 };
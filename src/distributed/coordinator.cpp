@@ -0,0 +1,222 @@
+#include "distributed/coordinator.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace distributed {
+
+std::unique_ptr<Coordinator> Coordinator::create(
+    const Configuration &configuration,
+    std::int64_t first,
+    int state_dof,
+    int control_dof,
+    int steps,
+    double time_step
+) {
+    if (configuration.workers.empty()) {
+        std::cerr << "distributed trajectory must have at least one worker" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.rollouts < 1) {
+        std::cerr << "distributed worker rollouts must be greater than zero" << std::endl;
+        return nullptr;
+    }
+
+    if (!(configuration.timeout >= 0.0)) {
+        std::cerr << "distributed worker timeout cannot be negative" << std::endl;
+        return nullptr;
+    }
+
+    Hello hello {
+        .state_dof = (std::uint32_t)state_dof,
+        .control_dof = (std::uint32_t)control_dof,
+        .steps = (std::uint32_t)steps,
+        .reserved = 0,
+        .time_step = time_step
+    };
+
+    auto coordinator = std::unique_ptr<Coordinator>(new Coordinator(configuration, hello));
+
+    for (const std::string &address : configuration.workers) {
+        auto socket = Socket::connect(address);
+        if (!socket) {
+            std::cerr << "failed to connect to worker " << address << std::endl;
+            return nullptr;
+        }
+
+        // A worker that hangs fails the send or receive, and is dropped
+        // instead of stalling the update.
+        if (configuration.timeout > 0.0 && !socket->set_timeout(configuration.timeout))
+            return nullptr;
+
+        Hello reply;
+        bool handshake = (
+            send_message(*socket, Message::HELLO, std::make_pair(&hello, sizeof(hello))) &&
+            receive_header(*socket, Message::HELLO, sizeof(Hello)) &&
+            socket->receive(&reply, sizeof(reply))
+        );
+
+        if (!handshake) {
+            std::cerr << "failed handshake with worker " << address << std::endl;
+            return nullptr;
+        }
+
+        if (reply.state_dof != hello.state_dof ||
+            reply.control_dof != hello.control_dof ||
+            reply.steps != hello.steps ||
+            reply.time_step != hello.time_step) {
+            std::cerr << "worker " << address << " has state dof " << reply.state_dof
+                      << ", control dof " << reply.control_dof
+                      << ", " << reply.steps << " steps of " << reply.time_step
+                      << "s, which does not match the trajectory" << std::endl;
+            return nullptr;
+        }
+
+        // Remote rollouts are numbered after the local rollouts and each
+        // other, so that every worker regenerates a distinct range of seeds.
+        std::int64_t offset = (std::int64_t)coordinator->m_workers.size() * configuration.rollouts;
+
+        coordinator->m_workers.push_back(Worker {
+            .address = address,
+            .socket = std::move(socket),
+            .first = first + offset
+        });
+    }
+
+    return coordinator;
+}
+
+Coordinator::Coordinator(const Configuration &configuration, const Hello &hello)
+  : m_rollouts(configuration.rollouts)
+  , m_seed(configuration.seed)
+  , m_workers()
+  , m_costs(configuration.rollouts)
+  , m_sum(hello.control_dof, hello.steps)
+  , m_minimum(NAN)
+  , m_maximum(NAN)
+{}
+
+void Coordinator::dispatch(
+    const VectorXd &state,
+    double time,
+    const MatrixXd &nominal,
+    std::uint64_t update
+) {
+    for (std::size_t index = 0; index < m_workers.size(); ++index) {
+        Worker &worker = m_workers[index];
+
+        Job job {
+            .seed = m_seed,
+            .update = update,
+            .first = worker.first,
+            .count = m_rollouts,
+            .time = time
+        };
+
+        bool sent = send_message(
+            *worker.socket,
+            Message::JOB,
+            std::make_pair(&job, sizeof(job)),
+            std::make_pair(state.data(), sizeof(double) * state.size()),
+            std::make_pair(nominal.data(), sizeof(double) * nominal.size())
+        );
+
+        if (!sent)
+            drop(index--, "failed to send job");
+    }
+}
+
+std::int64_t Coordinator::collect_costs()
+{
+    m_minimum = std::numeric_limits<double>::infinity();
+    m_maximum = -std::numeric_limits<double>::infinity();
+
+    std::int64_t valid = 0;
+    const std::size_t size = sizeof(double) * m_costs.size();
+
+    for (std::size_t index = 0; index < m_workers.size(); ++index) {
+        Worker &worker = m_workers[index];
+
+        bool received = (
+            receive_header(*worker.socket, Message::COSTS, size) &&
+            worker.socket->receive(m_costs.data(), size)
+        );
+
+        if (!received) {
+            drop(index--, "failed to receive costs");
+            continue;
+        }
+
+        for (double cost : m_costs) {
+            if (std::isnan(cost))
+                continue;
+
+            m_minimum = std::min(m_minimum, cost);
+            m_maximum = std::max(m_maximum, cost);
+            ++valid;
+        }
+    }
+
+    if (valid == 0) {
+        m_minimum = NAN;
+        m_maximum = NAN;
+    }
+
+    return valid;
+}
+
+void Coordinator::accumulate(
+    double minimum,
+    double difference,
+    double cost_scale,
+    MatrixXd &sum,
+    double &total
+) {
+    Weight weight {
+        .minimum = minimum,
+        .difference = difference,
+        .cost_scale = cost_scale
+    };
+
+    // Send to every worker before receiving, so that they sum concurrently.
+    for (std::size_t index = 0; index < m_workers.size(); ++index) {
+        Worker &worker = m_workers[index];
+        if (!send_message(*worker.socket, Message::WEIGHT, std::make_pair(&weight, sizeof(weight))))
+            drop(index--, "failed to send weight");
+    }
+
+    const std::size_t size = sizeof(double) * m_sum.size();
+
+    for (std::size_t index = 0; index < m_workers.size(); ++index) {
+        Worker &worker = m_workers[index];
+
+        double likelihood;
+        bool received = (
+            receive_header(*worker.socket, Message::SUM, sizeof(likelihood) + size) &&
+            worker.socket->receive(&likelihood, sizeof(likelihood)) &&
+            worker.socket->receive(m_sum.data(), size)
+        );
+
+        if (!received) {
+            drop(index--, "failed to receive sum");
+            continue;
+        }
+
+        if (difference > 0.0) {
+            total += likelihood;
+            sum += m_sum;
+        }
+    }
+}
+
+void Coordinator::drop(std::size_t index, const char *reason)
+{
+    std::cerr << "dropping worker " << m_workers[index].address << ": "
+              << reason << std::endl;
+
+    m_workers.erase(m_workers.begin() + index);
+}
+
+} // namespace distributed
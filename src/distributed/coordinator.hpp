@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller/eigen.hpp"
+#include "controller/json.hpp"
+#include "distributed/protocol.hpp"
+
+namespace distributed {
+
+/**
+ * @brief Distributes rollouts of a trajectory update to worker processes.
+ *
+ * Each worker is sent the initial state, the nominal control and a range of
+ * rollout seeds, and only returns the cost of each rollout and the likelihood
+ * weighted sum of its noise. Workers that fail, or do not respond within the
+ * timeout, are dropped from later updates.
+ */
+class Coordinator
+{
+public:
+
+    /**
+     * @brief Configuration of the rollout workers.
+     */
+    struct Configuration {
+
+        /// The address of each worker, a unix socket path or IPv4 host:port.
+        std::vector<std::string> workers;
+
+        /// The number of rollouts performed by each worker per update.
+        std::int64_t rollouts;
+
+        /// The base seed of all rollout noise.
+        std::uint64_t seed;
+
+        /// The maximum time in seconds to wait on a worker connection, or
+        /// zero to wait indefinitely. Must cover the worker rollouts.
+        double timeout;
+
+        // JSON conversion for distributed configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(Configuration, workers, rollouts, seed, timeout)
+    };
+
+    /**
+     * @brief Connect to the workers of a trajectory.
+     *
+     * @param configuration The worker configuration.
+     * @param first The index of the first remote rollout, after the local
+     * rollouts.
+     * @param state_dof The degrees of freedom of the state.
+     * @param control_dof The degrees of freedom of the control.
+     * @param steps The number of time steps of a rollout.
+     * @param time_step The time step of a rollout.
+     *
+     * @returns A pointer to the coordinator on success or nullptr on failure.
+     */
+    static std::unique_ptr<Coordinator> create(
+        const Configuration &configuration,
+        std::int64_t first,
+        int state_dof,
+        int control_dof,
+        int steps,
+        double time_step
+    );
+
+    /**
+     * @brief Send an update to each worker.
+     *
+     * Workers begin rolling out while the local rollouts are performed.
+     *
+     * @param state The initial state of the rollouts.
+     * @param time The time of the initial state.
+     * @param nominal The nominal control the noise is added to.
+     * @param update The index of the update, for seeding.
+     */
+    void dispatch(
+        const VectorXd &state,
+        double time,
+        const MatrixXd &nominal,
+        std::uint64_t update
+    );
+
+    /**
+     * @brief Wait for the rollout costs of each worker.
+     * @returns The number of remote rollouts with a valid cost.
+     */
+    std::int64_t collect_costs();
+
+    /**
+     * @brief Get the minimum cost of the collected remote rollouts.
+     */
+    inline double get_minimum() const {
+        return m_minimum;
+    }
+
+    /**
+     * @brief Get the maximum cost of the collected remote rollouts.
+     */
+    inline double get_maximum() const {
+        return m_maximum;
+    }
+
+    /**
+     * @brief Complete an update, adding the worker likelihoods and likelihood
+     * weighted noise to the local sums.
+     *
+     * Must be called once after each collection, with a zero difference if
+     * the update is skipped.
+     *
+     * @param minimum The minimum cost of all rollouts.
+     * @param difference The maximum minus the minimum cost of all rollouts.
+     * @param cost_scale The cost to likelihood scale.
+     * @param sum The unnormalised likelihood weighted noise to add to.
+     * @param total The total likelihood to add to.
+     */
+    void accumulate(
+        double minimum,
+        double difference,
+        double cost_scale,
+        MatrixXd &sum,
+        double &total
+    );
+
+    /**
+     * @brief Get the number of workers still connected.
+     */
+    inline std::size_t get_worker_count() const {
+        return m_workers.size();
+    }
+
+private:
+
+    /**
+     * @brief A connected worker.
+     */
+    struct Worker {
+
+        /// The address of the worker, for reporting.
+        std::string address;
+
+        /// The connection to the worker.
+        std::unique_ptr<Socket> socket;
+
+        /// The index of the first rollout of the worker.
+        std::int64_t first;
+    };
+
+    Coordinator(const Configuration &configuration, const Hello &hello);
+
+    /**
+     * @brief Disconnect a failed worker.
+     * @param index The index of the worker.
+     * @param reason The reason it failed.
+     */
+    void drop(std::size_t index, const char *reason);
+
+    /// The number of rollouts performed by each worker.
+    const std::int64_t m_rollouts;
+
+    /// The base seed of the rollout noise.
+    const std::uint64_t m_seed;
+
+    /// The connected workers.
+    std::vector<Worker> m_workers;
+
+    /// Buffer of the costs received from a worker.
+    std::vector<double> m_costs;
+
+    /// Buffer of the noise sum received from a worker.
+    MatrixXd m_sum;
+
+    /// The minimum cost of the collected remote rollouts.
+    double m_minimum;
+
+    /// The maximum cost of the collected remote rollouts.
+    double m_maximum;
+};
+
+} // namespace distributed
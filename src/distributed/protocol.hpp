@@ -0,0 +1,178 @@
+#pragma once
+
+// Messages exchanged between a coordinating trajectory and its rollout
+// workers. Both ends are the same build on the same machine, so values are
+// sent in native byte order.
+//
+// A coordinator connects and sends HELLO, which the worker answers with HELLO
+// if the dimensions match. Then for each update:
+//
+// 1. The coordinator sends JOB with the initial state and nominal control.
+// 2. The worker rolls out its seeded samples and replies COSTS.
+// 3. The coordinator sends WEIGHT with the cost range of all rollouts.
+// 4. The worker regenerates its samples from the seed and replies SUM, the
+//    sum of the sample likelihoods and the likelihood weighted noise.
+
+#include <cstdint>
+
+#include "distributed/socket.hpp"
+
+namespace distributed {
+
+/**
+ * @brief The type of a message.
+ */
+enum class Message : std::uint32_t {
+    HELLO = 1,
+    JOB = 2,
+    COSTS = 3,
+    WEIGHT = 4,
+    SUM = 5
+};
+
+/**
+ * @brief Precedes each message.
+ */
+struct Header {
+
+    /// The type of the message.
+    Message type;
+
+    /// Unused padding.
+    std::uint32_t reserved;
+
+    /// The number of bytes following the header.
+    std::uint64_t size;
+};
+
+/**
+ * @brief The dimensions both ends must agree on. Sent by both ends on
+ * connection.
+ */
+struct Hello {
+
+    /// The degrees of freedom of the state.
+    std::uint32_t state_dof;
+
+    /// The degrees of freedom of the control.
+    std::uint32_t control_dof;
+
+    /// The number of time steps in a rollout.
+    std::uint32_t steps;
+
+    /// Unused padding.
+    std::uint32_t reserved;
+
+    /// The time step of a rollout.
+    double time_step;
+};
+
+/**
+ * @brief A batch of rollouts to evaluate. Followed by the initial state and
+ * the column major nominal control trajectory.
+ */
+struct Job {
+
+    /// The base seed of the rollout noise.
+    std::uint64_t seed;
+
+    /// The update the rollouts belong to.
+    std::uint64_t update;
+
+    /// The index of the first rollout, for seeding.
+    std::int64_t first;
+
+    /// The number of rollouts.
+    std::int64_t count;
+
+    /// The time of the initial state.
+    double time;
+};
+
+/**
+ * @brief The cost range of all rollouts, used to map costs to likelihoods.
+ */
+struct Weight {
+
+    /// The minimum cost of all rollouts.
+    double minimum;
+
+    /// The maximum minus the minimum cost of all rollouts. Zero if the update
+    /// is skipped, in which case the sum is zero.
+    double difference;
+
+    /// The cost to likelihood scale.
+    double cost_scale;
+};
+
+/**
+ * @brief Get the seed of the noise of one rollout.
+ *
+ * Each rollout has an independent stream, so that any process can regenerate
+ * the noise of any rollout.
+ *
+ * @param seed The base seed.
+ * @param update The update the rollout belongs to.
+ * @param rollout The index of the rollout.
+ *
+ * @returns The seed of the rollout noise.
+ */
+inline std::uint64_t rollout_seed(
+    std::uint64_t seed,
+    std::uint64_t update,
+    std::uint64_t rollout
+) {
+    // splitmix64 finaliser.
+    auto mix = [](std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    };
+
+    return mix(seed ^ mix(update ^ mix(rollout)));
+}
+
+/**
+ * @brief Send a message header followed by a number of buffers.
+ *
+ * @param socket The socket to send on.
+ * @param type The type of the message.
+ * @param buffers Pairs of pointers and byte sizes.
+ *
+ * @returns If the whole message was sent.
+ */
+template<typename... Buffers>
+bool send_message(Socket &socket, Message type, Buffers... buffers)
+{
+    Header header {
+        .type = type,
+        .reserved = 0,
+        .size = (0 + ... + buffers.second)
+    };
+
+    return (
+        socket.send(&header, sizeof(header)) &&
+        (... && socket.send(buffers.first, buffers.second))
+    );
+}
+
+/**
+ * @brief Receive a message header and check its type and size.
+ *
+ * @param socket The socket to receive on.
+ * @param type The expected type of the message.
+ * @param size The expected number of bytes following the header.
+ *
+ * @returns If a header of the expected type and size was received.
+ */
+inline bool receive_header(Socket &socket, Message type, std::uint64_t size)
+{
+    Header header;
+    if (!socket.receive(&header, sizeof(header)))
+        return false;
+
+    return header.type == type && header.size == size;
+}
+
+} // namespace distributed
@@ -0,0 +1,299 @@
+#include "distributed/socket.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace distributed {
+
+#ifdef __linux__
+
+namespace {
+
+/**
+ * @brief A parsed socket address.
+ */
+struct Address {
+
+    /// The address family, AF_UNIX or AF_INET.
+    int family;
+
+    /// Storage for either address type.
+    sockaddr_storage storage;
+
+    /// The length of the address in storage.
+    socklen_t length;
+};
+
+/**
+ * @brief Parse a unix socket path or numeric IPv4 host:port address.
+ *
+ * @param string The address to parse.
+ * @param address The address to fill.
+ *
+ * @returns If the address was valid.
+ */
+bool parse(const std::string &string, Address &address)
+{
+    std::memset(&address, 0, sizeof(address));
+
+    if (!string.empty() && string[0] == '/') {
+        auto *path = reinterpret_cast<sockaddr_un *>(&address.storage);
+
+        if (string.size() >= sizeof(path->sun_path)) {
+            std::cerr << "socket path " << string << " is too long" << std::endl;
+            return false;
+        }
+
+        path->sun_family = AF_UNIX;
+        std::memcpy(path->sun_path, string.c_str(), string.size() + 1);
+
+        address.family = AF_UNIX;
+        address.length = sizeof(sockaddr_un);
+        return true;
+    }
+
+    auto colon = string.rfind(':');
+    if (colon == std::string::npos) {
+        std::cerr << "socket address " << string << " is not a path or host:port" << std::endl;
+        return false;
+    }
+
+    auto *internet = reinterpret_cast<sockaddr_in *>(&address.storage);
+    internet->sin_family = AF_INET;
+
+    std::string host = string.substr(0, colon);
+    if (inet_pton(AF_INET, host.c_str(), &internet->sin_addr) != 1) {
+        std::cerr << "socket host " << host << " is not a numeric IPv4 address" << std::endl;
+        return false;
+    }
+
+    try {
+        int port = std::stoi(string.substr(colon + 1));
+        if (port <= 0 || port > 65535)
+            throw std::out_of_range("port");
+        internet->sin_port = htons((std::uint16_t)port);
+    }
+    catch (const std::exception &) {
+        std::cerr << "socket address " << string << " has an invalid port" << std::endl;
+        return false;
+    }
+
+    address.family = AF_INET;
+    address.length = sizeof(sockaddr_in);
+    return true;
+}
+
+/**
+ * @brief Disable batching of small writes, since messages are request and
+ * response.
+ */
+void set_no_delay(int descriptor)
+{
+    int enable = 1;
+    setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+} // namespace
+
+std::unique_ptr<Socket> Socket::connect(const std::string &string)
+{
+    Address address;
+    if (!parse(string, address))
+        return nullptr;
+
+    int descriptor = socket(address.family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor < 0) {
+        std::cerr << "failed to create socket: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    auto connection = std::unique_ptr<Socket>(new Socket(descriptor));
+
+    if (::connect(descriptor, (sockaddr *)&address.storage, address.length) != 0) {
+        std::cerr << "failed to connect to " << string << ": "
+                  << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    if (address.family == AF_INET)
+        set_no_delay(descriptor);
+
+    return connection;
+}
+
+std::unique_ptr<Socket> Socket::listen(const std::string &string)
+{
+    Address address;
+    if (!parse(string, address))
+        return nullptr;
+
+    int descriptor = socket(address.family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor < 0) {
+        std::cerr << "failed to create socket: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    auto listener = std::unique_ptr<Socket>(new Socket(descriptor));
+
+    if (address.family == AF_UNIX) {
+        ::unlink(string.c_str());
+    }
+    else {
+        int enable = 1;
+        setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    }
+
+    if (::bind(descriptor, (sockaddr *)&address.storage, address.length) != 0) {
+        std::cerr << "failed to bind to " << string << ": "
+                  << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    if (::listen(descriptor, SOMAXCONN) != 0) {
+        std::cerr << "failed to listen on " << string << ": "
+                  << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    return listener;
+}
+
+Socket::Socket(int descriptor)
+    : m_descriptor(descriptor)
+{}
+
+Socket::~Socket()
+{
+    ::close(m_descriptor);
+}
+
+std::unique_ptr<Socket> Socket::accept()
+{
+    int descriptor;
+    do {
+        descriptor = ::accept4(m_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+    } while (descriptor < 0 && errno == EINTR);
+
+    if (descriptor < 0) {
+        std::cerr << "failed to accept connection: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    // No effect on unix sockets.
+    set_no_delay(descriptor);
+
+    return std::unique_ptr<Socket>(new Socket(descriptor));
+}
+
+bool Socket::set_timeout(double seconds)
+{
+    timeval timeout {
+        .tv_sec = (time_t)std::floor(seconds),
+        .tv_usec = (suseconds_t)((seconds - std::floor(seconds)) * 1e6)
+    };
+
+    // A zero timeout waits indefinitely, so round short timeouts up.
+    if (seconds > 0.0 && timeout.tv_sec == 0 && timeout.tv_usec == 0)
+        timeout.tv_usec = 1;
+
+    bool set = (
+        setsockopt(m_descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+        setsockopt(m_descriptor, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0
+    );
+
+    if (!set)
+        std::cerr << "failed to set socket timeout: " << std::strerror(errno) << std::endl;
+
+    return set;
+}
+
+bool Socket::send(const void *data, std::size_t size)
+{
+    auto *bytes = static_cast<const char *>(data);
+
+    while (size > 0) {
+        ssize_t sent = ::send(m_descriptor, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+
+        bytes += sent;
+        size -= (std::size_t)sent;
+    }
+
+    return true;
+}
+
+bool Socket::receive(void *data, std::size_t size)
+{
+    auto *bytes = static_cast<char *>(data);
+
+    while (size > 0) {
+        ssize_t received = ::recv(m_descriptor, bytes, size, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+
+        bytes += received;
+        size -= (std::size_t)received;
+    }
+
+    return true;
+}
+
+#else
+
+std::unique_ptr<Socket> Socket::connect(const std::string &)
+{
+    std::cerr << "sockets are unsupported on this platform" << std::endl;
+    return nullptr;
+}
+
+std::unique_ptr<Socket> Socket::listen(const std::string &)
+{
+    std::cerr << "sockets are unsupported on this platform" << std::endl;
+    return nullptr;
+}
+
+Socket::Socket(int descriptor)
+    : m_descriptor(descriptor)
+{}
+
+Socket::~Socket() = default;
+
+std::unique_ptr<Socket> Socket::accept()
+{
+    return nullptr;
+}
+
+bool Socket::set_timeout(double)
+{
+    return false;
+}
+
+bool Socket::send(const void *, std::size_t)
+{
+    return false;
+}
+
+bool Socket::receive(void *, std::size_t)
+{
+    return false;
+}
+
+#endif
+
+} // namespace distributed
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace distributed {
+
+/**
+ * @brief A blocking stream socket between local processes.
+ *
+ * Addresses beginning with a slash are unix socket paths. Otherwise they are
+ * numeric IPv4 `host:port` pairs, typically on the loopback interface.
+ *
+ * Only supported on linux, elsewhere creation fails.
+ */
+class Socket
+{
+public:
+
+    /**
+     * @brief Connect to a listening socket.
+     *
+     * @param address The address to connect to.
+     * @returns A pointer to the connected socket on success or nullptr on
+     * failure.
+     */
+    static std::unique_ptr<Socket> connect(const std::string &address);
+
+    /**
+     * @brief Listen for connections on an address. Replaces an existing unix
+     * socket file.
+     *
+     * @param address The address to listen on.
+     * @returns A pointer to the listening socket on success or nullptr on
+     * failure.
+     */
+    static std::unique_ptr<Socket> listen(const std::string &address);
+
+    /**
+     * @brief Closes the socket.
+     */
+    ~Socket();
+
+    /**
+     * @brief Wait for and accept a connection on a listening socket.
+     * @returns A pointer to the connected socket on success or nullptr on
+     * failure.
+     */
+    std::unique_ptr<Socket> accept();
+
+    /**
+     * @brief Limit the time each send and receive waits for the connection,
+     * after which they fail.
+     *
+     * @param seconds The maximum time to wait, or zero to wait indefinitely.
+     * @returns If the timeout was set.
+     */
+    bool set_timeout(double seconds);
+
+    /**
+     * @brief Send all of a buffer.
+     *
+     * @param data The buffer to send.
+     * @param size The number of bytes to send.
+     *
+     * @returns If all bytes were sent before the connection closed.
+     */
+    bool send(const void *data, std::size_t size);
+
+    /**
+     * @brief Receive exactly the size of a buffer.
+     *
+     * @param data The buffer to fill.
+     * @param size The number of bytes to receive.
+     *
+     * @returns If all bytes were received before the connection closed.
+     */
+    bool receive(void *data, std::size_t size);
+
+private:
+
+    Socket(int descriptor);
+
+    /// The socket file descriptor.
+    int m_descriptor;
+};
+
+} // namespace distributed
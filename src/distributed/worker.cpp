@@ -0,0 +1,238 @@
+#include "distributed/worker.hpp"
+
+#include <cmath>
+#include <iostream>
+
+namespace distributed {
+
+std::unique_ptr<Worker> Worker::create(
+    const mppi::Configuration &configuration,
+    std::unique_ptr<mppi::Dynamics> &&dynamics,
+    std::unique_ptr<mppi::Cost> &&cost
+) {
+    if (dynamics->get_control_dof() != cost->get_control_dof() ||
+        dynamics->get_state_dof() != cost->get_state_dof()) {
+        std::cerr << "worker dynamics and cost dimensions differ" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.covariance.rows() != dynamics->get_control_dof() ||
+        configuration.covariance.cols() != dynamics->get_control_dof()) {
+        std::cerr << "worker covariance must be square with the control dof "
+                  << dynamics->get_control_dof() << std::endl;
+        return nullptr;
+    }
+
+    if (!(configuration.time_step > 0.0) || configuration.horison < configuration.time_step) {
+        std::cerr << "worker horison must be at least one positive time step" << std::endl;
+        return nullptr;
+    }
+
+    int step_count = (int)std::round(configuration.horison / configuration.time_step);
+
+    auto parameterisation = mppi::Parameterisation::create(
+        configuration.sample_mask,
+        configuration.knots,
+        dynamics->get_control_dof(),
+        step_count
+    );
+
+    if (!parameterisation)
+        return nullptr;
+
+    return std::unique_ptr<Worker>(new Worker(
+        configuration,
+        std::move(*parameterisation),
+        std::move(dynamics),
+        std::move(cost)
+    ));
+}
+
+Worker::Worker(
+    const mppi::Configuration &configuration,
+    mppi::Parameterisation &&parameterisation,
+    std::unique_ptr<mppi::Dynamics> &&dynamics,
+    std::unique_ptr<mppi::Cost> &&cost
+) : m_hello {
+        .state_dof = (std::uint32_t)dynamics->get_state_dof(),
+        .control_dof = (std::uint32_t)dynamics->get_control_dof(),
+        .steps = (std::uint32_t)parameterisation.get_step_count(),
+        .reserved = 0,
+        .time_step = configuration.time_step
+    }
+  , m_discount(m_hello.steps)
+  , m_dynamics(std::move(dynamics))
+  , m_cost(std::move(cost))
+  , m_parameterisation(std::move(parameterisation))
+  , m_gaussian(m_parameterisation.reduce(configuration.covariance))
+  , m_state(m_hello.state_dof)
+  , m_nominal(m_hello.control_dof, m_hello.steps)
+  , m_parameters(m_parameterisation.get_parameter_dof(), m_parameterisation.get_knot_count())
+  , m_noise(m_hello.control_dof, m_hello.steps)
+  , m_control(m_hello.control_dof)
+  , m_total(0.0)
+  , m_sum(m_hello.control_dof, m_hello.steps)
+{
+    for (std::uint32_t step = 0; step < m_hello.steps; ++step)
+        m_discount[step] = std::pow(configuration.cost_discount_factor, step);
+}
+
+bool Worker::serve(Socket &connection)
+{
+    Hello hello;
+    bool handshake = (
+        receive_header(connection, Message::HELLO, sizeof(Hello)) &&
+        connection.receive(&hello, sizeof(hello))
+    );
+
+    if (!handshake) {
+        std::cerr << "worker failed to receive hello" << std::endl;
+        return false;
+    }
+
+    // Reply with the worker dimensions either way, so that the coordinator can
+    // report the mismatch.
+    if (!send_message(connection, Message::HELLO, std::make_pair(&m_hello, sizeof(m_hello))))
+        return false;
+
+    if (hello.state_dof != m_hello.state_dof ||
+        hello.control_dof != m_hello.control_dof ||
+        hello.steps != m_hello.steps ||
+        hello.time_step != m_hello.time_step) {
+        std::cerr << "worker dimensions do not match the coordinator" << std::endl;
+        return false;
+    }
+
+    const std::size_t state_size = sizeof(double) * m_state.size();
+    const std::size_t nominal_size = sizeof(double) * m_nominal.size();
+
+    while (true) {
+        Header header;
+        Job job;
+
+        // Disconnecting between updates is the normal end of a session.
+        if (!connection.receive(&header, sizeof(header)))
+            return true;
+
+        bool received = (
+            header.type == Message::JOB &&
+            header.size == sizeof(Job) + state_size + nominal_size &&
+            connection.receive(&job, sizeof(job)) &&
+            connection.receive(m_state.data(), state_size) &&
+            connection.receive(m_nominal.data(), nominal_size) &&
+            job.count >= 0
+        );
+
+        if (!received) {
+            std::cerr << "worker received an invalid job" << std::endl;
+            return false;
+        }
+
+        evaluate(job);
+
+        bool sent = send_message(
+            connection,
+            Message::COSTS,
+            std::make_pair(m_costs.data(), sizeof(double) * m_costs.size())
+        );
+
+        Weight weight;
+        received = (
+            sent &&
+            receive_header(connection, Message::WEIGHT, sizeof(Weight)) &&
+            connection.receive(&weight, sizeof(weight))
+        );
+
+        if (!received) {
+            std::cerr << "worker failed to exchange costs" << std::endl;
+            return false;
+        }
+
+        accumulate(job, weight);
+
+        sent = send_message(
+            connection,
+            Message::SUM,
+            std::make_pair(&m_total, sizeof(m_total)),
+            std::make_pair(m_sum.data(), sizeof(double) * m_sum.size())
+        );
+
+        if (!sent) {
+            std::cerr << "worker failed to send sum" << std::endl;
+            return false;
+        }
+    }
+}
+
+void Worker::sample(const Job &job, std::int64_t rollout)
+{
+    m_gaussian.seed(rollout_seed(job.seed, job.update, (std::uint64_t)(job.first + rollout)));
+
+    for (int knot = 0; knot < m_parameters.cols(); ++knot)
+        m_parameters.col(knot) = m_gaussian();
+
+    m_noise.setZero();
+    m_parameterisation.expand(m_noise, m_parameters);
+}
+
+void Worker::evaluate(const Job &job)
+{
+    m_costs.resize(job.count);
+
+    for (std::int64_t rollout = 0; rollout < job.count; ++rollout) {
+        sample(job, rollout);
+
+        m_dynamics->set_state(m_state, job.time);
+        m_cost->reset(job.time);
+
+        VectorXd state = m_state;
+        double cost = 0.0;
+
+        for (int step = 0; step < m_noise.cols(); ++step) {
+            m_control.noalias() = m_nominal.col(step) + m_noise.col(step);
+
+            double step_cost = m_discount[step] * m_cost->get_cost(
+                state, m_control, m_dynamics.get(), job.time + step * m_hello.time_step
+            );
+
+            // Failed rollouts are ignored by the coordinator.
+            if (std::isnan(step_cost)) {
+                cost = NAN;
+                break;
+            }
+
+            cost += step_cost;
+            state = m_dynamics->step(m_control, m_hello.time_step);
+        }
+
+        m_costs[rollout] = cost;
+    }
+}
+
+void Worker::accumulate(const Job &job, const Weight &weight)
+{
+    m_total = 0.0;
+    m_sum.setZero();
+
+    // The coordinator skips updates with too little cost variation.
+    if (!(weight.difference > 0.0))
+        return;
+
+    for (std::int64_t rollout = 0; rollout < job.count; ++rollout) {
+        double cost = m_costs[rollout];
+        if (std::isnan(cost))
+            continue;
+
+        double likelihood = std::exp(
+            -weight.cost_scale * (cost - weight.minimum) / weight.difference
+        );
+
+        // Regenerate the noise rather than storing every rollout.
+        sample(job, rollout);
+
+        m_total += likelihood;
+        m_sum += likelihood * m_noise;
+    }
+}
+
+} // namespace distributed
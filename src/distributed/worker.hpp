@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "controller/mppi.hpp"
+#include "distributed/protocol.hpp"
+
+namespace distributed {
+
+/**
+ * @brief Evaluates batches of seeded rollouts for a coordinating trajectory in
+ * another process.
+ *
+ * The worker must be configured with the same dynamics, objective, covariance,
+ * sample mask, knots, time step, horison and discount as the coordinator. Rollouts are evaluated
+ * on the calling thread, so throughput scales with the number of worker
+ * processes.
+ */
+class Worker
+{
+public:
+
+    /**
+     * @brief Create a rollout worker.
+     *
+     * @param configuration The trajectory configuration of the coordinator.
+     * @param dynamics The dynamics to roll out.
+     * @param cost The objective of the rollouts.
+     *
+     * @returns A pointer to the worker on success or nullptr on failure.
+     */
+    static std::unique_ptr<Worker> create(
+        const mppi::Configuration &configuration,
+        std::unique_ptr<mppi::Dynamics> &&dynamics,
+        std::unique_ptr<mppi::Cost> &&cost
+    );
+
+    /**
+     * @brief Serve a coordinator until it disconnects.
+     *
+     * @param connection The connection to the coordinator.
+     * @returns If the handshake succeeded and the coordinator disconnected
+     * between updates.
+     */
+    bool serve(Socket &connection);
+
+private:
+
+    Worker(
+        const mppi::Configuration &configuration,
+        mppi::Parameterisation &&parameterisation,
+        std::unique_ptr<mppi::Dynamics> &&dynamics,
+        std::unique_ptr<mppi::Cost> &&cost
+    );
+
+    /**
+     * @brief Regenerate the noise of a rollout into the noise buffer.
+     *
+     * @param job The job the rollout belongs to.
+     * @param rollout The index of the rollout within the job.
+     */
+    void sample(const Job &job, std::int64_t rollout);
+
+    /**
+     * @brief Roll out and cost each rollout of a job.
+     * @param job The job to evaluate.
+     */
+    void evaluate(const Job &job);
+
+    /**
+     * @brief Sum the likelihoods and likelihood weighted noise of the rollouts
+     * of the last evaluated job.
+     *
+     * @param job The job that was evaluated.
+     * @param weight The cost range of all rollouts of the update.
+     */
+    void accumulate(const Job &job, const Weight &weight);
+
+    /// The dimensions of the trajectory.
+    const Hello m_hello;
+
+    /// The cost discount factor raised to the power of each time step.
+    VectorXd m_discount;
+
+    /// The rollout dynamics.
+    std::unique_ptr<mppi::Dynamics> m_dynamics;
+
+    /// The rollout objective.
+    std::unique_ptr<mppi::Cost> m_cost;
+
+    /// Maps the sampled noise parameters to control noise.
+    const mppi::Parameterisation m_parameterisation;
+
+    /// Generates the rollout noise parameters.
+    Gaussian m_gaussian;
+
+    /// The initial state of the job.
+    VectorXd m_state;
+
+    /// The nominal control trajectory of the job.
+    MatrixXd m_nominal;
+
+    /// The noise parameters of the current rollout.
+    MatrixXd m_parameters;
+
+    /// The noise of the current rollout.
+    MatrixXd m_noise;
+
+    /// The control applied at the current rollout step.
+    VectorXd m_control;
+
+    /// The cost of each rollout of the job.
+    std::vector<double> m_costs;
+
+    /// The sum of the likelihoods of the rollouts.
+    double m_total;
+
+    /// The likelihood weighted sum of the rollout noise.
+    MatrixXd m_sum;
+};
+
+} // namespace distributed
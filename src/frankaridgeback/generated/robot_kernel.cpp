@@ -0,0 +1,1547 @@
+// Generated by scripts/generate_dynamics.py from robot.urdf. Do not edit,
+// regenerate with the generate_dynamics target when the model changes.
+
+#include "frankaridgeback/generated/robot_kernel.hpp"
+
+#include <cmath>
+
+namespace FrankaRidgeback::Kernel {
+
+namespace {
+
+/// The acceleration of the root that is equivalent to gravity.
+const Vector6d GRAVITY_ACCELERATION = (Vector6d() << 0.0, 0.0, 9.81, 0.0, 0.0, 0.0).finished();
+
+inline Matrix3d rotation_x(double angle)
+{
+    double c = std::cos(angle), s = std::sin(angle);
+    return (Matrix3d() << 1.0, 0.0, 0.0, 0.0, c, -s, 0.0, s, c).finished();
+}
+
+inline Matrix3d rotation_y(double angle)
+{
+    double c = std::cos(angle), s = std::sin(angle);
+    return (Matrix3d() << c, 0.0, s, 0.0, 1.0, 0.0, -s, 0.0, c).finished();
+}
+
+inline Matrix3d rotation_z(double angle)
+{
+    double c = std::cos(angle), s = std::sin(angle);
+    return (Matrix3d() << c, -s, 0.0, s, c, 0.0, 0.0, 0.0, 1.0).finished();
+}
+
+template<int Index>
+inline Vector6d unit_motion(double value)
+{
+    Vector6d motion = Vector6d::Zero();
+    motion[Index] = value;
+    return motion;
+}
+
+/// Transform a motion from a child frame to its parent.
+inline Vector6d act(const Matrix3d &rotation, const Vector3d &translation, const Vector6d &motion)
+{
+    Vector6d result;
+    result.tail<3>() = rotation * motion.tail<3>();
+    result.head<3>() = rotation * motion.head<3>() + translation.cross(result.tail<3>());
+    return result;
+}
+
+/// Transform a motion from a parent frame to its child.
+inline Vector6d act_inverse(const Matrix3d &rotation, const Vector3d &translation, const Vector6d &motion)
+{
+    Vector6d result;
+    result.tail<3>() = rotation.transpose() * motion.tail<3>();
+    result.head<3>() = rotation.transpose() * (motion.head<3>() - translation.cross(motion.tail<3>()));
+    return result;
+}
+
+/// Transform a force from a child frame to its parent.
+inline Vector6d act_force(const Matrix3d &rotation, const Vector3d &translation, const Vector6d &force)
+{
+    Vector6d result;
+    result.head<3>() = rotation * force.head<3>();
+    result.tail<3>() = rotation * force.tail<3>() + translation.cross(result.head<3>());
+    return result;
+}
+
+/// The spatial cross product of a velocity and a motion.
+inline Vector6d cross_motion(const Vector6d &velocity, const Vector6d &motion)
+{
+    Vector6d result;
+    result.head<3>() = velocity.tail<3>().cross(motion.head<3>()) + velocity.head<3>().cross(motion.tail<3>());
+    result.tail<3>() = velocity.tail<3>().cross(motion.tail<3>());
+    return result;
+}
+
+/// The spatial cross product of a velocity and a force.
+inline Vector6d cross_force(const Vector6d &velocity, const Vector6d &force)
+{
+    Vector6d result;
+    result.head<3>() = velocity.tail<3>().cross(force.head<3>());
+    result.tail<3>() = velocity.tail<3>().cross(force.tail<3>()) + velocity.head<3>().cross(force.head<3>());
+    return result;
+}
+
+/// Transform a spatial inertia from a child frame to its parent.
+inline Matrix6d inertia_to_parent(const Matrix3d &rotation, const Vector3d &translation, const Matrix6d &inertia)
+{
+    Matrix3d skew;
+    skew << 0.0, -translation.z(), translation.y(),
+            translation.z(), 0.0, -translation.x(),
+            -translation.y(), translation.x(), 0.0;
+
+    // The motion transform from the parent to the child.
+    Matrix6d inverse = Matrix6d::Zero();
+    inverse.topLeftCorner<3, 3>() = rotation.transpose();
+    inverse.topRightCorner<3, 3>() = -rotation.transpose() * skew;
+    inverse.bottomRightCorner<3, 3>() = rotation.transpose();
+
+    return inverse.transpose() * inertia * inverse;
+}
+
+// x_base_joint, prismatic about (1.0, 0.0, 0.0).
+static const Vector3d PLACEMENT_TRANSLATION_0 = Vector3d(0.0, 0.0, 0.0);
+static const Matrix6d INERTIA_0 = (Matrix6d() <<
+    0.01, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.01, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.01, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.01, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.01, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.01
+).finished();
+
+// y_base_joint, prismatic about (0.0, 1.0, 0.0).
+static const Vector3d PLACEMENT_TRANSLATION_1 = Vector3d(0.0, 0.0, 0.0);
+static const Matrix6d INERTIA_1 = (Matrix6d() <<
+    0.01, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.01, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.01, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.01, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.01, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.01
+).finished();
+
+// pivot_joint, revolute about (0.0, 0.0, 1.0).
+static const Vector3d PLACEMENT_TRANSLATION_2 = Vector3d(0.0, 0.0, 0.0);
+static const Matrix6d INERTIA_2 = (Matrix6d() <<
+    169.23499999999999, 0.0, 0.0, 0.0, 13.609945540000002, -0.344833704,
+    0.0, 169.23499999999999, 0.0, -13.609945540000002, 0.0, 2.7706037800000005,
+    0.0, 0.0, 169.23499999999999, 0.344833704, -2.7706037800000005, 0.0,
+    0.0, -13.609945540000002, 0.344833704, 7.274851077269355, -0.004186486540635612, -0.6268970952881903,
+    13.609945540000002, 0.0, -2.7706037800000005, -0.004186486540635612, 7.3693376996949, -0.0024673862023078183,
+    -0.344833704, 2.7706037800000005, 0.0, -0.6268970952881903, -0.0024673862023078183, 7.423443526686384
+).finished();
+
+// panda_joint1, revolute about (0.0, 0.0, 1.0).
+static const Vector3d PLACEMENT_TRANSLATION_3 = Vector3d(0.295, 0.005, 1.058);
+static const Matrix6d INERTIA_3 = (Matrix6d() <<
+    2.74, 0.0, 0.0, 0.0, -0.18517413200000002, 0.089038492,
+    0.0, 2.74, 0.0, 0.18517413200000002, 0.0, 0.0,
+    0.0, 0.0, 2.74, -0.089038492, 0.0, 0.0,
+    0.0, 0.18517413200000002, -0.089038492, 0.033449474010631204, 0.0, 0.0,
+    -0.18517413200000002, 0.0, 0.0, 0.0, 0.0284280083430976, -0.0013415390974455994,
+    0.089038492, 0.0, 0.0, 0.0, -0.0013415390974455994, 0.0091002852996036
+).finished();
+
+// panda_joint2, revolute about (0.0, 0.0, 1.0).
+static const Matrix3d PLACEMENT_ROTATION_4 = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 4.8965888601467475e-12, 1.0, 0.0, -1.0, 4.8965888601467475e-12).finished();
+static const Vector3d PLACEMENT_TRANSLATION_4 = Vector3d(0.0, 0.0, 0.0);
+static const Matrix6d INERTIA_4 = (Matrix6d() <<
+    2.74, 0.0, 0.0, 0.0, 0.08830609, 0.18799140000000003,
+    0.0, 2.74, 0.0, -0.08830609, 0.0, 0.0,
+    0.0, 0.0, 2.74, -0.18799140000000003, 0.0, 0.0,
+    0.0, -0.08830609, -0.18799140000000003, 0.034029681003665005, 0.0, 0.0,
+    0.08830609, 0.0, 0.0, 0.0, 0.009059557033315, 0.0013302386158500004,
+    0.18799140000000003, 0.0, 0.0, 0.0, 0.0013302386158500004, 0.029049524584900004
+).finished();
+
+// panda_joint3, revolute about (0.0, 0.0, 1.0).
+static const Matrix3d PLACEMENT_ROTATION_5 = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 4.8965888601467475e-12, -1.0, 0.0, 1.0, 4.8965888601467475e-12).finished();
+static const Vector3d PLACEMENT_TRANSLATION_5 = Vector3d(0.0, -0.316, 0.0);
+static const Matrix6d INERTIA_5 = (Matrix6d() <<
+    2.38, 0.0, 0.0, 0.0, -0.07545552, -0.07529701200000001,
+    0.0, 2.38, 0.0, 0.07545552, 0.0, 0.11183453399999999,
+    0.0, 0.0, 2.38, 0.07529701200000001, -0.11183453399999999, 0.0,
+    0.0, 0.07545552, 0.07529701200000001, 0.012488209802608799, -0.0060230601373516, 0.00022412625560599975,
+    -0.07545552, 0.0, -0.11183453399999999, -0.0060230601373516, 0.0175383483618362, 0.0002092549536080006,
+    -0.07529701200000001, 0.11183453399999999, 0.0, 0.00022412625560599975, 0.0002092549536080006, 0.015754463740575
+).finished();
+
+// panda_joint4, revolute about (0.0, 0.0, 1.0).
+static const Matrix3d PLACEMENT_ROTATION_6 = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 4.8965888601467475e-12, -1.0, 0.0, 1.0, 4.8965888601467475e-12).finished();
+static const Vector3d PLACEMENT_TRANSLATION_6 = Vector3d(0.0825, 0.0, 0.0);
+static const Matrix6d INERTIA_6 = (Matrix6d() <<
+    2.38, 0.0, 0.0, 0.0, 0.07587916, -0.080171014,
+    0.0, 2.38, 0.0, -0.07587916, 0.0, -0.085786148,
+    0.0, 0.0, 2.38, 0.080171014, 0.085786148, 0.0,
+    0.0, -0.07587916, 0.080171014, 0.013116402848334199, 0.006360687833394401, 0.00032280454058600033,
+    0.07587916, 0.0, 0.085786148, 0.006360687833394401, 0.0137652138221008, -0.00019827182713799988,
+    -0.080171014, -0.085786148, 0.0, 0.00032280454058600033, -0.00019827182713799988, 0.016044212482595
+).finished();
+
+// panda_joint5, revolute about (0.0, 0.0, 1.0).
+static const Matrix3d PLACEMENT_ROTATION_7 = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 4.8965888601467475e-12, 1.0, 0.0, -1.0, 4.8965888601467475e-12).finished();
+static const Vector3d PLACEMENT_TRANSLATION_7 = Vector3d(-0.0825, 0.384, 0.0);
+static const Matrix6d INERTIA_7 = (Matrix6d() <<
+    2.74, 0.0, 0.0, 0.0, -0.28544224, -0.16725699800000002,
+    0.0, 2.74, 0.0, 0.28544224, 0.0, 0.0,
+    0.0, 0.0, 2.74, 0.16725699800000002, 0.0, 0.0,
+    0.0, 0.28544224, 0.16725699800000002, 0.0703174240590546, 6.50283587108e-07, -1.05129179916e-05,
+    -0.28544224, 0.0, 0.0, 6.50283587108e-07, 0.05861151953443999, 0.009667630565777997,
+    -0.16725699800000002, 0.0, 0.0, -1.05129179916e-05, 0.009667630565777997, 0.014651159313454601
+).finished();
+
+// panda_joint6, revolute about (0.0, 0.0, 1.0).
+static const Matrix3d PLACEMENT_ROTATION_8 = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 4.8965888601467475e-12, -1.0, 0.0, 1.0, 4.8965888601467475e-12).finished();
+static const Vector3d PLACEMENT_TRANSLATION_8 = Vector3d(0.0, 0.0, 0.0);
+static const Matrix6d INERTIA_8 = (Matrix6d() <<
+    1.55, 0.0, 0.0, 0.0, 0.016483165, -0.0141174,
+    0.0, 1.55, 0.0, -0.016483165, 0.0, 0.079128895,
+    0.0, 0.0, 1.55, 0.0141174, -0.079128895, 0.0,
+    0.0, -0.016483165, 0.0141174, 0.0033372327045195, -0.001157982841168, -0.0002122231132215001,
+    0.016483165, 0.0, -0.079128895, -0.001157982841168, 0.008259687342985, -1.9656645795e-05,
+    -0.0141174, 0.079128895, 0.0, -0.0002122231132215001, -1.9656645795e-05, 0.0097505254453455
+).finished();
+
+// panda_joint7, revolute about (0.0, 0.0, 1.0).
+static const Matrix3d PLACEMENT_ROTATION_9 = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 4.8965888601467475e-12, -1.0, 0.0, 1.0, 4.8965888601467475e-12).finished();
+static const Vector3d PLACEMENT_TRANSLATION_9 = Vector3d(0.088, 0.0, 0.0);
+static const Matrix6d INERTIA_9 = (Matrix6d() <<
+    1.27, 0.0, 0.0, 0.0, 0.13337377, -0.006616986911386117,
+    0.0, 1.27, 0.0, -0.13337377, 0.0, 0.006710406911385411,
+    0.0, 0.0, 1.27, 0.006616986911386117, -0.006710406911385411, 0.0,
+    0.0, -0.13337377, 0.006616986911386117, 0.01805366335564107, -0.0013799767709283999, -0.0004513096318720562,
+    0.13337377, 0.0, -0.006710406911385411, -0.0013799767709283999, 0.01805482922157093, -0.0005784859867973512,
+    -0.006616986911386117, 0.006710406911385411, 0.0, -0.0004513096318720562, -0.0005784859867973512, 0.0034110831947827998
+).finished();
+
+// panda_finger_joint1, prismatic about (0.0, 1.0, 0.0).
+static const Matrix3d PLACEMENT_ROTATION_10 = (Matrix3d() << 0.7071067811868645, 0.7071067811862305, 0.0, -0.7071067811862305, 0.7071067811868645, 0.0, 0.0, 0.0, 1.0).finished();
+static const Vector3d PLACEMENT_TRANSLATION_10 = Vector3d(0.0, 0.0, 0.1654);
+static const Matrix6d INERTIA_10 = (Matrix6d() <<
+    0.1, 0.0, 0.0, 0.0, 0.0022794100000000004, -0.00145644,
+    0.0, 0.1, 0.0, -0.0022794100000000004, 0.0, 0.0,
+    0.0, 0.0, 0.1, 0.00145644, 0.0, 0.0,
+    0.0, -0.0022794100000000004, 0.00145644, 0.00010329136672209999, 0.0, 0.0,
+    0.0022794100000000004, 0.0, 0.0, 0.0, 8.154448028480001e-05, -3.3198239004000005e-05,
+    -0.00145644, 0.0, 0.0, 0.0, -3.3198239004000005e-05, 2.816342685257e-05
+).finished();
+
+// panda_finger_joint2, prismatic about (0.0, -1.0, 0.0).
+static const Matrix3d PLACEMENT_ROTATION_11 = (Matrix3d() << 0.7071067811868645, 0.7071067811862305, 0.0, -0.7071067811862305, 0.7071067811868645, 0.0, 0.0, 0.0, 1.0).finished();
+static const Vector3d PLACEMENT_TRANSLATION_11 = Vector3d(0.0, 0.0, 0.1654);
+static const Matrix6d INERTIA_11 = (Matrix6d() <<
+    0.1, 0.0, 0.0, 0.0, 0.0022794100000000004, -0.00145644,
+    0.0, 0.1, 0.0, -0.0022794100000000004, 0.0, 0.0,
+    0.0, 0.0, 0.1, 0.00145644, 0.0, 0.0,
+    0.0, -0.0022794100000000004, 0.00145644, 0.00010329136672209999, 1.105907354710552e-19, 0.0,
+    0.0022794100000000004, 0.0, 0.0, 1.105907354710552e-19, 8.154448028480001e-05, -3.3198239004000005e-05,
+    -0.00145644, 0.0, 0.0, 0.0, -3.3198239004000005e-05, 2.816342685257e-05
+).finished();
+
+} // namespace
+
+void placements(Data &data, const Eigen::Ref<const VectorXd> &position)
+{
+    // x_base_joint
+    data.parent_rotation[0].setIdentity();
+    data.parent_translation[0] = PLACEMENT_TRANSLATION_0 + Vector3d(1.0, 0.0, 0.0) * position[0];
+    data.rotation[0] = data.parent_rotation[0];
+    data.translation[0] = data.parent_translation[0];
+
+    // y_base_joint
+    data.parent_rotation[1].setIdentity();
+    data.parent_translation[1] = PLACEMENT_TRANSLATION_1 + Vector3d(0.0, 1.0, 0.0) * position[1];
+    data.rotation[1] = data.rotation[0] * data.parent_rotation[1];
+    data.translation[1] = data.translation[0] + data.rotation[0] * data.parent_translation[1];
+
+    // pivot_joint
+    data.parent_rotation[2] = rotation_z(position[2]);
+    data.parent_translation[2] = PLACEMENT_TRANSLATION_2;
+    data.rotation[2] = data.rotation[1] * data.parent_rotation[2];
+    data.translation[2] = data.translation[1] + data.rotation[1] * data.parent_translation[2];
+
+    // panda_joint1
+    data.parent_rotation[3] = rotation_z(position[3]);
+    data.parent_translation[3] = PLACEMENT_TRANSLATION_3;
+    data.rotation[3] = data.rotation[2] * data.parent_rotation[3];
+    data.translation[3] = data.translation[2] + data.rotation[2] * data.parent_translation[3];
+
+    // panda_joint2
+    data.parent_rotation[4] = PLACEMENT_ROTATION_4 * rotation_z(position[4]);
+    data.parent_translation[4] = PLACEMENT_TRANSLATION_4;
+    data.rotation[4] = data.rotation[3] * data.parent_rotation[4];
+    data.translation[4] = data.translation[3] + data.rotation[3] * data.parent_translation[4];
+
+    // panda_joint3
+    data.parent_rotation[5] = PLACEMENT_ROTATION_5 * rotation_z(position[5]);
+    data.parent_translation[5] = PLACEMENT_TRANSLATION_5;
+    data.rotation[5] = data.rotation[4] * data.parent_rotation[5];
+    data.translation[5] = data.translation[4] + data.rotation[4] * data.parent_translation[5];
+
+    // panda_joint4
+    data.parent_rotation[6] = PLACEMENT_ROTATION_6 * rotation_z(position[6]);
+    data.parent_translation[6] = PLACEMENT_TRANSLATION_6;
+    data.rotation[6] = data.rotation[5] * data.parent_rotation[6];
+    data.translation[6] = data.translation[5] + data.rotation[5] * data.parent_translation[6];
+
+    // panda_joint5
+    data.parent_rotation[7] = PLACEMENT_ROTATION_7 * rotation_z(position[7]);
+    data.parent_translation[7] = PLACEMENT_TRANSLATION_7;
+    data.rotation[7] = data.rotation[6] * data.parent_rotation[7];
+    data.translation[7] = data.translation[6] + data.rotation[6] * data.parent_translation[7];
+
+    // panda_joint6
+    data.parent_rotation[8] = PLACEMENT_ROTATION_8 * rotation_z(position[8]);
+    data.parent_translation[8] = PLACEMENT_TRANSLATION_8;
+    data.rotation[8] = data.rotation[7] * data.parent_rotation[8];
+    data.translation[8] = data.translation[7] + data.rotation[7] * data.parent_translation[8];
+
+    // panda_joint7
+    data.parent_rotation[9] = PLACEMENT_ROTATION_9 * rotation_z(position[9]);
+    data.parent_translation[9] = PLACEMENT_TRANSLATION_9;
+    data.rotation[9] = data.rotation[8] * data.parent_rotation[9];
+    data.translation[9] = data.translation[8] + data.rotation[8] * data.parent_translation[9];
+
+    // panda_finger_joint1
+    data.parent_rotation[10] = PLACEMENT_ROTATION_10;
+    data.parent_translation[10] = PLACEMENT_TRANSLATION_10 + PLACEMENT_ROTATION_10 * (Vector3d(0.0, 1.0, 0.0) * position[10]);
+    data.rotation[10] = data.rotation[9] * data.parent_rotation[10];
+    data.translation[10] = data.translation[9] + data.rotation[9] * data.parent_translation[10];
+
+    // panda_finger_joint2
+    data.parent_rotation[11] = PLACEMENT_ROTATION_11;
+    data.parent_translation[11] = PLACEMENT_TRANSLATION_11 + PLACEMENT_ROTATION_11 * (Vector3d(0.0, -1.0, 0.0) * position[11]);
+    data.rotation[11] = data.rotation[9] * data.parent_rotation[11];
+    data.translation[11] = data.translation[9] + data.rotation[9] * data.parent_translation[11];
+}
+
+void forward_kinematics(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &acceleration
+) {
+    placements(data, position);
+
+    // x_base_joint
+    data.velocity[0].setZero();
+    data.velocity[0][0] += velocity[0];
+    data.acceleration[0].setZero();
+    data.acceleration[0][0] += acceleration[0];
+    data.acceleration[0] += cross_motion(data.velocity[0], unit_motion<0>(velocity[0]));
+
+    // y_base_joint
+    data.velocity[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.velocity[0]);
+    data.velocity[1][1] += velocity[1];
+    data.acceleration[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.acceleration[0]);
+    data.acceleration[1][1] += acceleration[1];
+    data.acceleration[1] += cross_motion(data.velocity[1], unit_motion<1>(velocity[1]));
+
+    // pivot_joint
+    data.velocity[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.velocity[1]);
+    data.velocity[2][5] += velocity[2];
+    data.acceleration[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.acceleration[1]);
+    data.acceleration[2][5] += acceleration[2];
+    data.acceleration[2] += cross_motion(data.velocity[2], unit_motion<5>(velocity[2]));
+
+    // panda_joint1
+    data.velocity[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.velocity[2]);
+    data.velocity[3][5] += velocity[3];
+    data.acceleration[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.acceleration[2]);
+    data.acceleration[3][5] += acceleration[3];
+    data.acceleration[3] += cross_motion(data.velocity[3], unit_motion<5>(velocity[3]));
+
+    // panda_joint2
+    data.velocity[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.velocity[3]);
+    data.velocity[4][5] += velocity[4];
+    data.acceleration[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.acceleration[3]);
+    data.acceleration[4][5] += acceleration[4];
+    data.acceleration[4] += cross_motion(data.velocity[4], unit_motion<5>(velocity[4]));
+
+    // panda_joint3
+    data.velocity[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.velocity[4]);
+    data.velocity[5][5] += velocity[5];
+    data.acceleration[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.acceleration[4]);
+    data.acceleration[5][5] += acceleration[5];
+    data.acceleration[5] += cross_motion(data.velocity[5], unit_motion<5>(velocity[5]));
+
+    // panda_joint4
+    data.velocity[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.velocity[5]);
+    data.velocity[6][5] += velocity[6];
+    data.acceleration[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.acceleration[5]);
+    data.acceleration[6][5] += acceleration[6];
+    data.acceleration[6] += cross_motion(data.velocity[6], unit_motion<5>(velocity[6]));
+
+    // panda_joint5
+    data.velocity[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.velocity[6]);
+    data.velocity[7][5] += velocity[7];
+    data.acceleration[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.acceleration[6]);
+    data.acceleration[7][5] += acceleration[7];
+    data.acceleration[7] += cross_motion(data.velocity[7], unit_motion<5>(velocity[7]));
+
+    // panda_joint6
+    data.velocity[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.velocity[7]);
+    data.velocity[8][5] += velocity[8];
+    data.acceleration[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.acceleration[7]);
+    data.acceleration[8][5] += acceleration[8];
+    data.acceleration[8] += cross_motion(data.velocity[8], unit_motion<5>(velocity[8]));
+
+    // panda_joint7
+    data.velocity[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.velocity[8]);
+    data.velocity[9][5] += velocity[9];
+    data.acceleration[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.acceleration[8]);
+    data.acceleration[9][5] += acceleration[9];
+    data.acceleration[9] += cross_motion(data.velocity[9], unit_motion<5>(velocity[9]));
+
+    // panda_finger_joint1
+    data.velocity[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.velocity[9]);
+    data.velocity[10][1] += velocity[10];
+    data.acceleration[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.acceleration[9]);
+    data.acceleration[10][1] += acceleration[10];
+    data.acceleration[10] += cross_motion(data.velocity[10], unit_motion<1>(velocity[10]));
+
+    // panda_finger_joint2
+    data.velocity[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.velocity[9]);
+    data.velocity[11][1] -= velocity[11];
+    data.acceleration[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.acceleration[9]);
+    data.acceleration[11][1] -= acceleration[11];
+    data.acceleration[11] += cross_motion(data.velocity[11], unit_motion<1>(-velocity[11]));
+}
+
+void rnea(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &acceleration,
+    Eigen::Ref<VectorXd> force
+) {
+    placements(data, position);
+
+    // x_base_joint
+    data.velocity[0].setZero();
+    data.velocity[0][0] += velocity[0];
+    data.acceleration[0] = act_inverse(data.parent_rotation[0], data.parent_translation[0], GRAVITY_ACCELERATION);
+    data.acceleration[0][0] += acceleration[0];
+    data.acceleration[0] += cross_motion(data.velocity[0], unit_motion<0>(velocity[0]));
+    data.force[0] = INERTIA_0 * data.acceleration[0] + cross_force(data.velocity[0], INERTIA_0 * data.velocity[0]);
+
+    // y_base_joint
+    data.velocity[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.velocity[0]);
+    data.velocity[1][1] += velocity[1];
+    data.acceleration[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.acceleration[0]);
+    data.acceleration[1][1] += acceleration[1];
+    data.acceleration[1] += cross_motion(data.velocity[1], unit_motion<1>(velocity[1]));
+    data.force[1] = INERTIA_1 * data.acceleration[1] + cross_force(data.velocity[1], INERTIA_1 * data.velocity[1]);
+
+    // pivot_joint
+    data.velocity[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.velocity[1]);
+    data.velocity[2][5] += velocity[2];
+    data.acceleration[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.acceleration[1]);
+    data.acceleration[2][5] += acceleration[2];
+    data.acceleration[2] += cross_motion(data.velocity[2], unit_motion<5>(velocity[2]));
+    data.force[2] = INERTIA_2 * data.acceleration[2] + cross_force(data.velocity[2], INERTIA_2 * data.velocity[2]);
+
+    // panda_joint1
+    data.velocity[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.velocity[2]);
+    data.velocity[3][5] += velocity[3];
+    data.acceleration[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.acceleration[2]);
+    data.acceleration[3][5] += acceleration[3];
+    data.acceleration[3] += cross_motion(data.velocity[3], unit_motion<5>(velocity[3]));
+    data.force[3] = INERTIA_3 * data.acceleration[3] + cross_force(data.velocity[3], INERTIA_3 * data.velocity[3]);
+
+    // panda_joint2
+    data.velocity[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.velocity[3]);
+    data.velocity[4][5] += velocity[4];
+    data.acceleration[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.acceleration[3]);
+    data.acceleration[4][5] += acceleration[4];
+    data.acceleration[4] += cross_motion(data.velocity[4], unit_motion<5>(velocity[4]));
+    data.force[4] = INERTIA_4 * data.acceleration[4] + cross_force(data.velocity[4], INERTIA_4 * data.velocity[4]);
+
+    // panda_joint3
+    data.velocity[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.velocity[4]);
+    data.velocity[5][5] += velocity[5];
+    data.acceleration[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.acceleration[4]);
+    data.acceleration[5][5] += acceleration[5];
+    data.acceleration[5] += cross_motion(data.velocity[5], unit_motion<5>(velocity[5]));
+    data.force[5] = INERTIA_5 * data.acceleration[5] + cross_force(data.velocity[5], INERTIA_5 * data.velocity[5]);
+
+    // panda_joint4
+    data.velocity[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.velocity[5]);
+    data.velocity[6][5] += velocity[6];
+    data.acceleration[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.acceleration[5]);
+    data.acceleration[6][5] += acceleration[6];
+    data.acceleration[6] += cross_motion(data.velocity[6], unit_motion<5>(velocity[6]));
+    data.force[6] = INERTIA_6 * data.acceleration[6] + cross_force(data.velocity[6], INERTIA_6 * data.velocity[6]);
+
+    // panda_joint5
+    data.velocity[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.velocity[6]);
+    data.velocity[7][5] += velocity[7];
+    data.acceleration[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.acceleration[6]);
+    data.acceleration[7][5] += acceleration[7];
+    data.acceleration[7] += cross_motion(data.velocity[7], unit_motion<5>(velocity[7]));
+    data.force[7] = INERTIA_7 * data.acceleration[7] + cross_force(data.velocity[7], INERTIA_7 * data.velocity[7]);
+
+    // panda_joint6
+    data.velocity[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.velocity[7]);
+    data.velocity[8][5] += velocity[8];
+    data.acceleration[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.acceleration[7]);
+    data.acceleration[8][5] += acceleration[8];
+    data.acceleration[8] += cross_motion(data.velocity[8], unit_motion<5>(velocity[8]));
+    data.force[8] = INERTIA_8 * data.acceleration[8] + cross_force(data.velocity[8], INERTIA_8 * data.velocity[8]);
+
+    // panda_joint7
+    data.velocity[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.velocity[8]);
+    data.velocity[9][5] += velocity[9];
+    data.acceleration[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.acceleration[8]);
+    data.acceleration[9][5] += acceleration[9];
+    data.acceleration[9] += cross_motion(data.velocity[9], unit_motion<5>(velocity[9]));
+    data.force[9] = INERTIA_9 * data.acceleration[9] + cross_force(data.velocity[9], INERTIA_9 * data.velocity[9]);
+
+    // panda_finger_joint1
+    data.velocity[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.velocity[9]);
+    data.velocity[10][1] += velocity[10];
+    data.acceleration[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.acceleration[9]);
+    data.acceleration[10][1] += acceleration[10];
+    data.acceleration[10] += cross_motion(data.velocity[10], unit_motion<1>(velocity[10]));
+    data.force[10] = INERTIA_10 * data.acceleration[10] + cross_force(data.velocity[10], INERTIA_10 * data.velocity[10]);
+
+    // panda_finger_joint2
+    data.velocity[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.velocity[9]);
+    data.velocity[11][1] -= velocity[11];
+    data.acceleration[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.acceleration[9]);
+    data.acceleration[11][1] -= acceleration[11];
+    data.acceleration[11] += cross_motion(data.velocity[11], unit_motion<1>(-velocity[11]));
+    data.force[11] = INERTIA_11 * data.acceleration[11] + cross_force(data.velocity[11], INERTIA_11 * data.velocity[11]);
+
+    // Transmit the forces from the leaves to the root.
+    force[11] = -data.force[11][1];
+    data.force[9] += act_force(data.parent_rotation[11], data.parent_translation[11], data.force[11]);
+    force[10] = data.force[10][1];
+    data.force[9] += act_force(data.parent_rotation[10], data.parent_translation[10], data.force[10]);
+    force[9] = data.force[9][5];
+    data.force[8] += act_force(data.parent_rotation[9], data.parent_translation[9], data.force[9]);
+    force[8] = data.force[8][5];
+    data.force[7] += act_force(data.parent_rotation[8], data.parent_translation[8], data.force[8]);
+    force[7] = data.force[7][5];
+    data.force[6] += act_force(data.parent_rotation[7], data.parent_translation[7], data.force[7]);
+    force[6] = data.force[6][5];
+    data.force[5] += act_force(data.parent_rotation[6], data.parent_translation[6], data.force[6]);
+    force[5] = data.force[5][5];
+    data.force[4] += act_force(data.parent_rotation[5], data.parent_translation[5], data.force[5]);
+    force[4] = data.force[4][5];
+    data.force[3] += act_force(data.parent_rotation[4], data.parent_translation[4], data.force[4]);
+    force[3] = data.force[3][5];
+    data.force[2] += act_force(data.parent_rotation[3], data.parent_translation[3], data.force[3]);
+    force[2] = data.force[2][5];
+    data.force[1] += act_force(data.parent_rotation[2], data.parent_translation[2], data.force[2]);
+    force[1] = data.force[1][1];
+    data.force[0] += act_force(data.parent_rotation[1], data.parent_translation[1], data.force[1]);
+    force[0] = data.force[0][0];
+}
+
+void non_linear_effects(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    Eigen::Ref<VectorXd> force
+) {
+    placements(data, position);
+
+    // x_base_joint
+    data.velocity[0].setZero();
+    data.velocity[0][0] += velocity[0];
+    data.acceleration[0] = act_inverse(data.parent_rotation[0], data.parent_translation[0], GRAVITY_ACCELERATION);
+    data.acceleration[0] += cross_motion(data.velocity[0], unit_motion<0>(velocity[0]));
+    data.force[0] = INERTIA_0 * data.acceleration[0] + cross_force(data.velocity[0], INERTIA_0 * data.velocity[0]);
+
+    // y_base_joint
+    data.velocity[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.velocity[0]);
+    data.velocity[1][1] += velocity[1];
+    data.acceleration[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.acceleration[0]);
+    data.acceleration[1] += cross_motion(data.velocity[1], unit_motion<1>(velocity[1]));
+    data.force[1] = INERTIA_1 * data.acceleration[1] + cross_force(data.velocity[1], INERTIA_1 * data.velocity[1]);
+
+    // pivot_joint
+    data.velocity[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.velocity[1]);
+    data.velocity[2][5] += velocity[2];
+    data.acceleration[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.acceleration[1]);
+    data.acceleration[2] += cross_motion(data.velocity[2], unit_motion<5>(velocity[2]));
+    data.force[2] = INERTIA_2 * data.acceleration[2] + cross_force(data.velocity[2], INERTIA_2 * data.velocity[2]);
+
+    // panda_joint1
+    data.velocity[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.velocity[2]);
+    data.velocity[3][5] += velocity[3];
+    data.acceleration[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.acceleration[2]);
+    data.acceleration[3] += cross_motion(data.velocity[3], unit_motion<5>(velocity[3]));
+    data.force[3] = INERTIA_3 * data.acceleration[3] + cross_force(data.velocity[3], INERTIA_3 * data.velocity[3]);
+
+    // panda_joint2
+    data.velocity[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.velocity[3]);
+    data.velocity[4][5] += velocity[4];
+    data.acceleration[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.acceleration[3]);
+    data.acceleration[4] += cross_motion(data.velocity[4], unit_motion<5>(velocity[4]));
+    data.force[4] = INERTIA_4 * data.acceleration[4] + cross_force(data.velocity[4], INERTIA_4 * data.velocity[4]);
+
+    // panda_joint3
+    data.velocity[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.velocity[4]);
+    data.velocity[5][5] += velocity[5];
+    data.acceleration[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.acceleration[4]);
+    data.acceleration[5] += cross_motion(data.velocity[5], unit_motion<5>(velocity[5]));
+    data.force[5] = INERTIA_5 * data.acceleration[5] + cross_force(data.velocity[5], INERTIA_5 * data.velocity[5]);
+
+    // panda_joint4
+    data.velocity[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.velocity[5]);
+    data.velocity[6][5] += velocity[6];
+    data.acceleration[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.acceleration[5]);
+    data.acceleration[6] += cross_motion(data.velocity[6], unit_motion<5>(velocity[6]));
+    data.force[6] = INERTIA_6 * data.acceleration[6] + cross_force(data.velocity[6], INERTIA_6 * data.velocity[6]);
+
+    // panda_joint5
+    data.velocity[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.velocity[6]);
+    data.velocity[7][5] += velocity[7];
+    data.acceleration[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.acceleration[6]);
+    data.acceleration[7] += cross_motion(data.velocity[7], unit_motion<5>(velocity[7]));
+    data.force[7] = INERTIA_7 * data.acceleration[7] + cross_force(data.velocity[7], INERTIA_7 * data.velocity[7]);
+
+    // panda_joint6
+    data.velocity[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.velocity[7]);
+    data.velocity[8][5] += velocity[8];
+    data.acceleration[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.acceleration[7]);
+    data.acceleration[8] += cross_motion(data.velocity[8], unit_motion<5>(velocity[8]));
+    data.force[8] = INERTIA_8 * data.acceleration[8] + cross_force(data.velocity[8], INERTIA_8 * data.velocity[8]);
+
+    // panda_joint7
+    data.velocity[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.velocity[8]);
+    data.velocity[9][5] += velocity[9];
+    data.acceleration[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.acceleration[8]);
+    data.acceleration[9] += cross_motion(data.velocity[9], unit_motion<5>(velocity[9]));
+    data.force[9] = INERTIA_9 * data.acceleration[9] + cross_force(data.velocity[9], INERTIA_9 * data.velocity[9]);
+
+    // panda_finger_joint1
+    data.velocity[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.velocity[9]);
+    data.velocity[10][1] += velocity[10];
+    data.acceleration[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.acceleration[9]);
+    data.acceleration[10] += cross_motion(data.velocity[10], unit_motion<1>(velocity[10]));
+    data.force[10] = INERTIA_10 * data.acceleration[10] + cross_force(data.velocity[10], INERTIA_10 * data.velocity[10]);
+
+    // panda_finger_joint2
+    data.velocity[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.velocity[9]);
+    data.velocity[11][1] -= velocity[11];
+    data.acceleration[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.acceleration[9]);
+    data.acceleration[11] += cross_motion(data.velocity[11], unit_motion<1>(-velocity[11]));
+    data.force[11] = INERTIA_11 * data.acceleration[11] + cross_force(data.velocity[11], INERTIA_11 * data.velocity[11]);
+
+    // Transmit the forces from the leaves to the root.
+    force[11] = -data.force[11][1];
+    data.force[9] += act_force(data.parent_rotation[11], data.parent_translation[11], data.force[11]);
+    force[10] = data.force[10][1];
+    data.force[9] += act_force(data.parent_rotation[10], data.parent_translation[10], data.force[10]);
+    force[9] = data.force[9][5];
+    data.force[8] += act_force(data.parent_rotation[9], data.parent_translation[9], data.force[9]);
+    force[8] = data.force[8][5];
+    data.force[7] += act_force(data.parent_rotation[8], data.parent_translation[8], data.force[8]);
+    force[7] = data.force[7][5];
+    data.force[6] += act_force(data.parent_rotation[7], data.parent_translation[7], data.force[7]);
+    force[6] = data.force[6][5];
+    data.force[5] += act_force(data.parent_rotation[6], data.parent_translation[6], data.force[6]);
+    force[5] = data.force[5][5];
+    data.force[4] += act_force(data.parent_rotation[5], data.parent_translation[5], data.force[5]);
+    force[4] = data.force[4][5];
+    data.force[3] += act_force(data.parent_rotation[4], data.parent_translation[4], data.force[4]);
+    force[3] = data.force[3][5];
+    data.force[2] += act_force(data.parent_rotation[3], data.parent_translation[3], data.force[3]);
+    force[2] = data.force[2][5];
+    data.force[1] += act_force(data.parent_rotation[2], data.parent_translation[2], data.force[2]);
+    force[1] = data.force[1][1];
+    data.force[0] += act_force(data.parent_rotation[1], data.parent_translation[1], data.force[1]);
+    force[0] = data.force[0][0];
+}
+
+void aba(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &force,
+    Eigen::Ref<VectorXd> acceleration
+) {
+    placements(data, position);
+
+    // Velocities, velocity product accelerations and bias forces from the
+    // root to the leaves.
+    // x_base_joint
+    data.velocity[0].setZero();
+    data.velocity[0][0] += velocity[0];
+    data.bias[0] = cross_motion(data.velocity[0], unit_motion<0>(velocity[0]));
+    data.inertia[0] = INERTIA_0;
+    data.force[0] = cross_force(data.velocity[0], INERTIA_0 * data.velocity[0]);
+
+    // y_base_joint
+    data.velocity[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.velocity[0]);
+    data.velocity[1][1] += velocity[1];
+    data.bias[1] = cross_motion(data.velocity[1], unit_motion<1>(velocity[1]));
+    data.inertia[1] = INERTIA_1;
+    data.force[1] = cross_force(data.velocity[1], INERTIA_1 * data.velocity[1]);
+
+    // pivot_joint
+    data.velocity[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.velocity[1]);
+    data.velocity[2][5] += velocity[2];
+    data.bias[2] = cross_motion(data.velocity[2], unit_motion<5>(velocity[2]));
+    data.inertia[2] = INERTIA_2;
+    data.force[2] = cross_force(data.velocity[2], INERTIA_2 * data.velocity[2]);
+
+    // panda_joint1
+    data.velocity[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.velocity[2]);
+    data.velocity[3][5] += velocity[3];
+    data.bias[3] = cross_motion(data.velocity[3], unit_motion<5>(velocity[3]));
+    data.inertia[3] = INERTIA_3;
+    data.force[3] = cross_force(data.velocity[3], INERTIA_3 * data.velocity[3]);
+
+    // panda_joint2
+    data.velocity[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.velocity[3]);
+    data.velocity[4][5] += velocity[4];
+    data.bias[4] = cross_motion(data.velocity[4], unit_motion<5>(velocity[4]));
+    data.inertia[4] = INERTIA_4;
+    data.force[4] = cross_force(data.velocity[4], INERTIA_4 * data.velocity[4]);
+
+    // panda_joint3
+    data.velocity[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.velocity[4]);
+    data.velocity[5][5] += velocity[5];
+    data.bias[5] = cross_motion(data.velocity[5], unit_motion<5>(velocity[5]));
+    data.inertia[5] = INERTIA_5;
+    data.force[5] = cross_force(data.velocity[5], INERTIA_5 * data.velocity[5]);
+
+    // panda_joint4
+    data.velocity[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.velocity[5]);
+    data.velocity[6][5] += velocity[6];
+    data.bias[6] = cross_motion(data.velocity[6], unit_motion<5>(velocity[6]));
+    data.inertia[6] = INERTIA_6;
+    data.force[6] = cross_force(data.velocity[6], INERTIA_6 * data.velocity[6]);
+
+    // panda_joint5
+    data.velocity[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.velocity[6]);
+    data.velocity[7][5] += velocity[7];
+    data.bias[7] = cross_motion(data.velocity[7], unit_motion<5>(velocity[7]));
+    data.inertia[7] = INERTIA_7;
+    data.force[7] = cross_force(data.velocity[7], INERTIA_7 * data.velocity[7]);
+
+    // panda_joint6
+    data.velocity[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.velocity[7]);
+    data.velocity[8][5] += velocity[8];
+    data.bias[8] = cross_motion(data.velocity[8], unit_motion<5>(velocity[8]));
+    data.inertia[8] = INERTIA_8;
+    data.force[8] = cross_force(data.velocity[8], INERTIA_8 * data.velocity[8]);
+
+    // panda_joint7
+    data.velocity[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.velocity[8]);
+    data.velocity[9][5] += velocity[9];
+    data.bias[9] = cross_motion(data.velocity[9], unit_motion<5>(velocity[9]));
+    data.inertia[9] = INERTIA_9;
+    data.force[9] = cross_force(data.velocity[9], INERTIA_9 * data.velocity[9]);
+
+    // panda_finger_joint1
+    data.velocity[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.velocity[9]);
+    data.velocity[10][1] += velocity[10];
+    data.bias[10] = cross_motion(data.velocity[10], unit_motion<1>(velocity[10]));
+    data.inertia[10] = INERTIA_10;
+    data.force[10] = cross_force(data.velocity[10], INERTIA_10 * data.velocity[10]);
+
+    // panda_finger_joint2
+    data.velocity[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.velocity[9]);
+    data.velocity[11][1] -= velocity[11];
+    data.bias[11] = cross_motion(data.velocity[11], unit_motion<1>(-velocity[11]));
+    data.inertia[11] = INERTIA_11;
+    data.force[11] = cross_force(data.velocity[11], INERTIA_11 * data.velocity[11]);
+
+    // Articulated inertias and bias forces from the leaves to the root.
+    // panda_finger_joint2
+    data.u_inertia[11] = -data.inertia[11].col(1);
+    data.d_inertia[11] = -data.u_inertia[11][1];
+    data.u_force[11] = force[11] - -data.force[11][1];
+    {
+        Matrix6d inertia = data.inertia[11] - data.u_inertia[11] * data.u_inertia[11].transpose() / data.d_inertia[11];
+        Vector6d bias = data.force[11] + inertia * data.bias[11] + data.u_inertia[11] * (data.u_force[11] / data.d_inertia[11]);
+        data.inertia[9] += inertia_to_parent(data.parent_rotation[11], data.parent_translation[11], inertia);
+        data.force[9] += act_force(data.parent_rotation[11], data.parent_translation[11], bias);
+    }
+
+    // panda_finger_joint1
+    data.u_inertia[10] = data.inertia[10].col(1);
+    data.d_inertia[10] = data.u_inertia[10][1];
+    data.u_force[10] = force[10] - data.force[10][1];
+    {
+        Matrix6d inertia = data.inertia[10] - data.u_inertia[10] * data.u_inertia[10].transpose() / data.d_inertia[10];
+        Vector6d bias = data.force[10] + inertia * data.bias[10] + data.u_inertia[10] * (data.u_force[10] / data.d_inertia[10]);
+        data.inertia[9] += inertia_to_parent(data.parent_rotation[10], data.parent_translation[10], inertia);
+        data.force[9] += act_force(data.parent_rotation[10], data.parent_translation[10], bias);
+    }
+
+    // panda_joint7
+    data.u_inertia[9] = data.inertia[9].col(5);
+    data.d_inertia[9] = data.u_inertia[9][5];
+    data.u_force[9] = force[9] - data.force[9][5];
+    {
+        Matrix6d inertia = data.inertia[9] - data.u_inertia[9] * data.u_inertia[9].transpose() / data.d_inertia[9];
+        Vector6d bias = data.force[9] + inertia * data.bias[9] + data.u_inertia[9] * (data.u_force[9] / data.d_inertia[9]);
+        data.inertia[8] += inertia_to_parent(data.parent_rotation[9], data.parent_translation[9], inertia);
+        data.force[8] += act_force(data.parent_rotation[9], data.parent_translation[9], bias);
+    }
+
+    // panda_joint6
+    data.u_inertia[8] = data.inertia[8].col(5);
+    data.d_inertia[8] = data.u_inertia[8][5];
+    data.u_force[8] = force[8] - data.force[8][5];
+    {
+        Matrix6d inertia = data.inertia[8] - data.u_inertia[8] * data.u_inertia[8].transpose() / data.d_inertia[8];
+        Vector6d bias = data.force[8] + inertia * data.bias[8] + data.u_inertia[8] * (data.u_force[8] / data.d_inertia[8]);
+        data.inertia[7] += inertia_to_parent(data.parent_rotation[8], data.parent_translation[8], inertia);
+        data.force[7] += act_force(data.parent_rotation[8], data.parent_translation[8], bias);
+    }
+
+    // panda_joint5
+    data.u_inertia[7] = data.inertia[7].col(5);
+    data.d_inertia[7] = data.u_inertia[7][5];
+    data.u_force[7] = force[7] - data.force[7][5];
+    {
+        Matrix6d inertia = data.inertia[7] - data.u_inertia[7] * data.u_inertia[7].transpose() / data.d_inertia[7];
+        Vector6d bias = data.force[7] + inertia * data.bias[7] + data.u_inertia[7] * (data.u_force[7] / data.d_inertia[7]);
+        data.inertia[6] += inertia_to_parent(data.parent_rotation[7], data.parent_translation[7], inertia);
+        data.force[6] += act_force(data.parent_rotation[7], data.parent_translation[7], bias);
+    }
+
+    // panda_joint4
+    data.u_inertia[6] = data.inertia[6].col(5);
+    data.d_inertia[6] = data.u_inertia[6][5];
+    data.u_force[6] = force[6] - data.force[6][5];
+    {
+        Matrix6d inertia = data.inertia[6] - data.u_inertia[6] * data.u_inertia[6].transpose() / data.d_inertia[6];
+        Vector6d bias = data.force[6] + inertia * data.bias[6] + data.u_inertia[6] * (data.u_force[6] / data.d_inertia[6]);
+        data.inertia[5] += inertia_to_parent(data.parent_rotation[6], data.parent_translation[6], inertia);
+        data.force[5] += act_force(data.parent_rotation[6], data.parent_translation[6], bias);
+    }
+
+    // panda_joint3
+    data.u_inertia[5] = data.inertia[5].col(5);
+    data.d_inertia[5] = data.u_inertia[5][5];
+    data.u_force[5] = force[5] - data.force[5][5];
+    {
+        Matrix6d inertia = data.inertia[5] - data.u_inertia[5] * data.u_inertia[5].transpose() / data.d_inertia[5];
+        Vector6d bias = data.force[5] + inertia * data.bias[5] + data.u_inertia[5] * (data.u_force[5] / data.d_inertia[5]);
+        data.inertia[4] += inertia_to_parent(data.parent_rotation[5], data.parent_translation[5], inertia);
+        data.force[4] += act_force(data.parent_rotation[5], data.parent_translation[5], bias);
+    }
+
+    // panda_joint2
+    data.u_inertia[4] = data.inertia[4].col(5);
+    data.d_inertia[4] = data.u_inertia[4][5];
+    data.u_force[4] = force[4] - data.force[4][5];
+    {
+        Matrix6d inertia = data.inertia[4] - data.u_inertia[4] * data.u_inertia[4].transpose() / data.d_inertia[4];
+        Vector6d bias = data.force[4] + inertia * data.bias[4] + data.u_inertia[4] * (data.u_force[4] / data.d_inertia[4]);
+        data.inertia[3] += inertia_to_parent(data.parent_rotation[4], data.parent_translation[4], inertia);
+        data.force[3] += act_force(data.parent_rotation[4], data.parent_translation[4], bias);
+    }
+
+    // panda_joint1
+    data.u_inertia[3] = data.inertia[3].col(5);
+    data.d_inertia[3] = data.u_inertia[3][5];
+    data.u_force[3] = force[3] - data.force[3][5];
+    {
+        Matrix6d inertia = data.inertia[3] - data.u_inertia[3] * data.u_inertia[3].transpose() / data.d_inertia[3];
+        Vector6d bias = data.force[3] + inertia * data.bias[3] + data.u_inertia[3] * (data.u_force[3] / data.d_inertia[3]);
+        data.inertia[2] += inertia_to_parent(data.parent_rotation[3], data.parent_translation[3], inertia);
+        data.force[2] += act_force(data.parent_rotation[3], data.parent_translation[3], bias);
+    }
+
+    // pivot_joint
+    data.u_inertia[2] = data.inertia[2].col(5);
+    data.d_inertia[2] = data.u_inertia[2][5];
+    data.u_force[2] = force[2] - data.force[2][5];
+    {
+        Matrix6d inertia = data.inertia[2] - data.u_inertia[2] * data.u_inertia[2].transpose() / data.d_inertia[2];
+        Vector6d bias = data.force[2] + inertia * data.bias[2] + data.u_inertia[2] * (data.u_force[2] / data.d_inertia[2]);
+        data.inertia[1] += inertia_to_parent(data.parent_rotation[2], data.parent_translation[2], inertia);
+        data.force[1] += act_force(data.parent_rotation[2], data.parent_translation[2], bias);
+    }
+
+    // y_base_joint
+    data.u_inertia[1] = data.inertia[1].col(1);
+    data.d_inertia[1] = data.u_inertia[1][1];
+    data.u_force[1] = force[1] - data.force[1][1];
+    {
+        Matrix6d inertia = data.inertia[1] - data.u_inertia[1] * data.u_inertia[1].transpose() / data.d_inertia[1];
+        Vector6d bias = data.force[1] + inertia * data.bias[1] + data.u_inertia[1] * (data.u_force[1] / data.d_inertia[1]);
+        data.inertia[0] += inertia_to_parent(data.parent_rotation[1], data.parent_translation[1], inertia);
+        data.force[0] += act_force(data.parent_rotation[1], data.parent_translation[1], bias);
+    }
+
+    // x_base_joint
+    data.u_inertia[0] = data.inertia[0].col(0);
+    data.d_inertia[0] = data.u_inertia[0][0];
+    data.u_force[0] = force[0] - data.force[0][0];
+
+    // Accelerations from the root to the leaves.
+    // x_base_joint
+    data.acceleration[0] = act_inverse(data.parent_rotation[0], data.parent_translation[0], GRAVITY_ACCELERATION) + data.bias[0];
+    acceleration[0] = (data.u_force[0] - data.u_inertia[0].dot(data.acceleration[0])) / data.d_inertia[0];
+    data.acceleration[0][0] += acceleration[0];
+
+    // y_base_joint
+    data.acceleration[1] = act_inverse(data.parent_rotation[1], data.parent_translation[1], data.acceleration[0]) + data.bias[1];
+    acceleration[1] = (data.u_force[1] - data.u_inertia[1].dot(data.acceleration[1])) / data.d_inertia[1];
+    data.acceleration[1][1] += acceleration[1];
+
+    // pivot_joint
+    data.acceleration[2] = act_inverse(data.parent_rotation[2], data.parent_translation[2], data.acceleration[1]) + data.bias[2];
+    acceleration[2] = (data.u_force[2] - data.u_inertia[2].dot(data.acceleration[2])) / data.d_inertia[2];
+    data.acceleration[2][5] += acceleration[2];
+
+    // panda_joint1
+    data.acceleration[3] = act_inverse(data.parent_rotation[3], data.parent_translation[3], data.acceleration[2]) + data.bias[3];
+    acceleration[3] = (data.u_force[3] - data.u_inertia[3].dot(data.acceleration[3])) / data.d_inertia[3];
+    data.acceleration[3][5] += acceleration[3];
+
+    // panda_joint2
+    data.acceleration[4] = act_inverse(data.parent_rotation[4], data.parent_translation[4], data.acceleration[3]) + data.bias[4];
+    acceleration[4] = (data.u_force[4] - data.u_inertia[4].dot(data.acceleration[4])) / data.d_inertia[4];
+    data.acceleration[4][5] += acceleration[4];
+
+    // panda_joint3
+    data.acceleration[5] = act_inverse(data.parent_rotation[5], data.parent_translation[5], data.acceleration[4]) + data.bias[5];
+    acceleration[5] = (data.u_force[5] - data.u_inertia[5].dot(data.acceleration[5])) / data.d_inertia[5];
+    data.acceleration[5][5] += acceleration[5];
+
+    // panda_joint4
+    data.acceleration[6] = act_inverse(data.parent_rotation[6], data.parent_translation[6], data.acceleration[5]) + data.bias[6];
+    acceleration[6] = (data.u_force[6] - data.u_inertia[6].dot(data.acceleration[6])) / data.d_inertia[6];
+    data.acceleration[6][5] += acceleration[6];
+
+    // panda_joint5
+    data.acceleration[7] = act_inverse(data.parent_rotation[7], data.parent_translation[7], data.acceleration[6]) + data.bias[7];
+    acceleration[7] = (data.u_force[7] - data.u_inertia[7].dot(data.acceleration[7])) / data.d_inertia[7];
+    data.acceleration[7][5] += acceleration[7];
+
+    // panda_joint6
+    data.acceleration[8] = act_inverse(data.parent_rotation[8], data.parent_translation[8], data.acceleration[7]) + data.bias[8];
+    acceleration[8] = (data.u_force[8] - data.u_inertia[8].dot(data.acceleration[8])) / data.d_inertia[8];
+    data.acceleration[8][5] += acceleration[8];
+
+    // panda_joint7
+    data.acceleration[9] = act_inverse(data.parent_rotation[9], data.parent_translation[9], data.acceleration[8]) + data.bias[9];
+    acceleration[9] = (data.u_force[9] - data.u_inertia[9].dot(data.acceleration[9])) / data.d_inertia[9];
+    data.acceleration[9][5] += acceleration[9];
+
+    // panda_finger_joint1
+    data.acceleration[10] = act_inverse(data.parent_rotation[10], data.parent_translation[10], data.acceleration[9]) + data.bias[10];
+    acceleration[10] = (data.u_force[10] - data.u_inertia[10].dot(data.acceleration[10])) / data.d_inertia[10];
+    data.acceleration[10][1] += acceleration[10];
+
+    // panda_finger_joint2
+    data.acceleration[11] = act_inverse(data.parent_rotation[11], data.parent_translation[11], data.acceleration[9]) + data.bias[11];
+    acceleration[11] = (data.u_force[11] - data.u_inertia[11].dot(data.acceleration[11])) / data.d_inertia[11];
+    data.acceleration[11][1] -= acceleration[11];
+}
+
+void frame_placement(const Data &data, int frame, Matrix3d &rotation, Vector3d &translation)
+{
+    switch (frame) {
+    case 0: // world
+        rotation = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = Vector3d(0.0, 0.0, 0.0);
+        return;
+    case 1: // world_joint
+        rotation = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = Vector3d(0.0, 0.0, 0.0);
+        return;
+    case 2: // omni_base_root_link
+        rotation = (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = Vector3d(0.0, 0.0, 0.0);
+        return;
+    case 3: // x_base_joint
+        rotation = data.rotation[0];
+        translation = data.translation[0];
+        return;
+    case 4: // x_slider
+        rotation = data.rotation[0];
+        translation = data.translation[0];
+        return;
+    case 5: // y_base_joint
+        rotation = data.rotation[1];
+        translation = data.translation[1];
+        return;
+    case 6: // y_slider
+        rotation = data.rotation[1];
+        translation = data.translation[1];
+        return;
+    case 7: // pivot_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 8: // pivot
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 9: // omni_base_flange
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 10: // base_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 11: // base_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 12: // chassis_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 13: // right_side_cover_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 14: // right_side_cover_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 15: // left_side_cover_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 16: // left_side_cover_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 17: // front_cover_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 18: // front_cover_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 19: // rear_cover_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 20: // rear_cover_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 21: // front_lights_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 22: // front_lights_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 23: // rear_lights_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 24: // rear_lights_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 25: // top_link_joint
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 26: // top_link
+        rotation = data.rotation[2];
+        translation = data.translation[2];
+        return;
+    case 27: // axle_joint
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.0, 0.0, 0.05);
+        return;
+    case 28: // axle_link
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.0, 0.0, 0.05);
+        return;
+    case 29: // imu_joint
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.2085, -0.2902, 0.1681);
+        return;
+    case 30: // imu_link
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.2085, -0.2902, 0.1681);
+        return;
+    case 31: // mid_mount_joint
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.0, 0.0, 0.28);
+        return;
+    case 32: // mid_mount
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.0, 0.0, 0.28);
+        return;
+    case 33: // ridgeback_sensor_mount_joint
+        rotation = data.rotation[2] * (Matrix3d() << -0.00020367320369517786, -0.9999999792586128, 0.0, 0.9999999792586128, -0.00020367320369517786, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.0, 0.0, 0.28);
+        return;
+    case 34: // ridgeback_sensor_mount_link
+        rotation = data.rotation[2] * (Matrix3d() << -0.00020367320369517786, -0.9999999792586128, 0.0, 0.9999999792586128, -0.00020367320369517786, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.0, 0.0, 0.28);
+        return;
+    case 35: // reference_link_joint
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(-0.343, 0.0, 1.05);
+        return;
+    case 36: // reference_link
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(-0.343, 0.0, 1.05);
+        return;
+    case 37: // arm_mount_joint
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.295, 0.005, 0.7250000000000001);
+        return;
+    case 38: // franka_mount_link
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.295, 0.005, 0.7250000000000001);
+        return;
+    case 39: // panda_joint_franka_mount_link
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.295, 0.005, 0.7250000000000001);
+        return;
+    case 40: // panda_link0
+        rotation = data.rotation[2] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[2] + data.rotation[2] * Vector3d(0.295, 0.005, 0.7250000000000001);
+        return;
+    case 41: // panda_joint1
+        rotation = data.rotation[3];
+        translation = data.translation[3];
+        return;
+    case 42: // panda_link1
+        rotation = data.rotation[3];
+        translation = data.translation[3];
+        return;
+    case 43: // panda_joint2
+        rotation = data.rotation[4];
+        translation = data.translation[4];
+        return;
+    case 44: // panda_link2
+        rotation = data.rotation[4];
+        translation = data.translation[4];
+        return;
+    case 45: // panda_joint3
+        rotation = data.rotation[5];
+        translation = data.translation[5];
+        return;
+    case 46: // panda_link3
+        rotation = data.rotation[5];
+        translation = data.translation[5];
+        return;
+    case 47: // panda_joint4
+        rotation = data.rotation[6];
+        translation = data.translation[6];
+        return;
+    case 48: // panda_link4
+        rotation = data.rotation[6];
+        translation = data.translation[6];
+        return;
+    case 49: // panda_joint5
+        rotation = data.rotation[7];
+        translation = data.translation[7];
+        return;
+    case 50: // panda_link5
+        rotation = data.rotation[7];
+        translation = data.translation[7];
+        return;
+    case 51: // panda_joint6
+        rotation = data.rotation[8];
+        translation = data.translation[8];
+        return;
+    case 52: // panda_link6
+        rotation = data.rotation[8];
+        translation = data.translation[8];
+        return;
+    case 53: // panda_joint7
+        rotation = data.rotation[9];
+        translation = data.translation[9];
+        return;
+    case 54: // panda_link7
+        rotation = data.rotation[9];
+        translation = data.translation[9];
+        return;
+    case 55: // panda_joint8
+        rotation = data.rotation[9] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[9] + data.rotation[9] * Vector3d(0.0, 0.0, 0.107);
+        return;
+    case 56: // panda_link8
+        rotation = data.rotation[9] * (Matrix3d() << 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[9] + data.rotation[9] * Vector3d(0.0, 0.0, 0.107);
+        return;
+    case 57: // panda_hand_joint
+        rotation = data.rotation[9] * (Matrix3d() << 0.7071067811868645, 0.7071067811862305, 0.0, -0.7071067811862305, 0.7071067811868645, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[9] + data.rotation[9] * Vector3d(0.0, 0.0, 0.107);
+        return;
+    case 58: // panda_hand
+        rotation = data.rotation[9] * (Matrix3d() << 0.7071067811868645, 0.7071067811862305, 0.0, -0.7071067811862305, 0.7071067811868645, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[9] + data.rotation[9] * Vector3d(0.0, 0.0, 0.107);
+        return;
+    case 59: // panda_finger_joint1
+        rotation = data.rotation[10];
+        translation = data.translation[10];
+        return;
+    case 60: // panda_leftfinger
+        rotation = data.rotation[10];
+        translation = data.translation[10];
+        return;
+    case 61: // panda_finger_joint2
+        rotation = data.rotation[11];
+        translation = data.translation[11];
+        return;
+    case 62: // panda_rightfinger
+        rotation = data.rotation[11];
+        translation = data.translation[11];
+        return;
+    case 63: // panda_grasp_joint
+        rotation = data.rotation[9] * (Matrix3d() << 0.7071067811868645, 0.7071067811862305, 0.0, -0.7071067811862305, 0.7071067811868645, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[9] + data.rotation[9] * Vector3d(0.0, 0.0, 0.202);
+        return;
+    case 64: // panda_grasp
+        rotation = data.rotation[9] * (Matrix3d() << 0.7071067811868645, 0.7071067811862305, 0.0, -0.7071067811862305, 0.7071067811868645, 0.0, 0.0, 0.0, 1.0).finished();
+        translation = data.translation[9] + data.rotation[9] * Vector3d(0.0, 0.0, 0.202);
+        return;
+    }
+}
+
+Vector6d frame_velocity(const Data &data, int frame)
+{
+    switch (frame) {
+    case 0: // world
+    case 1: // world_joint
+    case 2: // omni_base_root_link
+        return Vector6d::Zero();
+    case 3: // x_base_joint
+    case 4: // x_slider
+        return act(data.rotation[0], data.translation[0], data.velocity[0]);
+    case 5: // y_base_joint
+    case 6: // y_slider
+        return act(data.rotation[1], data.translation[1], data.velocity[1]);
+    case 7: // pivot_joint
+    case 8: // pivot
+    case 9: // omni_base_flange
+    case 10: // base_link
+    case 11: // base_link_joint
+    case 12: // chassis_link
+    case 13: // right_side_cover_link_joint
+    case 14: // right_side_cover_link
+    case 15: // left_side_cover_link_joint
+    case 16: // left_side_cover_link
+    case 17: // front_cover_link_joint
+    case 18: // front_cover_link
+    case 19: // rear_cover_link_joint
+    case 20: // rear_cover_link
+    case 21: // front_lights_link_joint
+    case 22: // front_lights_link
+    case 23: // rear_lights_link_joint
+    case 24: // rear_lights_link
+    case 25: // top_link_joint
+    case 26: // top_link
+    case 27: // axle_joint
+    case 28: // axle_link
+    case 29: // imu_joint
+    case 30: // imu_link
+    case 31: // mid_mount_joint
+    case 32: // mid_mount
+    case 33: // ridgeback_sensor_mount_joint
+    case 34: // ridgeback_sensor_mount_link
+    case 35: // reference_link_joint
+    case 36: // reference_link
+    case 37: // arm_mount_joint
+    case 38: // franka_mount_link
+    case 39: // panda_joint_franka_mount_link
+    case 40: // panda_link0
+        return act(data.rotation[2], data.translation[2], data.velocity[2]);
+    case 41: // panda_joint1
+    case 42: // panda_link1
+        return act(data.rotation[3], data.translation[3], data.velocity[3]);
+    case 43: // panda_joint2
+    case 44: // panda_link2
+        return act(data.rotation[4], data.translation[4], data.velocity[4]);
+    case 45: // panda_joint3
+    case 46: // panda_link3
+        return act(data.rotation[5], data.translation[5], data.velocity[5]);
+    case 47: // panda_joint4
+    case 48: // panda_link4
+        return act(data.rotation[6], data.translation[6], data.velocity[6]);
+    case 49: // panda_joint5
+    case 50: // panda_link5
+        return act(data.rotation[7], data.translation[7], data.velocity[7]);
+    case 51: // panda_joint6
+    case 52: // panda_link6
+        return act(data.rotation[8], data.translation[8], data.velocity[8]);
+    case 53: // panda_joint7
+    case 54: // panda_link7
+    case 55: // panda_joint8
+    case 56: // panda_link8
+    case 57: // panda_hand_joint
+    case 58: // panda_hand
+    case 63: // panda_grasp_joint
+    case 64: // panda_grasp
+        return act(data.rotation[9], data.translation[9], data.velocity[9]);
+    case 59: // panda_finger_joint1
+    case 60: // panda_leftfinger
+        return act(data.rotation[10], data.translation[10], data.velocity[10]);
+    case 61: // panda_finger_joint2
+    case 62: // panda_rightfinger
+        return act(data.rotation[11], data.translation[11], data.velocity[11]);
+    }
+
+    return Vector6d::Zero();
+}
+
+Vector6d frame_acceleration(const Data &data, int frame)
+{
+    switch (frame) {
+    case 0: // world
+    case 1: // world_joint
+    case 2: // omni_base_root_link
+        return Vector6d::Zero();
+    case 3: // x_base_joint
+    case 4: // x_slider
+        return act(data.rotation[0], data.translation[0], data.acceleration[0]);
+    case 5: // y_base_joint
+    case 6: // y_slider
+        return act(data.rotation[1], data.translation[1], data.acceleration[1]);
+    case 7: // pivot_joint
+    case 8: // pivot
+    case 9: // omni_base_flange
+    case 10: // base_link
+    case 11: // base_link_joint
+    case 12: // chassis_link
+    case 13: // right_side_cover_link_joint
+    case 14: // right_side_cover_link
+    case 15: // left_side_cover_link_joint
+    case 16: // left_side_cover_link
+    case 17: // front_cover_link_joint
+    case 18: // front_cover_link
+    case 19: // rear_cover_link_joint
+    case 20: // rear_cover_link
+    case 21: // front_lights_link_joint
+    case 22: // front_lights_link
+    case 23: // rear_lights_link_joint
+    case 24: // rear_lights_link
+    case 25: // top_link_joint
+    case 26: // top_link
+    case 27: // axle_joint
+    case 28: // axle_link
+    case 29: // imu_joint
+    case 30: // imu_link
+    case 31: // mid_mount_joint
+    case 32: // mid_mount
+    case 33: // ridgeback_sensor_mount_joint
+    case 34: // ridgeback_sensor_mount_link
+    case 35: // reference_link_joint
+    case 36: // reference_link
+    case 37: // arm_mount_joint
+    case 38: // franka_mount_link
+    case 39: // panda_joint_franka_mount_link
+    case 40: // panda_link0
+        return act(data.rotation[2], data.translation[2], data.acceleration[2]);
+    case 41: // panda_joint1
+    case 42: // panda_link1
+        return act(data.rotation[3], data.translation[3], data.acceleration[3]);
+    case 43: // panda_joint2
+    case 44: // panda_link2
+        return act(data.rotation[4], data.translation[4], data.acceleration[4]);
+    case 45: // panda_joint3
+    case 46: // panda_link3
+        return act(data.rotation[5], data.translation[5], data.acceleration[5]);
+    case 47: // panda_joint4
+    case 48: // panda_link4
+        return act(data.rotation[6], data.translation[6], data.acceleration[6]);
+    case 49: // panda_joint5
+    case 50: // panda_link5
+        return act(data.rotation[7], data.translation[7], data.acceleration[7]);
+    case 51: // panda_joint6
+    case 52: // panda_link6
+        return act(data.rotation[8], data.translation[8], data.acceleration[8]);
+    case 53: // panda_joint7
+    case 54: // panda_link7
+    case 55: // panda_joint8
+    case 56: // panda_link8
+    case 57: // panda_hand_joint
+    case 58: // panda_hand
+    case 63: // panda_grasp_joint
+    case 64: // panda_grasp
+        return act(data.rotation[9], data.translation[9], data.acceleration[9]);
+    case 59: // panda_finger_joint1
+    case 60: // panda_leftfinger
+        return act(data.rotation[10], data.translation[10], data.acceleration[10]);
+    case 61: // panda_finger_joint2
+    case 62: // panda_rightfinger
+        return act(data.rotation[11], data.translation[11], data.acceleration[11]);
+    }
+
+    return Vector6d::Zero();
+}
+
+void frame_jacobian(const Data &data, int frame, Jacobian &jacobian)
+{
+    jacobian.setZero();
+
+    switch (frame) {
+    case 0: // world
+    case 1: // world_joint
+    case 2: // omni_base_root_link
+        return;
+    case 3: // x_base_joint
+    case 4: // x_slider
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        return;
+    case 5: // y_base_joint
+    case 6: // y_slider
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        return;
+    case 7: // pivot_joint
+    case 8: // pivot
+    case 9: // omni_base_flange
+    case 10: // base_link
+    case 11: // base_link_joint
+    case 12: // chassis_link
+    case 13: // right_side_cover_link_joint
+    case 14: // right_side_cover_link
+    case 15: // left_side_cover_link_joint
+    case 16: // left_side_cover_link
+    case 17: // front_cover_link_joint
+    case 18: // front_cover_link
+    case 19: // rear_cover_link_joint
+    case 20: // rear_cover_link
+    case 21: // front_lights_link_joint
+    case 22: // front_lights_link
+    case 23: // rear_lights_link_joint
+    case 24: // rear_lights_link
+    case 25: // top_link_joint
+    case 26: // top_link
+    case 27: // axle_joint
+    case 28: // axle_link
+    case 29: // imu_joint
+    case 30: // imu_link
+    case 31: // mid_mount_joint
+    case 32: // mid_mount
+    case 33: // ridgeback_sensor_mount_joint
+    case 34: // ridgeback_sensor_mount_link
+    case 35: // reference_link_joint
+    case 36: // reference_link
+    case 37: // arm_mount_joint
+    case 38: // franka_mount_link
+    case 39: // panda_joint_franka_mount_link
+    case 40: // panda_link0
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        return;
+    case 41: // panda_joint1
+    case 42: // panda_link1
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        return;
+    case 43: // panda_joint2
+    case 44: // panda_link2
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        return;
+    case 45: // panda_joint3
+    case 46: // panda_link3
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        return;
+    case 47: // panda_joint4
+    case 48: // panda_link4
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        jacobian.col(6) = act(data.rotation[6], data.translation[6], unit_motion<5>(1.0));
+        return;
+    case 49: // panda_joint5
+    case 50: // panda_link5
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        jacobian.col(6) = act(data.rotation[6], data.translation[6], unit_motion<5>(1.0));
+        jacobian.col(7) = act(data.rotation[7], data.translation[7], unit_motion<5>(1.0));
+        return;
+    case 51: // panda_joint6
+    case 52: // panda_link6
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        jacobian.col(6) = act(data.rotation[6], data.translation[6], unit_motion<5>(1.0));
+        jacobian.col(7) = act(data.rotation[7], data.translation[7], unit_motion<5>(1.0));
+        jacobian.col(8) = act(data.rotation[8], data.translation[8], unit_motion<5>(1.0));
+        return;
+    case 53: // panda_joint7
+    case 54: // panda_link7
+    case 55: // panda_joint8
+    case 56: // panda_link8
+    case 57: // panda_hand_joint
+    case 58: // panda_hand
+    case 63: // panda_grasp_joint
+    case 64: // panda_grasp
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        jacobian.col(6) = act(data.rotation[6], data.translation[6], unit_motion<5>(1.0));
+        jacobian.col(7) = act(data.rotation[7], data.translation[7], unit_motion<5>(1.0));
+        jacobian.col(8) = act(data.rotation[8], data.translation[8], unit_motion<5>(1.0));
+        jacobian.col(9) = act(data.rotation[9], data.translation[9], unit_motion<5>(1.0));
+        return;
+    case 59: // panda_finger_joint1
+    case 60: // panda_leftfinger
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        jacobian.col(6) = act(data.rotation[6], data.translation[6], unit_motion<5>(1.0));
+        jacobian.col(7) = act(data.rotation[7], data.translation[7], unit_motion<5>(1.0));
+        jacobian.col(8) = act(data.rotation[8], data.translation[8], unit_motion<5>(1.0));
+        jacobian.col(9) = act(data.rotation[9], data.translation[9], unit_motion<5>(1.0));
+        jacobian.col(10) = act(data.rotation[10], data.translation[10], unit_motion<1>(1.0));
+        return;
+    case 61: // panda_finger_joint2
+    case 62: // panda_rightfinger
+        jacobian.col(0) = act(data.rotation[0], data.translation[0], unit_motion<0>(1.0));
+        jacobian.col(1) = act(data.rotation[1], data.translation[1], unit_motion<1>(1.0));
+        jacobian.col(2) = act(data.rotation[2], data.translation[2], unit_motion<5>(1.0));
+        jacobian.col(3) = act(data.rotation[3], data.translation[3], unit_motion<5>(1.0));
+        jacobian.col(4) = act(data.rotation[4], data.translation[4], unit_motion<5>(1.0));
+        jacobian.col(5) = act(data.rotation[5], data.translation[5], unit_motion<5>(1.0));
+        jacobian.col(6) = act(data.rotation[6], data.translation[6], unit_motion<5>(1.0));
+        jacobian.col(7) = act(data.rotation[7], data.translation[7], unit_motion<5>(1.0));
+        jacobian.col(8) = act(data.rotation[8], data.translation[8], unit_motion<5>(1.0));
+        jacobian.col(9) = act(data.rotation[9], data.translation[9], unit_motion<5>(1.0));
+        jacobian.col(11) = act(data.rotation[11], data.translation[11], unit_motion<1>(-1.0));
+        return;
+    }
+}
+
+} // namespace FrankaRidgeback::Kernel
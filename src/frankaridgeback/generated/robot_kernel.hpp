@@ -0,0 +1,267 @@
+// Generated by scripts/generate_dynamics.py from robot.urdf. Do not edit,
+// regenerate with the generate_dynamics target when the model changes.
+
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include "controller/eigen.hpp"
+
+/**
+ * @brief A fixed size dynamics kernel for the kinematic tree of
+ * robot.urdf.
+ *
+ * Spatial quantities are in (linear, angular) order. Body quantities are
+ * expressed in the body frame, and world quantities at the world origin, as in
+ * pinocchio.
+ */
+namespace FrankaRidgeback::Kernel {
+
+using Matrix3d = Eigen::Matrix3d;
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+/// The degrees of freedom of the tree, one per body.
+inline constexpr int DOF = 12;
+
+/// The number of frames, one for each joint and link.
+inline constexpr int FRAMES = 65;
+
+/// The name of each frame.
+inline constexpr std::array<std::string_view, FRAMES> FRAME_NAMES {{
+    "world",
+    "world_joint",
+    "omni_base_root_link",
+    "x_base_joint",
+    "x_slider",
+    "y_base_joint",
+    "y_slider",
+    "pivot_joint",
+    "pivot",
+    "omni_base_flange",
+    "base_link",
+    "base_link_joint",
+    "chassis_link",
+    "right_side_cover_link_joint",
+    "right_side_cover_link",
+    "left_side_cover_link_joint",
+    "left_side_cover_link",
+    "front_cover_link_joint",
+    "front_cover_link",
+    "rear_cover_link_joint",
+    "rear_cover_link",
+    "front_lights_link_joint",
+    "front_lights_link",
+    "rear_lights_link_joint",
+    "rear_lights_link",
+    "top_link_joint",
+    "top_link",
+    "axle_joint",
+    "axle_link",
+    "imu_joint",
+    "imu_link",
+    "mid_mount_joint",
+    "mid_mount",
+    "ridgeback_sensor_mount_joint",
+    "ridgeback_sensor_mount_link",
+    "reference_link_joint",
+    "reference_link",
+    "arm_mount_joint",
+    "franka_mount_link",
+    "panda_joint_franka_mount_link",
+    "panda_link0",
+    "panda_joint1",
+    "panda_link1",
+    "panda_joint2",
+    "panda_link2",
+    "panda_joint3",
+    "panda_link3",
+    "panda_joint4",
+    "panda_link4",
+    "panda_joint5",
+    "panda_link5",
+    "panda_joint6",
+    "panda_link6",
+    "panda_joint7",
+    "panda_link7",
+    "panda_joint8",
+    "panda_link8",
+    "panda_hand_joint",
+    "panda_hand",
+    "panda_finger_joint1",
+    "panda_leftfinger",
+    "panda_finger_joint2",
+    "panda_rightfinger",
+    "panda_grasp_joint",
+    "panda_grasp"
+}};
+
+/// The jacobian of a frame in the world.
+using Jacobian = Eigen::Matrix<double, 6, DOF>;
+
+/**
+ * @brief The quantities of each body computed by the kernel functions.
+ */
+struct Data {
+
+    /// The rotation of each body relative to its parent.
+    std::array<Matrix3d, DOF> parent_rotation;
+
+    /// The translation of each body relative to its parent.
+    std::array<Vector3d, DOF> parent_translation;
+
+    /// The rotation of each body in the world.
+    std::array<Matrix3d, DOF> rotation;
+
+    /// The translation of each body in the world.
+    std::array<Vector3d, DOF> translation;
+
+    /// The spatial velocity of each body.
+    std::array<Vector6d, DOF> velocity;
+
+    /// The spatial acceleration of each body.
+    std::array<Vector6d, DOF> acceleration;
+
+    /// The velocity product acceleration of each body.
+    std::array<Vector6d, DOF> bias;
+
+    /// The articulated inertia of each body.
+    std::array<Matrix6d, DOF> inertia;
+
+    /// The articulated bias force, or the force transmitted by each joint.
+    std::array<Vector6d, DOF> force;
+
+    /// The articulated inertia along each joint subspace.
+    std::array<Vector6d, DOF> u_inertia;
+
+    /// The joint space articulated inertia of each joint.
+    std::array<double, DOF> d_inertia;
+
+    /// The joint force not yet balanced by each body.
+    std::array<double, DOF> u_force;
+};
+
+/**
+ * @brief Find a frame by name.
+ * @param name The name of the frame.
+ * @returns The index of the frame, or -1 if there is no such frame.
+ */
+inline int find_frame(std::string_view name)
+{
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        if (FRAME_NAMES[frame] == name)
+            return frame;
+    }
+    return -1;
+}
+
+/**
+ * @brief Compute the placement of each body.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ */
+void placements(Data &data, const Eigen::Ref<const VectorXd> &position);
+
+/**
+ * @brief Compute the placement, velocity and acceleration of each body,
+ * without gravity.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param acceleration The joint accelerations.
+ */
+void forward_kinematics(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &acceleration
+);
+
+/**
+ * @brief Compute the joint forces for the joint accelerations with the
+ * recursive newton euler algorithm.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param acceleration The joint accelerations.
+ * @param force The joint forces to set.
+ */
+void rnea(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &acceleration,
+    Eigen::Ref<VectorXd> force
+);
+
+/**
+ * @brief Compute the joint forces of gravity and the velocity product terms
+ * with the recursive newton euler algorithm.
+ *
+ * @param data The data to update.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param force The joint forces to set.
+ */
+void non_linear_effects(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    Eigen::Ref<VectorXd> force
+);
+
+/**
+ * @brief Compute the joint accelerations from the joint forces with the
+ * articulated body algorithm.
+ *
+ * @param data The data to update. The body accelerations include gravity.
+ * @param position The joint positions.
+ * @param velocity The joint velocities.
+ * @param force The joint forces.
+ * @param acceleration The joint accelerations to set.
+ */
+void aba(
+    Data &data,
+    const Eigen::Ref<const VectorXd> &position,
+    const Eigen::Ref<const VectorXd> &velocity,
+    const Eigen::Ref<const VectorXd> &force,
+    Eigen::Ref<VectorXd> acceleration
+);
+
+/**
+ * @brief Get the placement of a frame in the world, after the body
+ * placements are computed.
+ *
+ * @param data The kernel data.
+ * @param frame The index of the frame.
+ * @param rotation The rotation of the frame to set.
+ * @param translation The translation of the frame to set.
+ */
+void frame_placement(const Data &data, int frame, Matrix3d &rotation, Vector3d &translation);
+
+/**
+ * @brief Get the spatial velocity of a frame in the world, after the forward
+ * kinematics are computed.
+ */
+Vector6d frame_velocity(const Data &data, int frame);
+
+/**
+ * @brief Get the spatial acceleration of a frame in the world, after the
+ * forward kinematics are computed.
+ */
+Vector6d frame_acceleration(const Data &data, int frame);
+
+/**
+ * @brief Get the jacobian of a frame in the world, after the body placements
+ * are computed.
+ *
+ * @param data The kernel data.
+ * @param frame The index of the frame.
+ * @param jacobian The jacobian to set.
+ */
+void frame_jacobian(const Data &data, int frame, Jacobian &jacobian);
+
+} // namespace FrankaRidgeback::Kernel
@@ -0,0 +1,185 @@
+#include "frankaridgeback/generated_dynamics.hpp"
+
+#include <cmath>
+#include <iostream>
+
+namespace FrankaRidgeback {
+
+static_assert(Kernel::DOF == DoF::JOINTS, "generated kernel does not match the robot");
+
+std::unique_ptr<GeneratedDynamics> GeneratedDynamics::create(
+    const Configuration &configuration,
+    std::unique_ptr<DynamicsForecast::Handle> &&dynamics_forecast_handle
+) {
+    int end_effector_frame = Kernel::find_frame(configuration.end_effector_frame);
+    if (end_effector_frame < 0) {
+        std::cerr << "generated dynamics has no end effector frame \""
+                  << configuration.end_effector_frame << "\"" << std::endl;
+        return nullptr;
+    }
+
+    std::array<int, (std::size_t)Frame::_SIZE> frames;
+    for (std::size_t frame = 0; frame < frames.size(); ++frame) {
+        frames[frame] = Kernel::find_frame(FRAME_NAMES[frame]);
+        if (frames[frame] < 0) {
+            std::cerr << "generated dynamics has no frame \"" << FRAME_NAMES[frame] << "\"" << std::endl;
+            return nullptr;
+        }
+    }
+
+    std::array<int, (std::size_t)Link::_SIZE> links;
+    for (std::size_t link = 0; link < links.size(); ++link) {
+        links[link] = Kernel::find_frame(LINK_NAMES[link]);
+        if (links[link] < 0) {
+            std::cerr << "generated dynamics has no link \"" << LINK_NAMES[link] << "\"" << std::endl;
+            return nullptr;
+        }
+    }
+
+    return std::unique_ptr<GeneratedDynamics>(
+        new GeneratedDynamics(
+            configuration,
+            std::move(dynamics_forecast_handle),
+            end_effector_frame,
+            frames,
+            links
+        )
+    );
+}
+
+GeneratedDynamics::GeneratedDynamics(
+    const Configuration &configuration,
+    std::unique_ptr<DynamicsForecast::Handle> &&dynamics_forecast_handle,
+    int end_effector_frame,
+    const std::array<int, (std::size_t)Frame::_SIZE> &frames,
+    const std::array<int, (std::size_t)Link::_SIZE> &links
+  ) : m_configuration(configuration)
+    , m_data()
+    , m_end_effector_frame(end_effector_frame)
+    , m_frames(frames)
+    , m_links(links)
+    , m_joint_position(VectorXd::Zero(DoF::JOINTS))
+    , m_joint_velocity(VectorXd::Zero(DoF::JOINTS))
+    , m_joint_torque(VectorXd::Zero(DoF::JOINTS))
+    , m_non_linear_torque(VectorXd::Zero(DoF::JOINTS))
+    , m_joint_acceleration(VectorXd::Zero(DoF::JOINTS))
+    , m_end_effector_state()
+    , m_forecast(std::move(dynamics_forecast_handle))
+    , m_power(0.0)
+    , m_energy_tank(configuration.energy)
+    , m_state()
+    , m_time(0.0)
+{
+    set_state(configuration.initial_state, m_time);
+}
+
+std::unique_ptr<mppi::Dynamics> GeneratedDynamics::copy()
+{
+    std::unique_ptr<DynamicsForecast::Handle> forecast = nullptr;
+    if (m_forecast)
+        forecast = m_forecast->copy();
+
+    return std::unique_ptr<GeneratedDynamics>(
+        new GeneratedDynamics(
+            m_configuration,
+            std::move(forecast),
+            m_end_effector_frame,
+            m_frames,
+            m_links
+        )
+    );
+}
+
+void GeneratedDynamics::set_state(const Eigen::VectorXd &state, double time)
+{
+    m_time = time;
+    m_state = state;
+    m_joint_position = m_state.position();
+    m_joint_velocity = m_state.velocity();
+    m_energy_tank.set_energy(m_state.available_energy().value());
+
+    calculate();
+}
+
+void GeneratedDynamics::calculate()
+{
+    // Gravity compensation.
+    Kernel::non_linear_effects(m_data, m_joint_position, m_joint_velocity, m_non_linear_torque);
+    m_joint_torque += m_non_linear_torque;
+
+    // Calculate the joint accelerations.
+    Kernel::aba(
+        m_data,
+        m_joint_position,
+        m_joint_velocity,
+        m_joint_torque,
+        m_joint_acceleration
+    );
+
+    // Second order forward kinematics for acceleration calculations.
+    Kernel::forward_kinematics(
+        m_data,
+        m_joint_position,
+        m_joint_velocity,
+        m_joint_acceleration
+    );
+
+    // Get the end effector jacobian.
+    Kernel::frame_jacobian(m_data, m_end_effector_frame, m_end_effector_state.jacobian);
+
+    // Update the base jacobian to be relative to the arm.
+    double yaw = m_joint_position[2];
+    m_end_effector_state.jacobian.topLeftCorner<3, 3>()
+        << std::cos(yaw), -std::sin(yaw), 0,
+           std::sin(yaw), std::cos(yaw), 0,
+           0, 0, 1;
+
+    Vector6d spatial_velocity = Kernel::frame_velocity(m_data, m_end_effector_frame);
+    Vector6d spatial_acceleration = Kernel::frame_acceleration(m_data, m_end_effector_frame);
+
+    Kernel::Matrix3d rotation;
+    Kernel::frame_placement(m_data, m_end_effector_frame, rotation, m_end_effector_state.position);
+
+    m_end_effector_state.orientation = rotation;
+    m_end_effector_state.linear_velocity = spatial_velocity.head<3>();
+    m_end_effector_state.angular_velocity = spatial_velocity.tail<3>();
+    m_end_effector_state.linear_acceleration = spatial_acceleration.head<3>();
+    m_end_effector_state.angular_acceleration = spatial_acceleration.tail<3>();
+}
+
+Eigen::Ref<Eigen::VectorXd> GeneratedDynamics::step(const Eigen::VectorXd &c, double dt)
+{
+    const Control &control = c;
+
+    // The current yaw of the robot.
+    double yaw = m_joint_position[2];
+
+    // Set the velocity control. Rotate base velocity to the robot frame of reference.
+    m_joint_velocity.head<2>() = Eigen::Rotation2Dd(yaw) * control.base_velocity();
+    m_joint_velocity[2] = control.base_angular_velocity().value();
+
+    // Set the joint torque as the control torque.
+    m_joint_torque.setZero();
+    m_joint_torque.segment<DoF::ARM>(DoF::BASE) = control.arm_velocity();
+
+    calculate();
+
+    // Euler integrate the forward dynamics.
+    m_joint_velocity += m_joint_acceleration * dt;
+    m_joint_position += m_joint_velocity * dt;
+
+    // Integrate the energy tank with current power consumption.
+    m_power = m_joint_torque.transpose() * m_joint_velocity;
+    m_energy_tank.step(m_power, dt);
+    m_state.available_energy().setConstant(m_energy_tank.get_energy());
+
+    m_state.position() = m_joint_position;
+    m_state.velocity() = m_joint_velocity;
+
+    // Update the time of the wrench forecast.
+    m_time += dt;
+
+    return m_state;
+}
+
+} // namespace FrankaRidgeback
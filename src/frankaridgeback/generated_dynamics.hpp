@@ -0,0 +1,327 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "controller/energy.hpp"
+#include "controller/json.hpp"
+#include "controller/forecast.hpp"
+#include "frankaridgeback/dynamics.hpp"
+#include "frankaridgeback/generated/robot_kernel.hpp"
+
+namespace FrankaRidgeback {
+
+/**
+ * @brief Model predictive path integral control dynamics for the
+ * frankaridgeback implemented with a kernel generated from the robot URDF.
+ *
+ * Equivalent to PinocchioDynamics, without the generic tree traversals. The
+ * kernel is generated by scripts/generate_dynamics.py, see the
+ * generate_dynamics target.
+ */
+class GeneratedDynamics : public Dynamics
+{
+public:
+
+    struct Configuration {
+
+        /// The name of the end effector frame.
+        std::string end_effector_frame;
+
+        /// The initial state of the dynamics.
+        State initial_state;
+
+        /// The initial energy in the energy tank.
+        double energy;
+
+        /// JSON conversion for dynamics configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            end_effector_frame, energy
+        );
+    };
+
+    static inline const Configuration DEFAULT_CONFIGURATION {
+        .end_effector_frame = "panda_grasp_joint",
+        .initial_state = FrankaRidgeback::State::Zero(),
+        .energy = 10.0
+    };
+
+    /**
+     * @brief Create a new generated dynamics object.
+     *
+     * Copies the configuration.
+     *
+     * @param configuration The configuration of the dynamics.
+     * @param dynamics_forecast_handle An optional dynamics forecast to
+     * forward to the objective function.
+     *
+     * @returns A pointer to the dynamics on success or nullptr on failure.
+     */
+    static std::unique_ptr<GeneratedDynamics> create(
+        const Configuration &configuration,
+        std::unique_ptr<DynamicsForecast::Handle> &&dynamics_forecast_handle = nullptr
+    );
+
+    /**
+     * @brief Copy the dynamics.
+     */
+    std::unique_ptr<mppi::Dynamics> copy() override;
+
+    /**
+     * @brief Get the configuration of the dynamics.
+     */
+    inline const Configuration &get_configuration()
+    {
+        return m_configuration;
+    }
+
+    /**
+     * @brief Step the dynamics simulation.
+     *
+     * @param control The controls applied at the current state (before dt).
+     * @param dt The change in time.
+     *
+     * @returns The FrankaRidgeback::State after stepping.
+     */
+    Eigen::Ref<VectorXd> step(const VectorXd &control, double dt) override;
+
+    /**
+     * @brief Set the dynamics simulation to a given state.
+     * @param state The system state.
+     * @param time The time of the dynamincs state.
+     */
+    void set_state(const VectorXd &state, double time) override;
+
+    /**
+     * @brief Get the dynamics state.
+     */
+    inline Eigen::Ref<VectorXd> get_state() override
+    {
+        return m_state;
+    }
+
+    /**
+     * @brief Get the number of degrees of freedom for the frankaridgeback
+     * control.
+     */
+    inline constexpr int get_control_dof() override
+    {
+        return DoF::CONTROL;
+    }
+
+    /**
+     * @brief Get the number of degrees of freedom for the frankaridgeback
+     * state.
+     */
+    inline constexpr int get_state_dof() override
+    {
+        return DoF::STATE;
+    }
+
+    /**
+     * @brief Get the current joint position.
+     */
+    inline const VectorXd &get_joint_position() const override
+    {
+        return m_joint_position;
+    }
+
+    /**
+     * @brief Get the current joint velocity.
+     */
+    const VectorXd &get_joint_velocity() const override
+    {
+        return m_joint_velocity;
+    }
+
+    /**
+     * @brief Get the position of a frame.
+     * @param frame The frame.
+     * @returns The position of the frame.
+     */
+    inline Vector3d get_frame_position(Frame frame) override
+    {
+        Kernel::Matrix3d rotation;
+        Vector3d translation;
+        Kernel::frame_placement(m_data, m_frames[(std::size_t)frame], rotation, translation);
+        return translation;
+    }
+
+    /**
+     * @brief Get the orientation of a frame.
+     * @param frame The frame.
+     * @returns The orientation of the frame.
+     */
+    Quaterniond get_frame_orientation(Frame frame) override
+    {
+        Kernel::Matrix3d rotation;
+        Vector3d translation;
+        Kernel::frame_placement(m_data, m_frames[(std::size_t)frame], rotation, translation);
+        return Quaterniond(rotation);
+    }
+
+    /**
+     * @brief Get the origin of a link in the world frame
+     * @param link The link to get the origin of.
+     * @returns The position of the link in the world frame.
+     */
+    Vector3d get_link_position(Link link) override
+    {
+        Kernel::Matrix3d rotation;
+        Vector3d translation;
+        Kernel::frame_placement(m_data, m_links[(std::size_t)link], rotation, translation);
+        return translation;
+    }
+
+    /**
+     * @brief Get the kinematics of the end effector.
+     */
+    inline const EndEffectorState &get_end_effector_state() const override
+    {
+        return m_end_effector_state;
+    }
+
+    /**
+     * @brief Get the current power from applied joint controls.
+     * @return The current power usage in joules/s.
+     */
+    virtual double get_joint_power() const override
+    {
+        return 0.0;
+    }
+
+    /**
+     * @brief Get the current power from external forces.
+     * @return The current power usage in joules/s.
+     */
+    virtual double get_external_power() const override
+    {
+        return 0.0;
+    }
+
+    /**
+     * @brief Get the current energy left in the energy tank.
+     */
+    double get_tank_energy() const override
+    {
+        return m_energy_tank.get_energy();
+    }
+
+    /**
+     * @brief Get a pointer to the dynamics forecast if it exists.
+     *
+     * @warning May be nullptr.
+     * @returns A pointer to the dynamics forecast on success or nullptr if
+     * there is no dynamics forecast handle.
+     */
+    const DynamicsForecast::Handle *get_forecast() const override
+    {
+        if (m_forecast)
+            return m_forecast.get();
+        return nullptr;
+    }
+
+    /**
+     * @brief Get the actual wrench applied of the end effector.
+     *
+     * @todo Implement simulating external end effector wrench for generated
+     * dynamics.
+     *
+     * @returns The actually applied wrench (fx, fy, fz, tau_x, tau_y, tau_z) at
+     * the end effector in the world frame.
+     */
+    inline Vector6d get_end_effector_simulated_wrench() const override
+    {
+        return Vector6d::Zero();
+    }
+
+    /**
+     * @brief Add cumulative wrench to the end effector, to be simulated on the
+     * next step.
+     *
+     * @todo Implement simulating external end effector wrench for generated
+     * dynamics.
+     *
+     * @param wrench The wrench to cumulative add to the end effector to be
+     * simulated.
+     */
+    inline void add_end_effector_simulated_wrench(Vector6d wrench) override {}
+
+private:
+
+    /**
+     * @brief Initialise the dynamics parameters.
+     *
+     * @param configuration The configuration of the dynamics.
+     * @param dynamics_forecast_handle An optional handle to the forecasted
+     * dynamics, forwarded to the objective function.
+     * @param end_effector_frame The kernel index of the end effector frame.
+     * @param frames The kernel index of each frame.
+     * @param links The kernel index of the frame of each link.
+     */
+    GeneratedDynamics(
+        const Configuration &configuration,
+        std::unique_ptr<DynamicsForecast::Handle> &&dynamics_forecast_handle,
+        int end_effector_frame,
+        const std::array<int, (std::size_t)Frame::_SIZE> &frames,
+        const std::array<int, (std::size_t)Link::_SIZE> &links
+    );
+
+    /**
+     * @brief Calculates kinematic information after position and velocity
+     * updates.
+     */
+    void calculate();
+
+    /// The configuration of the dynamics.
+    Configuration m_configuration;
+
+    /// Kernel quantities of each body.
+    Kernel::Data m_data;
+
+    /// Kernel index of the end effector frame.
+    int m_end_effector_frame;
+
+    /// Kernel index of each frame.
+    std::array<int, (std::size_t)Frame::_SIZE> m_frames;
+
+    /// Kernel index of the frame of each link.
+    std::array<int, (std::size_t)Link::_SIZE> m_links;
+
+    /// The current joint positions.
+    VectorXd m_joint_position;
+
+    /// The current joint velocities.
+    VectorXd m_joint_velocity;
+
+    /// The current torques applied by the controller to the joints.
+    VectorXd m_joint_torque;
+
+    /// The joint torques of gravity and velocity products.
+    VectorXd m_non_linear_torque;
+
+    /// The acceleration of the joints from forward dynamics.
+    VectorXd m_joint_acceleration;
+
+    /// The kinematic state of the end effector.
+    EndEffectorState m_end_effector_state;
+
+    /// Optional pointer to the force predictor.
+    std::unique_ptr<DynamicsForecast::Handle> m_forecast;
+
+    /// The current power consumption.
+    double m_power;
+
+    /// The energy tank.
+    EnergyTank m_energy_tank;
+
+    /// The state to yield to the mppi trajectory generator.
+    State m_state;
+
+    /// Time of the last dynamics set.
+    double m_time;
+};
+
+} // namespace FrankaRidgeback
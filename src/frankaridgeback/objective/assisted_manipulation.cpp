@@ -1,321 +1,288 @@
 #include "frankaridgeback/objective/assisted_manipulation.hpp"
 
 #include <iostream>
+#include <unordered_map>
 
 #include "frankaridgeback/dynamics.hpp"
 
 namespace FrankaRidgeback {
 
-std::unique_ptr<AssistedManipulation> AssistedManipulation::create(
-    const Configuration &configuration
-) {
-    return std::unique_ptr<AssistedManipulation>(
-        new AssistedManipulation(configuration)
-    );
-}
-
-AssistedManipulation::AssistedManipulation(
-    const Configuration &configuration
-  ) : m_configuration(configuration)
+namespace {
+
+/**
+ * @brief The assisted manipulation objective as a compile time sum of terms.
+ *
+ * @tparam Accounting Terms::RecordCosts to accumulate the breakdown of the
+ * cost, or Terms::DiscardCosts to leave it unrecorded during rollouts.
+ * @tparam Objective The Terms::Sum of the enabled terms.
+ */
+template<typename Accounting, typename Objective>
+class AssistedManipulationCost final : public AssistedManipulation
 {
-    reset(0.0);
-}
-
-void AssistedManipulation::reset(double time)
-{
-    m_initial_time = time;
-    m_joint_cost = 0.0;
-    m_self_collision_cost = 0.0;
-    m_workspace_cost = 0.0;
-    m_energy_cost = 0.0;
-    m_velocity_cost = 0.0;
-    m_trajectory_cost = 0.0;
-    m_manipulability_cost = 0.0;
-    m_cost = 0.0;
-}
-
-double AssistedManipulation::get_cost(
-    const Eigen::VectorXd &s,
-    const Eigen::VectorXd &c,
-    mppi::Dynamics *d,
-    double time
-) {
-    const State &state = s;
-    const Control &control = c;
+public:
+
+    AssistedManipulationCost(
+        const Configuration &configuration,
+        const Objective &objective,
+        std::shared_ptr<Steps> steps
+      ) : AssistedManipulation(configuration, std::move(steps))
+        , m_objective(objective)
+    {}
+
+    void prepare(const Eigen::VectorXd &times, mppi::Dynamics *dynamics) override
+    {
+        m_steps->resize(times.size());
+
+        for (Eigen::Index i = 0; i < times.size(); ++i)
+            m_objective.prepare((*m_steps)[i], static_cast<Dynamics*>(dynamics), times[i]);
+    }
 
-    auto dynamics = static_cast<Dynamics*>(d);
+    double get_cost(
+        const Eigen::VectorXd &state,
+        const Eigen::VectorXd &,
+        mppi::Dynamics *d,
+        double time
+    ) override {
+        auto dynamics = static_cast<Dynamics*>(d);
 
-    double cost = 0.0;
+        if (const Terms::Step *step = next_step(time))
+            return m_objective.template evaluate<Accounting>(m_breakdown, state, dynamics, *step);
 
-    if (m_configuration.enable_joint_limit)
-        cost += joint_limit_cost(state);
+        Terms::Step step;
+        m_objective.prepare(step, dynamics, time);
+        return m_objective.template evaluate<Accounting>(m_breakdown, state, dynamics, step);
+    }
 
-    if (m_configuration.enable_self_collision_limit)
-        cost += self_collision_cost(dynamics);
+    std::unique_ptr<mppi::Cost> copy() override
+    {
+        return std::make_unique<AssistedManipulationCost<Accounting, Objective>>(
+            m_configuration, m_objective, m_steps
+        );
+    }
 
-    if (m_configuration.enable_workspace_limit)
-        cost += workspace_cost(dynamics);
+    std::unique_ptr<mppi::Cost> copy_optimal() override
+    {
+        return std::make_unique<AssistedManipulationCost<Terms::RecordCosts, Objective>>(
+            m_configuration, m_objective, m_steps
+        );
+    }
 
-    if (m_configuration.enable_energy_limit)
-        cost += energy_cost(dynamics);
+private:
 
-    if (m_configuration.enable_velocity_cost)
-        cost += velocity_cost(state);
+    /// The terms of the objective.
+    Objective m_objective;
+};
 
-    if (m_configuration.enable_trajectory_cost)
-        cost += trajectory_cost(dynamics, time);
+using Configuration = AssistedManipulation::Configuration;
 
-    if (m_configuration.enable_manipulability_cost)
-        cost += manipulability_cost(dynamics);
+/**
+ * @brief Parameterise a term from the objective configuration.
+ */
+template<typename Term>
+Term make_term(const Configuration &configuration);
 
-    return cost;
+template<>
+Terms::JointLimit make_term(const Configuration &configuration)
+{
+    return {
+        .lower = configuration.lower_joint_limit,
+        .upper = configuration.upper_joint_limit
+    };
 }
 
-double AssistedManipulation::joint_limit_cost(const State &state)
+template<>
+Terms::SelfCollision make_term(const Configuration &configuration)
 {
-    double cost = 0.0;
-
-    for (size_t i = 0; i < DoF::JOINTS; i++) {
-        const auto &lower = m_configuration.lower_joint_limit[i];
-        const auto &upper = m_configuration.upper_joint_limit[i];
-        double position = state.position()(i);
-        double c = lower(position) + upper(position);
-        cost += c;
-    }
-
-    m_joint_cost += cost;
-    return cost;
+    return {
+        .limit = configuration.self_collision_limit,
+        .radii = configuration.self_collision_radii
+    };
 }
 
-double AssistedManipulation::self_collision_cost(Dynamics *dynamics)
+template<>
+Terms::Workspace make_term(const Configuration &configuration)
 {
-    const static std::vector<std::tuple<Link, std::vector<Link>>> CHECK_COLLSION = {{
-        {Link::PIVOT, {
-            Link::PANDA_LINK3,
-            Link::PANDA_LINK4,
-            Link::PANDA_LINK5,
-            Link::PANDA_LINK6,
-            Link::PANDA_LINK7,
-        }},
-        {Link::PANDA_LINK1, {
-            Link::PANDA_LINK3,
-            Link::PANDA_LINK4,
-            Link::PANDA_LINK5,
-            Link::PANDA_LINK6,
-            Link::PANDA_LINK7,
-        }},
-        {Link::PANDA_LINK2, {
-            Link::PANDA_LINK4,
-            Link::PANDA_LINK5,
-            Link::PANDA_LINK6,
-            Link::PANDA_LINK7,
-        }},
-        {Link::PANDA_LINK3, {
-            Link::PANDA_LINK5,
-            Link::PANDA_LINK6,
-            Link::PANDA_LINK7,
-        }},
-        {Link::PANDA_LINK4, {
-            Link::PANDA_LINK6,
-            Link::PANDA_LINK7,
-        }},
-        {Link::PANDA_LINK5, {
-            Link::PANDA_LINK7,
-        }}
-    }};
-
-    const auto &self_collision = m_configuration.self_collision_limit;
-    double cost = 0.0;
-
-    for (std::size_t i = 0; i < CHECK_COLLSION.size(); i++) {
-        const auto &[first_link, against] = CHECK_COLLSION[i];
-
-        for (std::size_t j = 0; j < against.size(); j++) {
-            Link second_link = against[j];
-
-            // Distance between sphere origins.
-            double distance = (
-                dynamics->get_link_position(first_link) -
-                dynamics->get_link_position(second_link)
-            ).norm();
-
-            // Sum of sphere radii.
-            double radii = (
-                m_configuration.self_collision_radii[(std::size_t)first_link - 3] +
-                m_configuration.self_collision_radii[(std::size_t)second_link - 3]
-            );
-
-            // Collision vector. Positive when colliding.
-            double collision = distance - radii;
-
-            // Barrier function cost.
-            cost += m_configuration.self_collision_limit(collision);
-        }
-    }
-
-    m_self_collision_cost += cost;
-    return cost;
+    return {
+        .above = configuration.workspace_limit_above,
+        .infront = configuration.workspace_limit_infront,
+        .reach = configuration.workspace_limit_reach,
+        .yaw = configuration.workspace_cost_yaw
+    };
 }
 
-double AssistedManipulation::workspace_cost(Dynamics *dynamics)
+template<>
+Terms::EnergyTank make_term(const Configuration &configuration)
 {
-    double cost = 0.0;
+    return {
+        .below = configuration.energy_limit_below,
+        .above = configuration.energy_limit_above
+    };
+}
 
-    // Position of the end effector.
-    Vector3d end_effector = dynamics->get_end_effector_state().position;
+template<>
+Terms::Velocity make_term(const Configuration &configuration)
+{
+    return { .cost = configuration.velocity_cost };
+}
 
-    // Rotation from world frame to infront of the robot.
-    AngleAxisd rotate_forward = AngleAxisd(dynamics->get_state()[2], Vector3d::UnitZ());
+template<>
+Terms::Trajectory make_term(const Configuration &configuration)
+{
+    return {
+        .target_scale = configuration.trajectory_target_scale,
+        .target_maximum = configuration.trajectory_target_maximum,
+        .position_cost = configuration.trajectory_position_cost,
+        .position_threshold = configuration.trajectory_position_threshold,
+        .velocity_cost = configuration.trajectory_velocity_cost,
+        .velocity_minimum = configuration.trajectory_velocity_minimum,
+        .velocity_maximum = configuration.trajectory_velocity_maximum,
+        .velocity_dropoff = configuration.trajectory_velocity_dropoff
+    };
+}
 
-    // Unit vector in the forward direction of the robot, normal to the
-    // infront / behind plane.
-    Vector3d forward = rotate_forward * Vector3d::UnitX();
+template<>
+Terms::Manipulability make_term(const Configuration &configuration)
+{
+    return { .cost = configuration.manipulability_cost };
+}
 
-    // Position of the plane in front of the robot.
-    Vector3d robot = (
-        dynamics->get_frame_position(Frame::ARM_MOUNT_JOINT) +
-        rotate_forward * Vector3d(0.1, 0, 0.15) // offset from base link
+/**
+ * @brief Create the objective from a sum of terms.
+ */
+template<typename... Ts>
+std::unique_ptr<AssistedManipulation> make_objective(const Configuration &configuration)
+{
+    using Objective = Terms::Sum<Ts...>;
+    return std::make_unique<AssistedManipulationCost<Terms::DiscardCosts, Objective>>(
+        configuration,
+        Objective(make_term<Ts>(configuration)...),
+        std::make_shared<std::vector<Terms::Step>>()
     );
+}
 
-    // Vector from plane origin to end effector.
-    Vector3d to_end_effector = end_effector - robot;
-
-    // Distance from the infront / behind plane to the end effector.
-    double projection = (
-        to_end_effector.dot(forward) / forward.dot(forward)
+/**
+ * @brief Create the objective checking if each term is enabled at runtime,
+ * for combinations not in the registry.
+ */
+std::unique_ptr<AssistedManipulation> make_runtime_objective(const Configuration &configuration)
+{
+    std::uint32_t terms = AssistedManipulation::get_terms(configuration);
+
+    auto enabled = [&]<typename Term>(Term term) {
+        return Terms::Enabled<Term> {
+            .enabled = (terms & (1u << (std::size_t)Term::INDEX)) != 0,
+            .term = std::move(term)
+        };
+    };
+
+    using Objective = Terms::Sum<
+        Terms::Enabled<Terms::JointLimit>,
+        Terms::Enabled<Terms::SelfCollision>,
+        Terms::Enabled<Terms::Workspace>,
+        Terms::Enabled<Terms::EnergyTank>,
+        Terms::Enabled<Terms::Velocity>,
+        Terms::Enabled<Terms::Trajectory>,
+        Terms::Enabled<Terms::Manipulability>
+    >;
+
+    return std::make_unique<AssistedManipulationCost<Terms::DiscardCosts, Objective>>(
+        configuration,
+        Objective(
+            enabled(make_term<Terms::JointLimit>(configuration)),
+            enabled(make_term<Terms::SelfCollision>(configuration)),
+            enabled(make_term<Terms::Workspace>(configuration)),
+            enabled(make_term<Terms::EnergyTank>(configuration)),
+            enabled(make_term<Terms::Velocity>(configuration)),
+            enabled(make_term<Terms::Trajectory>(configuration)),
+            enabled(make_term<Terms::Manipulability>(configuration))
+        ),
+        std::make_shared<std::vector<Terms::Step>>()
     );
+}
 
-    // Keep end effector in front of the robot.
-    cost += m_configuration.workspace_limit_infront(projection);
-
-    // Limit reach.
-    double reach = to_end_effector.norm();
-    cost += m_configuration.workspace_limit_reach(reach);
-
-    // Calculate yaw between body and end effector.
-    Vector2d v1 = to_end_effector.head<2>();
-    Vector2d v2 = forward.head<2>();
-    double yaw = std::acos(v1.dot(v2) / v1.norm() / v2.norm());
-    if (!std::isnan(yaw)) {
-        cost += m_configuration.workspace_cost_yaw(std::fabs(yaw));
-    }
-
-    // Keep the end effector above the robot.
-    double height = end_effector[2] - robot[2];
-    cost += m_configuration.workspace_limit_above(height);
+using Factory = std::unique_ptr<AssistedManipulation> (*)(const Configuration &);
 
-    m_workspace_cost += cost;
-    return cost;
+/**
+ * @brief Make a registry entry of a combination of terms.
+ */
+template<typename... Ts>
+std::pair<const std::uint32_t, Factory> entry()
+{
+    return {Terms::Sum<Ts...>::MASK, &make_objective<Ts...>};
 }
 
-double AssistedManipulation::energy_cost(Dynamics *dynamics)
+/**
+ * @brief Combinations of terms instantiated at compile time, by the mask of
+ * the enabled terms.
+ */
+const std::unordered_map<std::uint32_t, Factory> &registry()
 {
-    double energy = dynamics->get_tank_energy();
-
-    double cost = (
-        m_configuration.energy_limit_below(energy) +
-        m_configuration.energy_limit_above(energy)
-    );
-
-    m_energy_cost += cost;
-    return cost;
+    using namespace Terms;
+
+    static const std::unordered_map<std::uint32_t, Factory> REGISTRY {
+        // The default configuration.
+        entry<JointLimit, Workspace, Velocity, Trajectory, Manipulability>(),
+        // The default configuration with self collision.
+        entry<JointLimit, SelfCollision, Workspace, Velocity, Trajectory, Manipulability>(),
+        // All terms.
+        entry<JointLimit, SelfCollision, Workspace, EnergyTank, Velocity, Trajectory, Manipulability>(),
+        // Without assistance, such as without a dynamics forecast.
+        entry<JointLimit, Workspace, Velocity, Manipulability>(),
+        // Limits only.
+        entry<JointLimit, Workspace>()
+    };
+
+    return REGISTRY;
 }
 
-double AssistedManipulation::velocity_cost(const State &state)
-{
-    double cost = 0.0;
+} // namespace
 
-    for (size_t i = 0; i < DoF::JOINTS; i++) {
-        const auto &objective = m_configuration.velocity_cost[i];
-        cost += objective.quadratic_cost * std::pow(std::fabs(state.velocity()(i)), 2);
-    }
+std::unique_ptr<AssistedManipulation> AssistedManipulation::create(
+    const Configuration &configuration
+) {
+    auto factory = registry().find(get_terms(configuration));
+    if (factory != registry().end())
+        return factory->second(configuration);
 
-    m_velocity_cost += cost;
-    return cost;
+    return make_runtime_objective(configuration);
 }
 
-double AssistedManipulation::trajectory_cost(const Dynamics *dynamics, double time)
+std::uint32_t AssistedManipulation::get_terms(const Configuration &configuration)
 {
-    if (!dynamics->get_forecast())
-        return 0.0;
-
-    const auto &state = dynamics->get_end_effector_state();
-    const auto forecast = dynamics->get_forecast()->get();
-
-    // Vector3d force = forecast->get_wrench_trajectory()[0].head<3>();
-    Vector3d force = forecast->get_end_effector_wrench(time).head<3>();
-
-    Vector3d target_vector = (
-        m_configuration.trajectory_target_scale * force
-    ).cwiseMin(
-        m_configuration.trajectory_target_maximum
-    ).cwiseMax(
-        -m_configuration.trajectory_target_maximum
+    auto bit = [](bool enabled, Terms::Index index) {
+        return enabled ? (1u << (std::size_t)index) : 0u;
+    };
+
+    return (
+        bit(configuration.enable_joint_limit, Terms::Index::JOINT_LIMIT) |
+        bit(configuration.enable_self_collision_limit, Terms::Index::SELF_COLLISION) |
+        bit(configuration.enable_workspace_limit, Terms::Index::WORKSPACE) |
+        bit(configuration.enable_energy_limit, Terms::Index::ENERGY) |
+        bit(configuration.enable_velocity_cost, Terms::Index::VELOCITY) |
+        bit(configuration.enable_trajectory_cost, Terms::Index::TRAJECTORY) |
+        bit(configuration.enable_manipulability_cost, Terms::Index::MANIPULABILITY)
     );
-
-    // target_vector = (
-    //     forecast->get_end_effector_trajectory()[0].position + target_vector - state.position
-    // );
-
-    double distance = target_vector.norm();
-
-    double cost = 0.0;
-    if (distance > m_configuration.trajectory_position_threshold) {
-        cost += m_configuration.trajectory_position_cost(distance);
-
-        // Project linear velocity onto the target vector.
-        double projection = (
-            state.linear_velocity.dot(target_vector) /
-            target_vector.dot(target_vector)
-        );
-
-        // Projected component onto the target vector.
-        projection = std::copysign(1.0, projection) * (target_vector * projection).norm();
-
-        // Calculate ideal velocity field.
-        double velocity_target = std::clamp(
-            std::exp(m_configuration.trajectory_velocity_dropoff * distance) - 1,
-            m_configuration.trajectory_velocity_minimum,
-            m_configuration.trajectory_velocity_maximum
-        );
-
-        double velocity_error = std::fabs(velocity_target - projection);
-
-        // Make relative to the velocity limit.
-        cost += m_configuration.trajectory_velocity_cost(velocity_error);
-    }
-
-    m_trajectory_cost += cost;
-    return cost;
 }
 
-double AssistedManipulation::manipulability_cost(Dynamics *dynamics)
+bool AssistedManipulation::is_registered(const Configuration &configuration)
 {
-    double cost = 0.0;
-
-    const auto &jacobian = dynamics->get_end_effector_state().jacobian.rightCols(
-        DoF::JOINTS - DoF::BASE
-    ).topLeftCorner(3, DoF::ARM);
-
-    m_manipulability_matrix = jacobian * jacobian.transpose();
-
-    // auto eigenvalues = m_manipulability_matrix.eigenvalues().real().eval();
-    // double min = eigenvalues.minCoeff();
-    // double max = eigenvalues.maxCoeff();
-    // auto mu_2 = max / min;
-    // cost = m_configuration.manipulability_cost(mu_2 - 1);
-
-    // Value proportional to the volume of the manipulability ellipsoid.
-    double volume = std::sqrt(m_manipulability_matrix.determinant());
-    if (std::isnan(volume))
-        volume = 1e-5;
-    else
-        volume = std::clamp(volume, 1e-5, 1e5);
+    return registry().contains(get_terms(configuration));
+}
 
-    cost = m_configuration.manipulability_cost(1 / volume);
+AssistedManipulation::AssistedManipulation(
+    const Configuration &configuration,
+    std::shared_ptr<Steps> steps
+  ) : m_configuration(configuration)
+    , m_steps(std::move(steps))
+{
+    reset(0.0);
+}
 
-    m_manipulability_cost += cost;
-    return cost;
+void AssistedManipulation::reset(double time)
+{
+    m_initial_time = time;
+    m_breakdown.fill(0.0);
+    m_step = 0;
 }
 
 } // namespace FrankaRidgeback
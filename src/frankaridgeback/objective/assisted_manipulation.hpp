@@ -1,17 +1,32 @@
 #pragma once
 
+#include <cmath>
+
 #include "controller/json.hpp"
 #include "controller/mppi.hpp"
 #include "controller/cost.hpp"
 #include "frankaridgeback/control.hpp"
 #include "frankaridgeback/dynamics.hpp"
 #include "frankaridgeback/state.hpp"
+#include "frankaridgeback/objective/terms.hpp"
 
 namespace FrankaRidgeback {
 
 /**
  * @brief Objective function of the franka research 3 ridgeback assisted
  * manipulation task.
+ * 
+ * The objective is the sum of the enabled terms in objective/terms.hpp.
+ * Combinations of terms in the registry are instantiated at compile time, so
+ * their cost is evaluated without branching on the enabled terms. Other
+ * combinations check if each term is enabled at runtime.
+ * 
+ * The breakdown of the cost into its terms is only accumulated by the copy
+ * evaluating the optimal rollout.
+ * 
+ * The parts of the terms that depend only on time, such as the trajectory
+ * target from the forecast end effector force, are prepared once per update
+ * into a table of steps shared by every copy.
  */
 class AssistedManipulation : public mppi::Cost
 {
@@ -22,7 +37,10 @@ public:
         /// If joint limit costs are enabled.
         bool enable_joint_limit;
 
-        /// If self collision costs are enabled.
+        /// If self collision costs are enabled. Disabled by default, since the
+        /// default collision spheres are not tuned to the link origins. The
+        /// origins of panda links 5 and 7 are 0.088m apart in every
+        /// configuration, so their spheres always overlap.
         bool enable_self_collision_limit;
 
         /// If workspace costs are enabled.
@@ -49,6 +67,8 @@ public:
         /// Self collision cost.
         LeftInverseBarrierFunction self_collision_limit;
 
+        /// Radius of the collision sphere at the origin of the pivot and each
+        /// panda link.
         std::array<double, 8> self_collision_radii;
 
         /// Trajectory not infront cost.
@@ -132,7 +152,7 @@ public:
      */
     static inline const Configuration DEFAULT_CONFIGURATION {
         .enable_joint_limit = true,
-        .enable_self_collision_limit = true,
+        .enable_self_collision_limit = false,
         .enable_workspace_limit = true,
         .enable_energy_limit = false,
         .enable_velocity_cost = true,
@@ -205,6 +225,7 @@ public:
         .manipulability_cost = { .quadratic_cost = 10 }
     };
 
+
     /**
      * @brief Get the number of state degrees of freedom.
      */
@@ -222,6 +243,9 @@ public:
     /**
      * @brief Create an assisted manipulation objective function.
      * 
+     * The objective does not accumulate the breakdown of its cost. Use
+     * copy_optimal() for an objective that does.
+     * 
      * @param configuration The configuration of the objective function.
      * @returns A pointer to the objective on success, or nullptr on failure.
      */
@@ -229,32 +253,51 @@ public:
         const Configuration &configuration
     );
 
+    /**
+     * @brief Get the bit mask of the terms enabled by a configuration.
+     * 
+     * Bits are set at each enabled Terms::Index.
+     * 
+     * @param configuration The configuration of the objective function.
+     * @returns The enabled terms.
+     */
+    static std::uint32_t get_terms(const Configuration &configuration);
+
+    /**
+     * @brief Check if the terms enabled by a configuration are instantiated
+     * at compile time.
+     * 
+     * @param configuration The configuration of the objective function.
+     * @returns If the combination of terms is in the registry.
+     */
+    static bool is_registered(const Configuration &configuration);
+
     inline double get_joint_limit_cost() const {
-        return m_joint_cost;
+        return m_breakdown[(std::size_t)Terms::Index::JOINT_LIMIT];
     }
 
     inline double get_self_collision_cost() const {
-        return m_self_collision_cost;
+        return m_breakdown[(std::size_t)Terms::Index::SELF_COLLISION];
     }
 
     inline double get_workspace_cost() const {
-        return m_workspace_cost;
+        return m_breakdown[(std::size_t)Terms::Index::WORKSPACE];
     }
 
     inline double get_energy_tank_cost() const {
-        return m_energy_cost;
+        return m_breakdown[(std::size_t)Terms::Index::ENERGY];
     }
 
     inline double get_joint_velocity_cost() const {
-        return m_velocity_cost;
+        return m_breakdown[(std::size_t)Terms::Index::VELOCITY];
     }
 
     inline double get_trajectory_cost() const {
-        return m_trajectory_cost;
+        return m_breakdown[(std::size_t)Terms::Index::TRAJECTORY];
     }
 
     inline double get_manipulability_cost() const {
-        return m_manipulability_cost;
+        return m_breakdown[(std::size_t)Terms::Index::MANIPULABILITY];
     }
 
     /**
@@ -263,138 +306,60 @@ public:
      */
     void reset(double time) override;
 
-    /**
-     * @brief Get the cost of a state and control input over dt.
-     * 
-     * @param state The state of the system.
-     * @param control The control parameters applied to the state.
-     * @param dynamics Pointer to the dynamics at the time step.
-     * @param time The current time.
-     * 
-     * @returns The cost of the step.
-     */
-    double get_cost(
-        const Eigen::VectorXd &state,
-        const Eigen::VectorXd &control,
-        mppi::Dynamics *dynamics,
-        double time
-    ) override;
+protected:
 
     /**
-     * @brief Make a copy of the objective function.
+     * @brief The prepared steps of the horison, shared between copies.
      */
-    inline std::unique_ptr<mppi::Cost> copy() override {
-        return std::unique_ptr<AssistedManipulation>(
-            new AssistedManipulation(m_configuration)
-        );
-    }
-
-private:
+    using Steps = std::vector<Terms::Step>;
 
     /**
      * @brief Initialise the assisted manipulation cost.
      * 
-     * @param model Pointer to the robot model.
      * @param configuration The configuration of the objective function.
+     * @param steps The prepared steps shared with other copies.
      */
-    AssistedManipulation(const Configuration &configuration);
-
-    /**
-     * @brief Penalises joint positions that exceed their limits.
-     * 
-     * @param state The current state of the frankaridgeback.
-     * @returns A cost depending on the joint state.
-     */
-    double joint_limit_cost(const State &state);
-
-    /**
-     * @brief Penalise configurations that.
-     * 
-     * This is an approximation function where each link has an imagined sphere
-     * located, with some defined radius that is smaller than the maximum link
-     * dimension (otherwise will always be in collision with adjacent links).
-     * The joints are considered colliding if the spheres are intersecting. The
-     * radii of the spheres can be adjusted to change the sensitivity to self 
-     * collision.
-     * 
-     * @param dynamcs The current dynamics state.
-     * @returns A cost penalising self collision.
-     */
-    double self_collision_cost(Dynamics *dynamics);
-
-    /**
-     * @brief Penalises end effector positions that are too close or too far
-     * from the robot base.
-     * 
-     * Implemented as a check on the euclidean distance between the base of the
-     * arm and the end effector frame.
-     * 
-     * @param dynamics The current dynamics state.
-     * @param target The target position.
-     * @returns A cost penalising end effector positions too close or too far
-     * from the base.
-     */
-    double workspace_cost(Dynamics *dynamics);
-
-    /**
-     * @brief Penalises trajectories that deplete the energy tank and maximum
-     * tank energy.
-     * 
-     * @param dynamics Pointer to the dynamics object.
-     * @returns The cost. 
-     */
-    double energy_cost(Dynamics *dynamics);
-
-    double velocity_cost(const State &state);
+    AssistedManipulation(
+        const Configuration &configuration,
+        std::shared_ptr<Steps> steps
+    );
 
-    /**
-     * @brief Reward trajectories that tend towards the expected trajectory
-     * given the end effector force.
-     * 
-     * @param dynamcs The current dynamics state.
-     * @param time The time of the dynamics.
-     * @returns A cost rewarding trajectories towards.
-     */
-    double trajectory_cost(const Dynamics *dynamics, double time);
+    /// The largest difference in seconds between the time of a rollout step
+    /// and the time its step was prepared for. Absorbs rounding if the times
+    /// are not computed by the same expression.
+    static constexpr double STEP_TIME_TOLERANCE = 1e-9;
 
     /**
-     * @brief Rewards higher manipulability joint configurations.
+     * @brief Get the next prepared step of the rollout.
      * 
-     * Manipulability is calculated based on the end effector jacobian and
-     * resulting manipulability ellipsoid.
-     * 
-     * Cost metric is proportional to `sqrt(det(J * J^T))` that is itself
-     * proportional to the volume of the manipulability ellipsoid, clipped above
-     * 1e-10. Jacobian in spatial frame. Greater values are better.
-     * 
-     * @param dynamics The current dynamics state.
-     * @returns A cost rewarding manipulability.
+     * @param time The time of the step.
+     * @returns The prepared step, or nullptr if the step was not prepared for
+     * the time, such as when the update was not prepared.
      */
-    double manipulability_cost(Dynamics *dynamics);
+    inline const Terms::Step *next_step(double time)
+    {
+        std::size_t index = m_step++;
+        if (index < m_steps->size() &&
+            std::abs((*m_steps)[index].time - time) <= STEP_TIME_TOLERANCE)
+            return &(*m_steps)[index];
+        return nullptr;
+    }
 
     /// The configuration of the objective function.
     Configuration m_configuration;
 
-    /// Spatial jacobian.
-    Eigen::Matrix<double, 3, 3> m_manipulability_matrix;
-
+    /// The time the objective was reset.
     double m_initial_time;
 
-    double m_joint_cost;
-
-    double m_self_collision_cost;
-
-    double m_workspace_cost;
-
-    double m_energy_cost;
-
-    double m_velocity_cost;
-
-    double m_trajectory_cost;
+    /// The cumulative cost of each term since the objective was reset.
+    Terms::Breakdown m_breakdown;
 
-    double m_manipulability_cost;
+    /// The prepared steps, read only during rollouts.
+    std::shared_ptr<Steps> m_steps;
 
-    double m_cost;
+    /// The index of the next step of the rollout since the objective was
+    /// reset.
+    std::size_t m_step;
 };
 
 } // namespace FrankaRidgeback
@@ -0,0 +1,590 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "controller/cost.hpp"
+#include "frankaridgeback/dynamics.hpp"
+#include "frankaridgeback/state.hpp"
+
+namespace FrankaRidgeback::Terms {
+
+/**
+ * @brief Index of each term in the breakdown of an objective's cost.
+ */
+enum class Index : std::size_t {
+    JOINT_LIMIT,
+    SELF_COLLISION,
+    WORKSPACE,
+    ENERGY,
+    VELOCITY,
+    TRAJECTORY,
+    MANIPULABILITY,
+    _SIZE
+};
+
+/**
+ * @brief The cumulative cost of each term of an objective.
+ */
+using Breakdown = std::array<double, (std::size_t)Index::_SIZE>;
+
+/**
+ * @brief The values of the terms that depend only on time, prepared once per
+ * update for a step of the horison and shared by every rollout.
+ */
+struct Step {
+
+    /// The time of the step. NaN if unprepared.
+    double time = NAN;
+
+    /// If the end effector force was forecast.
+    bool forecast = false;
+
+    /// The trajectory target vector from the forecast end effector force.
+    Vector3d target_vector = Vector3d::Zero();
+};
+
+/**
+ * @brief Accounting policy that accumulates the cost of each objective term,
+ * so the breakdown of the cost can be logged.
+ */
+struct RecordCosts {
+    static inline void add(double &total, double cost) { total += cost; }
+};
+
+/**
+ * @brief Accounting policy that discards the cost of each objective term.
+ */
+struct DiscardCosts {
+    static inline void add(double &, double) {}
+};
+
+/**
+ * @brief Penalises joint positions approaching their limits.
+ */
+struct JointLimit {
+
+    static constexpr Index INDEX = Index::JOINT_LIMIT;
+
+    /// Lower joint limits.
+    BarrierArray<LeftInverseBarrierFunction, DoF::JOINTS> lower;
+
+    /// Upper joint limits.
+    BarrierArray<RightInverseBarrierFunction, DoF::JOINTS> upper;
+
+    inline double operator()(const State &state, Dynamics *, double) const
+    {
+        Eigen::Array<double, DoF::JOINTS, 1> position = state.position().array();
+        return lower(position) + upper(position);
+    }
+};
+
+/**
+ * @brief Penalises joint positions beyond hard coded limits of the base and
+ * arm, by a constant plus the squared violation.
+ *
+ * The joint limit cost of the track point objective. Unlike JointLimit, it is
+ * zero within the limits.
+ */
+struct QuadraticJointLimit {
+
+    static constexpr Index INDEX = Index::JOINT_LIMIT;
+
+    /// The number of joints limited, the base and arm joints.
+    static constexpr std::size_t JOINTS = 10;
+
+    /// Lower limit of each joint.
+    static constexpr std::array<double, JOINTS> LOWER {
+        -2.0, -2.0, -6.28,
+        -2.8973, -1.7628, -2.8973, -3.0718, -2.8973, -0.0175, -2.8973
+    };
+
+    /// Upper limit of each joint.
+    static constexpr std::array<double, JOINTS> UPPER {
+        2.0, 2.0, 6.28,
+        2.8973, 1.7628, 2.8973, 0.0698, 2.8973, 3.7525, 2.8973
+    };
+
+    inline double operator()(const State &state, Dynamics *, double) const
+    {
+        double cost = 0.0;
+        for (std::size_t i = 0; i < JOINTS; i++) {
+            if (state(i) < LOWER[i])
+                cost += 1000.0 + 100000.0 * std::pow(LOWER[i] - state(i), 2);
+
+            if (state(i) > UPPER[i])
+                cost += 1000.0 + 100000.0 * std::pow(state(i) - UPPER[i], 2);
+        }
+        return cost;
+    }
+};
+
+/**
+ * @brief Penalises configurations where the arm collides with itself.
+ *
+ * This is an approximation function where each link has an imagined sphere
+ * located, with some defined radius that is smaller than the maximum link
+ * dimension (otherwise will always be in collision with adjacent links).
+ * The links are considered colliding if the spheres are intersecting. The
+ * radii of the spheres can be adjusted to change the sensitivity to self
+ * collision.
+ */
+struct SelfCollision {
+
+    static constexpr Index INDEX = Index::SELF_COLLISION;
+
+    /// The first link with a collision sphere.
+    static constexpr std::size_t FIRST_LINK = (std::size_t)Link::PIVOT;
+
+    /// The number of links with a collision sphere.
+    static constexpr std::size_t LINKS = 8;
+
+    /// Pairs of links checked for collision, relative to the first link.
+    static constexpr std::array<std::pair<std::size_t, std::size_t>, 20> PAIRS {{
+        {0, 3}, {0, 4}, {0, 5}, {0, 6}, {0, 7}, // Pivot
+        {1, 3}, {1, 4}, {1, 5}, {1, 6}, {1, 7}, // Link 1
+        {2, 4}, {2, 5}, {2, 6}, {2, 7},         // Link 2
+        {3, 5}, {3, 6}, {3, 7},                 // Link 3
+        {4, 6}, {4, 7},                         // Link 4
+        {5, 7}                                  // Link 5
+    }};
+
+    /// Barrier on the distance between the collision spheres.
+    LeftInverseBarrierFunction limit;
+
+    /// Radius of the collision sphere of each link.
+    std::array<double, LINKS> radii;
+
+    inline double operator()(const State &, Dynamics *dynamics, double) const
+    {
+        return sum(dynamics, limit);
+    }
+
+protected:
+
+    /**
+     * @brief Sum a cost of the separation of each pair of collision spheres.
+     *
+     * @param dynamics The dynamics to read the link positions from.
+     * @param cost The cost of the distance between sphere origins, less the
+     * sum of their radii. Negative when colliding.
+     *
+     * @returns The total cost.
+     */
+    template<typename Cost>
+    inline double sum(Dynamics *dynamics, const Cost &cost) const
+    {
+        // Read each link position once, rather than once per pair.
+        std::array<Vector3d, LINKS> positions;
+        for (std::size_t i = 0; i < LINKS; i++)
+            positions[i] = dynamics->get_link_position((Link)(FIRST_LINK + i));
+
+        double total = 0.0;
+        for (const auto &[first, second] : PAIRS) {
+            double separation = (
+                (positions[first] - positions[second]).norm() -
+                (radii[first] + radii[second])
+            );
+
+            total += cost(separation);
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief Penalises configurations where the arm collides with itself, with
+ * the barrier on the penetration of the collision spheres rather than their
+ * separation.
+ *
+ * The self collision cost of the track point objective, whose barrier is
+ * configured for the penetration.
+ */
+struct SelfPenetration : SelfCollision {
+
+    inline double operator()(const State &, Dynamics *dynamics, double) const
+    {
+        return sum(dynamics, [this](double separation) {
+            return limit(-separation);
+        });
+    }
+};
+
+/**
+ * @brief Penalises end effector positions that are too close or too far
+ * from the robot base.
+ *
+ * Implemented as a check on the euclidean distance between the base of the
+ * arm and the end effector frame.
+ */
+struct Workspace {
+
+    static constexpr Index INDEX = Index::WORKSPACE;
+
+    /// Keeps the end effector above the arm mount.
+    LeftInverseBarrierFunction above;
+
+    /// Keeps the end effector in front of the robot.
+    LeftInverseBarrierFunction infront;
+
+    /// Limits the reach of the end effector.
+    RightInverseBarrierFunction reach;
+
+    /// Cost of the yaw between the base and the end effector.
+    QuadraticCost yaw;
+
+    inline double operator()(const State &, Dynamics *dynamics, double) const
+    {
+        // Position of the end effector.
+        const Vector3d &end_effector = dynamics->get_end_effector_state().position;
+
+        // Rotation from world frame to infront of the robot.
+        AngleAxisd rotate_forward = AngleAxisd(dynamics->get_state()[2], Vector3d::UnitZ());
+
+        // Unit vector in the forward direction of the robot, normal to the
+        // infront / behind plane.
+        Vector3d forward = rotate_forward * Vector3d::UnitX();
+
+        // Position of the plane in front of the robot.
+        Vector3d robot = (
+            dynamics->get_frame_position(Frame::ARM_MOUNT_JOINT) +
+            rotate_forward * Vector3d(0.1, 0, 0.15) // offset from base link
+        );
+
+        // Vector from plane origin to end effector.
+        Vector3d to_end_effector = end_effector - robot;
+
+        // Distance from the infront / behind plane to the end effector.
+        double projection = to_end_effector.dot(forward) / forward.dot(forward);
+
+        double cost = infront(projection) + reach(to_end_effector.norm());
+
+        // Yaw between body and end effector.
+        Vector2d v1 = to_end_effector.head<2>();
+        Vector2d v2 = forward.head<2>();
+        double angle = std::acos(v1.dot(v2) / v1.norm() / v2.norm());
+        if (!std::isnan(angle))
+            cost += yaw(std::fabs(angle));
+
+        // Keep the end effector above the robot.
+        cost += above(end_effector[2] - robot[2]);
+        return cost;
+    }
+};
+
+/**
+ * @brief Penalises trajectories that deplete the energy tank, or exceed the
+ * maximum tank energy.
+ */
+struct EnergyTank {
+
+    static constexpr Index INDEX = Index::ENERGY;
+
+    /// Minimum tank energy.
+    LeftInverseBarrierFunction below;
+
+    /// Maximum tank energy.
+    RightInverseBarrierFunction above;
+
+    inline double operator()(const State &, Dynamics *dynamics, double) const
+    {
+        double energy = dynamics->get_tank_energy();
+        return below(energy) + above(energy);
+    }
+};
+
+/**
+ * @brief Minimises joint velocities.
+ */
+struct Velocity {
+
+    static constexpr Index INDEX = Index::VELOCITY;
+
+    /// Velocity cost of each joint. Only the quadratic cost is used.
+    std::array<QuadraticCost, DoF::JOINTS> cost;
+
+    inline double operator()(const State &state, Dynamics *, double) const
+    {
+        double total = 0.0;
+        for (std::size_t i = 0; i < DoF::JOINTS; i++) {
+            double velocity = state.velocity()(i);
+            total += cost[i].quadratic_cost * velocity * velocity;
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief Rewards trajectories that tend towards the expected trajectory given
+ * the end effector force.
+ */
+struct Trajectory {
+
+    static constexpr Index INDEX = Index::TRAJECTORY;
+
+    /// Scale from end effector force to the target vector.
+    double target_scale;
+
+    /// Maximum component of the target vector.
+    double target_maximum;
+
+    /// Cost of the distance to the target.
+    QuadraticCost position_cost;
+
+    /// Minimum distance to the target incurring cost.
+    double position_threshold;
+
+    /// Cost of the error from the ideal velocity towards the target.
+    QuadraticCost velocity_cost;
+
+    /// The minimum velocity for trajectory tracking.
+    double velocity_minimum;
+
+    /// The maximum velocity for trajectory tracking.
+    double velocity_maximum;
+
+    /// Rate of dropoff between maximum and zero velocity.
+    double velocity_dropoff;
+
+    /**
+     * @brief Prepare the target vector from the end effector force forecast
+     * at the time of the step.
+     */
+    inline void prepare(Step &step, Dynamics *dynamics, double time) const
+    {
+        step.forecast = dynamics->get_forecast() != nullptr;
+        if (!step.forecast)
+            return;
+
+        const auto forecast = dynamics->get_forecast()->get();
+        Vector3d force = forecast->get_end_effector_wrench(time).head<3>();
+
+        step.target_vector = (target_scale * force)
+            .cwiseMin(target_maximum)
+            .cwiseMax(-target_maximum);
+    }
+
+    inline double operator()(const State &state, Dynamics *dynamics, double time) const
+    {
+        Step step;
+        prepare(step, dynamics, time);
+        return (*this)(state, dynamics, step);
+    }
+
+    inline double operator()(const State &, Dynamics *dynamics, const Step &step) const
+    {
+        if (!step.forecast)
+            return 0.0;
+
+        const auto &state = dynamics->get_end_effector_state();
+        const Vector3d &target_vector = step.target_vector;
+
+        double distance = target_vector.norm();
+        if (distance <= position_threshold)
+            return 0.0;
+
+        double cost = position_cost(distance);
+
+        // Project linear velocity onto the target vector.
+        double projection = (
+            state.linear_velocity.dot(target_vector) /
+            target_vector.dot(target_vector)
+        );
+
+        // Projected component onto the target vector.
+        projection = std::copysign(1.0, projection) * (target_vector * projection).norm();
+
+        // Calculate ideal velocity field.
+        double velocity_target = std::clamp(
+            std::exp(velocity_dropoff * distance) - 1,
+            velocity_minimum,
+            velocity_maximum
+        );
+
+        cost += velocity_cost(std::fabs(velocity_target - projection));
+        return cost;
+    }
+};
+
+/**
+ * @brief Rewards higher manipulability joint configurations.
+ *
+ * Cost metric is inversely proportional to `sqrt(det(J * J^T))`, the volume
+ * of the manipulability ellipsoid of the arm's linear jacobian, clipped to
+ * [1e-5, 1e5].
+ */
+struct Manipulability {
+
+    static constexpr Index INDEX = Index::MANIPULABILITY;
+
+    /// Cost of the inverse manipulability.
+    QuadraticCost cost;
+
+    inline double operator()(const State &, Dynamics *dynamics, double) const
+    {
+        const auto jacobian = dynamics->get_end_effector_state().jacobian
+            .block<3, DoF::ARM>(0, DoF::BASE);
+
+        Eigen::Matrix3d manipulability = jacobian * jacobian.transpose();
+
+        double volume = std::sqrt(manipulability.determinant());
+        if (std::isnan(volume))
+            volume = 1e-5;
+        else
+            volume = std::clamp(volume, 1e-5, 1e5);
+
+        return cost(1 / volume);
+    }
+};
+
+/**
+ * @brief A term that is only evaluated if enabled at runtime.
+ *
+ * Used for combinations of terms that are not instantiated at compile time.
+ */
+template<typename Term>
+struct Enabled {
+
+    static constexpr Index INDEX = Term::INDEX;
+
+    /// If the term is evaluated.
+    bool enabled;
+
+    /// The term.
+    Term term;
+
+    inline void prepare(Step &step, Dynamics *dynamics, double time) const
+    {
+        if constexpr (requires { term.prepare(step, dynamics, time); }) {
+            if (enabled)
+                term.prepare(step, dynamics, time);
+        }
+    }
+
+    template<typename Time>
+    inline double operator()(const State &state, Dynamics *dynamics, const Time &time) const
+    {
+        if constexpr (std::is_invocable_v<const Term &, const State &, Dynamics *, const Time &>)
+            return enabled ? term(state, dynamics, time) : 0.0;
+        else
+            return enabled ? term(state, dynamics, time.time) : 0.0;
+    }
+};
+
+/**
+ * @brief The sum of a compile time combination of terms.
+ *
+ * Evaluating the sum expands each term inline, so a combination of terms is
+ * evaluated without branching on the enabled terms or virtual dispatch.
+ *
+ * @tparam Terms The terms of the sum. Each term is callable with the state,
+ * the dynamics and the time, returning its cost, and has a breakdown INDEX.
+ * Terms with parts depending only on time may also prepare them into a Step
+ * with prepare(), and be called with the prepared step instead of the time.
+ */
+template<typename... Terms>
+class Sum
+{
+public:
+
+    /// Bit mask of the breakdown indexes of the terms.
+    static constexpr std::uint32_t MASK = ((1u << (std::size_t)Terms::INDEX) | ... | 0u);
+
+    /**
+     * @brief Create a sum of terms.
+     * @param terms The parameterised terms.
+     */
+    explicit Sum(Terms... terms)
+        : m_terms(std::move(terms)...)
+    {}
+
+    /**
+     * @brief Prepare the parts of the terms that depend only on time.
+     *
+     * @param step The step to prepare.
+     * @param dynamics Pointer to the dynamics.
+     * @param time The time of the step.
+     */
+    inline void prepare(Step &step, Dynamics *dynamics, double time) const
+    {
+        step.time = time;
+
+        std::apply(
+            [&](const Terms &...terms) {
+                (prepare(terms, step, dynamics, time), ...);
+            },
+            m_terms
+        );
+    }
+
+    /**
+     * @brief Get the sum of the cost of each term.
+     *
+     * @tparam Accounting The policy accumulating the cost of each term into
+     * the breakdown.
+     *
+     * @param breakdown The breakdown of the cost.
+     * @param state The state of the system.
+     * @param dynamics Pointer to the dynamics at the time step.
+     * @param step The prepared step at the current time.
+     *
+     * @returns The total cost of the terms.
+     */
+    template<typename Accounting>
+    inline double evaluate(
+        Breakdown &breakdown,
+        const State &state,
+        Dynamics *dynamics,
+        const Step &step
+    ) const {
+        return std::apply(
+            [&](const Terms &...terms) {
+                double cost = 0.0;
+                ((cost += account<Accounting>(breakdown, terms, state, dynamics, step)), ...);
+                return cost;
+            },
+            m_terms
+        );
+    }
+
+private:
+
+    template<typename Term>
+    static inline void prepare(
+        const Term &term,
+        Step &step,
+        Dynamics *dynamics,
+        double time
+    ) {
+        if constexpr (requires { term.prepare(step, dynamics, time); })
+            term.prepare(step, dynamics, time);
+    }
+
+    template<typename Accounting, typename Term>
+    static inline double account(
+        Breakdown &breakdown,
+        const Term &term,
+        const State &state,
+        Dynamics *dynamics,
+        const Step &step
+    ) {
+        double cost;
+        if constexpr (std::is_invocable_v<const Term &, const State &, Dynamics *, const Step &>)
+            cost = term(state, dynamics, step);
+        else
+            cost = term(state, dynamics, step.time);
+
+        Accounting::add(breakdown[(std::size_t)Term::INDEX], cost);
+        return cost;
+    }
+
+    /// The terms of the sum.
+    std::tuple<Terms...> m_terms;
+};
+
+} // namespace FrankaRidgeback::Terms
@@ -4,6 +4,7 @@
 #include "controller/mppi.hpp"
 #include "controller/cost.hpp"
 #include "frankaridgeback/dynamics.hpp"
+#include "frankaridgeback/objective/terms.hpp"
 
 namespace FrankaRidgeback {
 
@@ -32,13 +33,15 @@ public:
         /// If the objective should have minimum reach.
         bool enable_reach_limits;
 
-        /// Lower joint limits if enabled.
+        /// Lower joint limits. Unused, the joint limit cost has hard coded
+        /// limits.
         std::array<LeftInverseBarrierFunction, DoF::JOINTS> lower_joint_limit;
 
-        /// Upper joint limits if enabled.
+        /// Upper joint limits. Unused, the joint limit cost has hard coded
+        /// limits.
         std::array<RightInverseBarrierFunction, DoF::JOINTS> upper_joint_limit;
 
-        /// Self collision cost.
+        /// Self collision cost, of the penetration of the collision spheres.
         LeftInverseBarrierFunction self_collision_limit;
 
         std::array<double, 8> self_collision_radii;
@@ -178,6 +181,11 @@ private:
      */
     inline TrackPoint(const Configuration &configuration)
         : m_configuration(configuration)
+        , m_joint_limit()
+        , m_self_collision{{
+            .limit = configuration.self_collision_limit,
+            .radii = configuration.self_collision_radii
+        }}
     {}
 
     /**
@@ -189,27 +197,6 @@ private:
      */
     double point_cost(Dynamics *dynamics);
 
-    /**
-     * @brief Get the cost of the joint limit proximity.
-     * 
-     * @param state The state of the franka-ridgeback.
-     * @return The cost.
-     */
-    double joint_limit_cost(const State &state);
-
-    /**
-     * @brief Get the cost of self collision.
-     * 
-     * Self collision is implemented using imaginary spheres centered on each
-     * joint. The joints are considered colliding if the spheres are
-     * intersecting. The radii of the spheres can be adjusted to change the
-     * sensitivity to self collision.
-     * 
-     * @param dynamics Pointer to the dynamics.
-     * @returns The cost.
-     */
-    double self_collision_cost(Dynamics *dynamics);
-
     /**
      * @brief Get the cost of the current power usage.
      * 
@@ -229,6 +216,12 @@ private:
     /// The configuration of the track point objective, including point to
     /// track.
     Configuration m_configuration;
+
+    /// Joint limit cost, on the hard coded limits.
+    Terms::QuadraticJointLimit m_joint_limit;
+
+    /// Self collision cost, on the penetration of the collision spheres.
+    Terms::SelfPenetration m_self_collision;
 };
 
 } // namespace FrankaRidgeback
@@ -0,0 +1,106 @@
+#include "frankaridgeback/objective/track_trajectory.hpp"
+
+#include <iostream>
+
+namespace FrankaRidgeback {
+
+std::unique_ptr<TrackTrajectory> TrackTrajectory::create(
+    const Configuration &configuration
+) {
+    auto reference = std::make_shared<Reference>();
+
+    reference->position_trajectory = PositionTrajectory::create(configuration.position);
+    if (!reference->position_trajectory) {
+        std::cerr << "failed to create track trajectory position trajectory" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.orientation) {
+        reference->orientation_trajectory = OrientationTrajectory::create(
+            *configuration.orientation
+        );
+        if (!reference->orientation_trajectory) {
+            std::cerr << "failed to create track trajectory orientation trajectory" << std::endl;
+            return nullptr;
+        }
+    }
+
+    return std::unique_ptr<TrackTrajectory>(
+        new TrackTrajectory(configuration, std::move(reference))
+    );
+}
+
+TrackTrajectory::TrackTrajectory(
+    const Configuration &configuration,
+    std::shared_ptr<Reference> reference
+  ) : m_configuration(configuration)
+    , m_reference(std::move(reference))
+    , m_step(0)
+{}
+
+void TrackTrajectory::prepare(const Eigen::VectorXd &times, mppi::Dynamics *)
+{
+    // Only allocates when the horison grows.
+    m_reference->times.assign(times.begin(), times.end());
+
+    m_reference->position.resize(times.size());
+    for (Eigen::Index step = 0; step < times.size(); ++step)
+        m_reference->position[step] = m_reference->position_trajectory->get_position(times[step]);
+
+    if (m_reference->orientation_trajectory) {
+        m_reference->orientation.resize(times.size());
+        for (Eigen::Index step = 0; step < times.size(); ++step)
+            m_reference->orientation[step] = m_reference->orientation_trajectory->get_orientation(times[step]);
+    }
+}
+
+double TrackTrajectory::get_cost(
+    const Eigen::VectorXd &s,
+    const Eigen::VectorXd & /* control */,
+    mppi::Dynamics *d,
+    double time
+) {
+    const State &state = s;
+    auto dynamics = static_cast<Dynamics*>(d);
+    const auto &end_effector = dynamics->get_end_effector_state();
+
+    std::size_t step;
+    bool prepared = next_step(time, step);
+
+    double cost = m_configuration.position_cost(
+        (end_effector.position - (prepared
+            ? m_reference->position[step]
+            : m_reference->position_trajectory->get_position(time)
+        )).norm()
+    );
+
+    if (m_reference->orientation_trajectory) {
+        cost += m_configuration.orientation_cost(
+            end_effector.orientation.angularDistance(prepared
+                ? m_reference->orientation[step]
+                : m_reference->orientation_trajectory->get_orientation(time)
+            )
+        );
+    }
+
+    if (m_configuration.enable_joint_limit)
+        cost += joint_limit_cost(state);
+
+    return cost;
+}
+
+double TrackTrajectory::joint_limit_cost(const State &state)
+{
+    double cost = 0.0;
+
+    for (size_t i = 0; i < DoF::JOINTS; i++) {
+        const auto &lower = m_configuration.lower_joint_limit[i];
+        const auto &upper = m_configuration.upper_joint_limit[i];
+        double position = state.position()(i);
+        cost += lower(position) + upper(position);
+    }
+
+    return cost;
+}
+
+} // namespace FrankaRidgeback
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "controller/json.hpp"
+#include "controller/mppi.hpp"
+#include "controller/cost.hpp"
+#include "controller/trajectory.hpp"
+#include "frankaridgeback/dynamics.hpp"
+
+namespace FrankaRidgeback {
+
+/**
+ * @brief Objective function tracking a time varying end effector pose given by
+ * a position and optional orientation trajectory.
+ *
+ * The target pose at every rollout time step is precomputed once per
+ * trajectory update into a reference buffer shared between all copies of the
+ * objective. The buffer is filled in prepare before the rollouts start, so
+ * rollouts only read it without synchronisation. The buffer takes the time
+ * steps and horison of the trajectory generator from the prepared times. Steps
+ * that were not prepared, such as the rollouts of an update that was not
+ * prepared, evaluate the trajectory directly.
+ */
+class TrackTrajectory : public mppi::Cost
+{
+public:
+
+    struct Configuration {
+
+        /// The position trajectory of the end effector to track.
+        PositionTrajectory::Configuration position;
+
+        /// The optional orientation trajectory of the end effector to track.
+        std::optional<OrientationTrajectory::Configuration> orientation;
+
+        /// Cost of the distance between the end effector and the position
+        /// reference.
+        QuadraticCost position_cost;
+
+        /// Cost of the angle between the end effector and the orientation
+        /// reference.
+        QuadraticCost orientation_cost;
+
+        /// If joint limit costs are enabled.
+        bool enable_joint_limit;
+
+        /// Lower joint limits if enabled.
+        std::array<LeftInverseBarrierFunction, DoF::JOINTS> lower_joint_limit;
+
+        /// Upper joint limits if enabled.
+        std::array<RightInverseBarrierFunction, DoF::JOINTS> upper_joint_limit;
+
+        // JSON conversion for track trajectory objective configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            position, orientation, position_cost,
+            orientation_cost, enable_joint_limit, lower_joint_limit,
+            upper_joint_limit
+        )
+    };
+
+    /**
+     * @brief The default configuration of the track trajectory objective.
+     * @note Inlined since static initialisation order is undefined.
+     */
+    static inline const Configuration DEFAULT_CONFIGURATION {
+        .position = PositionTrajectory::Configuration {
+            .type = PositionTrajectory::Configuration::CIRCLE,
+            .point = PointTrajectory::DEFAULT_CONFIGURATION,
+            .circle = CircularTrajectory::DEFAULT_CONFIGURATION,
+            .rectangle = RectangularTrajectory::DEFAULT_CONFIGURATION,
+            .lissajous = LissajousTrajectory::DEFAULT_CONFIGURATION,
+            .figure_eight = FigureEightTrajectory::DEFAULT_CONFIGURATION
+        },
+        .orientation = std::nullopt,
+        .position_cost = { .quadratic_cost = 100.0 },
+        .orientation_cost = { .quadratic_cost = 10.0 },
+        .enable_joint_limit = true,
+        .lower_joint_limit = {{
+            {-2.0,    0.0}, // Base x
+            {-2.0,    0.0}, // Base y
+            {-6.28,   0.0}, // Base yaw
+            {-2.8,    10.0}, // Joint1
+            {-1.745,  10.0}, // Joint2
+            {-2.8,    10.0}, // Joint3
+            {-3.0718, 10.0}, // Joint4
+            {-2.7925, 10.0}, // Joint5
+            {0.349,   10.0}, // Joint6
+            {-2.967,  10.0}, // Joint7
+            {0.0,     0.0}, // Gripper x
+            {0.0,     0.0}  // Gripper y
+        }},
+        .upper_joint_limit = {{
+            {2.0,     0.0}, // Base x
+            {2.0,     0.0}, // Base y
+            {6.28,    0.0}, // Base yaw
+            {2.8,     10.0}, // Joint1
+            {1.745,   10.0}, // Joint2
+            {2.8,     10.0}, // Joint3
+            {0.0,     10.0}, // Joint4
+            {2.7925,  10.0}, // Joint5
+            {4.53785, 10.0}, // Joint6
+            {2.967,   10.0}, // Joint7
+            {0.5,     0.0}, // Gripper x
+            {0.5,     0.0}  // Gripper y
+        }}
+    };
+
+    /**
+     * @brief Get the number of state degrees of freedom.
+     */
+    inline constexpr int get_state_dof() override {
+        return DoF::STATE;
+    }
+
+    /**
+     * @brief Get the number of control degrees of freedom.
+     */
+    inline constexpr int get_control_dof() override {
+        return DoF::CONTROL;
+    }
+
+    /**
+     * @brief Create a track trajectory objective function.
+     *
+     * @param configuration The configuration of the objective function.
+     * @returns A pointer to the objective on success, or nullptr on failure.
+     */
+    static std::unique_ptr<TrackTrajectory> create(
+        const Configuration &configuration
+    );
+
+    /**
+     * @brief Fill the shared reference buffer at the time of each step of the
+     * update.
+     *
+     * Must not be called concurrently with rollouts of any copy of the
+     * objective.
+     *
+     * @param times The time of each step of the horison.
+     * @param dynamics Unused.
+     */
+    void prepare(const Eigen::VectorXd &times, mppi::Dynamics *dynamics) override;
+
+    /**
+     * @brief Reset the objective function to a new initial time.
+     * @param time The initial objective time.
+     */
+    inline void reset(double /* time */) override {
+        m_step = 0;
+    }
+
+    /**
+     * @brief Get the cost of a state and control input over dt.
+     *
+     * @param state The state of the system.
+     * @param control The control parameters applied to the state.
+     * @param dynamics Pointer to the dynamics at the time step.
+     * @param time The current time.
+     *
+     * @returns The cost of the step.
+     */
+    double get_cost(
+        const Eigen::VectorXd &state,
+        const Eigen::VectorXd &control,
+        mppi::Dynamics *dynamics,
+        double time
+    ) override;
+
+    /**
+     * @brief Make a copy of the objective function sharing the reference
+     * buffer.
+     */
+    inline std::unique_ptr<mppi::Cost> copy() override {
+        return std::unique_ptr<TrackTrajectory>(
+            new TrackTrajectory(m_configuration, m_reference)
+        );
+    }
+
+    /**
+     * @brief Get the reference position at a time.
+     * @param time The time of the reference.
+     */
+    inline Vector3d get_reference_position(double time) const {
+        return m_reference->position_trajectory->get_position(time);
+    }
+
+private:
+
+    /**
+     * @brief The reference pose at every time step of the horison, shared
+     * between all copies of the objective.
+     */
+    struct Reference {
+
+        /// The time of each reference in the buffer.
+        std::vector<double> times;
+
+        /// The position trajectory being tracked.
+        std::unique_ptr<PositionTrajectory> position_trajectory;
+
+        /// The optional orientation trajectory being tracked.
+        std::unique_ptr<OrientationTrajectory> orientation_trajectory;
+
+        /// The reference position at each time step.
+        std::vector<Vector3d> position;
+
+        /// The reference orientation at each time step, if tracked.
+        std::vector<Quaterniond> orientation;
+    };
+
+    /**
+     * @brief Initialise the track trajectory objective.
+     *
+     * @param configuration The configuration of the objective.
+     * @param reference The reference buffer shared with other copies.
+     */
+    TrackTrajectory(
+        const Configuration &configuration,
+        std::shared_ptr<Reference> reference
+    );
+
+    /// The largest difference in seconds between the time of a rollout step
+    /// and the time its reference was prepared for. Absorbs rounding if the
+    /// times are not computed by the same expression.
+    static constexpr double STEP_TIME_TOLERANCE = 1e-9;
+
+    /**
+     * @brief Get the index of the reference of the next step of the rollout.
+     *
+     * @param time The time of the step.
+     * @param index The index of the prepared reference at the time.
+     *
+     * @returns If the reference was prepared for the time, or false such as
+     * when the update was not prepared.
+     */
+    inline bool next_step(double time, std::size_t &index)
+    {
+        index = m_step++;
+        return index < m_reference->times.size() &&
+            std::abs(m_reference->times[index] - time) <= STEP_TIME_TOLERANCE;
+    }
+
+    /**
+     * @brief Penalises joint positions that exceed their limits.
+     *
+     * @param state The current state of the frankaridgeback.
+     * @returns A cost depending on the joint state.
+     */
+    double joint_limit_cost(const State &state);
+
+    /// The configuration of the objective function.
+    Configuration m_configuration;
+
+    /// The reference buffer shared between copies, read only during rollouts.
+    std::shared_ptr<Reference> m_reference;
+
+    /// The index of the next step of the rollout since the objective was
+    /// reset.
+    std::size_t m_step;
+};
+
+} // namespace FrankaRidgeback
@@ -1,5 +1,6 @@
 #include "frankaridgeback/pinocchio_dynamics.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 #include <string>
@@ -9,6 +10,7 @@
 #include <pinocchio/algorithm/joint-configuration.hpp>
 #include <pinocchio/algorithm/kinematics.hpp>
 #include <pinocchio/algorithm/aba.hpp>
+#include <pinocchio/algorithm/model.hpp>
 #include <pinocchio/parsers/urdf.hpp>
 #include <pinocchio/algorithm/rnea.hpp>
 
@@ -51,7 +53,6 @@ std::unique_ptr<PinocchioDynamics> PinocchioDynamics::create(
     try {
         model = std::make_unique<pinocchio::Model>();
         pinocchio::urdf::buildModelFromXML(urdf.str(), *model);
-        data = std::make_unique<pinocchio::Data>(*model);
 
         geometry_model = std::make_unique<pinocchio::GeometryModel>();
         pinocchio::urdf::buildGeom(
@@ -60,6 +61,42 @@ std::unique_ptr<PinocchioDynamics> PinocchioDynamics::create(
             pinocchio::GeometryType::COLLISION,
             *geometry_model
         );
+
+        // Lock the base joints out of the model, leaving the arm subtree
+        // fixed to the base.
+        if (configuration.decoupled_base) {
+            std::vector<pinocchio::JointIndex> base_joints;
+            for (Frame frame : {Frame::X_BASE_JOINT, Frame::Y_BASE_JOINT, Frame::PIVOT_JOINT}) {
+                const std::string &name = FRAME_NAMES[(std::size_t)frame];
+                if (!model->existJointName(name)) {
+                    std::cerr << "failed to decouple base, model has no joint " << name << std::endl;
+                    return nullptr;
+                }
+                base_joints.push_back(model->getJointId(name));
+            }
+
+            auto arm_model = std::make_unique<pinocchio::Model>();
+            auto arm_geometry_model = std::make_unique<pinocchio::GeometryModel>();
+            pinocchio::buildReducedModel(
+                *model,
+                *geometry_model,
+                base_joints,
+                pinocchio::neutral(*model),
+                *arm_model,
+                *arm_geometry_model
+            );
+
+            if (arm_model->nv != DECOUPLED_DOF) {
+                std::cerr << "failed to decouple base, arm model has " << arm_model->nv
+                          << " degrees of freedom" << std::endl;
+                return nullptr;
+            }
+
+            model = std::move(arm_model);
+            geometry_model = std::move(arm_geometry_model);
+        }
+
+        data = std::make_unique<pinocchio::Data>(*model);
         geometry_data = std::make_unique<pinocchio::GeometryData>(*geometry_model);
     }
     catch (const std::exception &err) {
@@ -67,8 +104,26 @@ std::unique_ptr<PinocchioDynamics> PinocchioDynamics::create(
         return nullptr;
     }
 
+    if (!model->existFrame(configuration.end_effector_frame)) {
+        std::cerr << "model has no end effector frame " << configuration.end_effector_frame << std::endl;
+        return nullptr;
+    }
+
     auto end_effector_frame_index = model->getFrameId(configuration.end_effector_frame);
 
+    // The frames placed every step. Other frames are placed on demand.
+    std::vector<pinocchio::FrameIndex> frames {end_effector_frame_index};
+    for (const std::string &name : configuration.frames) {
+        if (!model->existFrame(name)) {
+            std::cerr << "model has no frame of interest " << name << std::endl;
+            return nullptr;
+        }
+
+        auto frame = model->getFrameId(name);
+        if (std::find(frames.begin(), frames.end(), frame) == frames.end())
+            frames.push_back(frame);
+    }
+
     return std::unique_ptr<PinocchioDynamics>(
         new PinocchioDynamics(
             configuration,
@@ -77,7 +132,8 @@ std::unique_ptr<PinocchioDynamics> PinocchioDynamics::create(
             std::move(geometry_model),
             std::move(geometry_data),
             std::move(dynamics_forecast_handle),
-            end_effector_frame_index
+            end_effector_frame_index,
+            frames
         )
     );
 }
@@ -89,13 +145,20 @@ PinocchioDynamics::PinocchioDynamics(
     std::unique_ptr<pinocchio::GeometryModel> &&geometry_model,
     std::unique_ptr<pinocchio::GeometryData> &&geometry_data,
     std::unique_ptr<DynamicsForecast::Handle> &&dynamics_forecast_handle,
-    std::size_t end_effector_frame_index
+    std::size_t end_effector_frame_index,
+    const std::vector<pinocchio::FrameIndex> &frames
   ) : m_configuration(configuration)
     , m_model(std::move(model))
     , m_data(std::move(data))
     , m_geometry_model(std::move(geometry_model))
     , m_geometry_data(std::move(geometry_data))
     , m_end_effector_frame_index(end_effector_frame_index)
+    , m_base_placement(pinocchio::SE3::Identity())
+    , m_frames(frames)
+    , m_frame_indexes()
+    , m_link_indexes()
+    , m_revision(0)
+    , m_frame_revisions(m_model->nframes, 0)
     , m_joint_position()
     , m_joint_velocity()
     , m_joint_torque()
@@ -112,9 +175,24 @@ PinocchioDynamics::PinocchioDynamics(
     m_joint_torque.setZero();
     m_joint_acceleration.setZero();
 
+    for (std::size_t frame = 0; frame < m_frame_indexes.size(); ++frame)
+        m_frame_indexes[frame] = m_model->getFrameId(FRAME_NAMES[frame]);
+
+    for (std::size_t link = 0; link < m_link_indexes.size(); ++link)
+        m_link_indexes[link] = m_model->getFrameId(LINK_NAMES[link]);
+
     set_state(configuration.initial_state, m_time);
 }
 
+void PinocchioDynamics::update_frame_placements()
+{
+    // Invalidate the placements of all frames.
+    ++m_revision;
+
+    for (pinocchio::FrameIndex frame : m_frames)
+        update_frame_placement(frame);
+}
+
 std::unique_ptr<mppi::Dynamics> PinocchioDynamics::copy()
 {
     auto model = std::make_unique<pinocchio::Model>(*m_model);
@@ -134,7 +212,8 @@ std::unique_ptr<mppi::Dynamics> PinocchioDynamics::copy()
             std::move(geometry_model),
             std::move(geometry_data),
             std::move(forecast),
-            m_end_effector_frame_index
+            m_end_effector_frame_index,
+            m_frames
         )
     );
 }
@@ -152,6 +231,11 @@ void PinocchioDynamics::set_state(const Eigen::VectorXd &state, double time)
 
 void PinocchioDynamics::calculate()
 {
+    if (m_configuration.decoupled_base) {
+        calculate_decoupled();
+        return;
+    }
+
     // Gravity compensation.
     m_joint_torque += pinocchio::nonLinearEffects(
         *m_model.get(),
@@ -179,7 +263,7 @@ void PinocchioDynamics::calculate()
         m_joint_acceleration
     );
 
-    pinocchio::updateFramePlacements(*m_model, *m_data);
+    update_frame_placements();
 
     // Get the end effector jacobian.
     m_end_effector_state.jacobian.setZero();
@@ -223,6 +307,117 @@ void PinocchioDynamics::calculate()
     m_end_effector_state.angular_acceleration = spatial_acceleration.tail<3>();
 }
 
+void PinocchioDynamics::calculate_decoupled()
+{
+    double x = m_joint_position[0];
+    double y = m_joint_position[1];
+    double yaw = m_joint_position[2];
+
+    m_base_placement = pinocchio::SE3(
+        Eigen::AngleAxisd(yaw, Vector3d::UnitZ()).toRotationMatrix(),
+        Vector3d(x, y, 0.0)
+    );
+
+    auto position = m_joint_position.tail<DECOUPLED_DOF>();
+    auto velocity = m_joint_velocity.tail<DECOUPLED_DOF>();
+    auto torque = m_joint_torque.tail<DECOUPLED_DOF>();
+
+    // Gravity compensation. Gravity is along the yaw axis, so is the same in
+    // the base frame.
+    torque += pinocchio::nonLinearEffects(*m_model, *m_data, position, velocity);
+
+    // The base follows the velocity control, so only the arm accelerates.
+    m_joint_acceleration.head<DoF::BASE>().setZero();
+    m_joint_acceleration.tail<DECOUPLED_DOF>() = pinocchio::aba(
+        *m_model,
+        *m_data,
+        position,
+        velocity,
+        torque
+    );
+
+    pinocchio::forwardKinematics(
+        *m_model,
+        *m_data,
+        position,
+        velocity,
+        m_joint_acceleration.tail<DECOUPLED_DOF>()
+    );
+
+    update_frame_placements();
+
+    // Get the arm jacobian in the base frame, and transform it to the world.
+    Eigen::Matrix<double, 6, DECOUPLED_DOF> arm_jacobian;
+    arm_jacobian.setZero();
+    pinocchio::computeFrameJacobian(
+        *m_model,
+        *m_data,
+        position,
+        m_end_effector_frame_index,
+        pinocchio::ReferenceFrame::WORLD,
+        arm_jacobian
+    );
+
+    m_end_effector_state.jacobian.rightCols<DECOUPLED_DOF>() =
+        m_base_placement.toActionMatrix() * arm_jacobian;
+
+    // The base jacobian relative to the arm, as for the coupled model.
+    m_end_effector_state.jacobian.leftCols<DoF::BASE>().setZero();
+    m_end_effector_state.jacobian.topLeftCorner<3, 3>() = m_base_placement.rotation();
+    m_end_effector_state.jacobian(5, 2) = 1.0;
+
+    // The spatial velocity and acceleration of the base at the world origin,
+    // from the base joint velocities.
+    double vx = m_joint_velocity[0];
+    double vy = m_joint_velocity[1];
+    double wz = m_joint_velocity[2];
+
+    pinocchio::Motion base_velocity(
+        Vector3d(vx + wz * y, vy - wz * x, 0.0),
+        Vector3d(0.0, 0.0, wz)
+    );
+
+    pinocchio::Motion base_acceleration(
+        Vector3d(wz * vy, -wz * vx, 0.0),
+        Vector3d::Zero()
+    );
+
+    // Compose the end effector motion relative to the base with the base.
+    pinocchio::Motion relative_velocity = m_base_placement.act(
+        pinocchio::getFrameVelocity(
+            *m_model,
+            *m_data,
+            m_end_effector_frame_index,
+            pinocchio::WORLD
+        )
+    );
+
+    pinocchio::Motion relative_acceleration = m_base_placement.act(
+        pinocchio::getFrameAcceleration(
+            *m_model,
+            *m_data,
+            m_end_effector_frame_index,
+            pinocchio::WORLD
+        )
+    );
+
+    auto spatial_velocity = (base_velocity + relative_velocity).toVector();
+    auto spatial_acceleration = (
+        base_acceleration +
+        relative_acceleration +
+        base_velocity.cross(relative_velocity)
+    ).toVector();
+
+    auto placement = get_frame_placement(m_end_effector_frame_index);
+
+    m_end_effector_state.position = placement.translation();
+    m_end_effector_state.orientation = placement.rotation();
+    m_end_effector_state.linear_velocity = spatial_velocity.head<3>();
+    m_end_effector_state.angular_velocity = spatial_velocity.tail<3>();
+    m_end_effector_state.linear_acceleration = spatial_acceleration.head<3>();
+    m_end_effector_state.angular_acceleration = spatial_acceleration.tail<3>();
+}
+
 Eigen::Ref<Eigen::VectorXd> PinocchioDynamics::step(const Eigen::VectorXd &c, double dt)
 {
     const Control &control = c;
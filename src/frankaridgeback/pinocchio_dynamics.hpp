@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 #include <pinocchio/multibody/model.hpp>
 #include <pinocchio/multibody/data.hpp>
@@ -20,6 +23,12 @@ namespace FrankaRidgeback {
  * @note See simulation/raisim_dynamics.hpp for a raisim based dynamics
  * implementation.
  * 
+ * The base may be decoupled from the rigid body dynamics. Since the base is
+ * velocity controlled, its joints are then locked out of the pinocchio model
+ * and integrated kinematically, and the articulated body algorithm is run over
+ * the arm and gripper only. The model frames are then placed relative to the
+ * base, and composed with the base pose by get_frame_placement().
+ * 
  * @warning This class is broken due to the pinocchio articulated body algorithm
  * function diverging. This class also expects torque control (not velocity
  * control).
@@ -43,10 +52,22 @@ public:
         /// The initial energy in the energy tank.
         double energy;
 
+        /// If the base is integrated kinematically from the velocity control,
+        /// and the rigid body dynamics are only computed for the arm. This is
+        /// a deliberate approximation: the reaction of the base to the arm is
+        /// dropped, so arm accelerations differ from the full model by up to
+        /// a few rad/s^2, and the energy tank is not charged for the base
+        /// joint torques.
+        bool decoupled_base;
+
+        /// The names of the frames placed after every step, in addition to the
+        /// end effector. Other frames are placed when first read after a step.
+        std::vector<std::string> frames;
+
         /// JSON conversion for dynamics configuration.
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(
             Configuration,
-            filename, end_effector_frame, energy
+            filename, end_effector_frame, energy, decoupled_base, frames
         );
     };
 
@@ -54,7 +75,9 @@ public:
         .filename = "",
         .end_effector_frame = "panda_grasp_joint",
         .initial_state = FrankaRidgeback::State::Zero(),
-        .energy = 10.0
+        .energy = 10.0,
+        .decoupled_base = false,
+        .frames = {"arm_mount_joint"}
     };
 
     /**
@@ -155,9 +178,7 @@ public:
      */
     inline Vector3d get_frame_position(Frame frame) override
     {
-        return m_data->oMf[
-            m_model->getFrameId(FRAME_NAMES[(std::size_t)frame])
-        ].translation();
+        return get_frame_placement(m_frame_indexes[(std::size_t)frame]).translation();
     }
 
     /**
@@ -170,22 +191,20 @@ public:
      */
     Quaterniond get_frame_orientation(Frame frame) override
     {
-        return Quaterniond(m_data->oMf[
-            m_model->getFrameId(FRAME_NAMES[(std::size_t)frame])
-        ].rotation());
+        return Quaterniond(
+            get_frame_placement(m_frame_indexes[(std::size_t)frame]).rotation()
+        );
     }
 
     /**
      * @brief Get the origin of a link in the world frame
      * 
-     * @todo Needs implementation.
-     * 
      * @param link The link to get the origin of.
      * @returns The position of the link in the world frame.
      */
     Vector3d get_link_position(Link link) override
     {
-        return Vector3d::Zero();
+        return get_frame_placement(m_link_indexes[(std::size_t)link]).translation();
     }
 
     /**
@@ -286,12 +305,32 @@ public:
      * See https://gepettoweb.laas.fr/doc/stack-of-tasks/pinocchio/topic/doc-v2/doxygen-html/structse3_1_1Data.html
      * for all available model data.
      * 
+     * @note If the base is decoupled, placements are relative to the base.
+     * 
      * @return const pinocchio::Data* 
      */
     pinocchio::Data *get_data() const {
         return m_data.get();
     }
 
+    /**
+     * @brief Get the placement of a frame in the world.
+     * 
+     * The frame is placed if it has not been since the last step. If the base
+     * is decoupled, the frames of the base joints are placed at the base pose.
+     * 
+     * @param frame The index of the frame in the model.
+     * @returns The placement of the frame.
+     */
+    inline pinocchio::SE3 get_frame_placement(pinocchio::FrameIndex frame) const
+    {
+        update_frame_placement(frame);
+
+        if (m_configuration.decoupled_base)
+            return m_base_placement * m_data->oMf[frame];
+        return m_data->oMf[frame];
+    }
+
     /**
      * @brief Get the offset in the world space between two frames.
      * 
@@ -304,8 +343,8 @@ public:
         const std::string &from_frame,
         const std::string &to_frame
     ){
-        return m_data->oMf[m_model->getFrameId(to_frame)].translation() -
-        m_data->oMf[m_model->getFrameId(from_frame)].translation();
+        return get_frame_placement(m_model->getFrameId(to_frame)).translation() -
+        get_frame_placement(m_model->getFrameId(from_frame)).translation();
     }
 
     /**
@@ -323,8 +362,8 @@ public:
         using namespace pinocchio;
 
         return log6(
-            m_data->oMf[m_model->getFrameId(to_frame)].actInv(
-                m_data->oMf[m_model->getFrameId(from_frame)]
+            get_frame_placement(m_model->getFrameId(to_frame)).actInv(
+                get_frame_placement(m_model->getFrameId(from_frame))
             )
         ).toVector();
     }
@@ -338,20 +377,52 @@ public:
     inline std::tuple<Vector3d, Quaterniond> get_frame_pose(
         const std::string &frame
     ){
+        auto placement = get_frame_placement(m_model->getFrameId(frame));
         return std::make_tuple(
-            m_data->oMf[m_model->getFrameId(frame)].translation(),
-            (Quaterniond)m_data->oMf[m_model->getFrameId(frame)].rotation()
+            placement.translation(),
+            (Quaterniond)placement.rotation()
         );
     }
 
 protected:
 
+    /// The degrees of freedom of the rigid body dynamics when the base is
+    /// decoupled.
+    static inline constexpr int DECOUPLED_DOF = DoF::ARM + DoF::GRIPPER;
+
     /**
      * @brief Calculates kinematic information after position and velocity
      * updates.
      */
     void calculate();
 
+    /**
+     * @brief Place a frame from the joint placements, if it has not been
+     * placed since they were last calculated.
+     * 
+     * @param frame The index of the frame in the model.
+     */
+    inline void update_frame_placement(pinocchio::FrameIndex frame) const
+    {
+        if (m_frame_revisions[frame] == m_revision)
+            return;
+
+        pinocchio::updateFramePlacement(*m_model, *m_data, frame);
+        m_frame_revisions[frame] = m_revision;
+    }
+
+    /**
+     * @brief Place the frames of interest after the joint placements are
+     * calculated, invalidating the other frames.
+     */
+    void update_frame_placements();
+
+    /**
+     * @brief Calculates kinematic information with the base integrated
+     * kinematically, and the rigid body dynamics of the arm only.
+     */
+    void calculate_decoupled();
+
     /**
      * @brief Initialise the dynamics parameters.
      * 
@@ -361,6 +432,7 @@ protected:
      * @param geometry Pointer to the pinocchio geometry model.
      * @param end_effector_index Index into the vector of model joint frames for
      * the end effector.
+     * @param frames The indexes of the frames placed after every step.
      * @param dynamics_forecast_handle An optional handle to the forecasted
      * dynamics, forwarded to the objective function.
      */
@@ -371,7 +443,8 @@ protected:
         std::unique_ptr<pinocchio::GeometryModel> &&geometry_model,
         std::unique_ptr<pinocchio::GeometryData> &&geometry_data,
         std::unique_ptr<DynamicsForecast::Handle> &&dynamics_forecast_handle,
-        std::size_t end_effector_index
+        std::size_t end_effector_index,
+        const std::vector<pinocchio::FrameIndex> &frames
     );
 
     /// The configuration of the pinocchio.
@@ -392,6 +465,25 @@ protected:
     /// Index of the end effector frame in the frame vector.
     std::size_t m_end_effector_frame_index;
 
+    /// The pose of the base in the world, if the base is decoupled.
+    pinocchio::SE3 m_base_placement;
+
+    /// Indexes of the frames placed after every step, including the end
+    /// effector.
+    std::vector<pinocchio::FrameIndex> m_frames;
+
+    /// Index of each frame in the model.
+    std::array<pinocchio::FrameIndex, (std::size_t)Frame::_SIZE> m_frame_indexes;
+
+    /// Index of the frame of each link in the model.
+    std::array<pinocchio::FrameIndex, (std::size_t)Link::_SIZE> m_link_indexes;
+
+    /// The number of times the joint placements have been calculated.
+    std::uint64_t m_revision;
+
+    /// The revision of the joint placements each frame was last placed from.
+    mutable std::vector<std::uint64_t> m_frame_revisions;
+
     /// The current joint positions.
     Eigen::Vector<double, DoF::JOINTS> m_joint_position;
 
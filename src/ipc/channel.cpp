@@ -0,0 +1,484 @@
+#include "ipc/channel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <linux/futex.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace ipc {
+
+namespace {
+
+/// Identifies the shared memory as a channel.
+constexpr const std::uint64_t s_magic = 0x6c656e6e61686370; // "pchannel"
+
+/// Incremented on changes to the shared memory layout.
+constexpr const std::uint32_t s_version = 1;
+
+/// The alignment of each part of the shared memory, to avoid false sharing.
+constexpr const std::size_t s_alignment = 64;
+
+/// The number of doubles at the start of the trajectory slot before the
+/// controls. The time, time step and column count.
+constexpr const std::size_t s_trajectory_header = 3;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+inline std::size_t align(std::size_t size)
+{
+    return (size + s_alignment - 1) / s_alignment * s_alignment;
+}
+
+/**
+ * @brief Sleep while a futex word holds an expected value, or until woken.
+ *
+ * @param word The futex word in shared memory.
+ * @param expected The value to sleep on.
+ * @param timeout The maximum time to sleep in seconds.
+ */
+void futex_wait(
+    const std::atomic<std::uint32_t> *word,
+    std::uint32_t expected,
+    double timeout
+) {
+#ifdef __linux__
+    timespec duration {};
+    duration.tv_sec = (time_t)timeout;
+    duration.tv_nsec = (long)((timeout - (double)duration.tv_sec) * 1e9);
+
+    // Not private, the word is shared between processes.
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, &duration, nullptr, 0);
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Wake all processes sleeping on a futex word.
+ * @param word The futex word in shared memory.
+ */
+void futex_wake(const std::atomic<std::uint32_t> *word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/**
+ * @brief Write a slot under its sequence lock, then wake readers.
+ *
+ * The sequence is odd while a write is in progress. Zero is reserved for a
+ * slot that has never been written.
+ *
+ * @param sequence The sequence of the slot.
+ * @param write Function writing the slot.
+ */
+template<typename Write>
+void seqlock_write(std::atomic<std::uint32_t> &sequence, Write &&write)
+{
+    std::uint32_t before = sequence.load(std::memory_order_relaxed);
+    sequence.store(before + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    write();
+
+    std::uint32_t after = before + 2;
+    if (after == 0)
+        after = 2;
+
+    sequence.store(after, std::memory_order_release);
+    futex_wake(&sequence);
+}
+
+/**
+ * @brief Read a slot under its sequence lock, retrying torn reads.
+ *
+ * @param sequence The sequence of the slot.
+ * @param read Function reading the slot. Must tolerate torn data.
+ *
+ * @returns The sequence of the consistent read.
+ */
+template<typename Read>
+std::uint32_t seqlock_read(const std::atomic<std::uint32_t> &sequence, Read &&read)
+{
+    while (true) {
+        std::uint32_t before = sequence.load(std::memory_order_acquire);
+
+        // Write in progress.
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        read();
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before)
+            return before;
+    }
+}
+
+/**
+ * @brief Get the time point a timeout from now.
+ * @param timeout The timeout in seconds.
+ */
+inline std::chrono::steady_clock::time_point get_deadline(double timeout)
+{
+    using namespace std::chrono;
+    return steady_clock::now() + duration_cast<steady_clock::duration>(duration<double>(timeout));
+}
+
+/**
+ * @brief Get the seconds remaining until a deadline, clamped to zero.
+ */
+inline double remaining(std::chrono::steady_clock::time_point deadline)
+{
+    using namespace std::chrono;
+    return std::max(0.0, duration<double>(deadline - steady_clock::now()).count());
+}
+
+} // namespace
+
+struct Channel::Header {
+
+    /// Set to s_magic once the header is initialised.
+    std::atomic<std::uint64_t> magic;
+
+    /// The layout version.
+    std::uint32_t version;
+
+    /// The degrees of freedom of the state.
+    std::uint32_t state_dof;
+
+    /// The degrees of freedom of the control.
+    std::uint32_t control_dof;
+
+    /// The maximum number of trajectory time steps.
+    std::uint32_t steps;
+
+    /// Nonzero once the creator has closed the channel.
+    std::atomic<std::uint32_t> closed;
+
+    /// Sequence lock and futex word of the state slot.
+    alignas(s_alignment) std::atomic<std::uint32_t> state_sequence;
+
+    /// Sequence lock and futex word of the trajectory slot.
+    alignas(s_alignment) std::atomic<std::uint32_t> trajectory_sequence;
+};
+
+std::size_t Channel::get_size(
+    unsigned int state_dof,
+    unsigned int control_dof,
+    unsigned int steps
+) {
+    return (
+        align(sizeof(Header)) +
+        align(sizeof(double) * (1 + state_dof)) +
+        align(sizeof(double) * (s_trajectory_header + (std::size_t)control_dof * steps))
+    );
+}
+
+std::unique_ptr<Channel> Channel::create(const Configuration &configuration)
+{
+#ifdef __linux__
+    if (configuration.name.empty() || configuration.name[0] != '/') {
+        std::cerr << "channel name must begin with a slash" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.state_dof == 0 || configuration.control_dof == 0 ||
+        configuration.steps == 0) {
+        std::cerr << "channel dimensions must be nonzero" << std::endl;
+        return nullptr;
+    }
+
+    std::size_t size = get_size(
+        configuration.state_dof,
+        configuration.control_dof,
+        configuration.steps
+    );
+
+    // Replace a channel left behind by a previous process.
+    shm_unlink(configuration.name.c_str());
+
+    int descriptor = shm_open(configuration.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (descriptor < 0) {
+        std::cerr << "failed to create channel " << configuration.name << ": "
+                  << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    if (ftruncate(descriptor, (off_t)size) != 0) {
+        std::cerr << "failed to size channel: " << std::strerror(errno) << std::endl;
+        ::close(descriptor);
+        shm_unlink(configuration.name.c_str());
+        return nullptr;
+    }
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+
+    if (memory == MAP_FAILED) {
+        std::cerr << "failed to map channel: " << std::strerror(errno) << std::endl;
+        shm_unlink(configuration.name.c_str());
+        return nullptr;
+    }
+
+    // The memory is zero filled, so the slots are unwritten.
+    Header *header = new (memory) Header();
+    header->version = s_version;
+    header->state_dof = configuration.state_dof;
+    header->control_dof = configuration.control_dof;
+    header->steps = configuration.steps;
+
+    // Published last, so that openers see an initialised header.
+    header->magic.store(s_magic, std::memory_order_release);
+
+    return std::unique_ptr<Channel>(
+        new Channel(configuration.name, memory, size, true)
+    );
+#else
+    std::cerr << "shared memory channels are unsupported on this platform" << std::endl;
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<Channel> Channel::open(const std::string &name)
+{
+#ifdef __linux__
+    int descriptor = shm_open(name.c_str(), O_RDWR, 0);
+    if (descriptor < 0) {
+        std::cerr << "failed to open channel " << name << ": "
+                  << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0 || (std::size_t)status.st_size < sizeof(Header)) {
+        std::cerr << "channel " << name << " is not initialised" << std::endl;
+        ::close(descriptor);
+        return nullptr;
+    }
+
+    auto size = (std::size_t)status.st_size;
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+
+    if (memory == MAP_FAILED) {
+        std::cerr << "failed to map channel: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    auto *header = static_cast<Header *>(memory);
+
+    bool valid = (
+        header->magic.load(std::memory_order_acquire) == s_magic &&
+        header->version == s_version &&
+        get_size(header->state_dof, header->control_dof, header->steps) == size
+    );
+
+    if (!valid) {
+        std::cerr << "channel " << name << " has an incompatible layout" << std::endl;
+        munmap(memory, size);
+        return nullptr;
+    }
+
+    return std::unique_ptr<Channel>(new Channel(name, memory, size, false));
+#else
+    std::cerr << "shared memory channels are unsupported on this platform" << std::endl;
+    return nullptr;
+#endif
+}
+
+Channel::Channel(
+    const std::string &name,
+    void *memory,
+    std::size_t size,
+    bool owner
+) : m_name(name)
+  , m_memory(memory)
+  , m_size(size)
+  , m_owner(owner)
+  , m_header(static_cast<Header *>(memory))
+{
+    m_state_dof = m_header->state_dof;
+    m_control_dof = m_header->control_dof;
+    m_steps = m_header->steps;
+
+    auto *bytes = static_cast<std::byte *>(memory);
+    m_state = reinterpret_cast<double *>(bytes + align(sizeof(Header)));
+    m_trajectory = reinterpret_cast<double *>(
+        bytes + align(sizeof(Header)) + align(sizeof(double) * (1 + m_state_dof))
+    );
+}
+
+Channel::~Channel()
+{
+#ifdef __linux__
+    if (m_owner) {
+        m_header->closed.store(1, std::memory_order_release);
+
+        // Wake readers so they observe the channel closing.
+        futex_wake(&m_header->state_sequence);
+        futex_wake(&m_header->trajectory_sequence);
+    }
+
+    munmap(m_memory, m_size);
+
+    if (m_owner)
+        shm_unlink(m_name.c_str());
+#endif
+}
+
+void Channel::write_state(const Eigen::Ref<const VectorXd> state, double time)
+{
+    assert(state.size() == m_state_dof);
+
+    seqlock_write(m_header->state_sequence, [&]() {
+        m_state[0] = time;
+        std::memcpy(m_state + 1, state.data(), sizeof(double) * m_state_dof);
+    });
+}
+
+std::uint32_t Channel::read_state(Eigen::Ref<VectorXd> state, double &time) const
+{
+    assert(state.size() == m_state_dof);
+
+    return seqlock_read(m_header->state_sequence, [&]() {
+        time = m_state[0];
+        std::memcpy(state.data(), m_state + 1, sizeof(double) * m_state_dof);
+    });
+}
+
+bool Channel::wait_state(std::uint32_t sequence, double timeout) const
+{
+    auto deadline = get_deadline(timeout);
+
+    while (!is_closed()) {
+        std::uint32_t current = m_header->state_sequence.load(std::memory_order_acquire);
+        if (current != sequence && !(current & 1))
+            return true;
+
+        double wait = remaining(deadline);
+        if (wait <= 0.0)
+            return false;
+
+        futex_wait(&m_header->state_sequence, current, wait);
+    }
+
+    return false;
+}
+
+void Channel::write_trajectory(
+    const Eigen::Ref<const MatrixXd> trajectory,
+    double time,
+    double time_step
+) {
+    assert(trajectory.rows() == m_control_dof);
+
+    auto columns = std::min<std::size_t>(trajectory.cols(), m_steps);
+
+    seqlock_write(m_header->trajectory_sequence, [&]() {
+        m_trajectory[0] = time;
+        m_trajectory[1] = time_step;
+        m_trajectory[2] = (double)columns;
+
+        // Copied through a map, since the outer stride of the trajectory may
+        // be larger than its rows, such as for a block of a larger matrix.
+        Eigen::Map<MatrixXd>(
+            m_trajectory + s_trajectory_header,
+            m_control_dof,
+            columns
+        ) = trajectory.leftCols(columns);
+    });
+}
+
+bool Channel::get_control(Eigen::Ref<VectorXd> control, double time) const
+{
+    assert(control.size() == m_control_dof);
+
+    bool written = false;
+
+    std::uint32_t sequence = seqlock_read(m_header->trajectory_sequence, [&]() {
+        double start = m_trajectory[0];
+        double step = m_trajectory[1];
+        double count = m_trajectory[2];
+
+        // A torn read may see any value, including non-finite ones, so values
+        // are range checked before conversion to an integer. The read is then
+        // retried and discarded.
+        written = count >= 1.0 && count <= (double)m_steps && step > 0.0 && std::isfinite(start);
+        if (!written)
+            return;
+
+        auto columns = (std::int64_t)count;
+
+        Eigen::Map<const MatrixXd> trajectory(
+            m_trajectory + s_trajectory_header,
+            m_control_dof,
+            columns
+        );
+
+        // Steps into the trajectory, or zero if not a number.
+        double t = (time - start) / step;
+        if (!(t > 0.0))
+            t = 0.0;
+
+        // Past the end of the trajectory.
+        if (t >= (double)(columns - 1)) {
+            control = trajectory.col(columns - 1);
+            return;
+        }
+
+        auto lower = (std::int64_t)t;
+        t -= (double)lower;
+        control = (1.0 - t) * trajectory.col(lower) + t * trajectory.col(lower + 1);
+    });
+
+    return sequence != 0 && written;
+}
+
+bool Channel::wait_trajectory(double time, double timeout) const
+{
+    auto deadline = get_deadline(timeout);
+
+    while (!is_closed()) {
+        double start = 0.0;
+        std::uint32_t sequence = seqlock_read(m_header->trajectory_sequence, [&]() {
+            start = m_trajectory[0];
+        });
+
+        if (sequence != 0 && start >= time)
+            return true;
+
+        double wait = remaining(deadline);
+        if (wait <= 0.0)
+            return false;
+
+        futex_wait(&m_header->trajectory_sequence, sequence, wait);
+    }
+
+    return false;
+}
+
+bool Channel::is_closed() const
+{
+    return m_header->closed.load(std::memory_order_acquire) != 0;
+}
+
+} // namespace ipc
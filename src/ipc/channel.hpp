@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "controller/eigen.hpp"
+#include "controller/json.hpp"
+
+namespace ipc {
+
+/**
+ * @brief A shared memory channel between a plant and an out of process
+ * controller on the same machine.
+ *
+ * The channel has two slots. The plant writes its state to the state slot,
+ * and the controller writes its control trajectory to the trajectory slot.
+ * Each slot has a single writer and is protected by a sequence lock, so
+ * writers never block and readers retry if a write was in progress. The
+ * sequence numbers double as futex words, so readers can sleep until the
+ * other process writes.
+ *
+ * The plant creates and owns the shared memory, and the controller opens it.
+ * The controller may be restarted while the plant is running.
+ *
+ * Only supported on linux, elsewhere creation fails.
+ */
+class Channel
+{
+public:
+
+    struct Configuration {
+
+        /// The name of the shared memory object, beginning with a slash.
+        std::string name;
+
+        /// The degrees of freedom of the state.
+        unsigned int state_dof;
+
+        /// The degrees of freedom of the control.
+        unsigned int control_dof;
+
+        /// The maximum number of control trajectory time steps.
+        unsigned int steps;
+
+        // JSON conversion for channel configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            name, state_dof, control_dof, steps
+        )
+    };
+
+    /**
+     * @brief Create a channel. Replaces an existing channel of the same name.
+     *
+     * The shared memory is removed when the channel is destroyed.
+     *
+     * @param configuration The configuration of the channel.
+     * @returns A pointer to the channel on success or nullptr on failure.
+     */
+    static std::unique_ptr<Channel> create(const Configuration &configuration);
+
+    /**
+     * @brief Open a channel created by another process.
+     *
+     * @param name The name of the shared memory object.
+     * @returns A pointer to the channel on success or nullptr on failure.
+     */
+    static std::unique_ptr<Channel> open(const std::string &name);
+
+    /**
+     * @brief Unmaps the shared memory, and closes the channel if it was
+     * created by this process.
+     */
+    ~Channel();
+
+    /**
+     * @brief Write the plant state, and wake the controller.
+     *
+     * @param state The state of dimension state_dof.
+     * @param time The time of the state.
+     */
+    void write_state(const Eigen::Ref<const VectorXd> state, double time);
+
+    /**
+     * @brief Read the latest plant state.
+     *
+     * @param state The state to fill, of dimension state_dof.
+     * @param time The time of the state.
+     *
+     * @returns The sequence number of the state read, that is zero if no state
+     * has been written.
+     */
+    std::uint32_t read_state(Eigen::Ref<VectorXd> state, double &time) const;
+
+    /**
+     * @brief Wait for a state newer than a previously read one.
+     *
+     * @param sequence The sequence number of the previously read state.
+     * @param timeout The maximum time to wait in seconds.
+     *
+     * @returns If a newer state was written before the timeout, and the
+     * channel is open.
+     */
+    bool wait_state(std::uint32_t sequence, double timeout) const;
+
+    /**
+     * @brief Write the control trajectory, and wake the plant.
+     *
+     * @param trajectory The control trajectory with control_dof rows and a
+     * column per time step. Columns beyond the channel steps are dropped.
+     * @param time The time of the first column.
+     * @param time_step The time between columns.
+     */
+    void write_trajectory(
+        const Eigen::Ref<const MatrixXd> trajectory,
+        double time,
+        double time_step
+    );
+
+    /**
+     * @brief Interpolate the control trajectory at a time without copying it
+     * out of shared memory.
+     *
+     * Past the end of the trajectory the last control is returned.
+     *
+     * @param control The control to fill, of dimension control_dof.
+     * @param time The time to evaluate the trajectory.
+     *
+     * @returns If a trajectory has been written.
+     */
+    bool get_control(Eigen::Ref<VectorXd> control, double time) const;
+
+    /**
+     * @brief Wait for a control trajectory starting at or after a time.
+     *
+     * @param time The earliest start time of the trajectory.
+     * @param timeout The maximum time to wait in seconds.
+     *
+     * @returns If such a trajectory was written before the timeout, and the
+     * channel is open.
+     */
+    bool wait_trajectory(double time, double timeout) const;
+
+    /**
+     * @brief If the channel was closed by its creator.
+     */
+    bool is_closed() const;
+
+    inline unsigned int get_state_dof() const {
+        return m_state_dof;
+    }
+
+    inline unsigned int get_control_dof() const {
+        return m_control_dof;
+    }
+
+    inline unsigned int get_steps() const {
+        return m_steps;
+    }
+
+private:
+
+    struct Header;
+
+    Channel(
+        const std::string &name,
+        void *memory,
+        std::size_t size,
+        bool owner
+    );
+
+    /**
+     * @brief Get the size of the shared memory for given dimensions.
+     */
+    static std::size_t get_size(
+        unsigned int state_dof,
+        unsigned int control_dof,
+        unsigned int steps
+    );
+
+    /// The name of the shared memory object.
+    std::string m_name;
+
+    /// The mapped shared memory.
+    void *m_memory;
+
+    /// The size of the mapped shared memory.
+    std::size_t m_size;
+
+    /// If this process created the channel.
+    bool m_owner;
+
+    /// The channel header at the start of the shared memory.
+    Header *m_header;
+
+    /// The state slot, the time followed by the state.
+    double *m_state;
+
+    /// The trajectory slot, the time, time step and column count followed by
+    /// the column major control trajectory.
+    double *m_trajectory;
+
+    /// The degrees of freedom of the state.
+    unsigned int m_state_dof;
+
+    /// The degrees of freedom of the control.
+    unsigned int m_control_dof;
+
+    /// The maximum number of control trajectory time steps.
+    unsigned int m_steps;
+};
+
+} // namespace ipc
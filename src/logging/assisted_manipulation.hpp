@@ -58,7 +58,9 @@ public:
      * @brief Log the objective function.
      * 
      * @param time The time of the objective.
-     * @param objective The assisted manipulation objective.
+     * @param objective The assisted manipulation objective. Only the copy
+     * from AssistedManipulation::copy_optimal() records the breakdown of the
+     * cost, see mppi::Trajectory::get_optimal_cost().
      */
     void log(
         double time,
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <charconv>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include <Eigen/Core>
+
 #include "logging/file.hpp"
 
 namespace logger {
@@ -19,6 +25,10 @@ concept Iterable = requires(T iterable)
 
 /**
  * @brief A CSV logging class.
+ *
+ * Numbers are formatted with std::to_chars in their shortest representation
+ * that reads back to the same value, independent of the locale. Rows are
+ * formatted into a buffer that is written to the file once full.
  */
 class CSV
 {
@@ -29,6 +39,15 @@ public:
      */
     using Header = std::vector<std::string>;
 
+    /// The size of the buffer rows are formatted into.
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    /// The most characters of a formatted number.
+    static constexpr std::size_t MAXIMUM_NUMBER_LENGTH = 32;
+
+    /// The separator between values.
+    static constexpr std::string_view SEPARATOR = ", ";
+
     /**
      * @brief Configuration of the CSV file.
      */
@@ -72,16 +91,11 @@ public:
             return nullptr;
         }
 
-        // Output the csv header.
-        if (!configuration.header.empty()) {
-            *file << configuration.header[0];
-            for (int i = 1; i < configuration.header.size(); i++)
-                *file << ", " << configuration.header[i];
-            *file << '\n';
-        }
+        auto csv = std::unique_ptr<CSV>(new CSV(std::move(file)));
 
-        auto csv = std::unique_ptr<CSV>(new CSV());
-        csv->m_file = std::move(file);
+        // Output the csv header.
+        if (!configuration.header.empty())
+            csv->write(configuration.header);
 
         return csv;
     }
@@ -91,36 +105,52 @@ public:
      * 
      * This function generically handles writing variables to a CSV file. If the
      * variable is iterable, then the csv file will iterate over each element
-     * and log it separately.
+     * and log it separately. Eigen vectors and matrices are written as their
+     * contiguous coefficients, in storage order.
      * 
      * @param arg The first argument passed to write.
      * @param args Optional other arguments to write to the file.
      */
     template<typename Arg, typename... Args>
-    void write(Arg &&arg, Args&&... args)
+    void write(const Arg &arg, const Args&... args)
     {
-        using namespace std::string_literals;
-
         // Log the first value.
-        write_value(std::forward<Arg&&>(arg));
+        write_value(arg);
 
         // Log comma separated values.
-        ((*m_file << ", ", write_value(std::forward<Args&&>(args))), ...);
+        ((write_string(SEPARATOR), write_value(args)), ...);
 
         // End with newline. End of newline at end of file.
-        *m_file << '\n';
+        write_character('\n');
     }
 
     /**
      * @brief Flush to disk.
      */
     inline void flush() {
-        m_file->get_stream().flush();
+        drain();
+        m_file->flush();
+    }
+
+    /**
+     * @brief Wait for the flushed rows to be written.
+     */
+    inline void wait() {
+        m_file->wait();
+    }
+
+    inline ~CSV()
+    {
+        drain();
     }
 
 private:
 
-    CSV() = default;
+    inline CSV(std::unique_ptr<File> &&file)
+        : m_file(std::move(file))
+        , m_buffer(new char[BUFFER_SIZE])
+        , m_size(0)
+    {}
 
     /**
      * @brief Push a string to a header.
@@ -140,6 +170,40 @@ private:
             header.push_back(element);
     }
 
+    /**
+     * @brief Write a value to the CSV file.
+     * 
+     * @tparam T The type of the value.
+     * @param value The value to write.
+     */
+    template<typename T>
+    void write_value(const T &value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            write_character(value ? '1' : '0');
+        }
+        else if constexpr (std::is_same_v<T, char>) {
+            write_character(value);
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            write_number(value);
+        }
+        else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+            write_string(value);
+        }
+        else if constexpr (std::is_base_of_v<Eigen::DenseBase<T>, T>) {
+            write_matrix(value);
+        }
+        else if constexpr (Iterable<T>) {
+            write_iterable(value);
+        }
+        else {
+            std::ostringstream stream;
+            stream << value;
+            write_string(stream.view());
+        }
+    }
+
     /**
      * @brief Write an iterable to the file, comma separated.
      * 
@@ -147,33 +211,142 @@ private:
      * @param iterable The iterable to write.
      */
     template<typename T>
-    void write_value(const T &iterable) requires Iterable<T>
+    void write_iterable(const T &iterable)
     {
         auto it = std::begin(iterable);
         if (it == std::end(iterable))
             return;
 
-        *m_file << *it;
+        write_value(*it);
 
         // Comma separation after the first element.
         for (++it; it != std::end(iterable); ++it) {
-            *m_file << ", " << *it;
+            write_string(SEPARATOR);
+            write_value(*it);
         }
     }
 
     /**
-     * @brief Write a value to the CSV file.
-     * 
-     * @tparam T The type of the value.
-     * @param value The value to write.
+     * @brief Write the coefficients of an Eigen vector or matrix, comma
+     * separated.
+     *
+     * Expressions without contiguous coefficients are evaluated first.
+     *
+     * @param matrix The vector or matrix to write.
+     */
+    template<typename Derived>
+    void write_matrix(const Eigen::DenseBase<Derived> &matrix)
+    {
+        const Derived &derived = matrix.derived();
+
+        if constexpr ((Derived::Flags & Eigen::DirectAccessBit) != 0) {
+            bool contiguous = (
+                derived.innerStride() == 1 &&
+                (derived.outerSize() <= 1 || derived.outerStride() == derived.innerSize())
+            );
+
+            if (contiguous) {
+                write_span(derived.data(), derived.size());
+                return;
+            }
+        }
+
+        const typename Derived::PlainObject plain = derived;
+        write_span(plain.data(), plain.size());
+    }
+
+    /**
+     * @brief Write contiguous numbers, comma separated.
+     *
+     * @param values Pointer to the first value.
+     * @param count The number of values.
      */
     template<typename T>
-    void write_value(const T &value) {
-        *m_file << value;
+    void write_span(const T *values, Eigen::Index count)
+    {
+        if (count == 0)
+            return;
+
+        write_value(values[0]);
+
+        for (Eigen::Index i = 1; i < count; ++i) {
+            reserve(SEPARATOR.size() + MAXIMUM_NUMBER_LENGTH);
+            std::copy(SEPARATOR.begin(), SEPARATOR.end(), m_buffer.get() + m_size);
+            m_size += SEPARATOR.size();
+            write_value(values[i]);
+        }
+    }
+
+    /**
+     * @brief Write a number in its shortest representation that reads back
+     * to the same value.
+     */
+    template<typename T>
+    inline void write_number(T value)
+    {
+        reserve(MAXIMUM_NUMBER_LENGTH);
+
+        char *begin = m_buffer.get() + m_size;
+        auto result = std::to_chars(begin, begin + MAXIMUM_NUMBER_LENGTH, value);
+        m_size += result.ptr - begin;
+    }
+
+    /**
+     * @brief Write a character.
+     */
+    inline void write_character(char character)
+    {
+        reserve(1);
+        m_buffer[m_size++] = character;
+    }
+
+    /**
+     * @brief Write a string. Strings larger than the buffer are written to
+     * the file directly.
+     */
+    inline void write_string(std::string_view string)
+    {
+        if (string.size() > BUFFER_SIZE) {
+            drain();
+            m_file->write(string.data(), string.size());
+            return;
+        }
+
+        reserve(string.size());
+        std::copy(string.begin(), string.end(), m_buffer.get() + m_size);
+        m_size += string.size();
+    }
+
+    /**
+     * @brief Make room in the buffer, writing it to the file if full.
+     * @param size The number of characters to make room for.
+     */
+    inline void reserve(std::size_t size)
+    {
+        if (m_size + size > BUFFER_SIZE)
+            drain();
+    }
+
+    /**
+     * @brief Write the buffer to the file.
+     */
+    inline void drain()
+    {
+        if (m_size == 0)
+            return;
+
+        m_file->write(m_buffer.get(), m_size);
+        m_size = 0;
     }
 
     /// The file to write to.
     std::unique_ptr<File> m_file;
+
+    /// The buffer rows are formatted into.
+    std::unique_ptr<char[]> m_buffer;
+
+    /// The number of characters in the buffer.
+    std::size_t m_size;
 };
 
 } // namespace logger
@@ -1,14 +1,24 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
-#include <fstream>
 #include <filesystem>
+#include <memory>
+#include <ostream>
+#include <streambuf>
 #include <string>
 
+#include "logging/writer.hpp"
+
 namespace logger {
 
 /**
  * @brief A file logging class.
+ *
+ * Written values are buffered into blocks that are written asynchronously by
+ * the Writer shared by every file, so logging does not wait on the disk.
+ * Flushing submits the partially filled block. The file is closed in the
+ * background once its blocks are written.
  */
 class File
 {
@@ -39,18 +49,19 @@ public:
             }
         }
 
-        // Open the CSV file.
-        std::fstream stream {path, std::ios::out};
+        // Open the file.
+        Writer &writer = Writer::get();
+        auto target = writer.open(path);
 
-        if (!stream.is_open()) {
+        if (!target) {
             std::cerr << "failed to open log file "<< path << std::endl;
             return nullptr;
         }
 
-        return std::unique_ptr<File>(new File(std::move(stream)));
+        return std::unique_ptr<File>(new File(writer, std::move(target)));
     }
 
-    inline std::fstream &get_stream() {
+    inline std::ostream &get_stream() {
         return m_stream;
     }
 
@@ -59,31 +70,173 @@ public:
         m_stream << value;
     }
 
+    /**
+     * @brief Write the bytes of contiguous values, in native byte order.
+     * 
+     * @param values Pointer to the first value.
+     * @param count The number of values.
+     */
+    template<typename T>
+    inline void write(const T *values, std::size_t count) {
+        m_stream.write(reinterpret_cast<const char *>(values), sizeof(T) * count);
+    }
+
     template<typename T>
-    inline std::fstream &operator<<(T &&value)
+    inline std::ostream &operator<<(T &&value)
     {
         m_stream << value;
         return m_stream;
     }
 
+    /**
+     * @brief Submit the buffered values to be written.
+     */
+    inline void flush() {
+        m_stream.flush();
+    }
+
+    /**
+     * @brief Wait for the submitted values to be written.
+     */
+    inline void wait() {
+        m_buffer.wait();
+    }
+
+    /**
+     * @brief Get the statistics of the blocks written to the file.
+     */
+    inline Writer::Statistics get_statistics() {
+        return m_buffer.get_statistics();
+    }
+
     inline ~File()
     {
         m_stream.flush();
-        m_stream.close();
     }
 
 private:
 
+    /**
+     * @brief Stream buffer filling blocks of the writer.
+     */
+    class Buffer : public std::streambuf
+    {
+    public:
+
+        inline Buffer(Writer &writer, std::shared_ptr<Writer::Target> &&target)
+            : m_writer(writer)
+            , m_target(std::move(target))
+            , m_block(writer.acquire())
+            , m_offset(0)
+        {
+            setp(m_block, m_block + Writer::BLOCK_CAPACITY);
+        }
+
+        inline ~Buffer()
+        {
+            submit();
+            m_writer.release(m_block);
+            m_writer.close(m_target);
+        }
+
+        inline void wait() {
+            m_writer.wait(m_target);
+        }
+
+        inline Writer::Statistics get_statistics()
+        {
+            std::scoped_lock lock(m_target->mutex);
+            return m_target->statistics;
+        }
+
+    protected:
+
+        inline int_type overflow(int_type character) override
+        {
+            submit();
+
+            if (!traits_type::eq_int_type(character, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(character);
+                pbump(1);
+            }
+
+            return traits_type::not_eof(character);
+        }
+
+        inline std::streamsize xsputn(const char *data, std::streamsize count) override
+        {
+            std::streamsize written = 0;
+
+            while (written < count) {
+                if (pptr() == epptr())
+                    submit();
+
+                std::streamsize size = std::min<std::streamsize>(
+                    count - written, epptr() - pptr()
+                );
+
+                std::copy_n(data + written, size, pptr());
+                pbump((int)size);
+                written += size;
+            }
+
+            return written;
+        }
+
+        inline int sync() override
+        {
+            submit();
+            return 0;
+        }
+
+    private:
+
+        /**
+         * @brief Submit the filled part of the block, and continue in a new
+         * block.
+         */
+        inline void submit()
+        {
+            std::size_t size = pptr() - pbase();
+            if (size == 0)
+                return;
+
+            m_writer.submit(m_target, m_block, size, m_offset);
+            m_offset += size;
+
+            m_block = m_writer.acquire();
+            setp(m_block, m_block + Writer::BLOCK_CAPACITY);
+        }
+
+        /// The writer writing the blocks.
+        Writer &m_writer;
+
+        /// The file written to.
+        std::shared_ptr<Writer::Target> m_target;
+
+        /// The block being filled.
+        char *m_block;
+
+        /// The offset in the file of the block being filled.
+        std::uint64_t m_offset;
+    };
+
     /**
      * @brief Initialise the file logger.
-     * @param out The open file stream to write to.
+     *
+     * @param writer The writer writing the file.
+     * @param target The open file to write to.
      */
-    inline File(std::fstream &&out)
-        : m_stream(std::move(out))
+    inline File(Writer &writer, std::shared_ptr<Writer::Target> &&target)
+        : m_buffer(writer, std::move(target))
+        , m_stream(&m_buffer)
     {}
 
-    /// The file to write to.
-    std::fstream m_stream;
+    /// The buffer of the file.
+    Buffer m_buffer;
+
+    /// The stream writing to the buffer.
+    std::ostream m_stream;
 };
 
 } // namespace logger
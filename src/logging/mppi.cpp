@@ -58,17 +58,42 @@ std::unique_ptr<MPPI> MPPI::create(const Configuration &configuration)
     if (configuration.log_update) {
         mppi->m_update = CSV::create(CSV::Configuration{
             .path = configuration.folder / "update.csv",
-            .header = CSV::make_header("update", "time", "update_duration")
+            .header = CSV::make_header(
+                "update", "time", "update_duration", "sample_duration",
+                "rollout_duration", "optimise_duration", "filter_duration",
+                "rollout_limit", "effective_sample_size", "cost_scale"
+            )
         });
     }
 
+    if (configuration.log_deadline) {
+        mppi->m_deadline = CSV::create(CSV::Configuration{
+            .path = configuration.folder / "deadline.csv",
+            .header = CSV::make_header(
+                "update", "time", "duration", "deadline", "overruns",
+                "consecutive_overruns", "worst_duration", "degradations",
+                "fallbacks", "fallback", "skipped", "overrun_sample_duration",
+                "overrun_rollout_duration", "overrun_optimise_duration",
+                "overrun_filter_duration"
+            )
+        });
+    }
+
+    if (configuration.log_rollout_states) {
+        mppi->m_rollout_states = File::create(
+            configuration.folder / "rollout_states.bin"
+        );
+    }
+
     bool error = (
         (configuration.log_costs && !mppi->m_costs) ||
         (configuration.log_weights && !mppi->m_weights) ||
         (configuration.log_gradient && !mppi->m_gradient) ||
         (configuration.log_optimal_rollout && !mppi->m_optimal_rollout) ||
         (configuration.log_optimal_cost && !mppi->m_optimal_cost) ||
-        (configuration.log_update && !mppi->m_update)
+        (configuration.log_update && !mppi->m_update) ||
+        (configuration.log_deadline && !mppi->m_deadline) ||
+        (configuration.log_rollout_states && !mppi->m_rollout_states)
     );
 
     if (error) {
@@ -77,6 +102,8 @@ std::unique_ptr<MPPI> MPPI::create(const Configuration &configuration)
     }
 
     mppi->m_last_update = std::numeric_limits<double>::min();
+    mppi->m_last_deadline_update = 0;
+    mppi->m_rollout_states_header = false;
 
     return mppi;
 }
@@ -92,10 +119,18 @@ void MPPI::log(const mppi::Trajectory &trajectory)
     std::size_t iteration = trajectory.get_update_count();
 
     if (m_update) {
+        const auto &phases = trajectory.get_update_phases();
         m_update->write(
             iteration,
             time,
-            trajectory.get_update_duration()
+            trajectory.get_update_duration(),
+            phases.sample,
+            phases.rollout,
+            phases.optimise,
+            phases.filter,
+            trajectory.get_rollout_limit(),
+            trajectory.get_effective_sample_size(),
+            trajectory.get_cost_scale()
         );
     }
 
@@ -132,7 +167,67 @@ void MPPI::log(const mppi::Trajectory &trajectory)
         m_optimal_cost->write(iteration, time, trajectory.get_optimal_total_cost());
     }
 
+    if (m_rollout_states && trajectory.get_recorder()) {
+        log(iteration, time, *trajectory.get_recorder());
+    }
+
     m_last_update = time;
 }
 
+void MPPI::log(std::size_t iteration, double time, const mppi::Recorder &recorder)
+{
+    if (!m_rollout_states_header) {
+        std::uint32_t states = recorder.get_state_dof();
+        std::uint32_t steps = recorder.get_step_count();
+
+        m_rollout_states->write(&states, 1);
+        m_rollout_states->write(&steps, 1);
+        m_rollout_states->write(recorder.get_state_indexes().data(), states);
+        m_rollout_states_header = true;
+    }
+
+    const auto &records = recorder.get_records();
+    std::uint64_t update = iteration;
+    std::uint64_t count = records.size();
+    std::size_t size = (std::size_t)recorder.get_state_dof() * recorder.get_step_count();
+
+    m_rollout_states->write(&update, 1);
+    m_rollout_states->write(&time, 1);
+    m_rollout_states->write(&count, 1);
+
+    for (const auto &record : records) {
+        std::int64_t rollout = record.rollout;
+        m_rollout_states->write(&rollout, 1);
+        m_rollout_states->write(&record.cost, 1);
+        m_rollout_states->write(record.states, size);
+    }
+}
+
+void MPPI::log(double time, const mppi::DeadlineMonitor &monitor)
+{
+    const auto &statistics = monitor.get_statistics();
+    if (!m_deadline || statistics.updates == m_last_deadline_update)
+        return;
+
+    m_deadline->write(
+        statistics.updates,
+        time,
+        statistics.duration,
+        monitor.get_deadline(),
+        statistics.overruns,
+        statistics.consecutive_overruns,
+        statistics.worst_duration,
+        statistics.degradations,
+        statistics.fallbacks,
+        monitor.in_fallback(),
+        statistics.skipped,
+        statistics.overrun_phases.sample,
+        statistics.overrun_phases.rollout,
+        statistics.overrun_phases.optimise,
+        statistics.overrun_phases.filter
+    );
+
+    m_last_deadline_update = statistics.updates;
+}
+
 } // namespace logger
@@ -3,12 +3,21 @@
 #include <filesystem>
 
 #include "logging/csv.hpp"
+#include "logging/file.hpp"
 #include "controller/mppi.hpp"
+#include "controller/deadline.hpp"
 
 namespace logger {
 
 /**
  * @brief Logging class for MPPI.
+ * 
+ * The recorded rollout states are logged to rollout_states.bin in native byte
+ * order. The file begins with the uint32 number of recorded states, the
+ * uint32 number of steps and the uint32 index of each recorded state. Each
+ * update is the uint64 update number, the double time and the uint64 number
+ * of records. Each record is the int64 rollout index, the double cost and the
+ * double states, a column of recorded states per step.
  */
 class MPPI
 {
@@ -46,10 +55,17 @@ public:
         /// Log other update information.
         bool log_update = true;
 
+        /// Log the deadline monitor statistics, if monitored.
+        bool log_deadline = true;
+
+        /// Log the recorded rollout states, if recorded.
+        bool log_rollout_states = true;
+
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(
             Configuration,
             folder, state_dof, control_dof, rollouts, log_costs, log_weights,
-            log_gradient, log_optimal_rollout, log_optimal_cost, log_update
+            log_gradient, log_optimal_rollout, log_optimal_cost, log_update,
+            log_deadline, log_rollout_states
         )
     };
 
@@ -67,13 +83,33 @@ public:
      */
     void log(const mppi::Trajectory &trajectory);
 
+    /**
+     * @brief Log the deadline statistics of the last monitored update.
+     *
+     * @param time The time of the last update.
+     * @param monitor The deadline monitor of the trajectory updates.
+     */
+    void log(double time, const mppi::DeadlineMonitor &monitor);
+
 private:
 
     MPPI() = default;
 
+    /**
+     * @brief Log the recorded rollout states of the last update.
+     * 
+     * @param iteration The update number.
+     * @param time The time of the update.
+     * @param recorder The recorder of the rollout states.
+     */
+    void log(std::size_t iteration, double time, const mppi::Recorder &recorder);
+
     /// The last time the trajectory was updated.
     double m_last_update;
 
+    /// The number of monitored updates at the last deadline log.
+    std::size_t m_last_deadline_update;
+
     /// Calculation of the times of each horison step of the generator.
     std::vector<double> m_time;
 
@@ -94,6 +130,15 @@ private:
 
     /// Optional logger for to calculation time of each update.
     std::unique_ptr<CSV> m_update;
+
+    /// Optional logger for the deadline statistics of each update.
+    std::unique_ptr<CSV> m_deadline;
+
+    /// Optional binary logger for the recorded rollout states.
+    std::unique_ptr<File> m_rollout_states;
+
+    /// If the rollout states header has been written.
+    bool m_rollout_states_header;
 };
 
 } // namespace logger
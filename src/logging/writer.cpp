@@ -0,0 +1,713 @@
+#include "logging/writer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace logger {
+
+namespace {
+
+/**
+ * @brief Get the current time in seconds.
+ */
+double now()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Open a file for writing, truncating it if it exists.
+ *
+ * @param path The path of the file.
+ * @returns The file descriptor, or -1 on failure.
+ */
+int open_file(const std::filesystem::path &path)
+{
+#ifdef _WIN32
+    return _wopen(
+        path.c_str(),
+        _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+        _S_IREAD | _S_IWRITE
+    );
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+}
+
+/**
+ * @brief Close a file.
+ * @param descriptor The file descriptor.
+ */
+void close_file(int descriptor)
+{
+#ifdef _WIN32
+    _close(descriptor);
+#else
+    ::close(descriptor);
+#endif
+}
+
+/**
+ * @brief Write bytes at an offset of a file, retrying partial writes.
+ *
+ * @param descriptor The file descriptor.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
+ * @param offset The offset in the file.
+ *
+ * @returns The number of bytes written, or a negative error number.
+ */
+long write_at(int descriptor, const char *data, std::size_t size, std::uint64_t offset)
+{
+#ifdef _WIN32
+    // Without positional writes, seeking and writing must not interleave.
+    static std::mutex mutex;
+    std::scoped_lock lock(mutex);
+
+    if (_lseeki64(descriptor, (__int64)offset, SEEK_SET) < 0)
+        return -errno;
+#endif
+
+    std::size_t written = 0;
+    while (written < size) {
+#ifdef _WIN32
+        int result = _write(descriptor, data + written, (unsigned int)(size - written));
+#else
+        ssize_t result = ::pwrite(descriptor, data + written, size - written, offset + written);
+#endif
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            return -errno;
+        }
+
+        written += result;
+    }
+
+    return (long)written;
+}
+
+/**
+ * @brief Preallocate the extents of a file ahead of a block.
+ *
+ * Preallocation keeps the file size, so the file ends at the last written
+ * block. Stops preallocating if the file system does not support it.
+ *
+ * @param target The file. The mutex of the target must be held.
+ * @param end The end of the block in the file.
+ */
+void preallocate(Writer::Target &target, std::uint64_t end)
+{
+#ifdef __linux__
+    while (end > target.preallocated) {
+        int result = fallocate(
+            target.descriptor,
+            FALLOC_FL_KEEP_SIZE,
+            (off_t)target.preallocated,
+            (off_t)Writer::PREALLOCATION
+        );
+
+        if (result != 0) {
+            target.preallocated = UINT64_MAX;
+            return;
+        }
+
+        target.preallocated += Writer::PREALLOCATION;
+    }
+#else
+    (void)target;
+    (void)end;
+#endif
+}
+
+} // namespace
+
+#ifdef __linux__
+
+/**
+ * @brief A minimal io_uring submitting writes and reaping their completions.
+ *
+ * Submission must be serialised by the caller. Completions must be reaped by
+ * a single thread.
+ */
+class Writer::Ring
+{
+public:
+
+    /// The user data of the request stopping the reaper.
+    static constexpr std::uint64_t STOP = UINT64_MAX;
+
+    /**
+     * @brief Create an io_uring.
+     *
+     * @param entries The number of submission queue entries.
+     * @returns A pointer to the ring, or nullptr if io_uring is unavailable.
+     */
+    static std::unique_ptr<Ring> create(unsigned int entries)
+    {
+        io_uring_params parameters {};
+        int descriptor = (int)syscall(__NR_io_uring_setup, entries, &parameters);
+        if (descriptor < 0)
+            return nullptr;
+
+        auto ring = std::unique_ptr<Ring>(new Ring(descriptor, parameters));
+        if (!ring->m_submission_ring || !ring->m_completion_ring || !ring->m_entries)
+            return nullptr;
+
+        return ring;
+    }
+
+    ~Ring()
+    {
+        if (m_entries)
+            munmap(m_entries, m_entries_size);
+        if (m_completion_ring && m_completion_ring != m_submission_ring)
+            munmap(m_completion_ring, m_completion_ring_size);
+        if (m_submission_ring)
+            munmap(m_submission_ring, m_submission_ring_size);
+        ::close(m_descriptor);
+    }
+
+    /**
+     * @brief Submit a write.
+     *
+     * @param descriptor The file descriptor.
+     * @param data The bytes to write.
+     * @param size The number of bytes to write.
+     * @param offset The offset in the file.
+     * @param user_data The user data of the completion.
+     *
+     * @returns If the write was submitted.
+     */
+    bool write(
+        int descriptor,
+        const char *data,
+        std::size_t size,
+        std::uint64_t offset,
+        std::uint64_t user_data
+    ) {
+        return submit(IORING_OP_WRITE, descriptor, data, size, offset, user_data);
+    }
+
+    /**
+     * @brief Submit a request that stops the reaper once completed.
+     * @returns If the request was submitted.
+     */
+    bool stop()
+    {
+        return submit(IORING_OP_NOP, -1, nullptr, 0, 0, STOP);
+    }
+
+    /**
+     * @brief Wait for at least one completion and handle every completion.
+     *
+     * @param handle Called with the user data and result of each completion.
+     */
+    template<typename Handle>
+    void wait(Handle &&handle)
+    {
+        while (true) {
+            long result = syscall(
+                __NR_io_uring_enter, m_descriptor, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0
+            );
+            if (result >= 0 || errno != EINTR)
+                break;
+        }
+
+        std::atomic_ref<unsigned int> tail(*m_completion_tail);
+        std::atomic_ref<unsigned int> head_reference(*m_completion_head);
+
+        unsigned int head = head_reference.load(std::memory_order_relaxed);
+        unsigned int end = tail.load(std::memory_order_acquire);
+
+        for (; head != end; ++head) {
+            const io_uring_cqe &completion = m_completions[head & *m_completion_mask];
+            handle(completion.user_data, completion.res);
+        }
+
+        head_reference.store(head, std::memory_order_release);
+    }
+
+private:
+
+    Ring(int descriptor, const io_uring_params &parameters)
+        : m_descriptor(descriptor)
+    {
+        m_submission_ring_size = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned int);
+        m_completion_ring_size = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+
+        bool single = parameters.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            m_submission_ring_size = std::max(m_submission_ring_size, m_completion_ring_size);
+            m_completion_ring_size = m_submission_ring_size;
+        }
+
+        m_submission_ring = map(m_submission_ring_size, IORING_OFF_SQ_RING);
+        if (!m_submission_ring)
+            return;
+
+        m_completion_ring = single
+            ? m_submission_ring
+            : map(m_completion_ring_size, IORING_OFF_CQ_RING);
+        if (!m_completion_ring)
+            return;
+
+        m_entries_size = parameters.sq_entries * sizeof(io_uring_sqe);
+        m_entries = (io_uring_sqe *)map(m_entries_size, IORING_OFF_SQES);
+        if (!m_entries)
+            return;
+
+        char *submission = (char *)m_submission_ring;
+        m_submission_head = (unsigned int *)(submission + parameters.sq_off.head);
+        m_submission_tail = (unsigned int *)(submission + parameters.sq_off.tail);
+        m_submission_mask = (unsigned int *)(submission + parameters.sq_off.ring_mask);
+        m_submission_array = (unsigned int *)(submission + parameters.sq_off.array);
+        m_submission_entries = parameters.sq_entries;
+
+        char *completion = (char *)m_completion_ring;
+        m_completion_head = (unsigned int *)(completion + parameters.cq_off.head);
+        m_completion_tail = (unsigned int *)(completion + parameters.cq_off.tail);
+        m_completion_mask = (unsigned int *)(completion + parameters.cq_off.ring_mask);
+        m_completions = (io_uring_cqe *)(completion + parameters.cq_off.cqes);
+    }
+
+    /**
+     * @brief Map a region of the ring.
+     * @returns The mapped region, or nullptr on failure.
+     */
+    void *map(std::size_t size, off_t offset)
+    {
+        void *region = mmap(
+            nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            m_descriptor, offset
+        );
+        return region == MAP_FAILED ? nullptr : region;
+    }
+
+    bool submit(
+        int opcode,
+        int descriptor,
+        const char *data,
+        std::size_t size,
+        std::uint64_t offset,
+        std::uint64_t user_data
+    ) {
+        std::atomic_ref<unsigned int> head(*m_submission_head);
+        std::atomic_ref<unsigned int> tail_reference(*m_submission_tail);
+
+        unsigned int tail = tail_reference.load(std::memory_order_relaxed);
+        if (tail - head.load(std::memory_order_acquire) >= m_submission_entries)
+            return false;
+
+        unsigned int index = tail & *m_submission_mask;
+        io_uring_sqe &entry = m_entries[index];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode = (std::uint8_t)opcode;
+        entry.fd = descriptor;
+        entry.addr = (std::uint64_t)data;
+        entry.len = (std::uint32_t)size;
+        entry.off = offset;
+        entry.user_data = user_data;
+
+        m_submission_array[index] = index;
+        tail_reference.store(tail + 1, std::memory_order_release);
+
+        while (true) {
+            long result = syscall(__NR_io_uring_enter, m_descriptor, 1, 0, 0, nullptr, 0);
+            if (result >= 0)
+                return true;
+            if (errno != EINTR)
+                return false;
+        }
+    }
+
+    /// The io_uring file descriptor.
+    int m_descriptor;
+
+    /// The mapped submission ring.
+    void *m_submission_ring = nullptr;
+    std::size_t m_submission_ring_size = 0;
+
+    /// The mapped completion ring. The submission ring if mapped once.
+    void *m_completion_ring = nullptr;
+    std::size_t m_completion_ring_size = 0;
+
+    /// The mapped submission queue entries.
+    io_uring_sqe *m_entries = nullptr;
+    std::size_t m_entries_size = 0;
+
+    unsigned int *m_submission_head = nullptr;
+    unsigned int *m_submission_tail = nullptr;
+    unsigned int *m_submission_mask = nullptr;
+    unsigned int *m_submission_array = nullptr;
+    unsigned int m_submission_entries = 0;
+
+    unsigned int *m_completion_head = nullptr;
+    unsigned int *m_completion_tail = nullptr;
+    unsigned int *m_completion_mask = nullptr;
+    io_uring_cqe *m_completions = nullptr;
+};
+
+#else
+
+/**
+ * @brief io_uring is unavailable on other platforms.
+ */
+class Writer::Ring
+{
+public:
+
+    static std::unique_ptr<Ring> create(unsigned int)
+    {
+        return nullptr;
+    }
+
+    bool write(int, const char *, std::size_t, std::uint64_t, std::uint64_t)
+    {
+        return false;
+    }
+
+    bool stop()
+    {
+        return false;
+    }
+
+    template<typename Handle>
+    void wait(Handle &&) {}
+};
+
+#endif
+
+Writer &Writer::get()
+{
+    static std::unique_ptr<Writer> writer = create(Backend::URING);
+    return *writer;
+}
+
+std::unique_ptr<Writer> Writer::create(Backend backend)
+{
+    std::unique_ptr<Ring> ring;
+
+    // Room for every request in flight and the request stopping the reaper.
+    if (backend == Backend::URING) {
+        ring = Ring::create(2 * MAXIMUM_IN_FLIGHT);
+        if (!ring)
+            backend = Backend::THREADS;
+    }
+
+    return std::unique_ptr<Writer>(new Writer(backend, std::move(ring)));
+}
+
+Writer::Writer(Backend backend, std::unique_ptr<Ring> ring)
+    : m_backend(backend)
+    , m_ring(std::move(ring))
+    , m_requests(MAXIMUM_IN_FLIGHT)
+    , m_free_requests(MAXIMUM_IN_FLIGHT)
+    , m_statistics()
+    , m_stop(false)
+{
+    std::iota(m_free_requests.rbegin(), m_free_requests.rend(), 0);
+
+    if (m_backend == Backend::URING) {
+        m_threads.emplace_back([this]() { reap(); });
+    }
+    else {
+        for (unsigned int i = 0; i < THREADS; ++i)
+            m_threads.emplace_back([this]() { work(); });
+    }
+}
+
+Writer::~Writer()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_completed.wait(lock, [&]() {
+            return m_free_requests.size() == m_requests.size();
+        });
+
+        m_stop = true;
+
+        if (m_ring)
+            m_ring->stop();
+    }
+
+    m_queued.notify_all();
+
+    for (auto &thread : m_threads)
+        thread.join();
+
+    for (char *block : m_blocks)
+        std::free(block);
+}
+
+std::shared_ptr<Writer::Target> Writer::open(const std::filesystem::path &path)
+{
+    int descriptor = open_file(path);
+    if (descriptor < 0) {
+        std::cerr << "failed to open log file " << path << ". "
+                  << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    auto target = std::make_shared<Target>();
+    target->path = path;
+    target->descriptor = descriptor;
+    return target;
+}
+
+char *Writer::acquire()
+{
+    std::scoped_lock lock(m_mutex);
+
+    if (!m_free_blocks.empty()) {
+        char *block = m_free_blocks.back();
+        m_free_blocks.pop_back();
+        return block;
+    }
+
+    char *block = (char *)std::aligned_alloc(BLOCK_ALIGNMENT, BLOCK_CAPACITY);
+    if (!block)
+        throw std::bad_alloc();
+
+    m_blocks.push_back(block);
+    return block;
+}
+
+void Writer::release(char *block)
+{
+    std::scoped_lock lock(m_mutex);
+    m_free_blocks.push_back(block);
+}
+
+void Writer::submit(
+    const std::shared_ptr<Target> &target,
+    char *block,
+    std::size_t size,
+    std::uint64_t offset
+) {
+    double submitted = now();
+
+    {
+        std::scoped_lock lock(target->mutex);
+        ++target->pending;
+        preallocate(*target, offset + size);
+    }
+
+    std::unique_lock lock(m_mutex);
+
+    // Back pressure when the disk does not keep up.
+    m_completed.wait(lock, [&]() { return !m_free_requests.empty(); });
+
+    std::size_t index = m_free_requests.back();
+    m_free_requests.pop_back();
+    m_requests[index] = Request {
+        .target = target,
+        .block = block,
+        .size = size,
+        .offset = offset,
+        .submitted = submitted
+    };
+
+    if (m_backend == Backend::THREADS) {
+        m_queue.push_back(index);
+        m_queued.notify_one();
+        return;
+    }
+
+    if (m_ring->write(target->descriptor, block, size, offset, index))
+        return;
+
+    // Write synchronously if the ring rejected the write.
+    lock.unlock();
+    complete(index, write_at(target->descriptor, block, size, offset));
+}
+
+void Writer::close(const std::shared_ptr<Target> &target)
+{
+    std::scoped_lock lock(target->mutex);
+
+    target->closing = true;
+    if (target->pending == 0 && target->descriptor >= 0) {
+        close_file(target->descriptor);
+        target->descriptor = -1;
+    }
+}
+
+void Writer::wait(const std::shared_ptr<Target> &target)
+{
+    std::unique_lock lock(target->mutex);
+    target->written.wait(lock, [&]() { return target->pending == 0; });
+}
+
+Writer::Statistics Writer::get_statistics()
+{
+    std::scoped_lock lock(m_mutex);
+    return m_statistics;
+}
+
+void Writer::reap()
+{
+    bool stopped = false;
+
+    while (!stopped) {
+        m_ring->wait([&](std::uint64_t user_data, int result) {
+            if (user_data == Ring::STOP) {
+                stopped = true;
+                return;
+            }
+
+            // The kernel orders the request before its completion, but the
+            // request is read under the lock to be ordered for the compiler.
+            Request request;
+            {
+                std::scoped_lock lock(m_mutex);
+                request = m_requests[user_data];
+            }
+
+            long written = result;
+
+            // Kernels before linux 5.6 do not support the write operation.
+            // Write the block synchronously, and stop submitting to the ring.
+            if (written == -EINVAL || written == -EOPNOTSUPP) {
+                fall_back();
+                written = write_at(
+                    request.target->descriptor,
+                    request.block,
+                    request.size,
+                    request.offset
+                );
+            }
+
+            // Complete short writes synchronously.
+            if (written >= 0 && (std::size_t)written < request.size) {
+                long remaining = write_at(
+                    request.target->descriptor,
+                    request.block + written,
+                    request.size - written,
+                    request.offset + written
+                );
+                written = remaining < 0 ? remaining : written + remaining;
+            }
+
+            complete(user_data, written);
+        });
+    }
+}
+
+void Writer::fall_back()
+{
+    std::scoped_lock lock(m_mutex);
+
+    if (m_backend == Backend::THREADS)
+        return;
+
+    std::cerr << "io_uring writes are unsupported, falling back to positional writes" << std::endl;
+
+    // The destructor only joins the threads once every request is complete,
+    // which is after the request that caused the fall back.
+    m_backend = Backend::THREADS;
+    for (unsigned int i = 0; i < THREADS; ++i)
+        m_threads.emplace_back([this]() { work(); });
+}
+
+void Writer::work()
+{
+    while (true) {
+        std::size_t index;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_queued.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+
+            if (m_queue.empty())
+                return;
+
+            index = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        const Request &request = m_requests[index];
+        complete(
+            index,
+            write_at(request.target->descriptor, request.block, request.size, request.offset)
+        );
+    }
+}
+
+void Writer::complete(std::size_t index, long written)
+{
+    Request request;
+    {
+        std::scoped_lock lock(m_mutex);
+        request = std::move(m_requests[index]);
+    }
+
+    const std::shared_ptr<Target> &target = request.target;
+
+    double latency = now() - request.submitted;
+    bool failed = written < 0 || (std::size_t)written != request.size;
+
+    auto account = [&](Statistics &statistics) {
+        if (failed) {
+            ++statistics.errors;
+            return;
+        }
+
+        ++statistics.writes;
+        statistics.bytes += request.size;
+        statistics.latency += latency;
+        statistics.worst_latency = std::max(statistics.worst_latency, latency);
+    };
+
+    {
+        std::scoped_lock lock(target->mutex);
+
+        if (failed && target->statistics.errors == 0) {
+            std::cerr << "failed to write log file " << target->path << ". "
+                      << std::strerror(written < 0 ? (int)-written : EIO) << std::endl;
+        }
+
+        account(target->statistics);
+
+        --target->pending;
+        if (target->pending == 0 && target->closing && target->descriptor >= 0) {
+            close_file(target->descriptor);
+            target->descriptor = -1;
+        }
+    }
+
+    target->written.notify_all();
+
+    {
+        std::scoped_lock lock(m_mutex);
+        account(m_statistics);
+        m_free_blocks.push_back(request.block);
+        m_free_requests.push_back(index);
+    }
+
+    m_completed.notify_all();
+}
+
+} // namespace logger
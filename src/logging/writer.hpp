@@ -0,0 +1,300 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logger {
+
+/**
+ * @brief Writes blocks of log files asynchronously on background threads.
+ *
+ * A single writer is shared by every log file of the process. Files fill
+ * aligned blocks of memory and submit each with the offset to write it at.
+ * On linux blocks are written with io_uring, so many writes are in flight at
+ * once without a thread per write. Otherwise, or if io_uring is unavailable,
+ * blocks are written with positional writes on a pool of threads. If the
+ * kernel rejects io_uring writes, as before linux 5.6, the rejected blocks are
+ * written synchronously and the writer switches to the pool of threads.
+ *
+ * File extents are preallocated ahead of the written blocks, so the file
+ * system does not allocate on every write. Closing a file returns
+ * immediately, and the file is closed once its outstanding blocks are
+ * written. The writer waits for every outstanding block on destruction.
+ */
+class Writer
+{
+public:
+
+    /**
+     * @brief The method blocks are written with.
+     */
+    enum class Backend {
+
+        /// Blocks are submitted to an io_uring and completions are reaped on
+        /// a background thread. Linux only.
+        URING,
+
+        /// Blocks are written with positional writes on a pool of threads.
+        THREADS
+    };
+
+    /// The size of each block.
+    static constexpr std::size_t BLOCK_CAPACITY = 256 * 1024;
+
+    /// The alignment of each block.
+    static constexpr std::size_t BLOCK_ALIGNMENT = 4096;
+
+    /// The number of blocks being written at once, before submitting a block
+    /// waits for another to complete.
+    static constexpr std::size_t MAXIMUM_IN_FLIGHT = 32;
+
+    /// The size of each extent preallocated ahead of the written blocks.
+    static constexpr std::uint64_t PREALLOCATION = 16 * BLOCK_CAPACITY;
+
+    /// The number of threads of the positional write backend.
+    static constexpr unsigned int THREADS = 2;
+
+    /**
+     * @brief Statistics of the written blocks.
+     */
+    struct Statistics {
+
+        /// The number of blocks written.
+        std::size_t writes = 0;
+
+        /// The number of bytes written.
+        std::size_t bytes = 0;
+
+        /// The number of blocks that failed to write.
+        std::size_t errors = 0;
+
+        /// The cumulative time from submitting each block to it being
+        /// written, in seconds.
+        double latency = 0.0;
+
+        /// The longest time from submitting a block to it being written, in
+        /// seconds.
+        double worst_latency = 0.0;
+
+        /**
+         * @brief Get the mean time from submitting a block to it being
+         * written, in seconds.
+         */
+        inline double get_mean_latency() const {
+            return writes > 0 ? latency / (double)writes : 0.0;
+        }
+    };
+
+    /**
+     * @brief An open file being written to.
+     */
+    struct Target {
+
+        /// The path of the file.
+        std::filesystem::path path;
+
+        /// The file descriptor.
+        int descriptor = -1;
+
+        /// Mutex protecting the target.
+        std::mutex mutex;
+
+        /// Notified when a block of the target is written.
+        std::condition_variable written;
+
+        /// The number of blocks submitted and not yet written.
+        std::size_t pending = 0;
+
+        /// If the file is closed once its pending blocks are written.
+        bool closing = false;
+
+        /// The end of the preallocated extents.
+        std::uint64_t preallocated = 0;
+
+        /// The statistics of the blocks written to the file.
+        Statistics statistics;
+    };
+
+    /**
+     * @brief Get the writer shared by every file of the process, using
+     * io_uring if available.
+     */
+    static Writer &get();
+
+    /**
+     * @brief Create a writer.
+     *
+     * @param backend The preferred backend. Falls back to positional writes
+     * if io_uring is unavailable.
+     * @returns A pointer to the writer.
+     */
+    static std::unique_ptr<Writer> create(Backend backend);
+
+    /**
+     * @brief Waits for every outstanding block to be written.
+     */
+    ~Writer();
+
+    /**
+     * @brief Open a file for writing, truncating it if it exists.
+     *
+     * @param path The path of the file.
+     * @returns A pointer to the target on success or nullptr on failure.
+     */
+    std::shared_ptr<Target> open(const std::filesystem::path &path);
+
+    /**
+     * @brief Get an empty block of BLOCK_CAPACITY bytes aligned to
+     * BLOCK_ALIGNMENT.
+     */
+    char *acquire();
+
+    /**
+     * @brief Return a block that was not submitted.
+     * @param block The block.
+     */
+    void release(char *block);
+
+    /**
+     * @brief Submit a block to be written.
+     *
+     * Returns once the block is submitted. Waits if the maximum number of
+     * blocks are in flight. The block is released once written.
+     *
+     * @param target The file to write to.
+     * @param block The block acquired from the writer.
+     * @param size The number of bytes of the block to write.
+     * @param offset The offset in the file to write the block at.
+     */
+    void submit(
+        const std::shared_ptr<Target> &target,
+        char *block,
+        std::size_t size,
+        std::uint64_t offset
+    );
+
+    /**
+     * @brief Close a file once its submitted blocks are written.
+     * @param target The file to close.
+     */
+    void close(const std::shared_ptr<Target> &target);
+
+    /**
+     * @brief Wait for the submitted blocks of a file to be written.
+     * @param target The file to wait for.
+     */
+    void wait(const std::shared_ptr<Target> &target);
+
+    /**
+     * @brief Get the backend blocks are written with.
+     */
+    inline Backend get_backend() const {
+        return m_backend.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the statistics of every block written.
+     */
+    Statistics get_statistics();
+
+private:
+
+    class Ring;
+
+    /**
+     * @brief A block being written.
+     */
+    struct Request {
+
+        /// The file written to.
+        std::shared_ptr<Target> target;
+
+        /// The block.
+        char *block = nullptr;
+
+        /// The number of bytes to write.
+        std::size_t size = 0;
+
+        /// The offset in the file.
+        std::uint64_t offset = 0;
+
+        /// The time the block was submitted, in seconds.
+        double submitted = 0.0;
+    };
+
+    Writer(Backend backend, std::unique_ptr<Ring> ring);
+
+    /**
+     * @brief Reap io_uring completions until stopped.
+     */
+    void reap();
+
+    /**
+     * @brief Switch to positional writes on a pool of threads, after the
+     * kernel rejected an io_uring write. The reaper keeps reaping the writes
+     * already submitted to the ring.
+     */
+    void fall_back();
+
+    /**
+     * @brief Perform positional writes until stopped.
+     */
+    void work();
+
+    /**
+     * @brief Finish writing a request.
+     *
+     * @param index The index of the request.
+     * @param written The bytes written, or a negative error number.
+     */
+    void complete(std::size_t index, long written);
+
+    /// The backend blocks are written with. Switches from io_uring to
+    /// positional writes if the kernel rejects io_uring writes.
+    std::atomic<Backend> m_backend;
+
+    /// The io_uring of the io_uring backend, otherwise nullptr.
+    std::unique_ptr<Ring> m_ring;
+
+    /// Mutex protecting the writer state.
+    std::mutex m_mutex;
+
+    /// Notified when a request completes.
+    std::condition_variable m_completed;
+
+    /// Notified when a request is queued for the positional write threads.
+    std::condition_variable m_queued;
+
+    /// The requests, by index.
+    std::vector<Request> m_requests;
+
+    /// The indexes of the unused requests.
+    std::vector<std::size_t> m_free_requests;
+
+    /// The indexes of the requests queued for the positional write threads.
+    std::deque<std::size_t> m_queue;
+
+    /// The empty blocks.
+    std::vector<char *> m_free_blocks;
+
+    /// Every allocated block.
+    std::vector<char *> m_blocks;
+
+    /// The statistics of every block written.
+    Statistics m_statistics;
+
+    /// If the background threads should stop.
+    bool m_stop;
+
+    /// The background threads.
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace logger
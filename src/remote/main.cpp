@@ -0,0 +1,327 @@
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "controller/mppi.hpp"
+#include "distributed/worker.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+#include "frankaridgeback/objective/assisted_manipulation.hpp"
+#include "frankaridgeback/objective/track_point.hpp"
+#include "frankaridgeback/objective/track_trajectory.hpp"
+#include "ipc/channel.hpp"
+
+/**
+ * @brief Configuration of the remote controller process.
+ */
+struct Configuration {
+
+    /**
+     * @brief Configuration of the objective function.
+     */
+    struct Objective {
+
+        enum Type {
+            ASSISTED_MANIPULATION,
+            TRACK_POINT,
+            TRACK_TRAJECTORY
+        };
+
+        /// The selected objective.
+        Type type;
+
+        /// Configuration for the assisted manipulation objective.
+        std::optional<FrankaRidgeback::AssistedManipulation::Configuration> assisted_manipulation;
+
+        /// Configuration for the reach objective.
+        std::optional<FrankaRidgeback::TrackPoint::Configuration> track_point;
+
+        /// Configuration for the track trajectory objective.
+        std::optional<FrankaRidgeback::TrackTrajectory::Configuration> track_trajectory;
+
+        // JSON conversion for remote controller objective.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Objective,
+            type, assisted_manipulation, track_point, track_trajectory
+        )
+    };
+
+    /// The name of the shared memory channel created by the actor.
+    std::string channel;
+
+    /// Configuration of the trajectory generator.
+    mppi::Configuration mppi;
+
+    /// Configuration of the rollout dynamics.
+    FrankaRidgeback::PinocchioDynamics::Configuration dynamics;
+
+    /// If provided, the end effector wrench measured in each published state
+    /// is forecast over the rollout horison, rolled out with the pinocchio
+    /// dynamics. Required by the assisted manipulation trajectory cost.
+    std::optional<FrankaRidgeback::DynamicsForecast::Configuration> forecast;
+
+    /// The objective configuration.
+    Objective objective;
+
+    // JSON conversion for remote controller configuration.
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+        Configuration,
+        channel, mppi, dynamics, forecast, objective
+    )
+};
+
+/// Set by the signal handler to stop the control loop.
+static std::atomic<bool> s_stop = false;
+
+/**
+ * @brief Create the objective function of the configuration.
+ *
+ * @param objective The objective configuration.
+ * @returns A pointer to the objective on success or nullptr on failure.
+ */
+std::unique_ptr<mppi::Cost> create_objective(const Configuration::Objective &objective)
+{
+    using namespace FrankaRidgeback;
+
+    switch (objective.type)
+    {
+        case Configuration::Objective::Type::ASSISTED_MANIPULATION: {
+            if (!objective.assisted_manipulation) {
+                std::cerr << "assisted manipulation objective selected with no configuration" << std::endl;
+                return nullptr;
+            }
+            return AssistedManipulation::create(*objective.assisted_manipulation);
+        }
+        case Configuration::Objective::Type::TRACK_POINT: {
+            if (!objective.track_point) {
+                std::cerr << "track point objective selected with no configuration" << std::endl;
+                return nullptr;
+            }
+            return TrackPoint::create(*objective.track_point);
+        }
+        case Configuration::Objective::Type::TRACK_TRAJECTORY: {
+            if (!objective.track_trajectory) {
+                std::cerr << "track trajectory objective selected with no configuration" << std::endl;
+                return nullptr;
+            }
+            return TrackTrajectory::create(*objective.track_trajectory);
+        }
+        default: {
+            std::cerr << "unknown objective type " << objective.type << " provided" << std::endl;
+            return nullptr;
+        }
+    }
+}
+
+/**
+ * @brief If the objective depends on a forecast of the end effector wrench.
+ *
+ * Without a forecast the assisted manipulation trajectory cost is silently
+ * zero, so such configurations are rejected.
+ *
+ * @param objective The objective configuration.
+ */
+bool requires_forecast(const Configuration::Objective &objective)
+{
+    return (
+        objective.type == Configuration::Objective::Type::ASSISTED_MANIPULATION &&
+        objective.assisted_manipulation &&
+        objective.assisted_manipulation->enable_trajectory_cost
+    );
+}
+
+/**
+ * @brief Serve the rollouts of distributed trajectories, one coordinator at a
+ * time, until terminated.
+ *
+ * @param configuration The controller configuration, shared with the
+ * coordinator.
+ * @param address The address to listen on.
+ *
+ * @returns The process exit code.
+ */
+int run_worker(const Configuration &configuration, const std::string &address)
+{
+    // The coordinator does not send the forecast to workers.
+    if (requires_forecast(configuration.objective)) {
+        std::cerr << "distributed workers do not support the assisted manipulation trajectory cost" << std::endl;
+        return 1;
+    }
+
+    auto dynamics = FrankaRidgeback::PinocchioDynamics::create(configuration.dynamics);
+    if (!dynamics) {
+        std::cerr << "failed to create worker dynamics" << std::endl;
+        return 1;
+    }
+
+    auto objective = create_objective(configuration.objective);
+    if (!objective) {
+        std::cerr << "failed to create worker objective" << std::endl;
+        return 1;
+    }
+
+    auto worker = distributed::Worker::create(
+        configuration.mppi,
+        std::move(dynamics),
+        std::move(objective)
+    );
+
+    if (!worker) {
+        std::cerr << "failed to create worker" << std::endl;
+        return 1;
+    }
+
+    auto listener = distributed::Socket::listen(address);
+    if (!listener) {
+        std::cerr << "failed to listen for coordinators" << std::endl;
+        return 1;
+    }
+
+    // A failed session only ends that connection.
+    while (true) {
+        auto connection = listener->accept();
+        if (!connection)
+            return 1;
+
+        worker->serve(*connection);
+    }
+}
+
+/**
+ * @brief Runs the trajectory generator of an actor in remote mode.
+ *
+ * Waits for each state published by the actor, updates the trajectory and
+ * publishes it back. Exits when the actor closes the channel, or on SIGINT or
+ * SIGTERM. May be restarted while the actor is running.
+ *
+ * With `--worker <address>`, instead serves the rollouts of a distributed
+ * trajectory on a unix socket path or IPv4 host:port.
+ */
+int main(int argc, char **argv)
+{
+    bool valid = (
+        (argc == 3 || (argc == 5 && std::string(argv[3]) == "--worker")) &&
+        std::string(argv[1]) == "--config"
+    );
+
+    if (!valid) {
+        std::cerr << "usage: " << argv[0] << " --config <path> [--worker <address>]" << std::endl;
+        return 1;
+    }
+
+    Configuration configuration;
+    try {
+        std::ifstream file {argv[2]};
+        configuration = json::parse(file).get<Configuration>();
+    }
+    catch (const json::exception &err) {
+        std::cerr << "failed to parse configuration " << argv[2] << ": "
+                  << err.what() << std::endl;
+        return 1;
+    }
+
+    if (argc == 5)
+        return run_worker(configuration, argv[4]);
+
+    if (requires_forecast(configuration.objective) && !configuration.forecast) {
+        std::cerr << "assisted manipulation trajectory cost requires a forecast configuration" << std::endl;
+        return 1;
+    }
+
+    // The rollouts read the forecast of the measured wrench through the
+    // handle given to their dynamics.
+    std::unique_ptr<FrankaRidgeback::DynamicsForecast> forecast = nullptr;
+    std::unique_ptr<FrankaRidgeback::DynamicsForecast::Handle> forecast_handle = nullptr;
+
+    if (configuration.forecast) {
+        auto forecast_dynamics = FrankaRidgeback::PinocchioDynamics::create(configuration.dynamics);
+        if (!forecast_dynamics) {
+            std::cerr << "failed to create controller forecast dynamics" << std::endl;
+            return 1;
+        }
+
+        forecast = FrankaRidgeback::DynamicsForecast::create(
+            *configuration.forecast,
+            std::move(forecast_dynamics)
+        );
+
+        if (!forecast) {
+            std::cerr << "failed to create controller forecast" << std::endl;
+            return 1;
+        }
+
+        forecast_handle = forecast->create_handle();
+    }
+
+    auto dynamics = FrankaRidgeback::PinocchioDynamics::create(
+        configuration.dynamics,
+        std::move(forecast_handle)
+    );
+
+    if (!dynamics) {
+        std::cerr << "failed to create controller dynamics" << std::endl;
+        return 1;
+    }
+
+    auto objective = create_objective(configuration.objective);
+    if (!objective) {
+        std::cerr << "failed to create controller objective" << std::endl;
+        return 1;
+    }
+
+    auto trajectory = mppi::Trajectory::create(
+        configuration.mppi,
+        std::move(dynamics),
+        std::move(objective)
+    );
+
+    if (!trajectory) {
+        std::cerr << "failed to create controller trajectory" << std::endl;
+        return 1;
+    }
+
+    auto channel = ipc::Channel::open(configuration.channel);
+    if (!channel) {
+        std::cerr << "failed to open controller channel" << std::endl;
+        return 1;
+    }
+
+    if (channel->get_state_dof() != trajectory->get_state_dof() ||
+        channel->get_control_dof() != trajectory->get_control_dof()) {
+        std::cerr << "channel dimensions do not match the controller" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, [](int) { s_stop = true; });
+    std::signal(SIGTERM, [](int) { s_stop = true; });
+
+    Eigen::VectorXd state(channel->get_state_dof());
+    double time = 0.0;
+    std::uint32_t sequence = 0;
+
+    // Wake periodically to observe signals.
+    while (!s_stop && !channel->is_closed()) {
+        if (!channel->wait_state(sequence, 0.1))
+            continue;
+
+        sequence = channel->read_state(state, time);
+
+        if (forecast) {
+            Vector6d wrench = FrankaRidgeback::State(state).end_effector_wrench();
+            forecast->observe_wrench(wrench, time);
+            forecast->forecast(state, time);
+        }
+
+        trajectory->update(state, time);
+
+        channel->write_trajectory(
+            trajectory->trajectory(),
+            trajectory->get_update_last(),
+            trajectory->get_time_step()
+        );
+    }
+
+    return 0;
+}
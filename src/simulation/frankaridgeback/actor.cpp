@@ -1,5 +1,7 @@
 #include "simulation/frankaridgeback/actor.hpp"
 
+#include <chrono>
+
 namespace FrankaRidgeback {
 
 std::shared_ptr<Actor> Actor::create(
@@ -17,6 +19,44 @@ std::shared_ptr<Actor> Actor::create(
         return nullptr;
     }
 
+    // The trajectory is generated by another process, so there is nothing
+    // else to create.
+    if (configuration.remote) {
+        if (!(configuration.remote->timeout >= 0.0)) {
+            std::cerr << "actor remote timeout must not be negative" << std::endl;
+            return nullptr;
+        }
+
+        auto channel = ipc::Channel::create(ipc::Channel::Configuration {
+            .name = configuration.remote->channel,
+            .state_dof = DoF::STATE,
+            .control_dof = DoF::CONTROL,
+            .steps = configuration.remote->steps
+        });
+
+        if (!channel) {
+            std::cerr << "failed to create actor remote channel" << std::endl;
+            return nullptr;
+        }
+
+        std::int64_t controller_countdown_max = (std::int64_t)(
+            configuration.controller_rate / simulator->get_time_step()
+        );
+
+        return std::shared_ptr<Actor>(
+            new Actor(
+                std::move(configuration),
+                std::move(dynamics),
+                nullptr,
+                nullptr,
+                nullptr,
+                std::move(channel),
+                controller_countdown_max,
+                0
+            )
+        );
+    }
+
     std::unique_ptr<mppi::Cost> objective;
 
     switch (configuration.objective.type)
@@ -41,6 +81,15 @@ std::shared_ptr<Actor> Actor::create(
             objective = TrackPoint::create(*configuration.objective.track_point);
             break;
         }
+        case Configuration::Objective::Type::TRACK_TRAJECTORY: {
+            if (!configuration.objective.track_trajectory) {
+                std::cerr << "track trajectory objective selected with no configuration" << std::endl;
+                return nullptr;
+            }
+
+            objective = TrackTrajectory::create(*configuration.objective.track_trajectory);
+            break;
+        }
         default: {
             std::cerr << "unknown objective type " << configuration.objective.type << " provided" << std::endl;
             return nullptr;
@@ -121,12 +170,37 @@ std::shared_ptr<Actor> Actor::create(
         return nullptr;
     }
 
+    // Monitor controller updates against the controller rate.
+    std::unique_ptr<mppi::DeadlineMonitor> deadline = nullptr;
+    if (configuration.deadline) {
+        deadline = mppi::DeadlineMonitor::create(
+            configuration.deadline->monitor,
+            configuration.controller_rate,
+            configuration.mppi.configuration.rollouts
+        );
+        if (!deadline) {
+            std::cerr << "failed to create actor deadline monitor" << std::endl;
+            return nullptr;
+        }
+
+        // The hold controller is recreated on each fallback, but validated
+        // here.
+        if (configuration.deadline->hold.n != DoF::CONTROL ||
+            !PID::create(configuration.deadline->hold)) {
+            std::cerr << "actor hold controller must have dimension "
+                      << DoF::CONTROL << std::endl;
+            return nullptr;
+        }
+    }
+
     return std::shared_ptr<Actor>(
         new Actor(
             std::move(configuration),
             std::move(dynamics),
             std::move(controller),
             std::move(forecast),
+            std::move(deadline),
+            nullptr,
             controller_countdown_max,
             forecast_countdown_max
         )
@@ -138,22 +212,29 @@ Actor::Actor(
     std::unique_ptr<ActorDynamics> &&dynamics,
     std::unique_ptr<mppi::Trajectory> &&controller,
     std::unique_ptr<DynamicsForecast> &&forecast,
+    std::unique_ptr<mppi::DeadlineMonitor> &&deadline,
+    std::unique_ptr<ipc::Channel> &&channel,
     std::int64_t controller_countdown_max,
     std::int64_t forecast_countdown_max
 ) : m_configuration(std::move(configuration))
   , m_dynamics(std::move(dynamics))
   , m_forecast(std::move(forecast))
   , m_controller(std::move(controller))
+  , m_deadline(std::move(deadline))
+  , m_hold(nullptr)
+  , m_channel(std::move(channel))
   , m_trajectory_countdown(0) // Update on first step.
   , m_trajectory_countdown_max(controller_countdown_max)
   , m_forecast_countdown(0)
   , m_forecast_countdown_max(forecast_countdown_max)
+  , m_wrench(Vector6d::Zero())
   , m_control(FrankaRidgeback::Control::Zero())
 {}
 
 void Actor::add_end_effector_wrench(Vector6d wrench, double time)
 {
     m_dynamics->get_dynamics()->add_end_effector_simulated_wrench(wrench);
+    m_wrench = wrench;
 
     if (m_forecast && m_forecast_countdown <= 0) {
         m_forecast->observe_wrench(wrench, time);
@@ -165,24 +246,19 @@ void Actor::act(Simulator *simulator)
 {
     using namespace FrankaRidgeback;
 
+    if (m_channel) {
+        act_remote(simulator);
+        return;
+    }
+
     // Update the controller every couple of time steps, depending on the
-    // controller update rate.
+    // controller update rate. The trajectory is not applied in fallback, so
+    // it is only updated as often as needed to probe the deadline.
     if (--m_trajectory_countdown <= 0) {
         m_trajectory_countdown = m_trajectory_countdown_max;
 
-        if (m_forecast) {
-            m_forecast->forecast(
-                m_dynamics->get_dynamics()->get_state(),
-                simulator->get_time()
-            );
-        }
-
-        for (unsigned int i = 0; i < m_configuration.controller_substeps; i++) {
-            m_controller->update(
-                m_dynamics->get_dynamics()->get_state(),
-                simulator->get_time()
-            );
-        }
+        if (!m_deadline || m_deadline->should_update())
+            update_trajectory(simulator);
     }
 
     if (m_forecast) {
@@ -191,8 +267,85 @@ void Actor::act(Simulator *simulator)
         }
     }
 
-    // Get the controls to apply to the dynamics.
-    m_controller->get(m_control, simulator->get_time());
+    // Get the controls to apply to the dynamics. The trajectory is stale while
+    // updates are overrunning, so hold position instead.
+    if (m_deadline && m_deadline->in_fallback()) {
+        m_hold->update(get_state().position(), simulator->get_time());
+        m_control = m_hold->get_control();
+    }
+    else {
+        m_controller->get(m_control, simulator->get_time());
+    }
+
+    m_dynamics->act(m_control, simulator->get_time_step());
+}
+
+void Actor::update_trajectory(Simulator *simulator)
+{
+    using namespace std::chrono;
+
+    auto start = steady_clock::now();
+    mppi::Trajectory::Phases phases;
+
+    if (m_forecast) {
+        m_forecast->forecast(
+            m_dynamics->get_dynamics()->get_state(),
+            simulator->get_time()
+        );
+    }
+
+    for (unsigned int i = 0; i < m_configuration.controller_substeps; i++) {
+        m_controller->update(
+            m_dynamics->get_dynamics()->get_state(),
+            simulator->get_time()
+        );
+        phases += m_controller->get_update_phases();
+    }
+
+    if (!m_deadline)
+        return;
+
+    bool fallback = m_deadline->in_fallback();
+
+    m_deadline->observe(
+        *m_controller,
+        duration<double>(steady_clock::now() - start).count(),
+        phases
+    );
+
+    // Hold the joint positions at the time of falling back.
+    if (!fallback && m_deadline->in_fallback()) {
+        auto hold = m_configuration.deadline->hold;
+        hold.reference = get_state().position();
+        hold.initial_time = simulator->get_time();
+        m_hold = controller::PID::create(hold);
+    }
+}
+
+void Actor::act_remote(Simulator *simulator)
+{
+    double time = simulator->get_time();
+
+    if (--m_trajectory_countdown <= 0) {
+        m_trajectory_countdown = m_trajectory_countdown_max;
+
+        // The remote controller forecasts the wrench from the state.
+        FrankaRidgeback::State state = get_state();
+        state.end_effector_wrench() = m_wrench;
+        m_channel->write_state(state, time);
+
+        // A missed response leaves the previous trajectory in place.
+        if (m_configuration.remote->synchronous &&
+            !m_channel->wait_trajectory(time, m_configuration.remote->timeout)) {
+            std::cerr << "actor remote controller did not respond at time "
+                      << time << std::endl;
+        }
+    }
+
+    // Before the first trajectory, apply no control.
+    if (!m_channel->get_control(m_control, time))
+        m_control.setZero();
+
     m_dynamics->act(m_control, simulator->get_time_step());
 }
 
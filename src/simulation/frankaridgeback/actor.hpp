@@ -6,11 +6,14 @@
 #include "simulation/frankaridgeback/actor_dynamics.hpp"
 #include "controller/pid.hpp"
 #include "controller/mppi.hpp"
+#include "controller/deadline.hpp"
 #include "controller/energy.hpp"
 #include "controller/forecast.hpp"
+#include "ipc/channel.hpp"
 #include "frankaridgeback/control.hpp"
 #include "frankaridgeback/state.hpp"
 #include "frankaridgeback/objective/track_point.hpp"
+#include "frankaridgeback/objective/track_trajectory.hpp"
 #include "frankaridgeback/objective/assisted_manipulation.hpp"
 
 namespace FrankaRidgeback {
@@ -70,7 +73,8 @@ public:
 
             enum Type {
                 ASSISTED_MANIPULATION,
-                TRACK_POINT
+                TRACK_POINT,
+                TRACK_TRAJECTORY
             };
 
             /// The selected objective.
@@ -82,10 +86,13 @@ public:
             /// Configuration for the reach objective.
             std::optional<FrankaRidgeback::TrackPoint::Configuration> track_point;
 
+            /// Configuration for the track trajectory objective.
+            std::optional<FrankaRidgeback::TrackTrajectory::Configuration> track_trajectory;
+
             // JSON conversion for base simulation objective.
             NLOHMANN_DEFINE_TYPE_INTRUSIVE(
                 Objective,
-                type, assisted_manipulation, track_point
+                type, assisted_manipulation, track_point, track_trajectory
             )
         };
 
@@ -119,11 +126,64 @@ public:
         /// The period of time between forecast observations.
         double forecast_rate;
 
+        /**
+         * @brief Configuration of deadline monitoring of controller updates.
+         */
+        struct Deadline {
+
+            /// Configuration of the monitor. The deadline is a fraction of the
+            /// controller rate.
+            mppi::DeadlineMonitor::Configuration monitor;
+
+            /// Configuration of the pid controller that holds the joint
+            /// positions at the time of fallback, of dimension DoF::CONTROL.
+            /// The reference and initial time are set on fallback.
+            controller::PID::Configuration hold;
+
+            // JSON conversion for Deadline configuration.
+            NLOHMANN_DEFINE_TYPE_INTRUSIVE(Deadline, monitor, hold)
+        };
+
+        /// The configuration of deadline monitoring, if provided.
+        std::optional<Deadline> deadline;
+
+        /**
+         * @brief Configuration of an out of process controller.
+         */
+        struct Remote {
+
+            /// The name of the shared memory channel to create, beginning with
+            /// a slash.
+            std::string channel;
+
+            /// The maximum number of control trajectory time steps.
+            unsigned int steps;
+
+            /// If the actor waits for a trajectory after publishing each
+            /// state, making the simulation deterministic with respect to
+            /// controller computation time.
+            bool synchronous;
+
+            /// The maximum time in seconds to wait for a trajectory when
+            /// synchronous.
+            double timeout;
+
+            // JSON conversion for Remote configuration.
+            NLOHMANN_DEFINE_TYPE_INTRUSIVE(Remote, channel, steps, synchronous, timeout)
+        };
+
+        /// If provided, the trajectory is generated by a separate controller
+        /// process connected by shared memory. The state is published at the
+        /// controller rate, with the last end effector wrench as its measured
+        /// wrench, for the controller to forecast. The mppi, objective,
+        /// forecast and deadline configurations are then unused by the actor.
+        std::optional<Remote> remote;
+
         // JSON conversion for franka ridgeback actor configuration.
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(
             Configuration,
             mppi, dynamics, objective, forecast, controller_rate,
-            controller_substeps, forecast_rate
+            controller_substeps, forecast_rate, deadline, remote
         )
     };
 
@@ -169,10 +229,14 @@ public:
 
     /**
      * @brief Get the mppi trajectory generator.
+     * 
+     * @warning May be nullptr.
+     * @returns A pointer to the trajectory generator, or nullptr if the actor
+     * is controlled remotely.
      */
-    inline const mppi::Trajectory &get_controller() const
+    inline const mppi::Trajectory *get_controller() const
     {
-        return *m_controller;
+        return m_controller.get();
     }
 
     /**
@@ -197,6 +261,20 @@ public:
         return nullptr;
     }
 
+    /**
+     * @brief Get a pointer to the controller deadline monitor if it exists.
+     * 
+     * @warning May be nullptr.
+     * @returns A pointer to the deadline monitor on success or nullptr if
+     * deadline monitoring is not configured.
+     */
+    inline const mppi::DeadlineMonitor *get_deadline_monitor() const
+    {
+        if (m_deadline)
+            return m_deadline.get();
+        return nullptr;
+    }
+
 private:
 
     friend class Simulator;
@@ -206,6 +284,8 @@ private:
         std::unique_ptr<ActorDynamics> &&dynamics,
         std::unique_ptr<mppi::Trajectory> &&controller,
         std::unique_ptr<DynamicsForecast> &&forecast,
+        std::unique_ptr<mppi::DeadlineMonitor> &&deadline,
+        std::unique_ptr<ipc::Channel> &&channel,
         std::int64_t controller_countdown_max,
         std::int64_t forecast_countdown_max
     );
@@ -216,6 +296,20 @@ private:
      */
     void act(Simulator *simulator) override;
 
+    /**
+     * @brief Forecast and update the trajectory, and observe the duration of
+     * the update with the deadline monitor.
+     * @param simulator The simulator to get the time from.
+     */
+    void update_trajectory(Simulator *simulator);
+
+    /**
+     * @brief Publish the state to and apply the control trajectory from the
+     * remote controller.
+     * @param simulator The simulator to get the time from.
+     */
+    void act_remote(Simulator *simulator);
+
     /**
      * @brief Update the state of the frankaridgeback actor after acting.
      * @param simulator Pointer to the simulator to update state from.
@@ -234,6 +328,15 @@ private:
     /// The trajectory generator.
     std::unique_ptr<mppi::Trajectory> m_controller;
 
+    /// The deadline monitor of trajectory updates. May be nullptr.
+    std::unique_ptr<mppi::DeadlineMonitor> m_deadline;
+
+    /// The controller applied instead of the trajectory in fallback.
+    std::unique_ptr<controller::PID> m_hold;
+
+    /// The channel to the remote controller. nullptr if controlled locally.
+    std::unique_ptr<ipc::Channel> m_channel;
+
     /// Countdown to next trajectory update.
     std::int64_t m_trajectory_countdown;
 
@@ -246,6 +349,10 @@ private:
     /// The value to reset the forecast countdown after update.
     std::int64_t m_forecast_countdown_max;
 
+    /// The last end effector wrench added, sent to the remote controller as
+    /// the measured wrench of the state.
+    Vector6d m_wrench;
+
     /// The current control action.
     FrankaRidgeback::Control m_control;
 };
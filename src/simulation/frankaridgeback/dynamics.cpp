@@ -32,6 +32,16 @@ std::unique_ptr<Dynamics> SimulatorDynamics::create(
             std::move(dynamics_forecast_handle)
         );
     }
+    else if (configuration.type == Configuration::Type::GENERATED) {
+        if (!configuration.generated) {
+            std::cerr << "no generated dynamics configuration provided" << std::endl;
+            return nullptr;
+        }
+        dynamics = GeneratedDynamics::create(
+            *configuration.generated,
+            std::move(dynamics_forecast_handle)
+        );
+    }
     else {
         std::cerr << "unrecognised dynamics type " << configuration.type << std::endl;
         return nullptr;
@@ -7,6 +7,7 @@
 #include "controller/json.hpp"
 #include "frankaridgeback/dynamics.hpp"
 #include "frankaridgeback/pinocchio_dynamics.hpp"
+#include "frankaridgeback/generated_dynamics.hpp"
 
 namespace FrankaRidgeback {
 
@@ -25,7 +26,8 @@ public:
 
         enum Type {
             RAISIM = 0,
-            PINOCCHIO = 1
+            PINOCCHIO = 1,
+            GENERATED = 2
         };
 
         /// The type of configured adaptor.
@@ -37,10 +39,13 @@ public:
         /// The configuration of the pinocchio dynamics adaptor if selected.
         std::optional<PinocchioDynamics::Configuration> pinocchio;
 
+        /// The configuration of the generated dynamics adaptor if selected.
+        std::optional<GeneratedDynamics::Configuration> generated;
+
         // JSON conversion for simulator adaptor configuration.
         NLOHMANN_DEFINE_TYPE_INTRUSIVE(
             Configuration,
-            type, raisim, pinocchio
+            type, raisim, pinocchio, generated
         )
     };
 
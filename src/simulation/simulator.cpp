@@ -1,5 +1,8 @@
 #include "simulator.hpp"
 
+#include <cstdlib>
+#include <iostream>
+
 void Simulator::activate()
 {
     std::string key = std::getenv("RAISIM_ACTIVATION");
@@ -9,6 +12,25 @@ void Simulator::activate()
     raisim::World::setActivationKey(key.c_str());
 }
 
+int Simulator::get_port()
+{
+    // The default port of the raisim server.
+    int port = 8080;
+
+    // Concurrent simulations are each given their own port by the test
+    // runner.
+    if (const char *value = std::getenv("RAISIM_PORT")) {
+        try {
+            port = std::stoi(value);
+        }
+        catch (const std::exception &) {
+            std::cerr << "ignoring invalid RAISIM_PORT " << value << std::endl;
+        }
+    }
+
+    return port;
+}
+
 std::unique_ptr<Simulator> Simulator::create(const Configuration &configuration)
 {
     activate();
@@ -34,7 +56,7 @@ Simulator::Simulator(
   , m_world(std::move(world))
   , m_server(m_world.get())
 {
-    m_server.launchServer();
+    m_server.launchServer(get_port());
 }
 
 void Simulator::step()
@@ -60,6 +60,13 @@ public:
      */
     static void activate();
 
+    /**
+     * @brief Get the port of the raisim server.
+     * @returns The port in the RAISIM_PORT environment variable if set, or
+     * the default raisim server port.
+     */
+    static int get_port();
+
     /**
      * @brief Create a new instance of the simulator.
      * @returns A pointer to the simulator on success, or nullptr on failure.
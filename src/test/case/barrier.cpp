@@ -0,0 +1,286 @@
+#include "test/case/barrier.hpp"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "logging/csv.hpp"
+#include "test/configuration.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Values = Eigen::Array<double, BarrierTest::SIZE, 1>;
+
+/// Receives the timed results so the evaluations are not optimised out.
+volatile double s_sink = 0.0;
+
+/**
+ * @brief The result of comparing an evaluation against the exact scalar
+ * evaluation.
+ */
+struct Comparison {
+
+    /// The largest error over the samples.
+    double error = 0.0;
+
+    /// The largest error allowed by the error bound.
+    double bound = 0.0;
+
+    /// The mean duration of the exact scalar evaluation.
+    double scalar_duration = 0.0;
+
+    /// The mean duration of the compared evaluation.
+    double duration = 0.0;
+};
+
+/**
+ * @brief Get the mean duration of a function over the samples.
+ *
+ * @param samples The samples to evaluate.
+ * @param function The evaluation of a sample.
+ *
+ * @returns The mean duration of the evaluation.
+ */
+template<typename Sample, typename Function>
+double time(const std::vector<Sample> &samples, Function &&function)
+{
+    double sink = 0.0;
+
+    auto start = Clock::now();
+    for (const Sample &sample : samples)
+        sink += function(sample);
+    auto end = Clock::now();
+
+    s_sink = sink;
+    return std::chrono::duration<double>(end - start).count() / (double)samples.size();
+}
+
+/**
+ * @brief Compare a barrier array against the sum of its scalar barriers.
+ *
+ * @param barriers The scalar barriers.
+ * @param samples The values of the barriers at each sample.
+ * @param tolerance The allowed relative difference.
+ * @param log_scale The total scale of the approximated logarithms, or zero if
+ * the barriers are exact.
+ *
+ * @returns The comparison.
+ */
+template<typename Barrier>
+Comparison compare(
+    const std::array<Barrier, BarrierTest::SIZE> &barriers,
+    const std::vector<Values> &samples,
+    double tolerance,
+    double log_scale
+) {
+    BarrierArray<Barrier, BarrierTest::SIZE> array(barriers);
+
+    // The exact barriers, for the reference.
+    auto exact_barriers = barriers;
+    if constexpr (requires (Barrier barrier) { barrier.approximate; }) {
+        for (auto &barrier : exact_barriers)
+            barrier.approximate = false;
+    }
+
+    auto scalar = [&](const Values &values) {
+        double cost = 0.0;
+        for (int i = 0; i < BarrierTest::SIZE; ++i)
+            cost += exact_barriers[i](values[i]);
+        return cost;
+    };
+
+    Comparison comparison;
+    comparison.scalar_duration = time(samples, scalar);
+    comparison.duration = time(samples, array);
+
+    for (const Values &values : samples) {
+        double expected = scalar(values);
+        double actual = array(values);
+        double allowed = tolerance * std::max(1.0, std::fabs(expected)) + log_scale * FAST_LOG10_ERROR;
+
+        comparison.error = std::max(comparison.error, std::fabs(actual - expected));
+        comparison.bound = std::max(comparison.bound, allowed);
+
+        if (std::fabs(actual - expected) > allowed) {
+            comparison.bound = -1.0;
+            break;
+        }
+    }
+
+    return comparison;
+}
+
+} // namespace
+
+const BarrierTest::Configuration BarrierTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .samples = 100000,
+    .seed = 1,
+    .tolerance = 1e-12
+};
+
+std::unique_ptr<BarrierTest> BarrierTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<BarrierTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<BarrierTest> BarrierTest::create(const Configuration &configuration)
+{
+    if (configuration.samples <= 0 || configuration.tolerance <= 0.0) {
+        std::cerr << "barrier test samples and tolerance must be positive" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<BarrierTest>(new BarrierTest(configuration));
+}
+
+BarrierTest::BarrierTest(const Configuration &configuration)
+    : m_configuration(configuration)
+{}
+
+bool BarrierTest::run()
+{
+    auto log = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "barrier.csv",
+        .header = logger::CSV::make_header(
+            "function", "error", "bound", "scalar_duration", "duration"
+        )
+    });
+
+    if (!log) {
+        std::cerr << "failed to create barrier test log" << std::endl;
+        return false;
+    }
+
+    std::mt19937_64 generator(m_configuration.seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::uniform_real_distribution<double> scale(0.1, 10.0);
+    std::uniform_real_distribution<double> magnitude(-6.0, 1.0);
+
+    bool passed = true;
+    auto report = [&](const char *name, const Comparison &comparison) {
+        log->write(
+            name,
+            comparison.error,
+            comparison.bound,
+            comparison.scalar_duration,
+            comparison.duration
+        );
+
+        std::cout << name << " error " << comparison.error
+                  << ", scalar " << comparison.scalar_duration * 1e9
+                  << "ns, compared " << comparison.duration * 1e9 << "ns" << std::endl;
+
+        if (comparison.bound < 0.0 || comparison.error > comparison.bound) {
+            std::cerr << name << " exceeds its error bound" << std::endl;
+            passed = false;
+        }
+    };
+
+    // The logarithm over the range of normal doubles, and close to one where
+    // the barriers are most sensitive.
+    {
+        std::uniform_real_distribution<double> exponent(-300.0, 300.0);
+        std::vector<double> values(m_configuration.samples);
+        for (std::size_t i = 0; i < values.size(); ++i)
+            values[i] = (i % 2) ? std::pow(10.0, exponent(generator)) : 1.0 + 0.5 * uniform(generator);
+
+        Comparison comparison;
+        comparison.bound = FAST_LOG10_ERROR;
+        for (double value : values) {
+            comparison.error = std::max(
+                comparison.error,
+                std::fabs(fast_log10(value) - std::log10(value))
+            );
+        }
+
+        comparison.scalar_duration = time(values, [](double value) { return std::log10(value); });
+        comparison.duration = time(values, [](double value) { return fast_log10(value); });
+        report("fast_log10", comparison);
+    }
+
+    // Values either side of the barrier bounds, from very close to far.
+    auto sample = [&](const Values &bounds) {
+        std::vector<Values> samples(m_configuration.samples);
+        for (Values &values : samples) {
+            for (int i = 0; i < SIZE; ++i) {
+                double distance = std::pow(10.0, magnitude(generator));
+                values[i] = bounds[i] + std::copysign(distance, uniform(generator));
+            }
+        }
+        return samples;
+    };
+
+    Values bounds = Values::NullaryExpr([&]() { return uniform(generator); });
+    std::vector<Values> samples = sample(bounds);
+
+    {
+        std::array<RightInverseBarrierFunction, SIZE> barriers;
+        for (int i = 0; i < SIZE; ++i)
+            barriers[i] = {.upper_bound = bounds[i], .scale = scale(generator)};
+
+        report("right_inverse", compare(barriers, samples, m_configuration.tolerance, 0.0));
+    }
+
+    {
+        std::array<LeftInverseBarrierFunction, SIZE> barriers;
+        for (int i = 0; i < SIZE; ++i)
+            barriers[i] = {.lower_bound = bounds[i], .scale = scale(generator)};
+
+        report("left_inverse", compare(barriers, samples, m_configuration.tolerance, 0.0));
+    }
+
+    for (bool approximate : {false, true}) {
+        std::array<UpperLogarithmicBarrierFunction, SIZE> barriers;
+        double log_scale = 0.0;
+        for (int i = 0; i < SIZE; ++i) {
+            barriers[i] = {
+                .upper_bound = bounds[i],
+                .scale = scale(generator),
+                .offset = uniform(generator),
+                .approximate = approximate
+            };
+            log_scale += approximate ? barriers[i].scale : 0.0;
+        }
+
+        report(
+            approximate ? "upper_logarithmic_fast" : "upper_logarithmic",
+            compare(barriers, samples, m_configuration.tolerance, log_scale)
+        );
+    }
+
+    for (bool approximate : {false, true}) {
+        std::array<LowerLogarithmicBarrierFunction, SIZE> barriers;
+        double log_scale = 0.0;
+        for (int i = 0; i < SIZE; ++i) {
+            barriers[i] = {
+                .lower_bound = bounds[i],
+                .scale = scale(generator),
+                .offset = uniform(generator),
+                .approximate = approximate
+            };
+            log_scale += approximate ? barriers[i].scale : 0.0;
+        }
+
+        report(
+            approximate ? "lower_logarithmic_fast" : "lower_logarithmic",
+            compare(barriers, samples, m_configuration.tolerance, log_scale)
+        );
+    }
+
+    return passed;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <filesystem>
+
+#include "test/test.hpp"
+#include "controller/cost.hpp"
+
+/**
+ * @brief Verifies the vectorised barrier functions and the fast logarithm
+ * against the exact scalar barrier functions.
+ *
+ * Each barrier family is evaluated over random barriers and values either
+ * side of their bounds. The test fails if fast_log10() exceeds its error
+ * bound, if an exact barrier array differs from the sum of its scalar
+ * barriers by more than the tolerance, or if an approximate barrier array
+ * differs by more than the logarithm error bound allows. The time taken by
+ * each evaluation is logged.
+ */
+class BarrierTest : public RegisteredTest<BarrierTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "barrier";
+
+    /// The number of barriers in each array.
+    static inline constexpr int SIZE = 12;
+
+    struct Configuration {
+
+        /// The folder to write the comparison log to.
+        std::filesystem::path folder;
+
+        /// The number of random samples of each comparison.
+        std::int64_t samples;
+
+        /// The seed of the random barriers and values.
+        std::uint64_t seed;
+
+        /// The largest relative difference allowed between an exact barrier
+        /// array and the sum of its scalar barriers.
+        double tolerance;
+
+        // JSON conversion for barrier test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, samples, seed, tolerance
+        )
+    };
+
+    /**
+     * @brief The default configuration of the barrier test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the barrier test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<BarrierTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the barrier test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<BarrierTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Compare the barrier functions at each sample.
+     * @returns If the barrier functions are within their error bounds.
+     */
+    bool run() override;
+
+private:
+
+    BarrierTest(const Configuration &configuration);
+
+    /// The test configuration.
+    Configuration m_configuration;
+};
@@ -1,5 +1,6 @@
 #include "test/case/base.hpp"
 #include "logging/file.hpp"
+#include "test/configuration.hpp"
 
 std::unique_ptr<BaseTest> BaseTest::create(Options &options)
 {
@@ -9,18 +10,15 @@ std::unique_ptr<BaseTest> BaseTest::create(Options &options)
 
     // If configuration overrides were provided, apply them based on the json
     // patch specification.
-    try {
-        if (!options.patch.is_null()) {
-            json json_configuration = configuration;
-            json_configuration.merge_patch(options.patch);
-            configuration = json_configuration;
-        }
-    }
-    catch (const json::exception &err) {
-        std::cerr << "error when patching json configuration: " << err.what() << std::endl;
-        std::cerr << "configuration was " << ((json)DEFAULT_CONFIGURATION).dump(4) << std::endl;
-        std::cerr << "patch was " << options.patch.dump(4) << std::endl;
-        return nullptr;
+    if (!options.patch.is_null()) {
+        json patch = {
+            {"duration", options.duration},
+            {"folder", options.folder}
+        };
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<BaseTest>::apply(configuration, patch))
+            return nullptr;
     }
 
     return create(configuration);
@@ -52,16 +50,21 @@ std::unique_ptr<BaseTest> BaseTest::create(const Configuration &configuration)
     auto forecast_log_configuration = configuration.forecast_logger;
     auto objective_log_configuration = configuration.objective_logger;
 
-    mppi_log_configuration.rollouts = frankaridgeback->get_controller().get_rollout_count();
     mppi_log_configuration.folder = configuration.folder / "mppi";
     dynamics_log_configuration.folder = configuration.folder / "dynamics";
     forecast_log_configuration.folder = configuration.folder / "forecast";
     objective_log_configuration.folder = configuration.folder / "objective";
 
-    auto mppi_logger = logger::MPPI::create(mppi_log_configuration);
-    if (!mppi_logger) {
-        std::cerr << "failed to create mppi logger" << std::endl;
-        return nullptr;
+    // Remotely controlled actors have no local trajectory generator to log.
+    std::unique_ptr<logger::MPPI> mppi_logger;
+    if (frankaridgeback->get_controller()) {
+        mppi_log_configuration.rollouts = frankaridgeback->get_controller()->get_rollout_count();
+
+        mppi_logger = logger::MPPI::create(mppi_log_configuration);
+        if (!mppi_logger) {
+            std::cerr << "failed to create mppi logger" << std::endl;
+            return nullptr;
+        }
     }
 
     auto dynamics_logger = logger::FrankaRidgebackDynamics::create(dynamics_log_configuration);
@@ -77,7 +80,8 @@ std::unique_ptr<BaseTest> BaseTest::create(const Configuration &configuration)
     }
 
     std::unique_ptr<logger::AssistedManipulation> objective_logger;
-    if (configuration.actor.objective.type == FrankaRidgeback::ObjectiveType::ASSISTED_MANIPULATION) {
+    if (frankaridgeback->get_controller() &&
+        configuration.actor.objective.type == FrankaRidgeback::ObjectiveType::ASSISTED_MANIPULATION) {
         objective_logger = logger::AssistedManipulation::create(objective_log_configuration);
         if (!objective_logger) {
             std::cerr << "failed to create objective logger" << std::endl;
@@ -129,7 +133,18 @@ void BaseTest::step()
 {
     m_simulator->step();
 
-    m_mppi_logger->log(m_frankaridgeback->get_controller());
+    const mppi::Trajectory *controller = m_frankaridgeback->get_controller();
+
+    if (m_mppi_logger) {
+        m_mppi_logger->log(*controller);
+
+        if (m_frankaridgeback->get_deadline_monitor()) {
+            m_mppi_logger->log(
+                controller->get_update_last(),
+                *m_frankaridgeback->get_deadline_monitor()
+            );
+        }
+    }
 
     m_dynamics_logger->log(m_simulator->get_time(), m_frankaridgeback->get_dynamics());
     m_dynamics_logger->log_control(m_simulator->get_time(), m_frankaridgeback->get_control());
@@ -139,9 +154,9 @@ void BaseTest::step()
 
     if (m_objective_logger) {
         m_objective_logger->log(
-            m_frankaridgeback->get_controller().get_update_last(),
+            controller->get_update_last(),
             dynamic_cast<const FrankaRidgeback::AssistedManipulation&>(
-                m_frankaridgeback->get_controller().get_optimal_cost()
+                controller->get_optimal_cost()
             )
         );
     }
@@ -75,6 +75,12 @@ public:
                         7.5, 7.5, 7.5, 7.5, 7.5, 7.5, 7.5, // arm
                         0.0, 0.0 // gripper
                     }.asDiagonal(),
+                    .sample_mask = std::vector<bool>{
+                        true, true, true, // base
+                        true, true, true, true, true, true, true, // arm
+                        false, false // gripper
+                    },
+                    .knots = std::nullopt,
                     .control_bound = true,
                     .control_min = FrankaRidgeback::Control{
                         -0.5, -0.5, -1.0, // base
@@ -91,23 +97,30 @@ public:
                         .window = 10,
                         .order = 1
                     },
-                    .threads = 12
+                    .threads = 12,
+                    .realtime = std::nullopt,
+                    .distributed = std::nullopt,
+                    .recording = std::nullopt,
+                    .cost_scale_adaptation = std::nullopt
                 },
                 .dynamics = {
                     .type = FrankaRidgeback::SimulatorDynamics::Configuration::Type::RAISIM,
                     .raisim = FrankaRidgeback::RaisimDynamics::DEFAULT_CONFIGURATION,
-                    .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION
+                    .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+                    .generated = FrankaRidgeback::GeneratedDynamics::DEFAULT_CONFIGURATION
                 }
             },
             .dynamics = {
                 .type = FrankaRidgeback::SimulatorDynamics::Configuration::Type::RAISIM,
                 .raisim = FrankaRidgeback::RaisimDynamics::DEFAULT_CONFIGURATION,
-                .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION
+                .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+                .generated = FrankaRidgeback::GeneratedDynamics::DEFAULT_CONFIGURATION
             },
             .objective = {
                 .type = FrankaRidgeback::Actor::Configuration::Objective::Type::ASSISTED_MANIPULATION,
                 .assisted_manipulation = FrankaRidgeback::AssistedManipulation::DEFAULT_CONFIGURATION,
-                .track_point = FrankaRidgeback::TrackPoint::DEFAULT_CONFIGURATION
+                .track_point = FrankaRidgeback::TrackPoint::DEFAULT_CONFIGURATION,
+                .track_trajectory = FrankaRidgeback::TrackTrajectory::DEFAULT_CONFIGURATION
             },
             .forecast = FrankaRidgeback::Actor::Configuration::Forecast {
                 .configuration = {
@@ -136,12 +149,15 @@ public:
                 .dynamics = {
                     .type = FrankaRidgeback::SimulatorDynamics::Configuration::Type::RAISIM,
                     .raisim = FrankaRidgeback::RaisimDynamics::DEFAULT_CONFIGURATION,
-                    .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION
+                    .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+                    .generated = FrankaRidgeback::GeneratedDynamics::DEFAULT_CONFIGURATION
                 }
             },
             .controller_rate = 0.05,
             .controller_substeps = 1,
-            .forecast_rate = 0.00
+            .forecast_rate = 0.00,
+            .deadline = std::nullopt,
+            .remote = std::nullopt
         },
         .mppi_logger = {
             .folder = "",
@@ -153,7 +169,9 @@ public:
             .log_gradient = true,
             .log_optimal_rollout = true,
             .log_optimal_cost = true,
-            .log_update = true
+            .log_update = true,
+            .log_deadline = true,
+            .log_rollout_states = true
         },
         .dynamics_logger = {
             .folder = "",
@@ -268,7 +286,8 @@ private:
     /// Pointer to the franka ridgeback being simulated.
     std::shared_ptr<FrankaRidgeback::Actor> m_frankaridgeback;
 
-    /// Logger for the frankaridgeback mppi trajectory generator.
+    /// Logger for the frankaridgeback mppi trajectory generator. nullptr if the
+    /// actor is controlled remotely.
     std::unique_ptr<logger::MPPI> m_mppi_logger;
 
     /// Logger for the frankaridgeback.
@@ -0,0 +1,223 @@
+#include "test/case/csv.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+#include "controller/eigen.hpp"
+#include "logging/csv.hpp"
+#include "test/configuration.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the duration of writing every row, including submitting the
+ * rows to be written.
+ *
+ * @param rows The number of rows.
+ * @param write Writes a row.
+ * @param flush Flushes the written rows.
+ *
+ * @returns The duration in seconds.
+ */
+template<typename Write, typename Flush>
+double time(std::int64_t rows, Write &&write, Flush &&flush)
+{
+    auto start = Clock::now();
+    for (std::int64_t i = 0; i < rows; ++i)
+        write(i);
+    flush();
+    auto end = Clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief Read back the values of a CSV file.
+ *
+ * @param path The path of the file.
+ * @param times The expected time of each row.
+ * @param values The expected values of each row, with a column per row.
+ *
+ * @returns The number of values that differ from the expected values.
+ */
+std::int64_t verify(
+    const std::filesystem::path &path,
+    const VectorXd &times,
+    const MatrixXd &values
+) {
+    std::ifstream file(path);
+    std::string line;
+
+    // Skip the header.
+    std::getline(file, line);
+
+    std::int64_t errors = 0;
+    std::int64_t row = 0;
+
+    for (; std::getline(file, line) && row < times.size(); ++row) {
+        const char *it = line.data();
+        const char *end = line.data() + line.size();
+
+        for (Eigen::Index column = 0; column <= values.rows(); ++column) {
+            while (it < end && (*it == ',' || *it == ' '))
+                ++it;
+
+            double value = NAN;
+            auto result = std::from_chars(it, end, value);
+            it = result.ptr;
+
+            double expected = column == 0 ? times[row] : values(column - 1, row);
+            if (result.ec != std::errc() || value != expected)
+                ++errors;
+        }
+    }
+
+    // Missing rows are errors.
+    return errors + (times.size() - row) * (values.rows() + 1);
+}
+
+} // namespace
+
+const CSVTest::Configuration CSVTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .rows = 100000,
+    .columns = 20,
+    .seed = 1
+};
+
+std::unique_ptr<CSVTest> CSVTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<CSVTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<CSVTest> CSVTest::create(const Configuration &configuration)
+{
+    if (configuration.rows <= 0 || configuration.columns <= 0) {
+        std::cerr << "csv test rows and columns must be positive" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<CSVTest>(new CSVTest(configuration));
+}
+
+CSVTest::CSVTest(const Configuration &configuration)
+    : m_configuration(configuration)
+{}
+
+bool CSVTest::run()
+{
+    auto log = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "csv.csv",
+        .header = logger::CSV::make_header(
+            "method", "duration", "row_duration", "bytes"
+        )
+    });
+
+    if (!log) {
+        std::cerr << "failed to create csv test log" << std::endl;
+        return false;
+    }
+
+    const std::int64_t rows = m_configuration.rows;
+    const std::int64_t columns = m_configuration.columns;
+
+    // Values over many magnitudes, so few have short representations.
+    std::mt19937_64 generator(m_configuration.seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::uniform_real_distribution<double> magnitude(-12.0, 12.0);
+
+    VectorXd times = VectorXd::LinSpaced(rows, 0.0, 0.01 * (double)(rows - 1));
+    MatrixXd values = MatrixXd::NullaryExpr(columns, rows, [&]() {
+        return uniform(generator) * std::pow(10.0, magnitude(generator));
+    });
+
+    auto header = logger::CSV::make_header("time");
+    for (std::int64_t i = 0; i < columns; ++i)
+        header.push_back("value" + std::to_string(i));
+
+    auto report = [&](const char *name, double duration, const std::filesystem::path &path) {
+        std::error_code code;
+        auto bytes = std::filesystem::file_size(path, code);
+
+        log->write(name, duration, duration / (double)rows, code ? 0 : bytes);
+
+        std::cout << name << " " << duration * 1e3 << "ms, "
+                  << duration / (double)rows * 1e9 << "ns per row" << std::endl;
+    };
+
+    // The csv logger.
+    auto csv_path = m_configuration.folder / "csv_formatted.csv";
+    {
+        auto csv = logger::CSV::create({.path = csv_path, .header = header});
+        if (!csv) {
+            std::cerr << "failed to create csv test file" << std::endl;
+            return false;
+        }
+
+        double duration = time(
+            rows,
+            [&](std::int64_t i) { csv->write(times[i], values.col(i)); },
+            [&]() { csv->flush(); }
+        );
+
+        csv->wait();
+        report("csv", duration, csv_path);
+    }
+
+    // The stream operators of the file at the default precision, as the csv
+    // logger previously formatted values, and at the round trip precision.
+    for (bool round_trip : {false, true}) {
+        auto path = m_configuration.folder / (
+            round_trip ? "csv_stream_round_trip.csv" : "csv_stream.csv"
+        );
+
+        auto file = logger::File::create(path);
+        if (!file) {
+            std::cerr << "failed to create csv test file" << std::endl;
+            return false;
+        }
+
+        if (round_trip)
+            file->get_stream() << std::setprecision(17);
+
+        double duration = time(
+            rows,
+            [&](std::int64_t i) {
+                *file << times[i];
+                for (std::int64_t j = 0; j < columns; ++j)
+                    *file << ", " << values(j, i);
+                *file << '\n';
+            },
+            [&]() { file->flush(); }
+        );
+
+        file->wait();
+        report(round_trip ? "stream_round_trip" : "stream", duration, path);
+    }
+
+    std::int64_t errors = verify(csv_path, times, values);
+    if (errors != 0) {
+        std::cerr << errors << " values read back from the csv file differ" << std::endl;
+        return false;
+    }
+
+    return true;
+}
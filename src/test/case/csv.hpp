@@ -0,0 +1,78 @@
+#pragma once
+
+#include <filesystem>
+
+#include "test/test.hpp"
+
+/**
+ * @brief Benchmarks CSV formatting against formatting with the file stream.
+ *
+ * Random rows of a time and a vector of values spanning many magnitudes are
+ * written with logger::CSV, and with the stream operators of logger::File at
+ * the default and round trip precisions. The test fails if the values read
+ * back from the CSV file differ from the written values. The duration and
+ * size of each method is logged.
+ */
+class CSVTest : public RegisteredTest<CSVTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "csv";
+
+    struct Configuration {
+
+        /// The folder to write the benchmark files and log to.
+        std::filesystem::path folder;
+
+        /// The number of rows to write.
+        std::int64_t rows;
+
+        /// The number of values of each row, after the time.
+        std::int64_t columns;
+
+        /// The seed of the random values.
+        std::uint64_t seed;
+
+        // JSON conversion for csv test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, rows, columns, seed
+        )
+    };
+
+    /**
+     * @brief The default configuration of the csv test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the csv test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<CSVTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the csv test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<CSVTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Write the rows with each method and read back the CSV file.
+     * @returns If the values read back equal the written values.
+     */
+    bool run() override;
+
+private:
+
+    CSVTest(const Configuration &configuration);
+
+    /// The test configuration.
+    Configuration m_configuration;
+};
@@ -0,0 +1,202 @@
+#include "test/case/decoupled.hpp"
+
+#include <chrono>
+#include <random>
+
+#include "logging/csv.hpp"
+#include "test/configuration.hpp"
+
+const DecoupledDynamicsTest::Configuration DecoupledDynamicsTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .samples = 1000,
+    .seed = 1,
+    .time_step = 0.01,
+    .tolerance = 1e-6,
+    .acceleration_tolerance = 2.5,
+    .coupling_tolerance = 0.3,
+    .coupled = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+    .decoupled = []{
+        auto configuration = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION;
+        configuration.decoupled_base = true;
+        return configuration;
+    }()
+};
+
+std::unique_ptr<DecoupledDynamicsTest> DecoupledDynamicsTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<DecoupledDynamicsTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<DecoupledDynamicsTest> DecoupledDynamicsTest::create(const Configuration &configuration)
+{
+    if (configuration.samples <= 0 || configuration.time_step <= 0.0) {
+        std::cerr << "decoupled dynamics test samples and time step must be positive" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.coupled.end_effector_frame != configuration.decoupled.end_effector_frame) {
+        std::cerr << "decoupled dynamics test must compare the same end effector frame" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.coupled.decoupled_base || !configuration.decoupled.decoupled_base) {
+        std::cerr << "decoupled dynamics test must compare the decoupled against the full pinocchio model" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<DecoupledDynamicsTest>(new DecoupledDynamicsTest(configuration));
+}
+
+DecoupledDynamicsTest::DecoupledDynamicsTest(const Configuration &configuration)
+    : m_configuration(configuration)
+{}
+
+bool DecoupledDynamicsTest::run()
+{
+    using namespace FrankaRidgeback;
+    using Clock = std::chrono::steady_clock;
+
+    auto coupled = PinocchioDynamics::create(m_configuration.coupled);
+    auto decoupled = PinocchioDynamics::create(m_configuration.decoupled);
+
+    if (!coupled || !decoupled) {
+        std::cerr << "failed to create decoupled dynamics test models" << std::endl;
+        return false;
+    }
+
+    auto log = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "decoupled.csv",
+        .header = logger::CSV::make_header(
+            "sample", "position_error", "orientation_error", "velocity_error",
+            "acceleration_error", "jacobian_error", "step_error",
+            "coupled_duration", "decoupled_duration"
+        )
+    });
+
+    if (!log) {
+        std::cerr << "failed to create decoupled dynamics test log" << std::endl;
+        return false;
+    }
+
+    std::mt19937_64 generator(m_configuration.seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    auto random = [&](int size, double scale) {
+        return VectorXd(VectorXd::NullaryExpr(size, [&]() { return scale * uniform(generator); }));
+    };
+
+    double worst_kinematic = 0.0;
+    double worst_acceleration = 0.0;
+    double worst_coupling = 0.0;
+    double coupled_duration = 0.0;
+    double decoupled_duration = 0.0;
+
+    for (std::int64_t sample = 0; sample < m_configuration.samples; ++sample) {
+        State state = State::Zero();
+        state.position() = random(DoF::JOINTS, M_PI);
+        state.velocity() = random(DoF::JOINTS, 1.0);
+        state.available_energy().setConstant(m_configuration.coupled.energy);
+
+        Control control = random(DoF::CONTROL, 1.0);
+
+        coupled->set_state(state, 0.0);
+        decoupled->set_state(state, 0.0);
+
+        const EndEffectorState &expected = coupled->get_end_effector_state();
+        const EndEffectorState &actual = decoupled->get_end_effector_state();
+
+        double position_error = (actual.position - expected.position).cwiseAbs().maxCoeff();
+        double orientation_error = actual.orientation.angularDistance(expected.orientation);
+        double velocity_error = std::max(
+            (actual.linear_velocity - expected.linear_velocity).cwiseAbs().maxCoeff(),
+            (actual.angular_velocity - expected.angular_velocity).cwiseAbs().maxCoeff()
+        );
+        double jacobian_error = (actual.jacobian - expected.jacobian).cwiseAbs().maxCoeff();
+
+        auto start = Clock::now();
+        VectorXd expected_step = coupled->step(control, m_configuration.time_step);
+        auto middle = Clock::now();
+        VectorXd actual_step = decoupled->step(control, m_configuration.time_step);
+        auto end = Clock::now();
+
+        // The joint torque is only set by the step, so the end effector
+        // acceleration is compared under the control.
+        double acceleration_error = std::max(
+            (actual.linear_acceleration - expected.linear_acceleration).cwiseAbs().maxCoeff(),
+            (actual.angular_acceleration - expected.angular_acceleration).cwiseAbs().maxCoeff()
+        );
+        double step_error = (actual_step - expected_step).cwiseAbs().maxCoeff();
+        double coupled_step = std::chrono::duration<double>(middle - start).count();
+        double decoupled_step = std::chrono::duration<double>(end - middle).count();
+
+        coupled_duration += coupled_step;
+        decoupled_duration += decoupled_step;
+
+        worst_kinematic = std::max({
+            worst_kinematic, position_error, orientation_error, velocity_error,
+            jacobian_error
+        });
+        worst_acceleration = std::max(worst_acceleration, acceleration_error);
+        worst_coupling = std::max(worst_coupling, step_error);
+
+        log->write(
+            sample,
+            position_error,
+            orientation_error,
+            velocity_error,
+            acceleration_error,
+            jacobian_error,
+            step_error,
+            coupled_step,
+            decoupled_step
+        );
+    }
+
+    double samples = (double)m_configuration.samples;
+    double saving = (coupled_duration - decoupled_duration) / samples;
+    std::cout << "decoupled dynamics step " << decoupled_duration / samples * 1e6
+              << "us, coupled step " << coupled_duration / samples * 1e6
+              << "us, saving " << saving * 1e6 << "us ("
+              << saving / coupled_duration * samples * 100.0 << "%) per step"
+              << std::endl;
+    std::cout << "largest kinematic difference " << worst_kinematic
+              << ", largest acceleration difference " << worst_acceleration
+              << ", largest step difference " << worst_coupling
+              << std::endl;
+
+    bool success = true;
+
+    if (!(worst_kinematic <= m_configuration.tolerance)) {
+        std::cerr << "decoupled kinematics differ from the full model by " << worst_kinematic
+                  << ", more than the tolerance " << m_configuration.tolerance << std::endl;
+        success = false;
+    }
+
+    if (!(worst_acceleration <= m_configuration.acceleration_tolerance)) {
+        std::cerr << "decoupled end effector acceleration differs from the full model by "
+                  << worst_acceleration << ", more than the acceleration tolerance "
+                  << m_configuration.acceleration_tolerance << std::endl;
+        success = false;
+    }
+
+    if (!(worst_coupling <= m_configuration.coupling_tolerance)) {
+        std::cerr << "decoupled steps differ from the full model by " << worst_coupling
+                  << ", more than the coupling tolerance " << m_configuration.coupling_tolerance
+                  << std::endl;
+        success = false;
+    }
+
+    return success;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <filesystem>
+
+#include "test/test.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+
+/**
+ * @brief Validates the pinocchio dynamics with the base decoupled against the
+ * full pinocchio model, without the simulator.
+ *
+ * Both dynamics are set to the same random states and stepped with the same
+ * random controls. The end effector pose, velocity and jacobian only depend
+ * on the kinematics, so the test fails if they differ by more than the
+ * tolerance. The end effector acceleration under the control and the stepped
+ * state omit the inertial coupling between the arm and the base when
+ * decoupled, so they are allowed to differ by the acceleration and coupling
+ * tolerances. The time taken by each step is logged and the saving per step is
+ * reported.
+ */
+class DecoupledDynamicsTest : public RegisteredTest<DecoupledDynamicsTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "decoupled";
+
+    struct Configuration {
+
+        /// The folder to write the comparison log to.
+        std::filesystem::path folder;
+
+        /// The number of random states to compare.
+        std::int64_t samples;
+
+        /// The seed of the random states and controls.
+        std::uint64_t seed;
+
+        /// The time step of each compared step.
+        double time_step;
+
+        /// The largest absolute difference allowed in the end effector pose,
+        /// velocity and jacobian.
+        double tolerance;
+
+        /// The largest absolute difference allowed in the end effector
+        /// acceleration under the control. The default bounds the 2.28
+        /// measured over the default samples.
+        double acceleration_tolerance;
+
+        /// The largest absolute difference allowed in the stepped state. The
+        /// default bounds the 0.28 measured over the default samples, which is
+        /// in the available energy.
+        double coupling_tolerance;
+
+        /// The reference pinocchio dynamics configuration with the base
+        /// coupled.
+        FrankaRidgeback::PinocchioDynamics::Configuration coupled;
+
+        /// The pinocchio dynamics configuration with the base decoupled.
+        FrankaRidgeback::PinocchioDynamics::Configuration decoupled;
+
+        // JSON conversion for decoupled dynamics test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, samples, seed, time_step, tolerance,
+            acceleration_tolerance, coupling_tolerance, coupled, decoupled
+        )
+    };
+
+    /**
+     * @brief The default configuration of the decoupled dynamics test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the decoupled dynamics test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<DecoupledDynamicsTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the decoupled dynamics test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<DecoupledDynamicsTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Compare the dynamics at each sampled state.
+     * @returns If the dynamics agree to the tolerances.
+     */
+    bool run() override;
+
+private:
+
+    DecoupledDynamicsTest(const Configuration &configuration);
+
+    /// The test configuration.
+    Configuration m_configuration;
+};
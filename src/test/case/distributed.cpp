@@ -0,0 +1,280 @@
+#include "test/case/distributed.hpp"
+
+#include <algorithm>
+#include <array>
+#include <csignal>
+
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "distributed/worker.hpp"
+#include "logging/csv.hpp"
+#include "test/case/base.hpp"
+#include "test/configuration.hpp"
+
+const DistributedTest::Configuration DistributedTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .workers = 2,
+    .worker_rollouts = 50,
+    .seed = 1,
+    .ticks = 200,
+    .time_step = 0.01,
+    .tolerance = 1e-9,
+    .mppi = [](){
+        mppi::Configuration mppi = BaseTest::DEFAULT_CONFIGURATION.actor.mppi.configuration;
+        mppi.keep_best_rollouts = 0;
+        mppi.cost_scale_adaptation = std::nullopt;
+        return mppi;
+    }(),
+    .dynamics = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+    .objective = FrankaRidgeback::TrackPoint::DEFAULT_CONFIGURATION
+};
+
+std::unique_ptr<DistributedTest> DistributedTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<DistributedTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<DistributedTest> DistributedTest::create(const Configuration &configuration)
+{
+    if (configuration.workers == 0 || configuration.worker_rollouts <= 0) {
+        std::cerr << "distributed test must have workers with rollouts" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.ticks <= 0 || configuration.time_step <= 0.0) {
+        std::cerr << "distributed test ticks and time step must be positive" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.mppi.distributed) {
+        std::cerr << "distributed test workers are configured by the test" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.mppi.keep_best_rollouts != 0 || configuration.mppi.cost_scale_adaptation) {
+        std::cerr << "distributed test cannot compare kept rollouts or cost scale "
+                  << "adaptation with the local reference" << std::endl;
+        return nullptr;
+    }
+
+    if (!(configuration.tolerance >= 0.0)) {
+        std::cerr << "distributed test tolerance cannot be negative" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<DistributedTest>(new DistributedTest(configuration));
+}
+
+DistributedTest::DistributedTest(const Configuration &configuration)
+    : m_configuration(configuration)
+    , m_addresses()
+{
+    for (unsigned int worker = 0; worker < configuration.workers; ++worker) {
+        std::string name = "worker" + std::to_string(worker) + ".sock";
+        std::string address = std::filesystem::absolute(configuration.folder / name).string();
+
+        // Unix socket paths are limited in length, so fall back to a short
+        // path unique to the process if the folder is too deep.
+        if (address.size() >= sizeof(sockaddr_un::sun_path)) {
+            address = (
+                std::filesystem::temp_directory_path() /
+                ("distributed_" + std::to_string(getpid()) + "_" + name)
+            ).string();
+        }
+
+        m_addresses.push_back(address);
+    }
+}
+
+bool DistributedTest::run()
+{
+    std::vector<pid_t> children;
+    bool success = true;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_configuration.folder, error);
+    if (error) {
+        std::cerr << "failed to create distributed test folder " << m_configuration.folder
+                  << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    // Fork before any trajectory threads exist. Each worker listens before
+    // forking so that the coordinator can connect immediately.
+    for (const std::string &address : m_addresses) {
+        auto listener = distributed::Socket::listen(address);
+        if (!listener) {
+            success = false;
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "failed to fork distributed test worker" << std::endl;
+            success = false;
+            break;
+        }
+
+        if (pid == 0) {
+            bool served = true;
+            for (int run = 0; run < RUNS; ++run) {
+                auto connection = listener->accept();
+                served = served && connection && serve(*connection);
+            }
+            _exit(served ? 0 : 1);
+        }
+
+        children.push_back(pid);
+    }
+
+    std::array<MatrixXd, RUNS> results;
+
+    for (int index = 0; index < RUNS && success; ++index)
+        success = run(index, results[index]);
+
+    if (success && results[0] != results[1]) {
+        std::cerr << "distributed trajectory differs between runs with the same seed" << std::endl;
+        success = false;
+    }
+
+    // Workers exit once the coordinators disconnect. If a run failed, they
+    // may still be waiting for a connection.
+    for (pid_t child : children) {
+        if (!success)
+            kill(child, SIGTERM);
+
+        int status = 0;
+        waitpid(child, &status, 0);
+        success = success && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    for (const std::string &address : m_addresses)
+        std::filesystem::remove(address);
+
+    return success;
+}
+
+bool DistributedTest::serve(distributed::Socket &connection)
+{
+    auto dynamics = FrankaRidgeback::PinocchioDynamics::create(m_configuration.dynamics);
+    auto objective = FrankaRidgeback::TrackPoint::create(m_configuration.objective);
+
+    if (!dynamics || !objective) {
+        std::cerr << "failed to create distributed test worker model" << std::endl;
+        return false;
+    }
+
+    auto worker = distributed::Worker::create(
+        m_configuration.mppi,
+        std::move(dynamics),
+        std::move(objective)
+    );
+
+    return worker && worker->serve(connection);
+}
+
+std::unique_ptr<mppi::Trajectory> DistributedTest::make_trajectory(
+    const std::vector<std::string> &workers
+) {
+    mppi::Configuration configuration = m_configuration.mppi;
+    configuration.distributed = distributed::Coordinator::Configuration {
+        .workers = workers,
+        .rollouts = m_configuration.worker_rollouts,
+        .seed = m_configuration.seed,
+        .timeout = 5.0
+    };
+
+    // The reference rolls out the samples of every worker after its own.
+    if (workers.empty())
+        configuration.rollouts += (std::int64_t)m_addresses.size() * m_configuration.worker_rollouts;
+
+    auto dynamics = FrankaRidgeback::PinocchioDynamics::create(m_configuration.dynamics);
+    auto objective = FrankaRidgeback::TrackPoint::create(m_configuration.objective);
+
+    if (!dynamics || !objective) {
+        std::cerr << "failed to create distributed test model" << std::endl;
+        return nullptr;
+    }
+
+    return mppi::Trajectory::create(configuration, std::move(dynamics), std::move(objective));
+}
+
+bool DistributedTest::run(int run, MatrixXd &result)
+{
+    auto trajectory = make_trajectory(m_addresses);
+    auto reference = make_trajectory({});
+    auto plant = FrankaRidgeback::PinocchioDynamics::create(m_configuration.dynamics);
+
+    if (!trajectory || !reference || !plant) {
+        std::cerr << "failed to create distributed test trajectories" << std::endl;
+        return false;
+    }
+
+    plant->set_state(m_configuration.mppi.initial_state, 0.0);
+
+    auto updates = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / ("updates" + std::to_string(run) + ".csv"),
+        .header = logger::CSV::make_header(
+            "tick", "duration", "remote_rollouts", "cost", "reference_error"
+        )
+    });
+
+    if (!updates) {
+        std::cerr << "failed to create distributed test log" << std::endl;
+        return false;
+    }
+
+    Eigen::VectorXd state = m_configuration.mppi.initial_state;
+    Eigen::VectorXd control(trajectory->get_control_dof());
+    double time = 0.0;
+    double maximum_error = 0.0;
+
+    for (std::int64_t tick = 0; tick < m_configuration.ticks; ++tick) {
+        trajectory->update(state, time);
+        reference->update(state, time);
+
+        double error = (trajectory->trajectory() - reference->trajectory()).cwiseAbs().maxCoeff();
+        maximum_error = std::max(maximum_error, error);
+
+        updates->write(
+            tick,
+            trajectory->get_update_duration(),
+            trajectory->get_remote_rollout_count(),
+            trajectory->get_optimal_total_cost(),
+            error
+        );
+
+        // Close the loop with the plant.
+        trajectory->get(control, time);
+        state = plant->step(control, m_configuration.time_step);
+        time += m_configuration.time_step;
+    }
+
+    result = trajectory->trajectory();
+
+    std::cout << "run " << run << " maximum difference from the local reference "
+              << maximum_error << std::endl;
+
+    if (!(maximum_error <= m_configuration.tolerance)) {
+        std::cerr << "distributed trajectory differs from the local reference by "
+                  << maximum_error << ", more than " << m_configuration.tolerance << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "test/test.hpp"
+#include "controller/mppi.hpp"
+#include "distributed/socket.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+#include "frankaridgeback/objective/track_point.hpp"
+
+/**
+ * @brief Runs a closed loop with pinocchio dynamics where rollouts are
+ * distributed to worker processes forked on unix sockets, without the
+ * simulator.
+ *
+ * The loop is run twice with the same seed, and the test fails if the optimal
+ * trajectories differ. Each update is also made by a local reference
+ * trajectory rolling out the same seeded samples, and the test fails if the
+ * optimal controls differ by more than a tolerance.
+ */
+class DistributedTest : public RegisteredTest<DistributedTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "distributed";
+
+    struct Configuration {
+
+        /// The folder to write the update logs and worker sockets to.
+        std::filesystem::path folder;
+
+        /// The number of worker processes.
+        unsigned int workers;
+
+        /// The number of rollouts performed by each worker per update.
+        std::int64_t worker_rollouts;
+
+        /// The base seed of the rollout noise.
+        std::uint64_t seed;
+
+        /// The number of control ticks of each run.
+        std::int64_t ticks;
+
+        /// The simulated time step between ticks.
+        double time_step;
+
+        /// The largest difference of the optimal control from the local
+        /// reference, allowing for the order the remote rollouts are summed.
+        double tolerance;
+
+        /// The trajectory generator configuration, without workers. Kept
+        /// rollouts and cost scale adaptation only see the local rollouts, so
+        /// must be disabled to compare with the reference.
+        mppi::Configuration mppi;
+
+        /// The rollout and plant dynamics configuration.
+        FrankaRidgeback::PinocchioDynamics::Configuration dynamics;
+
+        /// The objective to optimise.
+        FrankaRidgeback::TrackPoint::Configuration objective;
+
+        // JSON conversion for distributed test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, workers, worker_rollouts, seed, ticks, time_step,
+            tolerance, mppi, dynamics, objective
+        )
+    };
+
+    /**
+     * @brief The default configuration of the distributed test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the distributed test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<DistributedTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the distributed test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<DistributedTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Start the workers, run the closed loop twice and compare the
+     * results with each other and the local reference.
+     *
+     * @returns If the test ran successfully, was deterministic and matched
+     * the reference.
+     */
+    bool run() override;
+
+private:
+
+    /// The number of times the closed loop is run.
+    static inline constexpr int RUNS = 2;
+
+    DistributedTest(const Configuration &configuration);
+
+    /**
+     * @brief Serve one run of the closed loop in a forked worker process.
+     * @param connection The connection to the coordinator.
+     * @returns If the worker served the run.
+     */
+    bool serve(distributed::Socket &connection);
+
+    /**
+     * @brief Run the closed loop with the distributed trajectory, updating
+     * the local reference from the same states.
+     *
+     * @param run The index of the run, for logging.
+     * @param result The final optimal control trajectory.
+     *
+     * @returns If the run succeeded and matched the reference.
+     */
+    bool run(int run, MatrixXd &result);
+
+    /**
+     * @brief Create a trajectory rolling out the seeded samples of the test.
+     *
+     * @param workers The worker addresses, or none for the local reference
+     * that rolls out the worker samples itself.
+     *
+     * @returns A pointer to the trajectory on success or nullptr on failure.
+     */
+    std::unique_ptr<mppi::Trajectory> make_trajectory(
+        const std::vector<std::string> &workers
+    );
+
+    /// The test configuration.
+    Configuration m_configuration;
+
+    /// The socket address of each worker.
+    std::vector<std::string> m_addresses;
+};
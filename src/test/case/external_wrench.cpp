@@ -1,6 +1,7 @@
 #include "test/case/external_wrench.hpp"
 
 #include "frankaridgeback/dynamics.hpp"
+#include "test/configuration.hpp"
 
 std::unique_ptr<ExternalWrenchTest> ExternalWrenchTest::create(Options &options)
 {
@@ -10,18 +11,15 @@ std::unique_ptr<ExternalWrenchTest> ExternalWrenchTest::create(Options &options)
 
     // If configuration overrides were provided, apply them based on the json
     // patch specification.
-    try {
-        if (!options.patch.is_null()) {
-            json json_configuration = configuration;
-            json_configuration.merge_patch(options.patch);
-            configuration = json_configuration;
-        }
-    }
-    catch (const json::exception &err) {
-        std::cerr << "error when patching json configuration: " << err.what() << std::endl;
-        std::cerr << "configuration was " << ((json)DEFAULT_CONFIGURATION).dump(4) << std::endl;
-        std::cerr << "patch was " << options.patch.dump(4) << std::endl;
-        return nullptr;
+    if (!options.patch.is_null()) {
+        json patch = {
+            {"duration", options.duration},
+            {"folder", options.folder}
+        };
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<ExternalWrenchTest>::apply(configuration, patch))
+            return nullptr;
     }
 
     return create(configuration);
@@ -0,0 +1,194 @@
+#include "test/case/generated.hpp"
+
+#include <array>
+#include <chrono>
+#include <random>
+
+#include "logging/csv.hpp"
+#include "test/configuration.hpp"
+
+const GeneratedDynamicsTest::Configuration GeneratedDynamicsTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .samples = 1000,
+    .seed = 1,
+    .time_step = 0.01,
+    .tolerance = 1e-6,
+    .pinocchio = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+    .generated = FrankaRidgeback::GeneratedDynamics::DEFAULT_CONFIGURATION
+};
+
+std::unique_ptr<GeneratedDynamicsTest> GeneratedDynamicsTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<GeneratedDynamicsTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<GeneratedDynamicsTest> GeneratedDynamicsTest::create(const Configuration &configuration)
+{
+    if (configuration.samples <= 0 || configuration.time_step <= 0.0) {
+        std::cerr << "generated dynamics test samples and time step must be positive" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.pinocchio.end_effector_frame != configuration.generated.end_effector_frame) {
+        std::cerr << "generated dynamics test must compare the same end effector frame" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.pinocchio.decoupled_base) {
+        std::cerr << "generated dynamics test must compare against the full pinocchio model" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<GeneratedDynamicsTest>(new GeneratedDynamicsTest(configuration));
+}
+
+GeneratedDynamicsTest::GeneratedDynamicsTest(const Configuration &configuration)
+    : m_configuration(configuration)
+{}
+
+bool GeneratedDynamicsTest::run()
+{
+    using namespace FrankaRidgeback;
+    using Clock = std::chrono::steady_clock;
+
+    auto pinocchio = PinocchioDynamics::create(m_configuration.pinocchio);
+    auto generated = GeneratedDynamics::create(m_configuration.generated);
+
+    if (!pinocchio || !generated) {
+        std::cerr << "failed to create generated dynamics test models" << std::endl;
+        return false;
+    }
+
+    auto log = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "generated.csv",
+        .header = logger::CSV::make_header(
+            "sample", "position_error", "orientation_error", "velocity_error",
+            "acceleration_error", "jacobian_error", "link_error", "step_error",
+            "pinocchio_duration", "generated_duration"
+        )
+    });
+
+    if (!log) {
+        std::cerr << "failed to create generated dynamics test log" << std::endl;
+        return false;
+    }
+
+    std::mt19937_64 generator(m_configuration.seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    auto random = [&](int size, double scale) {
+        return VectorXd(VectorXd::NullaryExpr(size, [&]() { return scale * uniform(generator); }));
+    };
+
+    // Frames placed independently of the dynamics, for the link origins.
+    const ::pinocchio::Model &model = *pinocchio->get_model();
+    ::pinocchio::Data reference(model);
+
+    std::array<::pinocchio::FrameIndex, (std::size_t)Link::_SIZE> links;
+    for (std::size_t link = 0; link < links.size(); ++link) {
+        if (!model.existFrame(LINK_NAMES[link])) {
+            std::cerr << "generated dynamics test model has no link " << LINK_NAMES[link] << std::endl;
+            return false;
+        }
+        links[link] = model.getFrameId(LINK_NAMES[link]);
+    }
+
+    double worst = 0.0;
+    double pinocchio_duration = 0.0;
+    double generated_duration = 0.0;
+
+    for (std::int64_t sample = 0; sample < m_configuration.samples; ++sample) {
+        State state = State::Zero();
+        state.position() = random(DoF::JOINTS, M_PI);
+        state.velocity() = random(DoF::JOINTS, 1.0);
+        state.available_energy().setConstant(m_configuration.pinocchio.energy);
+
+        Control control = random(DoF::CONTROL, 1.0);
+
+        pinocchio->set_state(state, 0.0);
+        generated->set_state(state, 0.0);
+
+        const EndEffectorState &expected = pinocchio->get_end_effector_state();
+        const EndEffectorState &actual = generated->get_end_effector_state();
+
+        double position_error = (actual.position - expected.position).cwiseAbs().maxCoeff();
+        double orientation_error = actual.orientation.angularDistance(expected.orientation);
+        double velocity_error = std::max(
+            (actual.linear_velocity - expected.linear_velocity).cwiseAbs().maxCoeff(),
+            (actual.angular_velocity - expected.angular_velocity).cwiseAbs().maxCoeff()
+        );
+        double acceleration_error = std::max(
+            (actual.linear_acceleration - expected.linear_acceleration).cwiseAbs().maxCoeff(),
+            (actual.angular_acceleration - expected.angular_acceleration).cwiseAbs().maxCoeff()
+        );
+        double jacobian_error = (actual.jacobian - expected.jacobian).cwiseAbs().maxCoeff();
+
+        ::pinocchio::framesForwardKinematics(model, reference, state.position());
+
+        double link_error = 0.0;
+        for (std::size_t link = 0; link < links.size(); ++link) {
+            const Vector3d &origin = reference.oMf[links[link]].translation();
+            link_error = std::max({
+                link_error,
+                (pinocchio->get_link_position((Link)link) - origin).cwiseAbs().maxCoeff(),
+                (generated->get_link_position((Link)link) - origin).cwiseAbs().maxCoeff()
+            });
+        }
+
+        auto start = Clock::now();
+        VectorXd expected_step = pinocchio->step(control, m_configuration.time_step);
+        auto middle = Clock::now();
+        VectorXd actual_step = generated->step(control, m_configuration.time_step);
+        auto end = Clock::now();
+
+        double step_error = (actual_step - expected_step).cwiseAbs().maxCoeff();
+        double pinocchio_step = std::chrono::duration<double>(middle - start).count();
+        double generated_step = std::chrono::duration<double>(end - middle).count();
+
+        pinocchio_duration += pinocchio_step;
+        generated_duration += generated_step;
+
+        worst = std::max({
+            worst, position_error, orientation_error, velocity_error,
+            acceleration_error, jacobian_error, link_error, step_error
+        });
+
+        log->write(
+            sample,
+            position_error,
+            orientation_error,
+            velocity_error,
+            acceleration_error,
+            jacobian_error,
+            link_error,
+            step_error,
+            pinocchio_step,
+            generated_step
+        );
+    }
+
+    double samples = (double)m_configuration.samples;
+    std::cout << "generated dynamics step " << generated_duration / samples * 1e6
+              << "us, pinocchio step " << pinocchio_duration / samples * 1e6
+              << "us, largest difference " << worst << std::endl;
+
+    if (worst > m_configuration.tolerance) {
+        std::cerr << "generated dynamics differ from pinocchio by " << worst
+                  << ", more than the tolerance " << m_configuration.tolerance << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <filesystem>
+
+#include "test/test.hpp"
+#include "frankaridgeback/generated_dynamics.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+
+/**
+ * @brief Validates the dynamics generated from the robot URDF against the
+ * pinocchio dynamics, without the simulator.
+ *
+ * Both dynamics are set to the same random states and stepped with the same
+ * random controls. The test fails if the end effector kinematics, the link
+ * origins or the stepped state differ by more than the tolerance, and logs the
+ * time taken by each step. The link origins of both dynamics are compared
+ * with frames placed directly by pinocchio.
+ */
+class GeneratedDynamicsTest : public RegisteredTest<GeneratedDynamicsTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "generated";
+
+    struct Configuration {
+
+        /// The folder to write the comparison log to.
+        std::filesystem::path folder;
+
+        /// The number of random states to compare.
+        std::int64_t samples;
+
+        /// The seed of the random states and controls.
+        std::uint64_t seed;
+
+        /// The time step of each compared step.
+        double time_step;
+
+        /// The largest absolute difference allowed between the dynamics.
+        double tolerance;
+
+        /// The reference pinocchio dynamics configuration.
+        FrankaRidgeback::PinocchioDynamics::Configuration pinocchio;
+
+        /// The generated dynamics configuration.
+        FrankaRidgeback::GeneratedDynamics::Configuration generated;
+
+        // JSON conversion for generated dynamics test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, samples, seed, time_step, tolerance, pinocchio, generated
+        )
+    };
+
+    /**
+     * @brief The default configuration of the generated dynamics test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the generated dynamics test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<GeneratedDynamicsTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the generated dynamics test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<GeneratedDynamicsTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Compare the dynamics at each sampled state.
+     * @returns If the dynamics agree to the tolerance.
+     */
+    bool run() override;
+
+private:
+
+    GeneratedDynamicsTest(const Configuration &configuration);
+
+    /// The test configuration.
+    Configuration m_configuration;
+};
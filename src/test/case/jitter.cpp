@@ -0,0 +1,183 @@
+#include "test/case/jitter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "logging/csv.hpp"
+#include "test/case/base.hpp"
+#include "test/configuration.hpp"
+
+const JitterTest::Configuration JitterTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .ticks = 100000,
+    .period = 0.0,
+    .time_step = 0.01,
+    .maximum_latency = 0.01,
+    .mppi = BaseTest::DEFAULT_CONFIGURATION.actor.mppi.configuration,
+    .dynamics = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+    .objective = FrankaRidgeback::TrackPoint::DEFAULT_CONFIGURATION
+};
+
+std::unique_ptr<JitterTest> JitterTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<JitterTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<JitterTest> JitterTest::create(const Configuration &configuration)
+{
+    if (configuration.ticks <= 0) {
+        std::cerr << "jitter test ticks must be positive" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.period < 0.0 || configuration.time_step <= 0.0) {
+        std::cerr << "jitter test period and time step must be positive" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.maximum_latency < 0.0) {
+        std::cerr << "jitter test maximum latency must not be negative" << std::endl;
+        return nullptr;
+    }
+
+    auto dynamics = FrankaRidgeback::PinocchioDynamics::create(configuration.dynamics);
+    if (!dynamics) {
+        std::cerr << "failed to create jitter test dynamics" << std::endl;
+        return nullptr;
+    }
+
+    auto plant = FrankaRidgeback::PinocchioDynamics::create(configuration.dynamics);
+    if (!plant) {
+        std::cerr << "failed to create jitter test plant" << std::endl;
+        return nullptr;
+    }
+
+    plant->set_state(configuration.mppi.initial_state, 0.0);
+
+    auto objective = FrankaRidgeback::TrackPoint::create(configuration.objective);
+    if (!objective) {
+        std::cerr << "failed to create jitter test objective" << std::endl;
+        return nullptr;
+    }
+
+    auto trajectory = mppi::Trajectory::create(
+        configuration.mppi,
+        std::move(dynamics),
+        std::move(objective)
+    );
+
+    if (!trajectory) {
+        std::cerr << "failed to create jitter test trajectory" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<JitterTest>(
+        new JitterTest(configuration, std::move(trajectory), std::move(plant))
+    );
+}
+
+JitterTest::JitterTest(
+    const Configuration &configuration,
+    std::unique_ptr<mppi::Trajectory> &&trajectory,
+    std::unique_ptr<FrankaRidgeback::PinocchioDynamics> &&plant
+  ) : m_configuration(configuration)
+    , m_trajectory(std::move(trajectory))
+    , m_plant(std::move(plant))
+    , m_latency(configuration.ticks, 0.0)
+{}
+
+bool JitterTest::run()
+{
+    using namespace std::chrono;
+
+    Eigen::VectorXd state = m_configuration.mppi.initial_state;
+    Eigen::VectorXd control(m_trajectory->get_control_dof());
+    double time = 0.0;
+
+    auto period = duration_cast<steady_clock::duration>(
+        duration<double>(m_configuration.period)
+    );
+    auto next = steady_clock::now();
+
+    for (std::int64_t tick = 0; tick < m_configuration.ticks; ++tick) {
+        if (m_configuration.period > 0.0) {
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+
+        auto start = steady_clock::now();
+        m_trajectory->update(state, time);
+        auto stop = steady_clock::now();
+
+        m_latency[tick] = duration<double>(stop - start).count();
+
+        // Close the loop with the plant.
+        m_trajectory->get(control, time);
+        state = m_plant->step(control, m_configuration.time_step);
+        time += m_configuration.time_step;
+    }
+
+    return log();
+}
+
+bool JitterTest::log()
+{
+    auto ticks = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "latency.csv",
+        .header = logger::CSV::make_header("tick", "latency")
+    });
+
+    auto summary = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "percentiles.csv",
+        .header = logger::CSV::make_header("percentile", "latency")
+    });
+
+    if (!ticks || !summary) {
+        std::cerr << "failed to create jitter test logs" << std::endl;
+        return false;
+    }
+
+    for (std::size_t tick = 0; tick < m_latency.size(); ++tick)
+        ticks->write(tick, m_latency[tick]);
+
+    std::vector<double> sorted = m_latency;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::cout << std::endl << "update latency (us):";
+
+    auto get_percentile = [&](double percentile) {
+        return sorted[(std::size_t)(percentile / 100.0 * (sorted.size() - 1))];
+    };
+
+    for (double percentile : {0.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0}) {
+        double latency = get_percentile(percentile);
+
+        summary->write(percentile, latency);
+        std::cout << " p" << percentile << " " << latency * 1e6;
+    }
+
+    std::cout << std::endl;
+
+    double tail = get_percentile(99.99);
+    if (m_configuration.maximum_latency > 0.0 && tail > m_configuration.maximum_latency) {
+        std::cerr << "p99.99 update latency " << tail * 1e6 << "us exceeds the maximum "
+                  << m_configuration.maximum_latency * 1e6 << "us" << std::endl;
+        return false;
+    }
+
+    return true;
+}
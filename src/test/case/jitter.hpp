@@ -0,0 +1,118 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "test/test.hpp"
+#include "controller/mppi.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+#include "frankaridgeback/objective/track_point.hpp"
+
+/**
+ * @brief Measures the distribution of trajectory update latency in a closed
+ * loop with pinocchio dynamics, without the simulator.
+ *
+ * Real time mode is enabled by patching `mppi.realtime`, for example
+ * `{"mppi": {"realtime": {"lock_memory": true, "worker_priority": 80,
+ * "control_priority": 90}}}`. The trajectory is created on the thread running
+ * the test, so the control priority applies to the closed loop.
+ *
+ * The test fails if the 99.99th percentile latency exceeds the bound.
+ */
+class JitterTest : public RegisteredTest<JitterTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "jitter";
+
+    struct Configuration {
+
+        /// The folder to write the latency logs to.
+        std::filesystem::path folder;
+
+        /// The number of control ticks to measure.
+        std::int64_t ticks;
+
+        /// The wall time between the start of each tick in seconds, or zero
+        /// to update back to back.
+        double period;
+
+        /// The simulated time step between ticks.
+        double time_step;
+
+        /// The largest 99.99th percentile update latency in seconds, or zero
+        /// for no bound.
+        double maximum_latency;
+
+        /// The trajectory generator configuration.
+        mppi::Configuration mppi;
+
+        /// The rollout and plant dynamics configuration.
+        FrankaRidgeback::PinocchioDynamics::Configuration dynamics;
+
+        /// The objective to optimise.
+        FrankaRidgeback::TrackPoint::Configuration objective;
+
+        // JSON conversion for jitter test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, ticks, period, time_step, maximum_latency, mppi, dynamics,
+            objective
+        )
+    };
+
+    /**
+     * @brief The default configuration of the jitter test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the jitter test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<JitterTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the jitter test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<JitterTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Run the closed loop and log the latency distribution.
+     * @returns If the test ran and the latency was within the bound.
+     */
+    bool run() override;
+
+private:
+
+    JitterTest(
+        const Configuration &configuration,
+        std::unique_ptr<mppi::Trajectory> &&trajectory,
+        std::unique_ptr<FrankaRidgeback::PinocchioDynamics> &&plant
+    );
+
+    /**
+     * @brief Write the per tick latency and its percentiles.
+     * @returns If the logs were written and the latency was within the bound.
+     */
+    bool log();
+
+    /// The test configuration.
+    Configuration m_configuration;
+
+    /// The trajectory generator under test.
+    std::unique_ptr<mppi::Trajectory> m_trajectory;
+
+    /// The dynamics the control is applied to.
+    std::unique_ptr<FrankaRidgeback::PinocchioDynamics> m_plant;
+
+    /// The update latency of each tick in seconds. Allocated on creation.
+    std::vector<double> m_latency;
+};
@@ -0,0 +1,589 @@
+#include "test/case/monte_carlo.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "analyse/statistics.hpp"
+#include "controller/concurrency.hpp"
+#include "logging/csv.hpp"
+#include "logging/file.hpp"
+#include "test/case/base.hpp"
+#include "test/case/external_wrench.hpp"
+#include "test/configuration.hpp"
+
+namespace {
+
+/// The quantiles of each metric estimated over the scenarios.
+const std::pair<const char *, double> QUANTILES[] = {
+    {"p5", 0.05}, {"p50", 0.5}, {"p95", 0.95}, {"p99", 0.99}
+};
+
+/**
+ * @brief The distribution of a metric, estimated in constant memory.
+ */
+class Distribution
+{
+public:
+
+    Distribution()
+    {
+        for (const auto &[name, quantile] : QUANTILES)
+            m_quantiles.emplace_back(quantile);
+    }
+
+    /**
+     * @brief Add a value to the distribution. Non-finite values are ignored.
+     */
+    void add(double value)
+    {
+        if (!std::isfinite(value))
+            return;
+
+        m_moments.add(value);
+        for (analyse::Quantile &quantile : m_quantiles)
+            quantile.add(value);
+    }
+
+    /**
+     * @brief Get the quantile at an index of QUANTILES.
+     */
+    double get(std::size_t index) const
+    {
+        return m_quantiles[index].get();
+    }
+
+    json describe() const
+    {
+        json description = {
+            {"count", m_moments.get_count()},
+            {"mean", m_moments.get_mean()},
+            {"deviation", m_moments.get_deviation()},
+            {"minimum", m_moments.get_minimum()},
+            {"maximum", m_moments.get_maximum()}
+        };
+
+        for (std::size_t i = 0; i < std::size(QUANTILES); ++i)
+            description[QUANTILES[i].first] = m_quantiles[i].get();
+
+        return description;
+    }
+
+private:
+
+    analyse::Moments m_moments;
+    std::vector<analyse::Quantile> m_quantiles;
+};
+
+const char *get_name(PositionTrajectory::Configuration::Type type)
+{
+    switch (type) {
+        case PositionTrajectory::Configuration::POINT: return "point";
+        case PositionTrajectory::Configuration::CIRCLE: return "circle";
+        case PositionTrajectory::Configuration::RECTANGLE: return "rectangle";
+        case PositionTrajectory::Configuration::LISSAJOUS: return "lissajous";
+        case PositionTrajectory::Configuration::FIGURE_EIGHT: return "figure_eight";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Check the configuration of a position trajectory type is provided.
+ */
+bool has_configuration(
+    const PositionTrajectory::Configuration &configuration,
+    PositionTrajectory::Configuration::Type type
+) {
+    switch (type) {
+        case PositionTrajectory::Configuration::POINT: return configuration.point.has_value();
+        case PositionTrajectory::Configuration::CIRCLE: return configuration.circle.has_value();
+        case PositionTrajectory::Configuration::RECTANGLE: return configuration.rectangle.has_value();
+        case PositionTrajectory::Configuration::LISSAJOUS: return configuration.lissajous.has_value();
+        case PositionTrajectory::Configuration::FIGURE_EIGHT: return configuration.figure_eight.has_value();
+    }
+    return false;
+}
+
+} // namespace
+
+const MonteCarloTest::Configuration MonteCarloTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .scenarios = 100,
+    .seed = 1,
+    .threads = 0,
+    .duration = 10.0,
+    .time_step = 0.01,
+    .randomisation = {
+        .trajectories = {
+            PositionTrajectory::Configuration::CIRCLE,
+            PositionTrajectory::Configuration::RECTANGLE,
+            PositionTrajectory::Configuration::LISSAJOUS,
+            PositionTrajectory::Configuration::FIGURE_EIGHT
+        },
+        .minimum_speed = 0.5,
+        .maximum_speed = 1.5,
+        .minimum_gain = 0.5,
+        .maximum_gain = 1.5,
+        .maximum_force_noise = 5.0
+    },
+    .trajectory = *ExternalWrenchTest::DEFAULT_CONFIGURATION.trajectory.position,
+    .force_pid = ExternalWrenchTest::DEFAULT_CONFIGURATION.force_pid,
+    .mppi = [] {
+        // Scenarios are run concurrently, so each uses few threads.
+        mppi::Configuration configuration = BaseTest::DEFAULT_CONFIGURATION.actor.mppi.configuration;
+        configuration.threads = 2;
+        return configuration;
+    }(),
+    .dynamics = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+    .forecast = BaseTest::DEFAULT_CONFIGURATION.actor.forecast->configuration,
+    .objective = FrankaRidgeback::AssistedManipulation::DEFAULT_CONFIGURATION
+};
+
+std::unique_ptr<MonteCarloTest> MonteCarloTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<MonteCarloTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<MonteCarloTest> MonteCarloTest::create(const Configuration &configuration)
+{
+    if (configuration.scenarios <= 0) {
+        std::cerr << "monte carlo test must run at least one scenario" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.duration <= 0.0 || configuration.time_step <= 0.0) {
+        std::cerr << "monte carlo test duration and time step must be positive" << std::endl;
+        return nullptr;
+    }
+
+    const Configuration::Randomisation &randomisation = configuration.randomisation;
+
+    if (randomisation.trajectories.empty()) {
+        std::cerr << "monte carlo test must select from at least one trajectory type" << std::endl;
+        return nullptr;
+    }
+
+    for (auto type : randomisation.trajectories) {
+        if (!has_configuration(configuration.trajectory, type)) {
+            std::cerr << "monte carlo test " << get_name(type)
+                      << " trajectory is not configured" << std::endl;
+            return nullptr;
+        }
+    }
+
+    if (randomisation.minimum_speed <= 0.0 || randomisation.minimum_speed > randomisation.maximum_speed) {
+        std::cerr << "monte carlo test speed range must be positive and ordered" << std::endl;
+        return nullptr;
+    }
+
+    if (randomisation.minimum_gain < 0.0 || randomisation.minimum_gain > randomisation.maximum_gain) {
+        std::cerr << "monte carlo test gain range must be non-negative and ordered" << std::endl;
+        return nullptr;
+    }
+
+    if (randomisation.maximum_force_noise < 0.0) {
+        std::cerr << "monte carlo test force noise cannot be negative" << std::endl;
+        return nullptr;
+    }
+
+    if (configuration.force_pid.n != 3) {
+        std::cerr << "monte carlo test force pid must be dof 3" << std::endl;
+        return nullptr;
+    }
+
+    // Check the models are valid before running every scenario.
+    if (!FrankaRidgeback::PinocchioDynamics::create(configuration.dynamics)) {
+        std::cerr << "failed to create monte carlo test dynamics" << std::endl;
+        return nullptr;
+    }
+
+    if (!FrankaRidgeback::AssistedManipulation::create(configuration.objective)) {
+        std::cerr << "failed to create monte carlo test objective" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<MonteCarloTest>(new MonteCarloTest(configuration));
+}
+
+MonteCarloTest::MonteCarloTest(const Configuration &configuration)
+    : m_configuration(configuration)
+    , m_ticks(std::max<std::int64_t>(
+        1, (std::int64_t)std::ceil(configuration.duration / configuration.time_step)
+    ))
+{}
+
+MonteCarloTest::Scenario MonteCarloTest::generate(std::uint64_t seed) const
+{
+    const Configuration::Randomisation &randomisation = m_configuration.randomisation;
+
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<std::size_t> type(0, randomisation.trajectories.size() - 1);
+    std::uniform_real_distribution<double> speed(randomisation.minimum_speed, randomisation.maximum_speed);
+    std::uniform_real_distribution<double> gain(randomisation.minimum_gain, randomisation.maximum_gain);
+    std::uniform_real_distribution<double> noise(0.0, randomisation.maximum_force_noise);
+
+    Scenario scenario;
+    scenario.seed = seed;
+    scenario.type = randomisation.trajectories[type(generator)];
+    scenario.speed = speed(generator);
+    scenario.gains = Vector3d(gain(generator), gain(generator), gain(generator));
+    scenario.force_noise = noise(generator);
+    return scenario;
+}
+
+bool MonteCarloTest::run()
+{
+    using namespace std::chrono;
+
+    std::vector<Scenario> scenarios(m_configuration.scenarios);
+    for (std::size_t i = 0; i < scenarios.size(); ++i)
+        scenarios[i] = generate(m_configuration.seed + i);
+
+    unsigned int threads = m_configuration.threads;
+    if (threads == 0) {
+        threads = std::max(
+            1u, std::thread::hardware_concurrency() / std::max(1u, m_configuration.mppi.threads)
+        );
+    }
+
+    std::vector<Result> results(scenarios.size());
+
+    // The update latency of every tick of every scenario.
+    std::mutex mutex;
+    Distribution latency;
+
+    auto start = steady_clock::now();
+
+    {
+        ThreadPool pool(threads);
+        std::vector<std::future<void>> futures;
+        futures.reserve(scenarios.size());
+
+        for (std::size_t i = 0; i < scenarios.size(); ++i) {
+            futures.push_back(pool.enqueue([this, i, &scenarios, &results, &mutex, &latency] {
+                std::vector<double> ticks;
+                ticks.reserve(m_ticks);
+
+                if (!run(scenarios[i], results[i], ticks))
+                    return;
+
+                std::lock_guard lock(mutex);
+                for (double value : ticks)
+                    latency.add(value);
+            }));
+        }
+
+        for (auto &future : futures)
+            future.wait();
+    }
+
+    double duration = duration_cast<microseconds>(steady_clock::now() - start).count() * 1e-6;
+
+    std::int64_t ran = std::count_if(results.begin(), results.end(), [](const Result &result) {
+        return result.ran;
+    });
+
+    // Each scenario has a different operator and rollout noise, so should end
+    // in a different plant state.
+    std::int64_t identical = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        for (std::size_t j = i + 1; j < results.size(); ++j) {
+            if (!results[i].ran || !results[j].ran)
+                continue;
+
+            if (results[i].final_state == results[j].final_state) {
+                std::cerr << "monte carlo scenarios " << scenarios[i].seed << " and "
+                          << scenarios[j].seed << " ended in the same plant state"
+                          << std::endl;
+                ++identical;
+            }
+        }
+    }
+
+    std::cout << std::endl << "ran " << ran << " of " << scenarios.size()
+              << " scenarios on " << threads << " threads in " << duration << "s"
+              << std::endl;
+
+    json summary = {
+        {"duration", duration},
+        {"threads", threads},
+        {"latency", latency.describe()},
+        {"identical", identical}
+    };
+
+    if (!log(scenarios, results, summary))
+        return false;
+
+    std::cout << "update latency (us) p50 " << latency.get(1) * 1e6
+              << " p99 " << latency.get(3) * 1e6 << std::endl;
+
+    return ran == (std::int64_t)scenarios.size() && identical == 0;
+}
+
+bool MonteCarloTest::run(
+    const Scenario &scenario,
+    Result &result,
+    std::vector<double> &latency
+) const {
+    PositionTrajectory::Configuration trajectory_configuration = m_configuration.trajectory;
+    trajectory_configuration.type = scenario.type;
+
+    switch (scenario.type) {
+        case PositionTrajectory::Configuration::POINT:
+            break;
+        case PositionTrajectory::Configuration::CIRCLE:
+            trajectory_configuration.circle->angular_velocity *= scenario.speed;
+            break;
+        case PositionTrajectory::Configuration::RECTANGLE:
+            trajectory_configuration.rectangle->velocity *= scenario.speed;
+            break;
+        case PositionTrajectory::Configuration::LISSAJOUS:
+            trajectory_configuration.lissajous->x_frequency *= scenario.speed;
+            trajectory_configuration.lissajous->y_frequency *= scenario.speed;
+            trajectory_configuration.lissajous->z_frequency *= scenario.speed;
+            break;
+        case PositionTrajectory::Configuration::FIGURE_EIGHT:
+            trajectory_configuration.figure_eight->frequency *= scenario.speed;
+            break;
+    }
+
+    controller::PID::Configuration pid_configuration = m_configuration.force_pid;
+    pid_configuration.kp *= scenario.gains[0];
+    pid_configuration.kd *= scenario.gains[1];
+    pid_configuration.ki *= scenario.gains[2];
+
+    auto position = PositionTrajectory::create(trajectory_configuration);
+    auto pid = controller::PID::create(pid_configuration);
+    auto plant = FrankaRidgeback::PinocchioDynamics::create(m_configuration.dynamics);
+    auto objective = FrankaRidgeback::AssistedManipulation::create(m_configuration.objective);
+
+    // The rollouts read the forecast of the operator wrench through the
+    // handle given to their dynamics.
+    std::unique_ptr<FrankaRidgeback::DynamicsForecast> forecast = nullptr;
+    if (auto forecast_dynamics = FrankaRidgeback::PinocchioDynamics::create(m_configuration.dynamics)) {
+        forecast = FrankaRidgeback::DynamicsForecast::create(
+            m_configuration.forecast,
+            std::move(forecast_dynamics)
+        );
+    }
+
+    std::unique_ptr<FrankaRidgeback::PinocchioDynamics> dynamics = nullptr;
+    if (forecast) {
+        dynamics = FrankaRidgeback::PinocchioDynamics::create(
+            m_configuration.dynamics,
+            forecast->create_handle()
+        );
+    }
+
+    if (!position || !pid || !forecast || !dynamics || !plant || !objective) {
+        std::cerr << "failed to create monte carlo scenario " << scenario.seed << std::endl;
+        return false;
+    }
+
+    plant->set_state(m_configuration.mppi.initial_state, 0.0);
+
+    auto trajectory = mppi::Trajectory::create(
+        m_configuration.mppi,
+        std::move(dynamics),
+        std::move(objective)
+    );
+
+    if (!trajectory) {
+        std::cerr << "failed to create monte carlo scenario " << scenario.seed
+                  << " trajectory" << std::endl;
+        return false;
+    }
+
+    trajectory->seed(scenario.seed);
+
+    // The force noise is drawn from a different sequence to the scenario.
+    std::mt19937_64 generator(~scenario.seed);
+    std::normal_distribution<double> noise(0.0, 1.0);
+
+    Eigen::VectorXd state = m_configuration.mppi.initial_state;
+    Eigen::VectorXd control(trajectory->get_control_dof());
+    FrankaRidgeback::Control operated;
+
+    double squared_error = 0.0, force = 0.0;
+    std::int64_t depleted = 0, ticks = 0;
+
+    result.minimum_energy = plant->get_tank_energy();
+
+    for (; ticks < m_ticks; ++ticks) {
+        double time = ticks * m_configuration.time_step;
+
+        // The operator pushes the end effector towards their reference.
+        const Vector3d &end_effector = plant->get_end_effector_state().position;
+        Vector3d reference = position->get_position(time);
+
+        pid->set_reference(reference);
+        pid->update(end_effector, time);
+
+        Vector6d wrench = Vector6d::Zero();
+        wrench.head<3>() = pid->get_control();
+        for (int i = 0; i < 3; ++i)
+            wrench[i] += scenario.force_noise * noise(generator);
+
+        double error = (reference - end_effector).norm();
+        squared_error += error * error;
+        result.maximum_error = std::max(result.maximum_error, error);
+        force += wrench.head<3>().norm();
+
+        // The operator force is measured as the end effector wrench, and
+        // forecast over the rollout horison.
+        state.segment<FrankaRidgeback::DoF::EXTERNAL_FORCE>(2 * FrankaRidgeback::DoF::JOINTS) = wrench.head<3>();
+        forecast->observe_wrench(wrench, time);
+        forecast->forecast(state, time);
+
+        trajectory->update(state, time);
+        latency.push_back(trajectory->get_update_duration());
+
+        // Close the loop with the plant, which the operator pushes on. The
+        // pinocchio dynamics do not simulate an end effector wrench, so the
+        // arm joint torques of the wrench are added to the arm torque control.
+        trajectory->get(control, time);
+        operated = control;
+        operated.arm_velocity() += (
+            plant->get_end_effector_state().jacobian.transpose() * wrench
+        ).segment<FrankaRidgeback::DoF::ARM>(FrankaRidgeback::DoF::BASE);
+        state = plant->step(operated, m_configuration.time_step);
+
+        double energy = plant->get_tank_energy();
+        result.minimum_energy = std::min(result.minimum_energy, energy);
+        depleted += energy <= 0.0;
+
+        if (!state.allFinite()) {
+            result.diverged = true;
+            ++ticks;
+            break;
+        }
+    }
+
+    result.ran = true;
+    result.final_state = state;
+    result.rms_error = std::sqrt(squared_error / (double)ticks);
+    result.mean_force = force / (double)ticks;
+    result.final_energy = plant->get_tank_energy();
+    result.depleted = (double)depleted / (double)ticks;
+
+    // The latency percentiles of a single scenario are exact.
+    std::vector<double> sorted = latency;
+    std::sort(sorted.begin(), sorted.end());
+
+    result.latency_p50 = sorted[(std::size_t)(0.5 * (sorted.size() - 1))];
+    result.latency_p99 = sorted[(std::size_t)(0.99 * (sorted.size() - 1))];
+    result.latency_maximum = sorted.back();
+    return true;
+}
+
+bool MonteCarloTest::log(
+    const std::vector<Scenario> &scenarios,
+    const std::vector<Result> &results,
+    json summary
+) const {
+    auto csv = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / "scenarios.csv",
+        .header = logger::CSV::make_header(
+            "seed", "trajectory", "speed", "kp_scale", "kd_scale", "ki_scale",
+            "force_noise", "ran", "diverged", "rms_error", "maximum_error",
+            "mean_force", "minimum_energy", "final_energy", "depleted",
+            "latency_p50", "latency_p99", "latency_maximum"
+        )
+    });
+
+    auto file = logger::File::create(m_configuration.folder / "summary.json");
+
+    if (!csv || !file) {
+        std::cerr << "failed to create monte carlo test logs" << std::endl;
+        return false;
+    }
+
+    const std::pair<const char *, double Result::*> METRICS[] = {
+        {"rms_error", &Result::rms_error},
+        {"maximum_error", &Result::maximum_error},
+        {"mean_force", &Result::mean_force},
+        {"minimum_energy", &Result::minimum_energy},
+        {"final_energy", &Result::final_energy},
+        {"depleted", &Result::depleted},
+        {"latency_p50", &Result::latency_p50},
+        {"latency_p99", &Result::latency_p99},
+        {"latency_maximum", &Result::latency_maximum}
+    };
+
+    std::vector<Distribution> distributions(std::size(METRICS));
+    std::int64_t ran = 0, diverged = 0;
+
+    // Scenarios are added in order, so the estimates do not depend on the
+    // order the scenarios finished in.
+    for (std::size_t i = 0; i < scenarios.size(); ++i) {
+        const Scenario &scenario = scenarios[i];
+        const Result &result = results[i];
+
+        csv->write(
+            scenario.seed,
+            get_name(scenario.type),
+            scenario.speed,
+            scenario.gains[0],
+            scenario.gains[1],
+            scenario.gains[2],
+            scenario.force_noise,
+            result.ran,
+            result.diverged,
+            result.rms_error,
+            result.maximum_error,
+            result.mean_force,
+            result.minimum_energy,
+            result.final_energy,
+            result.depleted,
+            result.latency_p50,
+            result.latency_p99,
+            result.latency_maximum
+        );
+
+        if (!result.ran)
+            continue;
+
+        ++ran;
+        diverged += result.diverged;
+
+        for (std::size_t j = 0; j < std::size(METRICS); ++j)
+            distributions[j].add(result.*METRICS[j].second);
+    }
+
+    summary["scenarios"] = scenarios.size();
+    summary["ran"] = ran;
+    summary["diverged"] = diverged;
+
+    for (std::size_t j = 0; j < std::size(METRICS); ++j)
+        summary["metrics"][METRICS[j].first] = distributions[j].describe();
+
+    file->get_stream() << summary.dump(4);
+
+    // Print the spread of the tracking, force and energy metrics.
+    std::cout << "diverged " << diverged << " of " << ran << std::endl;
+    for (std::size_t j = 0; j < 4; ++j) {
+        std::cout << METRICS[j].first
+                  << " p5 " << distributions[j].get(0)
+                  << " p50 " << distributions[j].get(1)
+                  << " p95 " << distributions[j].get(2) << std::endl;
+    }
+
+    return true;
+}
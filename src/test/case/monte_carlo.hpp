@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "test/test.hpp"
+#include "controller/mppi.hpp"
+#include "controller/pid.hpp"
+#include "controller/trajectory.hpp"
+#include "frankaridgeback/dynamics.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+#include "frankaridgeback/objective/assisted_manipulation.hpp"
+
+/**
+ * @brief Evaluates the assistance over many randomised operators applying an
+ * external wrench, with pinocchio dynamics as the plant, without the
+ * simulator.
+ *
+ * Each scenario is generated from its seed. The operator follows a position
+ * trajectory of a randomly selected type and speed with a force pid
+ * controller of randomly scaled gains, and their force is perturbed by
+ * gaussian noise of a random deviation. The force is applied to the arm
+ * joints of the plant through the end effector jacobian, since the pinocchio
+ * dynamics do not simulate an end effector wrench, so it is drawn from the
+ * plant energy tank like the arm torque control. It is measured as the end
+ * effector wrench in the state, and observed by the dynamics forecast of the
+ * trajectory generator, as in the external wrench test.
+ *
+ * Scenarios are run concurrently, each with its own trajectory generator,
+ * whose rollout noise is seeded from the scenario seed. Tracking error, user
+ * force, energy tank and update latency metrics of each scenario are written
+ * to `scenarios.csv`, and their distribution over the scenarios to
+ * `summary.json`, estimated with streaming quantiles. The test fails if two
+ * scenarios end in the same plant state, since the operator and rollout noise
+ * then have no effect on the closed loop.
+ */
+class MonteCarloTest : public RegisteredTest<MonteCarloTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "monte_carlo";
+
+    struct Configuration {
+
+        /// The folder to write the scenario metrics and summary to.
+        std::filesystem::path folder;
+
+        /// The number of scenarios to run.
+        std::int64_t scenarios;
+
+        /// The seed of the first scenario. Each subsequent scenario uses the
+        /// next seed.
+        std::uint64_t seed;
+
+        /// The number of scenarios run concurrently, or zero for the number of
+        /// cores divided by the trajectory generator threads.
+        unsigned int threads;
+
+        /// The simulated duration of each scenario in seconds.
+        double duration;
+
+        /// The simulated time step between ticks.
+        double time_step;
+
+        /// The ranges the operator behaviour of each scenario is drawn from.
+        struct Randomisation {
+
+            /// The position trajectory types to select from uniformly.
+            std::vector<PositionTrajectory::Configuration::Type> trajectories;
+
+            /// The minimum scale of the speed of the position trajectory.
+            double minimum_speed;
+
+            /// The maximum scale of the speed of the position trajectory.
+            double maximum_speed;
+
+            /// The minimum scale of each gain of the force pid.
+            double minimum_gain;
+
+            /// The maximum scale of each gain of the force pid.
+            double maximum_gain;
+
+            /// The maximum standard deviation of the noise added to the
+            /// operator force, in newtons.
+            double maximum_force_noise;
+
+            // JSON conversion for monte carlo randomisation configuration.
+            NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+                Randomisation,
+                trajectories, minimum_speed, maximum_speed, minimum_gain,
+                maximum_gain, maximum_force_noise
+            )
+        };
+
+        /// The ranges the operator behaviour is drawn from.
+        Randomisation randomisation;
+
+        /// The position trajectories the selected type is configured from.
+        PositionTrajectory::Configuration trajectory;
+
+        /// The operator force pid, before the gains are scaled.
+        controller::PID::Configuration force_pid;
+
+        /// The trajectory generator configuration.
+        mppi::Configuration mppi;
+
+        /// The rollout, forecast and plant dynamics configuration.
+        FrankaRidgeback::PinocchioDynamics::Configuration dynamics;
+
+        /// The forecast of the operator wrench over the rollout horison.
+        FrankaRidgeback::DynamicsForecast::Configuration forecast;
+
+        /// The objective to optimise.
+        FrankaRidgeback::AssistedManipulation::Configuration objective;
+
+        // JSON conversion for monte carlo test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, scenarios, seed, threads, duration, time_step,
+            randomisation, trajectory, force_pid, mppi, dynamics, forecast,
+            objective
+        )
+    };
+
+    /**
+     * @brief The default configuration of the monte carlo test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the monte carlo test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<MonteCarloTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the monte carlo test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<MonteCarloTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Run every scenario and log the metrics and their distribution.
+     * @returns If every scenario ran.
+     */
+    bool run() override;
+
+private:
+
+    /**
+     * @brief The operator behaviour of a scenario.
+     */
+    struct Scenario {
+
+        /// The seed the scenario was generated from.
+        std::uint64_t seed;
+
+        /// The type of the position trajectory.
+        PositionTrajectory::Configuration::Type type;
+
+        /// The scale of the speed of the position trajectory.
+        double speed;
+
+        /// The scale of the proportional, derivative and integral gains.
+        Vector3d gains;
+
+        /// The standard deviation of the noise added to the force.
+        double force_noise;
+    };
+
+    /**
+     * @brief The metrics of a scenario.
+     */
+    struct Result {
+
+        /// If the scenario ran.
+        bool ran = false;
+
+        /// If the plant state became non-finite, ending the scenario.
+        bool diverged = false;
+
+        /// The root mean square distance of the end effector from the
+        /// operator reference.
+        double rms_error = 0.0;
+
+        /// The maximum distance of the end effector from the operator
+        /// reference.
+        double maximum_error = 0.0;
+
+        /// The mean magnitude of the operator force.
+        double mean_force = 0.0;
+
+        /// The minimum energy in the energy tank.
+        double minimum_energy = 0.0;
+
+        /// The energy in the energy tank at the end of the scenario.
+        double final_energy = 0.0;
+
+        /// The fraction of ticks the energy tank was empty.
+        double depleted = 0.0;
+
+        /// The median trajectory update latency in seconds.
+        double latency_p50 = 0.0;
+
+        /// The 99th percentile trajectory update latency in seconds.
+        double latency_p99 = 0.0;
+
+        /// The maximum trajectory update latency in seconds.
+        double latency_maximum = 0.0;
+
+        /// The plant state at the end of the scenario.
+        Eigen::VectorXd final_state;
+    };
+
+    MonteCarloTest(const Configuration &configuration);
+
+    /**
+     * @brief Generate the operator behaviour of a scenario from its seed.
+     */
+    Scenario generate(std::uint64_t seed) const;
+
+    /**
+     * @brief Run a scenario in closed loop.
+     *
+     * @param scenario The operator behaviour of the scenario.
+     * @param result The metrics of the scenario.
+     * @param latency Buffer for the update latency of each tick.
+     *
+     * @returns If the scenario was created and ran.
+     */
+    bool run(const Scenario &scenario, Result &result, std::vector<double> &latency) const;
+
+    /**
+     * @brief Write the metrics of each scenario and their distribution.
+     *
+     * @param scenarios The operator behaviour of each scenario.
+     * @param results The metrics of each scenario.
+     * @param summary The summary of the run, to add the distribution of each
+     * metric to.
+     *
+     * @returns If the logs were written.
+     */
+    bool log(
+        const std::vector<Scenario> &scenarios,
+        const std::vector<Result> &results,
+        json summary
+    ) const;
+
+    /// The test configuration.
+    Configuration m_configuration;
+
+    /// The number of ticks of each scenario.
+    std::int64_t m_ticks;
+};
@@ -0,0 +1,229 @@
+#include "test/case/prepared.hpp"
+
+#include <random>
+#include <thread>
+
+#include "logging/csv.hpp"
+#include "test/case/base.hpp"
+#include "test/configuration.hpp"
+
+const PreparedCostTest::Configuration PreparedCostTest::DEFAULT_CONFIGURATION {
+    .folder = "",
+    .samples = 100,
+    .seed = 1,
+    .steps = 100,
+    .time_step = 0.01,
+    .threads = 4,
+    .tolerance = 1e-12,
+    .dynamics = FrankaRidgeback::PinocchioDynamics::DEFAULT_CONFIGURATION,
+    .forecast = BaseTest::DEFAULT_CONFIGURATION.actor.forecast->configuration,
+    .assisted_manipulation = FrankaRidgeback::AssistedManipulation::DEFAULT_CONFIGURATION,
+    .track_trajectory = FrankaRidgeback::TrackTrajectory::DEFAULT_CONFIGURATION
+};
+
+std::unique_ptr<PreparedCostTest> PreparedCostTest::create(Options &options)
+{
+    Configuration configuration = DEFAULT_CONFIGURATION;
+    configuration.folder = options.folder;
+
+    // If configuration overrides were provided, apply them based on the json
+    // patch specification.
+    if (!options.patch.is_null()) {
+        json patch = {{"folder", options.folder}};
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<PreparedCostTest>::apply(configuration, patch))
+            return nullptr;
+    }
+
+    return create(configuration);
+}
+
+std::unique_ptr<PreparedCostTest> PreparedCostTest::create(const Configuration &configuration)
+{
+    if (configuration.samples <= 0 || configuration.steps <= 0 ||
+        configuration.time_step <= 0.0 || configuration.threads == 0) {
+        std::cerr << "prepared cost test samples, steps, time step and threads must be positive" << std::endl;
+        return nullptr;
+    }
+
+    return std::unique_ptr<PreparedCostTest>(new PreparedCostTest(configuration));
+}
+
+PreparedCostTest::PreparedCostTest(const Configuration &configuration)
+    : m_configuration(configuration)
+{}
+
+bool PreparedCostTest::run()
+{
+    using namespace FrankaRidgeback;
+
+    bool success = true;
+
+    // Each pair is created separately, so they do not share prepared steps.
+    {
+        auto prepared = AssistedManipulation::create(m_configuration.assisted_manipulation);
+        auto unprepared = AssistedManipulation::create(m_configuration.assisted_manipulation);
+
+        if (!prepared || !unprepared) {
+            std::cerr << "failed to create assisted manipulation objectives" << std::endl;
+            return false;
+        }
+
+        success &= compare("assisted_manipulation", *prepared, *unprepared);
+    }
+
+    {
+        auto prepared = TrackTrajectory::create(m_configuration.track_trajectory);
+        auto unprepared = TrackTrajectory::create(m_configuration.track_trajectory);
+
+        if (!prepared || !unprepared) {
+            std::cerr << "failed to create track trajectory objectives" << std::endl;
+            return false;
+        }
+
+        success &= compare("track_trajectory", *prepared, *unprepared);
+    }
+
+    return success;
+}
+
+bool PreparedCostTest::compare(
+    const std::string &name,
+    mppi::Cost &prepared,
+    mppi::Cost &unprepared
+) {
+    using namespace FrankaRidgeback;
+
+    // The objectives read the forecast of the observed wrench through the
+    // handle given to the rollout dynamics.
+    std::unique_ptr<DynamicsForecast> forecast = nullptr;
+    if (auto forecast_dynamics = PinocchioDynamics::create(m_configuration.dynamics)) {
+        forecast = DynamicsForecast::create(
+            m_configuration.forecast,
+            std::move(forecast_dynamics)
+        );
+    }
+
+    std::unique_ptr<PinocchioDynamics> dynamics = nullptr;
+    if (forecast)
+        dynamics = PinocchioDynamics::create(m_configuration.dynamics, forecast->create_handle());
+
+    if (!forecast || !dynamics) {
+        std::cerr << "failed to create prepared cost test dynamics" << std::endl;
+        return false;
+    }
+
+    // The copies evaluating each rollout concurrently, sharing the prepared
+    // steps of the prepared objective.
+    std::vector<std::unique_ptr<mppi::Dynamics>> copy_dynamics;
+    std::vector<std::unique_ptr<mppi::Cost>> copy_objective;
+    for (unsigned int thread = 0; thread < m_configuration.threads; ++thread) {
+        copy_dynamics.push_back(dynamics->copy());
+        copy_objective.push_back(prepared.copy());
+    }
+
+    auto log = logger::CSV::create(logger::CSV::Configuration{
+        .path = m_configuration.folder / (name + ".csv"),
+        .header = logger::CSV::make_header("sample", "steps", "total_cost", "largest_difference")
+    });
+
+    if (!log) {
+        std::cerr << "failed to create prepared cost test log" << std::endl;
+        return false;
+    }
+
+    // Every objective is compared over the same samples.
+    std::mt19937_64 generator(m_configuration.seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    auto random = [&](int size, double scale) {
+        return VectorXd(VectorXd::NullaryExpr(size, [&]() { return scale * uniform(generator); }));
+    };
+
+    std::vector<double> expected;
+    std::vector<double> largest(m_configuration.threads);
+    double worst = 0.0;
+
+    for (std::int64_t sample = 0; sample < m_configuration.samples; ++sample) {
+        std::int64_t steps = (sample % 2 == 0)
+            ? m_configuration.steps
+            : std::max<std::int64_t>(m_configuration.steps / 2, 1);
+
+        double time = (double)sample * m_configuration.time_step * (double)m_configuration.steps;
+
+        State state = State::Zero();
+        state.position() = m_configuration.dynamics.initial_state.position() + random(DoF::JOINTS, 0.2);
+        state.velocity() = random(DoF::JOINTS, 0.5);
+        state.available_energy().setConstant(m_configuration.dynamics.energy);
+
+        Vector6d wrench = random(6, 10.0);
+        forecast->observe_wrench(wrench, time);
+        forecast->forecast(state, time);
+
+        Eigen::MatrixXd controls(DoF::CONTROL, steps);
+        for (std::int64_t step = 0; step < steps; ++step)
+            controls.col(step) = random(DoF::CONTROL, 1.0);
+
+        // The cost of each step of the unprepared objective.
+        dynamics->set_state(state, time);
+        unprepared.reset(time);
+        expected.resize(steps);
+
+        double step_time = time;
+        double total = 0.0;
+        for (std::int64_t step = 0; step < steps; ++step) {
+            Eigen::VectorXd control = controls.col(step);
+            Eigen::VectorXd rollout_state = dynamics->step(control, m_configuration.time_step);
+            expected[step] = unprepared.get_cost(rollout_state, control, dynamics.get(), step_time);
+            total += expected[step];
+            step_time += m_configuration.time_step;
+        }
+
+        // Prepared for the step times as computed by the trajectory.
+        Eigen::VectorXd times = time + Eigen::VectorXd::LinSpaced(
+            steps, 0.0, (double)(steps - 1)
+        ).array() * m_configuration.time_step;
+
+        prepared.prepare(times, dynamics.get());
+
+        std::vector<std::thread> threads;
+        for (unsigned int thread = 0; thread < m_configuration.threads; ++thread) {
+            threads.emplace_back([&, thread]() {
+                mppi::Dynamics *copy = copy_dynamics[thread].get();
+                mppi::Cost *objective = copy_objective[thread].get();
+
+                copy->set_state(state, time);
+                objective->reset(time);
+                largest[thread] = 0.0;
+
+                double step_time = time;
+                for (std::int64_t step = 0; step < steps; ++step) {
+                    Eigen::VectorXd control = controls.col(step);
+                    Eigen::VectorXd rollout_state = copy->step(control, m_configuration.time_step);
+                    double actual = objective->get_cost(rollout_state, control, copy, step_time);
+                    largest[thread] = std::max(largest[thread], std::abs(actual - expected[step]));
+                    step_time += m_configuration.time_step;
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        double difference = *std::max_element(largest.begin(), largest.end());
+        worst = std::max(worst, difference);
+        log->write(sample, steps, total, difference);
+    }
+
+    std::cout << "largest difference between prepared and unprepared " << name
+              << " costs " << worst << std::endl;
+
+    if (!(worst <= m_configuration.tolerance)) {
+        std::cerr << "prepared " << name << " costs differ from unprepared costs by "
+                  << worst << ", more than the tolerance " << m_configuration.tolerance
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
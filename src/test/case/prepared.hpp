@@ -0,0 +1,131 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "test/test.hpp"
+#include "frankaridgeback/dynamics.hpp"
+#include "frankaridgeback/pinocchio_dynamics.hpp"
+#include "frankaridgeback/objective/assisted_manipulation.hpp"
+#include "frankaridgeback/objective/track_trajectory.hpp"
+
+/**
+ * @brief Validates that preparing the time dependent parts of each objective
+ * once per update does not change its cost, without the simulator.
+ *
+ * The assisted manipulation and track trajectory objectives are each compared
+ * in the same way. From each random state and observed wrench, the wrench is
+ * forecast, and the objective is prepared for the step times of a rollout as
+ * computed by the trajectory. Copies sharing the prepared objective then
+ * evaluate the same rollout concurrently, as the rollouts of the trajectory
+ * generator do. Each copy is compared with another objective that is never
+ * prepared. The rollout step times are accumulated rather than computed as by
+ * the trajectory, so they may differ from the prepared times by rounding. The
+ * number of steps alternates between samples, so the prepared steps take
+ * their size from the prepared times. The test fails if the cost of any step
+ * of any copy differs by more than the tolerance.
+ */
+class PreparedCostTest : public RegisteredTest<PreparedCostTest>
+{
+public:
+
+    static inline constexpr const char *TEST_NAME = "prepared";
+
+    struct Configuration {
+
+        /// The folder to write the comparison logs to.
+        std::filesystem::path folder;
+
+        /// The number of random rollouts to compare for each objective.
+        std::int64_t samples;
+
+        /// The seed of the random states, wrenches and controls.
+        std::uint64_t seed;
+
+        /// The number of steps of the longest rollout. Every other rollout
+        /// has half as many steps.
+        std::int64_t steps;
+
+        /// The time step of each rollout step.
+        double time_step;
+
+        /// The number of copies evaluating each rollout concurrently.
+        unsigned int threads;
+
+        /// The largest absolute difference allowed between the step costs.
+        double tolerance;
+
+        /// The rollout and forecast dynamics configuration.
+        FrankaRidgeback::PinocchioDynamics::Configuration dynamics;
+
+        /// The forecast of the observed wrench over the rollout.
+        FrankaRidgeback::DynamicsForecast::Configuration forecast;
+
+        /// The assisted manipulation objective to compare.
+        FrankaRidgeback::AssistedManipulation::Configuration assisted_manipulation;
+
+        /// The track trajectory objective to compare.
+        FrankaRidgeback::TrackTrajectory::Configuration track_trajectory;
+
+        // JSON conversion for prepared cost test configuration.
+        NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+            Configuration,
+            folder, samples, seed, steps, time_step, threads, tolerance,
+            dynamics, forecast, assisted_manipulation, track_trajectory
+        )
+    };
+
+    /**
+     * @brief The default configuration of the prepared cost test.
+     */
+    static const Configuration DEFAULT_CONFIGURATION;
+
+    /**
+     * @brief Create an instance of the prepared cost test.
+     *
+     * @param options The test options. The configuration overrides from the
+     * default configuration.
+     *
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<PreparedCostTest> create(Options &options);
+
+    /**
+     * @brief Create an instance of the prepared cost test.
+     *
+     * @param configuration The configuration of the test.
+     * @returns A pointer to the test on success or nullptr on failure.
+     */
+    static std::unique_ptr<PreparedCostTest> create(const Configuration &configuration);
+
+    /**
+     * @brief Compare the prepared and unprepared costs of each objective.
+     * @returns If the costs agree to the tolerance.
+     */
+    bool run() override;
+
+private:
+
+    PreparedCostTest(const Configuration &configuration);
+
+    /**
+     * @brief Compare the prepared and unprepared costs of an objective over
+     * the random rollouts, and log the largest difference of each rollout to
+     * `<name>.csv`.
+     *
+     * @param name The name of the objective.
+     * @param prepared The objective to prepare. Copied for each thread.
+     * @param unprepared The objective to never prepare, not sharing prepared
+     * steps with the prepared objective.
+     *
+     * @returns If the costs agree to the tolerance.
+     */
+    bool compare(
+        const std::string &name,
+        mppi::Cost &prepared,
+        mppi::Cost &unprepared
+    );
+
+    /// The test configuration.
+    Configuration m_configuration;
+};
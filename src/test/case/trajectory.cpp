@@ -1,5 +1,7 @@
 #include "test/case/trajectory.hpp"
 
+#include "test/configuration.hpp"
+
 const TrajectoryTest::Configuration TrajectoryTest::DEFAULT_CONFIGURATION {
     .duration = 15.0,
     .position = PositionTrajectory::Configuration {
@@ -25,18 +27,14 @@ std::unique_ptr<TrajectoryTest> TrajectoryTest::create(Options &options)
 
     // If configuration overrides were provided, apply them based on the json
     // patch specification.
-    try {
-        if (!options.patch.is_null()) {
-            json json_configuration = DEFAULT_CONFIGURATION;
-            json_configuration.merge_patch(options.patch);
-            configuration = json_configuration;
-        }
-    }
-    catch (const json::exception &err) {
-        std::cerr << "error when patching json configuration: " << err.what() << std::endl;
-        std::cerr << "configuration was " << ((json)DEFAULT_CONFIGURATION).dump(4) << std::endl;
-        std::cerr << "patch was " << options.patch.dump(4) << std::endl;
-        return nullptr;
+    if (!options.patch.is_null()) {
+        json patch = {
+            {"duration", options.duration}
+        };
+        patch.merge_patch(options.patch);
+
+        if (!ConfigurationPatcher<TrajectoryTest>::apply(configuration, patch))
+            return nullptr;
     }
 
     return create(configuration);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * @brief Applies json patches to test configurations.
+ *
+ * The json form of the default configuration is serialised once per process
+ * and shared by every patch.
+ *
+ * @tparam Test The test, with a static `DEFAULT_CONFIGURATION` of its
+ * `Configuration`, which has json conversion.
+ */
+template<typename Test>
+class ConfigurationPatcher
+{
+public:
+
+    using Configuration = typename Test::Configuration;
+
+    /**
+     * @brief Get the json form of the default configuration.
+     * @note Serialised on first use since static initialisation order is
+     * undefined.
+     */
+    static const json &get_default()
+    {
+        static const json s_default = Test::DEFAULT_CONFIGURATION;
+        return s_default;
+    }
+
+    /**
+     * @brief Patch the default configuration.
+     *
+     * @param configuration The configuration to write the result into.
+     * @param patch The json merge patch applied to the default configuration.
+     *
+     * @returns If the patch was applied successfully. The configuration is
+     * unchanged on failure.
+     */
+    static bool apply(Configuration &configuration, const json &patch)
+    {
+        json patched = get_default();
+
+        try {
+            patched.merge_patch(patch);
+            configuration = patched;
+        }
+        catch (const json::exception &err) {
+            std::cerr << "error when patching json configuration: " << err.what() << std::endl;
+            std::cerr << "configuration was " << get_default().dump(4) << std::endl;
+            std::cerr << "patch was " << patch.dump(4) << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+};
@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "test/case/angles.hpp"
@@ -14,6 +15,7 @@
 #include "test/case/reach.hpp"
 #include "test/case/rectangle.hpp"
 #include "test/case/slerp.hpp"
+#include "test/runner.hpp"
 #include "test/test.hpp"
 
 /**
@@ -106,6 +108,8 @@ int main(int argc, char **argv)
     // Prints usage diagnostics for command line errors.
     auto usage = [argc, argv](std::string reason) /* [[noreturn]] */ {
         std::cerr << "usage: "<< argv[0] << " --test <string> --out <path> [--config <json>]" << std::endl;
+        std::cerr << "       "<< argv[0] << " (-a | --test <string>[:<cpus>] ...) --out <path> [--config <json>]"
+                  << " [--cpus <int>] [--timeout <seconds>] [--port <int>] [--junit <path>] [--json <path>]" << std::endl;
 
         std::cerr << "ran: ";
         for (int i = 0; i < argc; i++)
@@ -133,8 +137,11 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    // Run tests concurrently in subprocesses if running more than one.
+    bool concurrent = flags.contains('a') || (args.contains("test") && args["test"].size() > 1);
+
     // Must supply test.
-    if (!args.contains("test") || args["test"].size() != 1) 
+    if (!concurrent && (!args.contains("test") || args["test"].size() != 1))
         usage("--test must be specified");
 
     // Must supply output folder.
@@ -154,5 +161,81 @@ int main(int argc, char **argv)
         }
     }
 
-    return (int)TestSuite::run(args["test"][0], configuration, args["out"][0]);
+    if (!concurrent) {
+        bool passed = TestSuite::run(args["test"][0], configuration, args["out"][0]);
+        return passed ? 0 : 1;
+    }
+
+    // Get the tests to run, and the cpus to reserve for each.
+    std::vector<TestRunner::Task> tasks;
+    std::vector<std::string> names = TestSuite::get_test_names();
+
+    if (flags.contains('a')) {
+        if (args.contains("test"))
+            usage("-a and --test cannot both be specified");
+
+        std::sort(names.begin(), names.end());
+        for (const std::string &name : names)
+            tasks.push_back({.name = name, .cpus = 1});
+    }
+    else {
+        for (const std::string &string : args["test"]) {
+            TestRunner::Task task;
+            if (!TestRunner::parse(string, task))
+                usage("failed to parse test " + string);
+
+            if (std::find(names.begin(), names.end(), task.name) == names.end())
+                usage("test \"" + task.name + "\" does not exist");
+
+            tasks.push_back(task);
+        }
+    }
+
+    // Gets the single value of an optional argument.
+    auto single = [&](const std::string &key) -> std::optional<std::string> {
+        if (!args.contains(key))
+            return std::nullopt;
+        if (args[key].size() != 1)
+            usage("--" + key + " must be specified once");
+        return args[key][0];
+    };
+
+    TestRunner::Configuration runner_configuration {
+        .executable = program,
+        .folder = args["out"][0],
+        .patch = configuration,
+        .cpus = 0,
+        .timeout = 0.0,
+        .junit = single("junit").value_or(""),
+        .results = single("json").value_or(""),
+        .port = 8080
+    };
+
+#ifdef __linux__
+    // Execute the same binary regardless of the working directory.
+    std::error_code error;
+    auto executable = std::filesystem::read_symlink("/proc/self/exe", error);
+    if (!error)
+        runner_configuration.executable = executable;
+#endif
+
+    try {
+        if (auto cpus = single("cpus"))
+            runner_configuration.cpus = (unsigned int)std::stoul(*cpus);
+
+        if (auto timeout = single("timeout"))
+            runner_configuration.timeout = std::stod(*timeout);
+
+        if (auto port = single("port"))
+            runner_configuration.port = std::stoi(*port);
+    }
+    catch (const std::exception &) {
+        usage("failed to parse --cpus, --timeout or --port");
+    }
+
+    auto runner = TestRunner::create(runner_configuration);
+    if (!runner)
+        return 1;
+
+    return runner->run(tasks) ? 0 : 1;
 }
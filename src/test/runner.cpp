@@ -0,0 +1,729 @@
+#include "test/runner.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include "test/test.hpp"
+#else
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// The interval between polling the running tests.
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(20);
+
+/// The time between asking a test process to terminate and killing it.
+constexpr double TERMINATION_GRACE = 5.0;
+
+/// The maximum number of bytes of each test log included in JUnit results.
+constexpr std::size_t JUNIT_LOG_LENGTH = 16 * 1024;
+
+/// Set by the signal handler when the run is interrupted.
+volatile std::sig_atomic_t s_interrupted = 0;
+
+const char *to_string(TestRunner::Status status)
+{
+    switch (status) {
+        case TestRunner::Status::PASSED: return "passed";
+        case TestRunner::Status::FAILED: return "failed";
+        case TestRunner::Status::TIMEOUT: return "timeout";
+        case TestRunner::Status::ERROR: return "error";
+        case TestRunner::Status::SKIPPED: return "skipped";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Format a duration in the style of the test suite.
+ */
+std::string format_duration(double duration)
+{
+    auto total = (long long)(duration * 1000.0 + 0.5);
+
+    std::ostringstream stream;
+    stream << total / 60000 << "min "
+           << (total / 1000) % 60 << "s "
+           << total % 1000 << "ms";
+    return stream.str();
+}
+
+/**
+ * @brief Format a list of CPUs as ranges, for example "0-3,6".
+ */
+std::string format_cpus(const std::vector<unsigned int> &cpus)
+{
+    std::ostringstream stream;
+
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            ++j;
+
+        if (i > 0)
+            stream << ',';
+
+        stream << cpus[i];
+        if (j > i)
+            stream << '-' << cpus[j];
+
+        i = j + 1;
+    }
+
+    return stream.str();
+}
+
+/**
+ * @brief Format a time point with strftime.
+ */
+std::string format_time(std::chrono::system_clock::time_point point, const char *format)
+{
+    auto time = std::chrono::system_clock::to_time_t(point);
+    char buffer[100] = {'\0'};
+    std::strftime(buffer, sizeof(buffer), format, std::localtime(&time));
+    return buffer;
+}
+
+/**
+ * @brief Escape text for an XML attribute or element.
+ */
+std::string escape_xml(const std::string &text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+
+    for (char c : text) {
+        switch (c) {
+            case '&': escaped += "&amp;"; break;
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '"': escaped += "&quot;"; break;
+            case '\'': escaped += "&apos;"; break;
+            default:
+                // Control characters other than whitespace are not valid XML.
+                if ((unsigned char)c < 0x20 && c != '\n' && c != '\r' && c != '\t')
+                    escaped += '?';
+                else
+                    escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+/**
+ * @brief Read at most the last length bytes of a file.
+ */
+std::string read_tail(const std::filesystem::path &path, std::size_t length)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return "";
+
+    auto size = (std::size_t)file.tellg();
+    std::size_t offset = size > length ? size - length : 0;
+
+    std::string text(size - offset, '\0');
+    file.seekg((std::streamoff)offset);
+    file.read(text.data(), (std::streamsize)text.size());
+    return text;
+}
+
+#ifndef _WIN32
+void interrupt(int)
+{
+    s_interrupted = 1;
+}
+#endif
+
+} // namespace
+
+/**
+ * @brief A running test process.
+ */
+struct TestRunner::Process {
+
+    /// The test run by the process.
+    Task task;
+
+    /// The result of the test.
+    Result *result = nullptr;
+
+    /// The process id.
+    int pid = -1;
+
+    /// The time the process started.
+    std::chrono::steady_clock::time_point start;
+
+    /// If the process was asked to terminate for exceeding the timeout.
+    bool timed_out = false;
+
+    /// If the process was asked to terminate for the run being interrupted.
+    bool interrupted = false;
+
+    /// The time the process was asked to terminate.
+    std::chrono::steady_clock::time_point terminated;
+
+    /// If the process was killed after not terminating.
+    bool killed = false;
+};
+
+bool TestRunner::parse(const std::string &string, Task &task)
+{
+    auto colon = string.rfind(':');
+    task.name = string.substr(0, colon);
+    task.cpus = 1;
+
+    if (task.name.empty())
+        return false;
+
+    if (colon == std::string::npos)
+        return true;
+
+    try {
+        std::size_t end = 0;
+        int cpus = std::stoi(string.substr(colon + 1), &end);
+        if (end != string.size() - colon - 1 || cpus < 1)
+            return false;
+        task.cpus = (unsigned int)cpus;
+    }
+    catch (const std::exception &) {
+        return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<TestRunner> TestRunner::create(const Configuration &configuration)
+{
+    if (configuration.timeout < 0.0) {
+        std::cerr << "test runner timeout cannot be negative" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<unsigned int> available;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                available.push_back(cpu);
+        }
+    }
+#endif
+
+    if (available.empty()) {
+        available.resize(std::max(1u, std::thread::hardware_concurrency()));
+        std::iota(available.begin(), available.end(), 0u);
+    }
+
+#ifndef _WIN32
+    if (!std::filesystem::is_regular_file(configuration.executable)) {
+        std::cerr << "test executable " << configuration.executable
+                  << " does not exist" << std::endl;
+        return nullptr;
+    }
+#endif
+
+    if (configuration.cpus > available.size()) {
+        std::cerr << "test runner budget of " << configuration.cpus
+                  << " cpus exceeds the " << available.size()
+                  << " available, using " << available.size() << std::endl;
+    }
+    else if (configuration.cpus > 0) {
+        available.resize(configuration.cpus);
+    }
+
+    return std::unique_ptr<TestRunner>(
+        new TestRunner(configuration, std::move(available))
+    );
+}
+
+TestRunner::TestRunner(
+    const Configuration &configuration,
+    std::vector<unsigned int> &&cpus
+) : m_configuration(configuration)
+  , m_cpus(std::move(cpus))
+  , m_duration(0.0)
+{
+}
+
+bool TestRunner::run(const std::vector<Task> &tasks)
+{
+    using namespace std::chrono;
+
+    auto now = system_clock::now();
+    m_timestamp = format_time(now, "%FT%T");
+
+    // Every test of the run writes to its own folder in the same folder.
+    std::filesystem::path folder = m_configuration.folder / (
+        "runner_" + format_time(now, "%F_%H-%M-%S")
+    );
+
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+    if (error) {
+        std::cerr << "failed to create folder " << folder << ": "
+                  << error.message() << std::endl;
+        return false;
+    }
+
+    // Number the logs and folders of tests that are run more than once.
+    std::unordered_map<std::string, int> repeats;
+
+    m_results.assign(tasks.size(), Result());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        int repeat = repeats[tasks[i].name]++;
+        std::string suffix = repeat > 0 ? "_" + std::to_string(repeat) : "";
+
+        m_results[i].name = tasks[i].name;
+        m_results[i].log = folder / (tasks[i].name + suffix + ".log");
+        m_results[i].folder = folder / (tasks[i].name + suffix);
+        m_results[i].port = m_configuration.port + (int)i;
+    }
+
+    std::cout << "running " << tasks.size() << " tests on "
+              << m_cpus.size() << " cpus in " << folder << std::endl;
+
+    auto started = steady_clock::now();
+
+#ifdef _WIN32
+    // Tests cannot be isolated in processes, so run them one after another.
+    std::cerr << "the test runner is not supported on windows, running tests "
+              << "sequentially" << std::endl;
+
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        Result &result = m_results[i];
+        result.log.clear();
+
+        auto begin = steady_clock::now();
+        bool passed = TestSuite::run(
+            tasks[i].name, m_configuration.patch, result.folder, 15.0
+        );
+        result.duration = duration<double>(steady_clock::now() - begin).count();
+        result.status = passed ? Status::PASSED : Status::FAILED;
+        result.exit_code = passed ? 0 : 1;
+    }
+#else
+    // Start the tests reserving the most cpus first, so they are not starved
+    // by smaller tests filling the budget.
+    std::vector<std::size_t> pending(tasks.size());
+    std::iota(pending.begin(), pending.end(), 0);
+    std::stable_sort(pending.begin(), pending.end(), [&](std::size_t l, std::size_t r) {
+        return tasks[l].cpus > tasks[r].cpus;
+    });
+
+    std::vector<bool> free(m_cpus.size(), true);
+    std::vector<Process> running;
+
+    // Terminate the tests if the run is interrupted, since they are in their
+    // own process groups and do not receive terminal signals.
+    s_interrupted = 0;
+    struct sigaction action {}, previous_interrupt {}, previous_terminate {};
+    action.sa_handler = interrupt;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &previous_interrupt);
+    sigaction(SIGTERM, &action, &previous_terminate);
+
+    bool interrupted = false;
+
+    while (!pending.empty() || !running.empty()) {
+        auto time = steady_clock::now();
+
+        if (s_interrupted && !interrupted) {
+            interrupted = true;
+            std::cerr << "interrupted, terminating " << running.size()
+                      << " tests" << std::endl;
+
+            for (Process &process : running) {
+                kill(-process.pid, SIGTERM);
+                process.interrupted = true;
+                process.terminated = time;
+            }
+
+            for (std::size_t index : pending)
+                m_results[index].message = "run interrupted";
+            pending.clear();
+        }
+
+        // Start every pending test that fits in the free cpus.
+        for (auto it = pending.begin(); it != pending.end();) {
+            const Task &task = tasks[*it];
+            auto cpus = std::min<std::size_t>(task.cpus, m_cpus.size());
+
+            if ((std::size_t)std::count(free.begin(), free.end(), true) < cpus) {
+                ++it;
+                continue;
+            }
+
+            Process process;
+            process.task = task;
+            process.result = &m_results[*it];
+
+            for (std::size_t i = 0; i < free.size() && process.result->cpus.size() < cpus; ++i) {
+                if (free[i]) {
+                    free[i] = false;
+                    process.result->cpus.push_back(m_cpus[i]);
+                }
+            }
+
+            if (start(process)) {
+                running.push_back(std::move(process));
+            }
+            else {
+                for (unsigned int cpu : process.result->cpus)
+                    free[std::find(m_cpus.begin(), m_cpus.end(), cpu) - m_cpus.begin()] = true;
+                print(*process.result);
+            }
+
+            it = pending.erase(it);
+        }
+
+        // Collect the finished tests and terminate those exceeding the timeout.
+        for (auto it = running.begin(); it != running.end();) {
+            Process &process = *it;
+            Result &result = *process.result;
+
+            int status = 0;
+            if (waitpid(process.pid, &status, WNOHANG) != process.pid) {
+                double elapsed = duration<double>(time - process.start).count();
+                bool terminating = process.timed_out || process.interrupted;
+
+                if (!terminating && m_configuration.timeout > 0.0 && elapsed > m_configuration.timeout) {
+                    kill(-process.pid, SIGTERM);
+                    process.timed_out = true;
+                    process.terminated = time;
+                }
+                else if (terminating && !process.killed &&
+                         duration<double>(time - process.terminated).count() > TERMINATION_GRACE) {
+                    kill(-process.pid, SIGKILL);
+                    process.killed = true;
+                }
+
+                ++it;
+                continue;
+            }
+
+            result.duration = duration<double>(time - process.start).count();
+
+            if (WIFEXITED(status))
+                result.exit_code = WEXITSTATUS(status);
+            else if (WIFSIGNALED(status))
+                result.signal = WTERMSIG(status);
+
+            if (process.timed_out) {
+                result.status = Status::TIMEOUT;
+                result.message = "exceeded the timeout of " +
+                    format_duration(m_configuration.timeout);
+            }
+            else if (process.interrupted) {
+                result.status = Status::ERROR;
+                result.message = "run interrupted";
+            }
+            else if (result.exit_code == 0) {
+                result.status = Status::PASSED;
+            }
+            else if (result.exit_code == 127) {
+                result.status = Status::ERROR;
+                result.message = "failed to execute " + m_configuration.executable.string();
+            }
+            else if (result.exit_code > 0) {
+                result.status = Status::FAILED;
+                result.message = "exited with code " + std::to_string(result.exit_code);
+            }
+            else {
+                result.status = Status::ERROR;
+                result.message = "terminated by signal " + std::to_string(result.signal) +
+                    " (" + strsignal(result.signal) + ")";
+            }
+
+            for (unsigned int cpu : result.cpus)
+                free[std::find(m_cpus.begin(), m_cpus.end(), cpu) - m_cpus.begin()] = true;
+
+            print(result);
+            it = running.erase(it);
+        }
+
+        if (!running.empty())
+            std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+
+    sigaction(SIGINT, &previous_interrupt, nullptr);
+    sigaction(SIGTERM, &previous_terminate, nullptr);
+#endif
+
+    m_duration = duration<double>(steady_clock::now() - started).count();
+
+    summarise();
+
+    bool success = true;
+
+    if (!m_configuration.junit.empty())
+        success &= write_junit(m_configuration.junit);
+
+    if (!m_configuration.results.empty())
+        success &= write_json(m_configuration.results);
+
+    for (const Result &result : m_results)
+        success &= result.status == Status::PASSED;
+
+    return success;
+}
+
+bool TestRunner::start(Process &process)
+{
+#ifdef _WIN32
+    return false;
+#else
+    Result &result = *process.result;
+
+    // Prepare everything the child needs before forking, since it may only
+    // make async signal safe calls.
+    std::vector<std::string> arguments {
+        m_configuration.executable.string(),
+        "--test", process.task.name,
+        "--out", result.folder.string()
+    };
+
+    if (!m_configuration.patch.is_null() && !m_configuration.patch.empty()) {
+        arguments.push_back("--config");
+        arguments.push_back(m_configuration.patch.dump());
+    }
+
+    std::vector<char *> argv;
+    for (std::string &argument : arguments)
+        argv.push_back(argument.data());
+    argv.push_back(nullptr);
+
+    // The environment of the runner, with the raisim server port of the test.
+    std::vector<std::string> variables;
+    for (char **variable = environ; *variable; ++variable) {
+        if (std::strncmp(*variable, "RAISIM_PORT=", 12) != 0)
+            variables.emplace_back(*variable);
+    }
+    variables.push_back("RAISIM_PORT=" + std::to_string(result.port));
+
+    std::vector<char *> envp;
+    for (std::string &variable : variables)
+        envp.push_back(variable.data());
+    envp.push_back(nullptr);
+
+    std::string log = result.log.string();
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned int cpu : result.cpus)
+        CPU_SET(cpu, &set);
+#endif
+
+    process.start = std::chrono::steady_clock::now();
+
+    int pid = fork();
+
+    if (pid < 0) {
+        result.status = Status::ERROR;
+        result.message = std::string("failed to fork: ") + std::strerror(errno);
+        return false;
+    }
+
+    if (pid == 0) {
+        // Put the test in its own process group, so it can be terminated
+        // along with any processes it starts.
+        setpgid(0, 0);
+
+#ifdef __linux__
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+
+        int input = open("/dev/null", O_RDONLY);
+        int output = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (input < 0 || output < 0)
+            _exit(127);
+
+        dup2(input, STDIN_FILENO);
+        dup2(output, STDOUT_FILENO);
+        dup2(output, STDERR_FILENO);
+        close(input);
+        close(output);
+
+        execve(argv[0], argv.data(), envp.data());
+        _exit(127);
+    }
+
+    // Also set the process group from the parent, so it is set before any
+    // signal is sent to it.
+    setpgid(pid, pid);
+    process.pid = pid;
+    return true;
+#endif
+}
+
+void TestRunner::print(const Result &result) const
+{
+    std::cout << "test \"" << result.name << "\" ";
+
+    switch (result.status) {
+        case Status::PASSED: std::cout << "okay"; break;
+        case Status::FAILED: std::cout << "failed"; break;
+        case Status::TIMEOUT: std::cout << "timed out"; break;
+        case Status::ERROR: std::cout << "error"; break;
+        case Status::SKIPPED: std::cout << "skipped"; break;
+    }
+
+    std::cout << " (" << format_duration(result.duration) << ")";
+
+    if (!result.cpus.empty())
+        std::cout << " on cpus " << format_cpus(result.cpus);
+
+    if (result.status != Status::PASSED) {
+        if (!result.message.empty())
+            std::cout << ": " << result.message;
+        if (!result.log.empty())
+            std::cout << ", see " << result.log;
+    }
+
+    std::cout << std::endl;
+}
+
+void TestRunner::summarise() const
+{
+    double total = 0.0;
+    std::size_t counts[5] = {0};
+
+    for (const Result &result : m_results) {
+        total += result.duration;
+        counts[(int)result.status]++;
+    }
+
+    std::cout << "ran " << m_results.size() << " tests in "
+              << format_duration(m_duration) << ", "
+              << format_duration(total) << " of test time";
+
+    if (m_duration > 0.0)
+        std::cout << " (" << std::fixed << std::setprecision(1)
+                  << total / m_duration << "x)" << std::defaultfloat;
+
+    std::cout << std::endl;
+
+    std::cout << counts[(int)Status::PASSED] << " passed, "
+              << counts[(int)Status::FAILED] << " failed, "
+              << counts[(int)Status::TIMEOUT] << " timed out, "
+              << counts[(int)Status::ERROR] << " errors, "
+              << counts[(int)Status::SKIPPED] << " skipped" << std::endl;
+}
+
+bool TestRunner::write_junit(const std::filesystem::path &path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "failed to open " << path << " to write junit results" << std::endl;
+        return false;
+    }
+
+    std::size_t failures = 0, errors = 0, skipped = 0;
+    for (const Result &result : m_results) {
+        failures += result.status == Status::FAILED;
+        errors += result.status == Status::TIMEOUT || result.status == Status::ERROR;
+        skipped += result.status == Status::SKIPPED;
+    }
+
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         << "<testsuite name=\"test\" tests=\"" << m_results.size()
+         << "\" failures=\"" << failures
+         << "\" errors=\"" << errors
+         << "\" skipped=\"" << skipped
+         << "\" time=\"" << m_duration
+         << "\" timestamp=\"" << m_timestamp << "\">\n";
+
+    for (const Result &result : m_results) {
+        file << "  <testcase name=\"" << escape_xml(result.name)
+             << "\" classname=\"test\" time=\"" << result.duration << "\">\n";
+
+        std::string message = escape_xml(result.message);
+
+        switch (result.status) {
+            case Status::PASSED:
+                break;
+            case Status::FAILED:
+                file << "    <failure message=\"" << message << "\"/>\n";
+                break;
+            case Status::TIMEOUT:
+            case Status::ERROR:
+                file << "    <error type=\"" << to_string(result.status)
+                     << "\" message=\"" << message << "\"/>\n";
+                break;
+            case Status::SKIPPED:
+                file << "    <skipped message=\"" << message << "\"/>\n";
+                break;
+        }
+
+        if (!result.log.empty() && result.status != Status::SKIPPED) {
+            file << "    <system-out>"
+                 << escape_xml(read_tail(result.log, JUNIT_LOG_LENGTH))
+                 << "</system-out>\n";
+        }
+
+        file << "  </testcase>\n";
+    }
+
+    file << "</testsuite>\n";
+    return (bool)file;
+}
+
+bool TestRunner::write_json(const std::filesystem::path &path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "failed to open " << path << " to write json results" << std::endl;
+        return false;
+    }
+
+    double total = 0.0;
+    json tests = json::array();
+
+    for (const Result &result : m_results) {
+        total += result.duration;
+        tests.push_back({
+            {"name", result.name},
+            {"status", to_string(result.status)},
+            {"message", result.message},
+            {"exit_code", result.exit_code},
+            {"signal", result.signal},
+            {"duration", result.duration},
+            {"cpus", result.cpus},
+            {"log", result.log.string()},
+            {"folder", result.folder.string()},
+            {"port", result.port}
+        });
+    }
+
+    json results {
+        {"timestamp", m_timestamp},
+        {"cpus", m_cpus},
+        {"duration", m_duration},
+        {"test_duration", total},
+        {"tests", tests}
+    };
+
+    file << results.dump(4) << std::endl;
+    return (bool)file;
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * @brief Runs tests concurrently, each in its own process.
+ *
+ * Each test is run by executing the test executable with a single test, so a
+ * test that crashes or hangs does not affect the others. Tests are started
+ * while they fit in the budget of CPUs, and each process is pinned to its own
+ * CPUs on linux so concurrent tests do not compete for them. A test that
+ * exceeds the timeout is terminated with its process group.
+ *
+ * The output of each test is written to a log file in the run folder, and the
+ * test writes its data to its own folder in the run folder. Each test is given
+ * its own raisim server port. The results may additionally be written as
+ * JUnit XML and JSON.
+ */
+class TestRunner
+{
+public:
+
+    struct Configuration {
+
+        /// The test executable to run each test with.
+        std::filesystem::path executable;
+
+        /// The folder to put generated test data and logs.
+        std::filesystem::path folder;
+
+        /// The change in configuration of every test.
+        json patch;
+
+        /// The number of CPUs shared by the running tests, or zero for every
+        /// available CPU.
+        unsigned int cpus;
+
+        /// The maximum duration of each test in seconds, or zero for no
+        /// maximum.
+        double timeout;
+
+        /// The path to write JUnit XML results to, or empty to not write them.
+        std::filesystem::path junit;
+
+        /// The path to write JSON results to, or empty to not write them.
+        std::filesystem::path results;
+
+        /// The raisim server port of the first test. Each test is given the
+        /// next port in the RAISIM_PORT environment variable, so concurrent
+        /// simulations do not share a port.
+        int port;
+    };
+
+    /**
+     * @brief A test to run.
+     */
+    struct Task {
+
+        /// The name of the test.
+        std::string name;
+
+        /// The number of CPUs reserved for the test.
+        unsigned int cpus = 1;
+    };
+
+    /**
+     * @brief The outcome of a test.
+     */
+    enum class Status {
+        PASSED,
+        FAILED,
+        TIMEOUT,
+        ERROR,
+        SKIPPED
+    };
+
+    /**
+     * @brief The result of a test.
+     */
+    struct Result {
+
+        /// The name of the test.
+        std::string name;
+
+        /// The outcome of the test.
+        Status status = Status::SKIPPED;
+
+        /// A description of the outcome if not passed.
+        std::string message;
+
+        /// The exit code of the process, or -1 if it did not exit.
+        int exit_code = -1;
+
+        /// The signal that terminated the process, or zero.
+        int signal = 0;
+
+        /// The duration of the test in seconds.
+        double duration = 0.0;
+
+        /// The CPUs the test was pinned to.
+        std::vector<unsigned int> cpus;
+
+        /// The path of the log of the test output.
+        std::filesystem::path log;
+
+        /// The folder the test writes its output to.
+        std::filesystem::path folder;
+
+        /// The raisim server port given to the test.
+        int port = 0;
+    };
+
+    /**
+     * @brief Parse a task from a test name, optionally followed by a colon
+     * and the number of CPUs to reserve.
+     *
+     * @param string The task string, for example "circle" or "circle:4".
+     * @param task The parsed task.
+     *
+     * @returns If the string was parsed.
+     */
+    static bool parse(const std::string &string, Task &task);
+
+    /**
+     * @brief Create a test runner.
+     *
+     * @param configuration The configuration of the runner.
+     * @returns A pointer to the runner on success or nullptr on failure.
+     */
+    static std::unique_ptr<TestRunner> create(const Configuration &configuration);
+
+    /**
+     * @brief Run tests concurrently and wait for them to finish.
+     *
+     * Tests reserving the most CPUs are started first. A test reserving more
+     * CPUs than the budget reserves the whole budget.
+     *
+     * @param tasks The tests to run.
+     * @returns If every test passed.
+     */
+    bool run(const std::vector<Task> &tasks);
+
+    /**
+     * @brief Get the results of the last run, in the order of the tasks.
+     */
+    inline const std::vector<Result> &get_results() const {
+        return m_results;
+    }
+
+    /**
+     * @brief Get the duration of the last run in seconds.
+     */
+    inline double get_duration() const {
+        return m_duration;
+    }
+
+private:
+
+    struct Process;
+
+    TestRunner(
+        const Configuration &configuration,
+        std::vector<unsigned int> &&cpus
+    );
+
+    /**
+     * @brief Start a test process.
+     *
+     * @param process The process, with the task and result set.
+     * @returns If the process was started.
+     */
+    bool start(Process &process);
+
+    /**
+     * @brief Print the result of a test.
+     */
+    void print(const Result &result) const;
+
+    /**
+     * @brief Print the aggregated timing and outcomes of the last run.
+     */
+    void summarise() const;
+
+    /**
+     * @brief Write the results of the last run as JUnit XML.
+     * @returns If the results were written.
+     */
+    bool write_junit(const std::filesystem::path &path) const;
+
+    /**
+     * @brief Write the results of the last run as JSON.
+     * @returns If the results were written.
+     */
+    bool write_json(const std::filesystem::path &path) const;
+
+    /// The configuration of the runner.
+    const Configuration m_configuration;
+
+    /// The CPUs shared by the running tests.
+    const std::vector<unsigned int> m_cpus;
+
+    /// The results of the last run.
+    std::vector<Result> m_results;
+
+    /// The duration of the last run in seconds.
+    double m_duration;
+
+    /// The time the last run started, formatted as an ISO 8601 datetime.
+    std::string m_timestamp;
+};
@@ -104,7 +104,7 @@ public:
     {
         bool success = true;
         for (auto &[name, creator] : s_tests)
-            success |= run(name);
+            success &= run(name);
         return success;
     }
 
@@ -118,7 +118,7 @@ public:
     {
         bool success = true;
         for (const auto &name : names)
-            success |= run(name);
+            success &= run(name);
         return success;
     }
 